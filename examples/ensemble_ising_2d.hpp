@@ -0,0 +1,83 @@
+#ifndef ENSEMBLE_ISING_2D_HPP
+#define ENSEMBLE_ISING_2D_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Class representing an ensemble of independent two-dimensional Ising models with periodic boundary conditions.
+// The spins of all chains at one site are stored contiguously (structure of arrays).
+class EnsembleIsingConfiguration2d
+{
+public:
+  // Type of the energies
+  typedef int energy_type;
+
+  // System sizes and number of chains
+  unsigned int size_x;
+  unsigned int size_y;
+  unsigned int chains;
+
+  // The spins are stored as -1 and 1, the spin of chain k at site i has the index i*chains + k
+  std::vector<signed char> spins;
+  // Indices of the four neighbours of every site
+  std::vector<uint32_t> neighbours;
+
+  // Default constructor, needed for serialization
+  EnsembleIsingConfiguration2d() : size_x(0), size_y(0), chains(0) { }
+  // Create an ensemble of Ising models with all spins pointing up
+  EnsembleIsingConfiguration2d(unsigned int length_x, unsigned int length_y, unsigned int chain_count)
+    : size_x(length_x), size_y(length_y), chains(chain_count), spins(length_x * length_y * chain_count, 1), neighbours(4 * length_x * length_y)
+  {
+    for (unsigned int i = 0; i < size_x; ++i)
+      for (unsigned int j = 0; j < size_y; ++j)
+      {
+	unsigned int site = i * size_y + j;
+	neighbours[4*site + 0] = (i == 0 ? size_x - 1 : i - 1) * size_y + j;
+	neighbours[4*site + 1] = (i == size_x - 1 ? 0 : i + 1) * size_y + j;
+	neighbours[4*site + 2] = i * size_y + (j == 0 ? size_y - 1 : j - 1);
+	neighbours[4*site + 3] = i * size_y + (j == size_y - 1 ? 0 : j + 1);
+      }
+  }
+
+  // Number of chains and number of sites of every chain
+  std::size_t chain_number() const { return chains; }
+  std::size_t site_number() const { return size_x * size_y; }
+
+  // Calculate the energy differences of flipping the given site in every chain
+  void ensemble_delta_E(const std::vector<uint32_t>& sites, std::vector<int>& delta_E) const
+  {
+    delta_E.resize(chains);
+    for (unsigned int k = 0; k < chains; ++k)
+    {
+      const uint32_t* site_neighbours = &neighbours[4*sites[k]];
+      delta_E[k] = 2 * spins[sites[k]*chains + k] * (spins[site_neighbours[0]*chains + k] + spins[site_neighbours[1]*chains + k] +
+						     spins[site_neighbours[2]*chains + k] + spins[site_neighbours[3]*chains + k]);
+    }
+  }
+  // Flip the given site in every chain in which the step was accepted
+  void ensemble_execute(const std::vector<uint32_t>& sites, const std::vector<char>& accepted)
+  {
+    for (unsigned int k = 0; k < chains; ++k)
+      spins[sites[k]*chains + k] *= 1 - 2 * accepted[k];
+  }
+
+  // Calculate the energy (negative sum over products of nearest neighbour spins) of a chain
+  int energy(std::size_t chain) const
+  {
+    int result = 0;
+    for (unsigned int site = 0; site < size_x * size_y; ++site)
+      result -= spins[site*chains + chain] * (spins[neighbours[4*site + 1]*chains + chain] + spins[neighbours[4*site + 3]*chains + chain]);
+    return result;
+  }
+  // Calculate the magnetization of a chain
+  int magnetization(std::size_t chain) const
+  {
+    int result = 0;
+    for (unsigned int site = 0; site < size_x * size_y; ++site)
+      result += spins[site*chains + chain];
+    return result;
+  }
+};
+
+#endif
@@ -0,0 +1,75 @@
+// Example program simulating the Glauber dynamics of a 2d Ising model in physical time. Compile using
+// g++ -std=c++11 -O2 -I../include kinetic_monte_carlo.cpp -lboost_serialization -o kinetic_monte_carlo
+
+#include <iostream>
+#include <cmath>
+#include "simple_ising_2d.hpp"
+
+#include <mocasinns/kinetic_monte_carlo.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+// Spin flip with the Glauber rate 1/(1 + exp(beta*dE)) at a given inverse temperature
+class GlauberStep2d : public IsingStep2d
+{
+public:
+  // Inverse temperature determining the rate of the flip
+  double beta;
+
+  // Default constructor, needed for the concept check
+  GlauberStep2d() : IsingStep2d(0, 0, 0), beta(0.0) { }
+  // Constructor taking the configuration, the spin index of the flip and the inverse temperature
+  GlauberStep2d(IsingConfiguration2d* config, unsigned int index_x, unsigned int index_y, double inverse_temperature) : IsingStep2d(config, index_x, index_y), beta(inverse_temperature) { }
+
+  // Physical rate of the flip in the actual configuration
+  double rate() { return 1.0 / (1.0 + std::exp(beta * delta_E())); }
+};
+
+// Ising model enumerating all spin flips as events of the kinetic Monte-Carlo simulation
+class GlauberIsingConfiguration2d : public IsingConfiguration2d
+{
+public:
+  // Inverse temperature of the heat bath
+  double beta;
+
+  // Create an Ising configuration with a certain number of spins at a given inverse temperature
+  GlauberIsingConfiguration2d(unsigned int length_x, unsigned int length_y, double inverse_temperature) : IsingConfiguration2d(length_x, length_y), beta(inverse_temperature) { }
+
+  // Enumerate the flips of all spins in typewriter order (y index runs fastest)
+  void all_steps(std::vector<GlauberStep2d>& steps)
+  {
+    for (unsigned int i = 0; i < size_x; ++i)
+      for (unsigned int j = 0; j < size_y; ++j)
+	steps.push_back(GlauberStep2d(this, i, j, beta));
+  }
+  // A flip changes the rates of the flipped spin and its four neighbours, whose indices are given by the footprint of the step
+  void affected_steps(GlauberStep2d& executed_step, std::vector<std::size_t>& indices) { executed_step.footprint(indices); }
+};
+
+typedef Mocasinns::KineticMonteCarlo<GlauberIsingConfiguration2d, GlauberStep2d, Mocasinns::Random::Boost_MT19937> KineticSimulation;
+
+int main(int argc, char* argv[])
+{
+  // Check and read command line arguments
+  if (argc != 4)
+  {
+    std::cerr << "ERROR: Use three command line parameters: size, inverse temperature and number of measurements" << std::endl;
+    return 1;
+  }
+  unsigned int size = atoi(argv[1]);
+  double beta = atof(argv[2]);
+  unsigned int measurements = atoi(argv[3]);
+
+  // Quench the completely ordered system and measure the energy per spin in unit intervals of the physical time
+  KineticSimulation::Parameters parameters;
+  parameters.relaxation_time = 0.0;
+  parameters.measurement_number = measurements;
+  parameters.time_between_measurement = 1.0;
+
+  GlauberIsingConfiguration2d configuration(size, size, beta);
+  KineticSimulation simulation(parameters, &configuration);
+  std::vector<int> energies = simulation.do_kinetic_monte_carlo_simulation();
+
+  std::cout << "time\tenergy per spin" << std::endl;
+  for (unsigned int m = 0; m < energies.size(); ++m)
+    std::cout << (m + 1)*parameters.time_between_measurement << "\t" << static_cast<double>(energies[m]) / (size*size) << std::endl;
+}
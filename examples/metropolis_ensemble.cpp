@@ -0,0 +1,71 @@
+// Example program comparing an ensemble of small 2d Ising models advanced in lockstep with independent serial Metropolis simulations. Compile using
+// g++ -std=c++11 -O3 -march=native -I../include metropolis_ensemble.cpp -lboost_serialization -o metropolis_ensemble
+
+#include <iostream>
+#include <chrono>
+#include "ensemble_ising_2d.hpp"
+#include "simple_ising_2d.hpp"
+
+#include <mocasinns/metropolis.hpp>
+#include <mocasinns/metropolis_ensemble.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+typedef Mocasinns::MetropolisEnsemble<EnsembleIsingConfiguration2d, Mocasinns::Random::Boost_MT19937> EnsembleSimulation;
+typedef Mocasinns::Metropolis<IsingConfiguration2d, IsingStep2d, Mocasinns::Random::Boost_MT19937> MetropolisSimulation;
+
+int main(int argc, char* argv[])
+{
+  // Check and read command line arguments
+  if (argc != 5)
+  {
+    std::cerr << "ERROR: Use four command line parameters: size, inverse temperature, number of chains and number of sweeps" << std::endl;
+    return 1;
+  }
+  unsigned int size = atoi(argv[1]);
+  double beta = atof(argv[2]);
+  unsigned int chains = atoi(argv[3]);
+  unsigned int sweeps = atoi(argv[4]);
+
+  // Simulate all chains in lockstep
+  EnsembleSimulation::Parameters ensemble_parameters;
+  ensemble_parameters.relaxation_steps = 100*size*size;
+  ensemble_parameters.measurement_number = sweeps;
+  ensemble_parameters.steps_between_measurement = size*size;
+  EnsembleIsingConfiguration2d ensemble_configuration(size, size, chains);
+  EnsembleSimulation ensemble_simulation(ensemble_parameters, &ensemble_configuration);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<std::vector<int> > ensemble_energies = ensemble_simulation.do_ensemble_simulation(beta);
+  double ensemble_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  double ensemble_mean = 0.0;
+  for (unsigned int k = 0; k < chains; ++k)
+    for (unsigned int m = 0; m < ensemble_energies[k].size(); ++m)
+      ensemble_mean += ensemble_energies[k][m];
+  ensemble_mean /= static_cast<double>(chains) * sweeps * size * size;
+
+  // Simulate the chains one after another
+  MetropolisSimulation::Parameters serial_parameters;
+  serial_parameters.relaxation_steps = ensemble_parameters.relaxation_steps;
+  serial_parameters.measurement_number = ensemble_parameters.measurement_number;
+  serial_parameters.steps_between_measurement = ensemble_parameters.steps_between_measurement;
+
+  start = std::chrono::steady_clock::now();
+  double serial_mean = 0.0;
+  for (unsigned int k = 0; k < chains; ++k)
+  {
+    IsingConfiguration2d configuration(size, size);
+    MetropolisSimulation simulation(serial_parameters, &configuration);
+    simulation.set_random_seed(k);
+    std::vector<int> energies = simulation.do_metropolis_simulation(beta);
+    for (unsigned int m = 0; m < energies.size(); ++m)
+      serial_mean += energies[m];
+  }
+  serial_mean /= static_cast<double>(chains) * sweeps * size * size;
+  double serial_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  double steps = static_cast<double>(chains) * (ensemble_parameters.relaxation_steps + sweeps * ensemble_parameters.steps_between_measurement);
+  std::cout << "mode\t\tenergy per spin\tsteps per second" << std::endl;
+  std::cout << "ensemble\t" << ensemble_mean << "\t" << steps / ensemble_seconds << std::endl;
+  std::cout << "serial  \t" << serial_mean << "\t" << steps / serial_seconds << std::endl;
+}
@@ -0,0 +1,48 @@
+// Example program calculating the mean energy of 64 replicas of a 2d Ising model stored with multi-spin coding. Compile using
+// g++ -std=c++11 -O2 -I../include metropolis_multi_spin.cpp -lboost_serialization -o metropolis_multi_spin
+
+#include <iostream>
+#include <chrono>
+#include "multi_spin_ising_2d.hpp"
+
+#include <mocasinns/metropolis.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+typedef Mocasinns::Metropolis<MultiSpinIsingConfiguration2d, MultiSpinIsingStep2d, Mocasinns::Random::Boost_MT19937> MetropolisSimulation;
+
+int main(int argc, char* argv[])
+{
+  // Check and read command line arguments
+  if (argc != 4)
+  {
+    std::cerr << "ERROR: Use three command line parameters: size, inverse temperature and number of measurements" << std::endl;
+    return 1;
+  }
+  unsigned int size = atoi(argv[1]);
+  double beta = atof(argv[2]);
+  unsigned int measurements = atoi(argv[3]);
+
+  MetropolisSimulation::Parameters parameters;
+  parameters.measurement_number = measurements;
+  parameters.relaxation_steps = 1000*size*size;
+  parameters.steps_between_measurement = 10*size*size;
+
+  MultiSpinIsingConfiguration2d configuration(size, size);
+  MetropolisSimulation simulation(parameters, &configuration);
+
+  // Measure the energies of all replicas
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<ObserveReplicaEnergies::observable_type> results = simulation.do_metropolis_simulation<ObserveReplicaEnergies>(beta);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Average over the measurements and the replicas
+  double mean_energy = 0.0;
+  for (unsigned int m = 0; m < results.size(); ++m)
+    for (unsigned int r = 0; r < results[m].size(); ++r)
+      mean_energy += results[m][r];
+  mean_energy /= static_cast<double>(results.size()) * MultiSpinIsingConfiguration2d::replica_number * size * size;
+
+  double spin_updates = static_cast<double>(parameters.relaxation_steps + parameters.measurement_number * parameters.steps_between_measurement) * MultiSpinIsingConfiguration2d::replica_number;
+  std::cout << "energy per spin: " << mean_energy << std::endl;
+  std::cout << "spin updates per second: " << spin_updates / seconds << std::endl;
+}
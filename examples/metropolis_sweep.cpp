@@ -0,0 +1,52 @@
+// Example program comparing the speed of random-site, sequential-sweep, checkerboard-parallel and speculative-parallel Metropolis steps on a 2d Ising model. Compile using
+// g++ -std=c++11 -O2 -I../include metropolis_sweep.cpp -lboost_serialization -fopenmp -o metropolis_sweep
+
+#include <iostream>
+#include <chrono>
+#include "simple_ising_2d.hpp"
+
+#include <mocasinns/metropolis.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+typedef Mocasinns::Metropolis<IsingConfiguration2d, IsingStep2d, Mocasinns::Random::Boost_MT19937> MetropolisSimulation;
+
+// Perform the given number of sweeps and return the number of steps per second
+double steps_per_second(unsigned int size, double beta, unsigned int sweeps, bool sequential_sweep, unsigned int sublattice_threads, unsigned int speculative_threads)
+{
+  MetropolisSimulation::Parameters parameters;
+  parameters.sequential_sweep = sequential_sweep;
+  parameters.sublattice_thread_number = sublattice_threads;
+  parameters.speculative_thread_number = speculative_threads;
+
+  IsingConfiguration2d configuration(size, size);
+  MetropolisSimulation simulation(parameters, &configuration);
+
+  // Measure the wall-clock time, since the checkerboard steps use several threads
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  simulation.do_metropolis_steps(static_cast<MetropolisSimulation::step_number_t>(sweeps)*size*size, beta);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << (sublattice_threads > 0 ? "checkerboard    " : (speculative_threads > 0 ? "speculative     " : (sequential_sweep ? "sequential sweep" : "random site     "))) << "\t"
+	    << static_cast<double>(configuration.energy()) / (size*size) << "\t";
+  return static_cast<double>(sweeps)*size*size / seconds;
+}
+
+int main(int argc, char* argv[])
+{
+  // Check and read command line arguments
+  if (argc != 5)
+  {
+    std::cerr << "ERROR: Use four command line parameters: size (even), inverse temperature, number of sweeps and number of threads" << std::endl;
+    return 1;
+  }
+  unsigned int size = atoi(argv[1]);
+  double beta = atof(argv[2]);
+  unsigned int sweeps = atoi(argv[3]);
+  unsigned int threads = atoi(argv[4]);
+
+  std::cout << "mode\t\t\tenergy per spin\tsteps per second" << std::endl;
+  std::cout << steps_per_second(size, beta, sweeps, false, 0, 0) << std::endl;
+  std::cout << steps_per_second(size, beta, sweeps, true, 0, 0) << std::endl;
+  std::cout << steps_per_second(size, beta, sweeps, false, threads, 0) << std::endl;
+  std::cout << steps_per_second(size, beta, sweeps, false, 0, threads) << std::endl;
+}
@@ -0,0 +1,152 @@
+#ifndef MULTI_SPIN_ISING_2D_HPP
+#define MULTI_SPIN_ISING_2D_HPP
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// The numeric functionals of boost accumulators must be defined before the observables of mocasinns
+#include <boost/accumulators/numeric/functional.hpp>
+#include <mocasinns/observables/vector_observable.hpp>
+
+class MultiSpinIsingConfiguration2d;
+
+// Class representing the flip of one spin in all 64 replicas of a multi-spin coded 2d Ising model
+class MultiSpinIsingStep2d
+{
+public:
+  // Pointer to the configuration to which the spin belongs
+  MultiSpinIsingConfiguration2d* configuration;
+  // Index of the site whose spins will be flipped by this step
+  unsigned int flip_index;
+
+  // Constructor taking the configuration and the site index of the flip
+  MultiSpinIsingStep2d(MultiSpinIsingConfiguration2d* config, unsigned int index) : configuration(config), flip_index(index) { }
+
+  // Calculates the energy difference of flipping the spin in all replicas
+  int delta_E();
+  // Calculates the masks of the replicas with energy difference 4 and 8 and returns the mask of the replicas with non-positive energy difference
+  uint64_t multi_spin_masks(std::vector<std::pair<int, uint64_t> >& masks);
+
+  // Flip the spin in all replicas
+  void execute();
+  // Flip the spin in the replicas given by the mask
+  void execute(uint64_t flip_mask);
+};
+
+// Class representing 64 replicas of a two-dimensional Ising model with periodic boundary conditions, one bit per spin and replica
+class MultiSpinIsingConfiguration2d
+{
+public:
+  // Number of replicas stored in one word
+  static const unsigned int replica_number = 64;
+
+  // System sizes
+  unsigned int size_x;
+  unsigned int size_y;
+
+  // Bit r of the word of a site is set if the spin of replica r points down
+  std::vector<uint64_t> spins;
+
+  // Default constructor, needed for serialization
+  MultiSpinIsingConfiguration2d() : size_x(0), size_y(0) { }
+  // Create 64 replicas of an Ising model with all spins pointing up
+  MultiSpinIsingConfiguration2d(unsigned int length_x, unsigned int length_y) : size_x(length_x), size_y(length_y), spins(length_x * length_y, 0) { }
+
+  // Indices of the neighbours of a site
+  unsigned int neighbour_x_lower(unsigned int index) const { return (index < size_y ? index + (size_x - 1) * size_y : index - size_y); }
+  unsigned int neighbour_x_upper(unsigned int index) const { return (index >= (size_x - 1) * size_y ? index - (size_x - 1) * size_y : index + size_y); }
+  unsigned int neighbour_y_lower(unsigned int index) const { return (index % size_y == 0 ? index + size_y - 1 : index - 1); }
+  unsigned int neighbour_y_upper(unsigned int index) const { return (index % size_y == size_y - 1 ? index + 1 - size_y : index + 1); }
+
+  // Apply a given flip to all replicas
+  void commit(const MultiSpinIsingStep2d& step) { spins[step.flip_index] = ~spins[step.flip_index]; }
+  // Apply a given flip to the replicas given by the mask
+  void commit(const MultiSpinIsingStep2d& step, uint64_t flip_mask) { spins[step.flip_index] ^= flip_mask; }
+
+  // Calculate the energies of all replicas, the energy is the negative sum over products of nearest neighbour spins
+  std::vector<int> replica_energies() const
+  {
+    // Count the anti-parallel bonds of every replica
+    std::vector<int> antiparallel_bonds(replica_number, 0);
+    for (unsigned int i = 0; i < spins.size(); ++i)
+    {
+      const uint64_t bonds_x = spins[i] ^ spins[neighbour_x_upper(i)];
+      const uint64_t bonds_y = spins[i] ^ spins[neighbour_y_upper(i)];
+      for (unsigned int r = 0; r < replica_number; ++r)
+	antiparallel_bonds[r] += ((bonds_x >> r) & 1) + ((bonds_y >> r) & 1);
+    }
+
+    std::vector<int> result(replica_number);
+    for (unsigned int r = 0; r < replica_number; ++r)
+      result[r] = 2 * antiparallel_bonds[r] - 2 * static_cast<int>(spins.size());
+    return result;
+  }
+  // Calculate the sum of the energies of all replicas
+  int energy()
+  {
+    std::vector<int> energies = replica_energies();
+    int result = 0;
+    for (unsigned int r = 0; r < replica_number; ++r)
+      result += energies[r];
+    return result;
+  }
+
+  // Create a step (spin flip in all replicas) using a given random number generator
+  template <class RandomNumberGenerator>
+  MultiSpinIsingStep2d propose_step(RandomNumberGenerator* rng) { return MultiSpinIsingStep2d(this, rng->random_int32(0, spins.size() - 1)); }
+};
+
+// Observator measuring the energies of all replicas
+struct ObserveReplicaEnergies
+{
+  typedef Mocasinns::Observables::VectorObservable<double> observable_type;
+  static observable_type observe(MultiSpinIsingConfiguration2d* config)
+  {
+    std::vector<int> energies = config->replica_energies();
+    return observable_type(energies.begin(), energies.end());
+  }
+};
+
+// Count the set bits of a word
+inline int bit_count(uint64_t word)
+{
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+}
+
+int MultiSpinIsingStep2d::delta_E()
+{
+  // Flipping a spin with k anti-parallel neighbours changes the energy by 8 - 4k
+  const uint64_t spin = configuration->spins[flip_index];
+  const int antiparallel_neighbours = bit_count(spin ^ configuration->spins[configuration->neighbour_x_lower(flip_index)])
+    + bit_count(spin ^ configuration->spins[configuration->neighbour_x_upper(flip_index)])
+    + bit_count(spin ^ configuration->spins[configuration->neighbour_y_lower(flip_index)])
+    + bit_count(spin ^ configuration->spins[configuration->neighbour_y_upper(flip_index)]);
+  return 8 * static_cast<int>(MultiSpinIsingConfiguration2d::replica_number) - 4 * antiparallel_neighbours;
+}
+
+uint64_t MultiSpinIsingStep2d::multi_spin_masks(std::vector<std::pair<int, uint64_t> >& masks)
+{
+  // Bits of the anti-parallel neighbours
+  const uint64_t spin = configuration->spins[flip_index];
+  const uint64_t a1 = spin ^ configuration->spins[configuration->neighbour_x_lower(flip_index)];
+  const uint64_t a2 = spin ^ configuration->spins[configuration->neighbour_x_upper(flip_index)];
+  const uint64_t a3 = spin ^ configuration->spins[configuration->neighbour_y_lower(flip_index)];
+  const uint64_t a4 = spin ^ configuration->spins[configuration->neighbour_y_upper(flip_index)];
+
+  // Replicas with at least one and at least two anti-parallel neighbours
+  const uint64_t at_least_one = a1 | a2 | a3 | a4;
+  const uint64_t at_least_two = (a1 & a2) | (a3 & a4) | ((a1 | a2) & (a3 | a4));
+
+  masks.push_back(std::make_pair(4, at_least_one & ~at_least_two));
+  masks.push_back(std::make_pair(8, ~at_least_one));
+  return at_least_two;
+}
+
+void MultiSpinIsingStep2d::execute() { configuration->commit(*this); }
+void MultiSpinIsingStep2d::execute(uint64_t flip_mask) { configuration->commit(*this, flip_mask); }
+
+#endif
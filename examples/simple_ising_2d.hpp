@@ -2,6 +2,7 @@
 #define SIMPLE_ISING_2D_HPP
 
 #include <vector>
+#include <cstddef>
 
 class IsingConfiguration2d;
 
@@ -23,6 +24,9 @@ public:
 
   // Execute the flip
   void execute();
+
+  // Append the indices of the flipped spin and its neighbours (used if the speculative evaluation of the Metropolis algorithm is enabled)
+  void footprint(std::vector<std::size_t>& sites);
 };
 
 // Class representing a one-dimensiona chain of ising spins
@@ -85,6 +89,47 @@ public:
   // Create a step (spin flip) using a given random number generator
   template <class RandomNumberGenerator>
   IsingStep2d propose_step(RandomNumberGenerator* rng) { return IsingStep2d(this, rng->random_int32(0, size_x - 1), rng->random_int32(0, size_y - 1)); }
+
+  // Number of steps in a sweep over all spins (used if the sequential sweep of the Metropolis algorithm is enabled)
+  std::size_t sweep_length() { return size_x * size_y; }
+  // Create the step at a given position of the sweep, the spins are visited in typewriter order (y index runs fastest)
+  template <class RandomNumberGenerator>
+  IsingStep2d propose_sweep_step(std::size_t position, RandomNumberGenerator*) { return IsingStep2d(this, position / size_y, position % size_y); }
+
+  // Number of sublattices of the checkerboard decomposition (used if sublattice threads of the Metropolis algorithm are enabled), requires even system sizes
+  std::size_t color_number() { return 2; }
+  // Number of spins of a sublattice of the checkerboard decomposition
+  std::size_t color_size(std::size_t) { return size_x * size_y / 2; }
+  // Create the step at a given position of a sublattice, spins of the same color are no nearest neighbours
+  template <class RandomNumberGenerator>
+  IsingStep2d propose_color_step(std::size_t color, std::size_t position, RandomNumberGenerator*)
+  {
+    unsigned int index_x = position / (size_y / 2);
+    unsigned int index_y = 2 * (position % (size_y / 2)) + (index_x + color) % 2;
+    return IsingStep2d(this, index_x, index_y);
+  }
+
+  // Number of sites (used by the cluster algorithms), the sites are numbered in typewriter order (y index runs fastest)
+  std::size_t site_number() { return size_x * size_y; }
+  // Number of nearest neighbours of a site
+  std::size_t neighbour_number(std::size_t) { return 4; }
+  // Index of the n-th nearest neighbour of a site
+  std::size_t neighbour(std::size_t site, std::size_t n)
+  {
+    const std::size_t index_x = site / size_y;
+    const std::size_t index_y = site % size_y;
+    switch (n)
+    {
+    case 0: return (index_x == 0 ? size_x - 1 : index_x - 1) * size_y + index_y;
+    case 1: return (index_x == size_x - 1 ? 0 : index_x + 1) * size_y + index_y;
+    case 2: return index_x * size_y + (index_y == 0 ? size_y - 1 : index_y - 1);
+    default: return index_x * size_y + (index_y == size_y - 1 ? 0 : index_y + 1);
+    }
+  }
+  // Energy by which the bond between two neighbours rises if only the first spin is flipped (the external field is not taken into account by the cluster algorithms)
+  int bond_energy(std::size_t site, std::size_t neighbour) { return 2 * spins[site / size_y][site % size_y] * spins[neighbour / size_y][neighbour % size_y]; }
+  // Flip the spin of a site
+  void flip_site(std::size_t site) { spins[site / size_y][site % size_y] *= -1; }
 };
   
 int IsingStep2d::delta_E()
@@ -104,4 +149,18 @@ int IsingStep2d::delta_E()
 
 void IsingStep2d::execute() { configuration->commit(*this); }
 
+void IsingStep2d::footprint(std::vector<std::size_t>& sites)
+{
+  unsigned int neighbour_x_lower = (flip_index_x == 0 ? configuration->size_x - 1 : flip_index_x - 1);
+  unsigned int neighbour_x_upper = (flip_index_x == configuration->size_x - 1 ? 0 : flip_index_x + 1);
+  unsigned int neighbour_y_lower = (flip_index_y == 0 ? configuration->size_y - 1 : flip_index_y - 1);
+  unsigned int neighbour_y_upper = (flip_index_y == configuration->size_y - 1 ? 0 : flip_index_y + 1);
+
+  sites.push_back(flip_index_x * configuration->size_y + flip_index_y);
+  sites.push_back(flip_index_x * configuration->size_y + neighbour_y_lower);
+  sites.push_back(flip_index_x * configuration->size_y + neighbour_y_upper);
+  sites.push_back(neighbour_x_lower * configuration->size_y + flip_index_y);
+  sites.push_back(neighbour_x_upper * configuration->size_y + flip_index_y);
+}
+
 #endif
@@ -0,0 +1,64 @@
+// Example program comparing Swendsen-Wang simulations of a 2d Ising model using several threads with Wolff simulations. Compile using
+// g++ -std=c++11 -O2 -I../include swendsen_wang.cpp -lboost_serialization -fopenmp -o swendsen_wang
+
+#include <iostream>
+#include <chrono>
+#include "simple_ising_2d.hpp"
+
+#include <mocasinns/wolff.hpp>
+#include <mocasinns/swendsen_wang.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+typedef Mocasinns::SwendsenWang<IsingConfiguration2d, Mocasinns::Random::Boost_MT19937> SwendsenWangSimulation;
+typedef Mocasinns::Wolff<IsingConfiguration2d, Mocasinns::Random::Boost_MT19937> WolffSimulation;
+
+// Print the mean energy per spin and the time needed per measurement
+void print_result(const char* name, const std::vector<int>& energies, unsigned int size, double seconds)
+{
+  double mean = 0.0;
+  for (unsigned int m = 0; m < energies.size(); ++m) mean += energies[m];
+  mean /= static_cast<double>(energies.size()) * size * size;
+
+  std::cout << name << "\t" << mean << "\t" << seconds / energies.size() << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  // Check and read command line arguments
+  if (argc != 5)
+  {
+    std::cerr << "ERROR: Use four command line parameters: size, inverse temperature, number of measurements and number of threads" << std::endl;
+    return 1;
+  }
+  unsigned int size = atoi(argv[1]);
+  double beta = atof(argv[2]);
+  unsigned int measurements = atoi(argv[3]);
+  unsigned int threads = atoi(argv[4]);
+
+  std::cout << "mode\t\tenergy per spin\tseconds per measurement" << std::endl;
+
+  // Swendsen-Wang simulation, one measurement after every decomposition into clusters
+  SwendsenWangSimulation::Parameters swendsen_wang_parameters;
+  swendsen_wang_parameters.relaxation_steps = 100;
+  swendsen_wang_parameters.measurement_number = measurements;
+  swendsen_wang_parameters.steps_between_measurement = 1;
+  swendsen_wang_parameters.thread_number = threads;
+  IsingConfiguration2d swendsen_wang_configuration(size, size);
+  SwendsenWangSimulation swendsen_wang_simulation(swendsen_wang_parameters, &swendsen_wang_configuration);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<int> swendsen_wang_energies = swendsen_wang_simulation.do_swendsen_wang_simulation(beta);
+  print_result("swendsen-wang", swendsen_wang_energies, size, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+  // Wolff simulation with the same number of measurements, one measurement after as many clusters as needed to flip about one sweep of spins
+  WolffSimulation::Parameters wolff_parameters;
+  wolff_parameters.relaxation_steps = 1000;
+  wolff_parameters.measurement_number = measurements;
+  wolff_parameters.steps_between_measurement = 10;
+  IsingConfiguration2d wolff_configuration(size, size);
+  WolffSimulation wolff_simulation(wolff_parameters, &wolff_configuration);
+
+  start = std::chrono::steady_clock::now();
+  std::vector<int> wolff_energies = wolff_simulation.do_wolff_simulation(beta);
+  print_result("wolff        ", wolff_energies, size, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
@@ -0,0 +1,75 @@
+// Example program comparing the autocorrelation time of the energy of a 2d Ising model in Wolff and Metropolis simulations. Compile using
+// g++ -std=c++11 -O2 -I../include wolff.cpp -lboost_serialization -o wolff
+
+#include <iostream>
+#include <chrono>
+#include "simple_ising_2d.hpp"
+
+#include <mocasinns/metropolis.hpp>
+#include <mocasinns/wolff.hpp>
+#include <mocasinns/random/boost_random.hpp>
+#include <mocasinns/analysis/autocorrelation.hpp>
+
+typedef Mocasinns::Wolff<IsingConfiguration2d, Mocasinns::Random::Boost_MT19937> WolffSimulation;
+typedef Mocasinns::Metropolis<IsingConfiguration2d, IsingStep2d, Mocasinns::Random::Boost_MT19937> MetropolisSimulation;
+
+// Estimate the integrated autocorrelation time of a time series by summing the autocorrelation function up to its first negative value
+double integrated_autocorrelation_time(const std::vector<double>& series)
+{
+  std::vector<double> autocorrelation = Mocasinns::Analysis::Autocorrelation<double>::autocorrelation_function(series.begin(), series.end());
+  double result = 0.5;
+  for (unsigned int t = 1; t < autocorrelation.size() / 2 && autocorrelation[t] > 0; ++t)
+    result += autocorrelation[t];
+  return result;
+}
+
+// Print the mean energy per spin, the autocorrelation time in measurements and the time needed per measurement
+void print_result(const char* name, const std::vector<int>& energies, unsigned int size, double seconds)
+{
+  std::vector<double> series(energies.begin(), energies.end());
+  double mean = 0.0;
+  for (unsigned int m = 0; m < series.size(); ++m) mean += series[m];
+  mean /= static_cast<double>(series.size()) * size * size;
+
+  std::cout << name << "\t" << mean << "\t" << integrated_autocorrelation_time(series) << "\t" << seconds / series.size() << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  // Check and read command line arguments
+  if (argc != 4)
+  {
+    std::cerr << "ERROR: Use three command line parameters: size, inverse temperature and number of measurements" << std::endl;
+    return 1;
+  }
+  unsigned int size = atoi(argv[1]);
+  double beta = atof(argv[2]);
+  unsigned int measurements = atoi(argv[3]);
+
+  std::cout << "mode\t\tenergy per spin\tautocorrelation time\tseconds per measurement" << std::endl;
+
+  // Wolff simulation, one measurement after as many clusters as needed to flip about one sweep of spins at the critical temperature
+  WolffSimulation::Parameters wolff_parameters;
+  wolff_parameters.relaxation_steps = 1000;
+  wolff_parameters.measurement_number = measurements;
+  wolff_parameters.steps_between_measurement = 1;
+  IsingConfiguration2d wolff_configuration(size, size);
+  WolffSimulation wolff_simulation(wolff_parameters, &wolff_configuration);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<int> wolff_energies = wolff_simulation.do_wolff_simulation(beta);
+  print_result("wolff     ", wolff_energies, size, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+  // Metropolis simulation with one sweep between two measurements
+  MetropolisSimulation::Parameters metropolis_parameters;
+  metropolis_parameters.relaxation_steps = 1000*size*size;
+  metropolis_parameters.measurement_number = measurements;
+  metropolis_parameters.steps_between_measurement = size*size;
+  metropolis_parameters.sequential_sweep = true;
+  IsingConfiguration2d metropolis_configuration(size, size);
+  MetropolisSimulation metropolis_simulation(metropolis_parameters, &metropolis_configuration);
+
+  start = std::chrono::steady_clock::now();
+  std::vector<int> metropolis_energies = metropolis_simulation.do_metropolis_simulation(beta);
+  print_result("metropolis", metropolis_energies, size, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
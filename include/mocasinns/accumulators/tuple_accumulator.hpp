@@ -0,0 +1,80 @@
+#ifndef MOCASINNS_ACCUMULATORS_TUPLE_ACCUMULATOR_HPP
+#define MOCASINNS_ACCUMULATORS_TUPLE_ACCUMULATOR_HPP
+
+#include <tuple>
+
+#include "../observables/fused_observator.hpp"
+#include "../details/stl_extensions/tuple_components.hpp"
+
+namespace Mocasinns
+{
+  namespace Accumulators
+  {
+    //! Binding of an accumulator to the tag of the observable it accumulates, used as template parameter of TupleAccumulator
+    template <class Tag, class Accumulator>
+    struct Accumulate
+    {
+      //! Tag of the accumulated observable
+      typedef Tag tag;
+      //! Type of the accumulator
+      typedef Accumulator accumulator_type;
+    };
+
+    //! Class template accumulating the observables measured by a fused pass, each in its own accumulator
+    /*!
+      \details The template parameters bind an accumulator to every observable that should be measured, e.g.
+      \code
+      typedef Accumulators::TupleAccumulator<Accumulators::Accumulate<Energy, EnergyAccumulator>,
+					     Accumulators::Accumulate<Magnetization, MagnetizationAccumulator> > Accumulator;
+      Accumulator accumulator;
+      simulation.do_metropolis_simulation<Accumulator::observator<IsingPass> >(beta, accumulator);
+      accumulator.get<Energy>();
+      \endcode
+      The observator TupleAccumulator::observator measures exactly the observables that are accumulated, all other observables of the fused pass are not computed (see Observables::FusedObservator).
+
+      \tparam Bindings Accumulate<Tag, Accumulator> for every accumulated observable
+    */
+    template <class... Bindings>
+    class TupleAccumulator
+    {
+    public:
+      //! Fused observator measuring the accumulated observables with the given fused pass
+      template <class FusedPass>
+      using observator = Observables::FusedObservator<FusedPass, typename Bindings::tag...>;
+      //! Type of the accumulated observables
+      typedef Observables::TupleObservable<typename Bindings::tag::observable_type...> observable_type;
+      //! STL-Tuple of the accumulators
+      typedef std::tuple<typename Bindings::accumulator_type...> accumulators_type;
+
+      //! Default constructor, default-constructs all accumulators
+      TupleAccumulator() : accumulators() {}
+      //! Constructor copying the given accumulators
+      explicit TupleAccumulator(const typename Bindings::accumulator_type&... initial_accumulators) : accumulators(initial_accumulators...) {}
+
+      //! Accumulating operator, passes every observable to its accumulator
+      void operator()(const observable_type& observables)
+      {
+	Details::STL_Extensions::TupleComponents<0, sizeof...(Bindings)>::dispatch(accumulators, observables.tuple());
+      }
+
+      //! Get-accessor for the accumulator of the observable with the given tag
+      template <class Tag>
+      typename std::tuple_element<Observables::FusedDetails::index_of<Tag, typename Bindings::tag...>::value, accumulators_type>::type& get()
+      {
+	return std::get<Observables::FusedDetails::index_of<Tag, typename Bindings::tag...>::value>(accumulators);
+      }
+      //! Const get-accessor for the accumulator of the observable with the given tag
+      template <class Tag>
+      const typename std::tuple_element<Observables::FusedDetails::index_of<Tag, typename Bindings::tag...>::value, accumulators_type>::type& get() const
+      {
+	return std::get<Observables::FusedDetails::index_of<Tag, typename Bindings::tag...>::value>(accumulators);
+      }
+
+    private:
+      //! Accumulators of the observables
+      accumulators_type accumulators;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef MOCASINNS_CONCEPTS_CLUSTER_CONFIGURATION_CONCEPT_HPP
+#define MOCASINNS_CONCEPTS_CLUSTER_CONFIGURATION_CONCEPT_HPP
+
+/*!
+  \file cluster_configuration_concept.hpp
+
+  \author Benedikt Krüger
+*/
+
+#include <cstddef>
+
+#include <boost/concept_check.hpp>
+
+namespace Mocasinns
+{
+  namespace Concepts
+  {
+
+    /*!
+      \brief Structure for checking a class for compatibility with the concept of a configuration used by the cluster algorithms of the mocasinns library.
+      \tparam ClusterConfigurationType Class or type that should be checked for compatibility with the cluster configuration concept.
+    */
+    template <class ClusterConfigurationType>
+    struct ClusterConfigurationConcept
+    {
+    public:
+      BOOST_CONCEPT_USAGE(ClusterConfigurationConcept)
+      {
+	// There must be a function returning the number of sites
+	site_number = configuration.site_number();
+
+	// There must be functions returning the number and the indices of the neighbours of a site
+	site_number = configuration.neighbour_number(site);
+	site = configuration.neighbour(site, site);
+
+	// There must be a function returning the energy of the bond between two neighbouring sites
+	configuration.bond_energy(site, site);
+
+	// There must be a function flipping a site
+	configuration.flip_site(site);
+      }
+
+    private:
+      ClusterConfigurationType configuration;
+      std::size_t site;
+      std::size_t site_number;
+    };
+  }
+}
+
+#endif
@@ -7,6 +7,8 @@
 */
 
 #include "configuration_concept.hpp"
+#include "cluster_configuration_concept.hpp"
+#include "kinetic_step_concept.hpp"
 #include "step_concept.hpp"
 #include "energy_concept.hpp"
 #include "histo_concept.hpp"
@@ -0,0 +1,41 @@
+#ifndef MOCASINNS_CONCEPTS_KINETIC_STEP_CONCEPT_HPP
+#define MOCASINNS_CONCEPTS_KINETIC_STEP_CONCEPT_HPP
+
+/*!
+  \file kinetic_step_concept.hpp
+
+  \author Benedikt Krüger
+*/
+
+#include <boost/concept_check.hpp>
+
+namespace Mocasinns
+{
+  namespace Concepts
+  {
+
+    /*!
+      \brief Structure for checking a class for compatibility with the concept of a step (event) used by the kinetic Monte-Carlo simulation of the mocasinns library.
+      \tparam KineticStepType Class or type that should be checked for compatibility with the kinetic step concept.
+    */
+    template <class KineticStepType>
+    struct KineticStepConcept
+    {
+    public:
+      BOOST_CONCEPT_USAGE(KineticStepConcept)
+      {
+	// There must be a function returning the physical rate of the step
+	rate = step.rate();
+
+	// There must be a function execute
+	step.execute();
+      }
+
+    private:
+      KineticStepType step;
+      double rate;
+    };
+  }
+}
+
+#endif
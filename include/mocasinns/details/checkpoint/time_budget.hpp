@@ -0,0 +1,117 @@
+/*!
+  \file time_budget.hpp
+
+  \brief Wall-clock time budget of a simulation, predicts from the durations of the finished chunks whether the next chunk ends before the deadline
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_CHECKPOINT_TIME_BUDGET_HPP
+#define MOCASINNS_DETAILS_CHECKPOINT_TIME_BUDGET_HPP
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Checkpoint
+    {
+      //! Wall-clock time budget with running statistics of the durations of the chunks of a simulation
+      /*!
+	\details A chunk is the work a simulation does between two checks for POSIX signals (usually the steps of one measurement or one sweep). The mean and the variance of the chunk durations are updated with Welford's algorithm, the duration of the next chunk is estimated as the mean plus three standard deviations. The next chunk fits into the budget if the remaining time exceeds the estimated chunk duration times the safety factor plus the duration of the last written checkpoint.
+      */
+      class TimeBudget
+      {
+      public:
+	//! Clock used for all time measurements, not affected by changes of the system time
+	typedef std::chrono::steady_clock clock_type;
+
+	//! Default constructor, no time budget is set
+	TimeBudget() : active(false), safety_factor(2.0), checkpoint_seconds(0.0) { reset_chunks(); }
+
+	//! Set the budget to the given number of seconds counted from now, a non-positive number disables the budget
+	void set(double seconds)
+	{
+	  active = (seconds > 0.0);
+	  deadline = clock_type::now() + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(seconds));
+	}
+	//! Whether a time budget is set
+	bool is_active() const { return active; }
+	//! Remaining time until the deadline in seconds, infinity if no budget is set
+	double remaining_seconds() const
+	{
+	  if (!active) return std::numeric_limits<double>::infinity();
+	  return std::chrono::duration<double>(deadline - clock_type::now()).count();
+	}
+
+	//! Get-Accessor for the factor by which the estimated duration of the next chunk is multiplied
+	double get_safety_factor() const { return safety_factor; }
+	//! Set-Accessor for the factor by which the estimated duration of the next chunk is multiplied
+	void set_safety_factor(double value) { safety_factor = value; }
+
+	//! Forget the durations of the previous chunks and start timing the first chunk now
+	void reset_chunks()
+	{
+	  chunk_number = 0;
+	  chunk_mean = 0.0;
+	  chunk_square_deviations = 0.0;
+	  chunk_start = clock_type::now();
+	}
+	//! Record the duration of the chunk that ends now and start timing the next one
+	void end_chunk()
+	{
+	  const clock_type::time_point now = clock_type::now();
+	  const double duration = std::chrono::duration<double>(now - chunk_start).count();
+	  chunk_start = now;
+
+	  ++chunk_number;
+	  const double delta = duration - chunk_mean;
+	  chunk_mean += delta / chunk_number;
+	  chunk_square_deviations += delta * (duration - chunk_mean);
+	}
+	//! Number of chunks recorded since the last reset
+	unsigned long get_chunk_number() const { return chunk_number; }
+	//! Estimated duration of the next chunk in seconds (mean plus three standard deviations of the recorded chunks)
+	double estimated_chunk_seconds() const
+	{
+	  if (chunk_number < 2) return chunk_mean;
+	  return chunk_mean + 3.0*std::sqrt(chunk_square_deviations / (chunk_number - 1));
+	}
+
+	//! Record the number of seconds that writing a checkpoint took
+	void set_checkpoint_seconds(double value) { checkpoint_seconds = value; }
+
+	//! Whether the next chunk and a checkpoint written afterwards are expected to end before the deadline
+	bool next_chunk_fits() const
+	{
+	  if (!active) return true;
+	  return remaining_seconds() > safety_factor*estimated_chunk_seconds() + checkpoint_seconds;
+	}
+
+      private:
+	//! Flag whether a time budget is set
+	bool active;
+	//! Deadline of the time budget
+	clock_type::time_point deadline;
+	//! Factor by which the estimated duration of the next chunk is multiplied
+	double safety_factor;
+	//! Duration of the last written checkpoint in seconds
+	double checkpoint_seconds;
+
+	//! Start of the current chunk
+	clock_type::time_point chunk_start;
+	//! Number of recorded chunks
+	unsigned long chunk_number;
+	//! Mean duration of the recorded chunks in seconds
+	double chunk_mean;
+	//! Sum of the squared deviations of the chunk durations from their mean
+	double chunk_square_deviations;
+      };
+    }
+  }
+}
+
+#endif
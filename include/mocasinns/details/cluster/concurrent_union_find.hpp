@@ -0,0 +1,84 @@
+/*!
+  \file concurrent_union_find.hpp
+
+  \brief File containing a lock-free union-find structure for labelling clusters with several threads
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_CLUSTER_CONCURRENT_UNION_FIND_HPP
+#define MOCASINNS_DETAILS_CLUSTER_CONCURRENT_UNION_FIND_HPP
+
+#include <vector>
+#include <cstddef>
+#include <atomic>
+#include <utility>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Cluster
+    {
+      //! Union-find structure (disjoint-set forest) whose find and unite operations can be called concurrently by several threads without locks
+      /*!
+	\details The parent of every element is stored in an atomic word. A root is always linked to the root with the smaller index by a compare-and-swap operation that fails if the root got a parent in between, in this case the union is repeated with the new roots. Because links point only to smaller indices no cycles can occur, and the root of every set is its element with the smallest index, which does not depend on the order of the unions. The paths are halved during find with compare-and-swap operations as well.
+      */
+      class ConcurrentUnionFind
+      {
+      public:
+	//! Standard constructor, creates a structure without elements
+	ConcurrentUnionFind() : parents() {}
+
+	//! Get-accessor for the number of elements
+	std::size_t size() const { return parents.size(); }
+
+	//! Change the number of elements, the elements are not initialised (call make_set for every element afterwards)
+	void resize(std::size_t element_number)
+	{
+	  if (element_number != parents.size()) std::vector<std::atomic<std::size_t> >(element_number).swap(parents);
+	}
+
+	//! Make the given element a set of its own, may be called concurrently for different elements
+	void make_set(std::size_t element) { parents[element].store(element, std::memory_order_relaxed); }
+
+	//! Return the root of the set containing the given element
+	std::size_t find(std::size_t element)
+	{
+	  std::size_t parent = parents[element].load(std::memory_order_relaxed);
+	  while (parent != element)
+	  {
+	    // Path halving, failing to shorten the path is harmless
+	    std::size_t grandparent = parents[parent].load(std::memory_order_relaxed);
+	    if (grandparent != parent) parents[element].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+	    element = grandparent;
+	    parent = parents[element].load(std::memory_order_relaxed);
+	  }
+	  return element;
+	}
+
+	//! Unite the sets containing the two given elements
+	void unite(std::size_t element_1, std::size_t element_2)
+	{
+	  while (true)
+	  {
+	    std::size_t root_1 = find(element_1);
+	    std::size_t root_2 = find(element_2);
+	    if (root_1 == root_2) return;
+
+	    // Link the root with the larger index to the other one
+	    if (root_1 < root_2) std::swap(root_1, root_2);
+	    std::size_t expected_parent = root_1;
+	    if (parents[root_1].compare_exchange_strong(expected_parent, root_2, std::memory_order_acq_rel)) return;
+	  }
+	}
+
+      private:
+	//! Parents of the elements, roots are their own parents
+	std::vector<std::atomic<std::size_t> > parents;
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,81 @@
+/*!
+  \file boltzmann_table.hpp
+
+  \brief File containing a flat table of the Metropolis acceptance probabilities of a range of discrete energy differences
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_ENSEMBLE_BOLTZMANN_TABLE_HPP
+#define MOCASINNS_DETAILS_ENSEMBLE_BOLTZMANN_TABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Ensemble
+    {
+      //! Table of the Metropolis acceptance probabilities \f$ \min(1, \exp(-\beta \Delta E)) \f$ of all discrete energy differences in a contiguous range
+      /*!
+	\details In contrast to Details::Metropolis::AcceptanceTable, the table is not changed by a lookup. It is filled completely for a range of energy differences and an inverse temperature by cover(), which only recalculates the table if the range grows or the inverse temperature changes. Afterwards the lookups of all chains of an ensemble are plain indexed loads without branches, since the acceptance probability of non-positive energy differences is stored as 1.
+      */
+      class BoltzmannTable
+      {
+      public:
+	//! Standard constructor, creates an empty table
+	BoltzmannTable(std::size_t maximal_table_size = 1 << 16)
+	  : table(), table_offset(0), table_beta(0.0), maximal_size(maximal_table_size) {}
+
+	//! Fill the table for all energy differences in [minimal_delta_E, maximal_delta_E] at the given inverse temperature, returns false if the range exceeds the maximal size
+	bool cover(long minimal_delta_E, long maximal_delta_E, double beta)
+	{
+	  if (!table.empty() && beta == table_beta && minimal_delta_E >= table_offset && maximal_delta_E < table_offset + static_cast<long>(table.size()))
+	    return true;
+
+	  // Extend the range by the already tabulated energy differences, so the table does not oscillate between ranges
+	  if (!table.empty() && beta == table_beta)
+	  {
+	    minimal_delta_E = std::min(minimal_delta_E, table_offset);
+	    maximal_delta_E = std::max(maximal_delta_E, table_offset + static_cast<long>(table.size()) - 1);
+	  }
+	  if (static_cast<std::size_t>(maximal_delta_E - minimal_delta_E + 1) > maximal_size) return false;
+
+	  table.resize(static_cast<std::size_t>(maximal_delta_E - minimal_delta_E + 1));
+	  table_offset = minimal_delta_E;
+	  table_beta = beta;
+	  for (std::size_t i = 0; i < table.size(); ++i)
+	  {
+	    const long delta_E = table_offset + static_cast<long>(i);
+	    table[i] = (delta_E <= 0 ? 1.0 : exp(-beta * delta_E));
+	  }
+	  return true;
+	}
+
+	//! Acceptance probability of an energy difference within the covered range
+	double operator[](long delta_E) const { return table[delta_E - table_offset]; }
+
+	//! Get-accessor for the energy difference of the first entry of the table
+	long offset() const { return table_offset; }
+	//! Get-accessor for the acceptance probabilities, the first entry belongs to the energy difference offset()
+	const double* data() const { return &table[0]; }
+
+      private:
+	//! Acceptance probabilities of the covered energy differences
+	std::vector<double> table;
+	//! Energy difference corresponding to the first entry of the table
+	long table_offset;
+	//! Inverse temperature of the tabulated values
+	double table_beta;
+	//! Maximal number of entries of the table
+	std::size_t maximal_size;
+      };
+    }
+  }
+}
+
+#endif
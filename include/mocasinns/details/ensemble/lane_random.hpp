@@ -0,0 +1,111 @@
+/*!
+  \file lane_random.hpp
+
+  \brief File containing a random number generator with independent lanes for advancing an ensemble of chains in lockstep
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_ENSEMBLE_LANE_RANDOM_HPP
+#define MOCASINNS_DETAILS_ENSEMBLE_LANE_RANDOM_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Ensemble
+    {
+      //! Random number generator creating one random number for each of several lanes at once
+      /*!
+	\details Every lane is an independent xorshift128+ generator. The states of the lanes are stored in structure-of-arrays layout, so the loops filling the random numbers of all lanes contain only shifts, exclusive ors and additions and can be vectorised by the compiler. The lanes are seeded with random words of another random number generator, the upper bits of the generated words are used because the lowest bits of xorshift128+ are weaker.
+      */
+      class LaneRandom
+      {
+      public:
+	//! Standard constructor, creates a generator without lanes
+	LaneRandom() : state_0(), state_1() {}
+
+	//! Get-accessor for the number of lanes
+	std::size_t size() const { return state_0.size(); }
+
+	//! Create the given number of lanes and seed them using random integers of the given random number generator
+	template <class RandomNumberGenerator>
+	void seed(std::size_t lane_number, RandomNumberGenerator* rng)
+	{
+	  state_0.resize(lane_number);
+	  state_1.resize(lane_number);
+	  for (std::size_t k = 0; k < lane_number; ++k)
+	  {
+	    state_0[k] = seed_word(rng);
+	    state_1[k] = seed_word(rng);
+	    // The state must not vanish completely
+	    if (state_0[k] == 0 && state_1[k] == 0) state_1[k] = 1;
+	  }
+	}
+
+	//! Fill one uniformly distributed double in [0,1) for every lane into the given vector
+	void fill_uniform(std::vector<double>& result)
+	{
+	  result.resize(state_0.size());
+	  const std::size_t lane_number = state_0.size();
+	  for (std::size_t k = 0; k < lane_number; ++k)
+	    result[k] = static_cast<double>(next(k) >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	//! Fill one uniformly distributed integer in [0, bound) for every lane into the given vector
+	void fill_below(uint32_t bound, std::vector<uint32_t>& result)
+	{
+	  result.resize(state_0.size());
+	  const std::size_t lane_number = state_0.size();
+	  for (std::size_t k = 0; k < lane_number; ++k)
+	    result[k] = static_cast<uint32_t>(((next(k) >> 32) * bound) >> 32);
+	}
+
+      private:
+	//! First words of the states of the lanes
+	std::vector<uint64_t> state_0;
+	//! Second words of the states of the lanes
+	std::vector<uint64_t> state_1;
+
+	//! Member variable for boost serialization
+	friend class boost::serialization::access;
+	//! Method to serialize the states of the lanes (omitted version name to avoid unused parameter warnings)
+	template<class Archive> void serialize(Archive & ar, const unsigned int)
+	{
+	  ar & state_0;
+	  ar & state_1;
+	}
+
+	//! Advance the given lane and return its next random word
+	uint64_t next(std::size_t k)
+	{
+	  uint64_t s1 = state_0[k];
+	  const uint64_t s0 = state_1[k];
+	  state_0[k] = s0;
+	  s1 ^= s1 << 23;
+	  state_1[k] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+	  return state_1[k] + s0;
+	}
+
+	//! Compose a 64 bit seed word from 16 bit random integers of the given random number generator
+	template <class RandomNumberGenerator>
+	static uint64_t seed_word(RandomNumberGenerator* rng)
+	{
+	  uint64_t result = 0;
+	  for (unsigned int i = 0; i < 4; ++i)
+	    result = (result << 16) | static_cast<uint64_t>(rng->random_int32(0, 65535));
+	  return result;
+	}
+      };
+    }
+  }
+}
+
+#endif
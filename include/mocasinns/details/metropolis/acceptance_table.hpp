@@ -0,0 +1,130 @@
+/*!
+  \file acceptance_table.hpp
+
+  \brief File containing a lookup table for the Boltzmann acceptance probabilities of discrete energy differences
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_ACCEPTANCE_TABLE_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_ACCEPTANCE_TABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/utility/enable_if.hpp>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Trait deciding whether the acceptance probabilities of energy differences of type EnergyType are tabulated. Defaults to true for integral types, specialise it for own discrete energy types that are convertible to long.
+      template <class EnergyType>
+      struct use_acceptance_table : public boost::is_integral<EnergyType> {};
+
+      //! Class caching the Boltzmann factors \f$ \exp(-\beta \Delta E) \f$ for discrete energy differences at a fixed inverse temperature
+      /*!
+	\details The table is filled lazily with every new energy difference and is cleared whenever the inverse temperature changes.
+	Energy differences that would let the table grow beyond the maximal size are calculated directly.
+	For energy types for which use_acceptance_table is false the Boltzmann factor is always calculated directly.
+      */
+      class AcceptanceTable
+      {
+      public:
+	//! Standard constructor, creates an empty table
+	AcceptanceTable(std::size_t maximal_table_size = 4096)
+	  : table(), table_offset(0), table_beta(0.0), table_valid(false), maximal_size(maximal_table_size) {}
+
+	//! Returns the Boltzmann factor of the given energy difference at the given inverse temperature using the table
+	template <class EnergyType, class TemperatureType>
+	typename boost::enable_if_c<use_acceptance_table<EnergyType>::value, double>::type
+	operator()(const EnergyType& delta_E, const TemperatureType& beta)
+	{
+	  // Invalidate the table if the inverse temperature has changed
+	  if (!table_valid || static_cast<double>(beta) != table_beta) reset(static_cast<double>(beta));
+
+	  // Look up the table
+	  const long index = static_cast<long>(delta_E) - table_offset;
+	  if (index >= 0 && index < static_cast<long>(table.size()) && table[index] >= 0.0)
+	    return table[index];
+
+	  // Calculate the new value and store it if possible
+	  const double result = exp( -(beta * delta_E));
+	  if (make_room(static_cast<long>(delta_E)))
+	    table[static_cast<long>(delta_E) - table_offset] = result;
+	  return result;
+	}
+	//! Returns the Boltzmann factor of the given energy difference at the given inverse temperature without using the table
+	template <class EnergyType, class TemperatureType>
+	typename boost::enable_if_c<!use_acceptance_table<EnergyType>::value, double>::type
+	operator()(const EnergyType& delta_E, const TemperatureType& beta)
+	{
+	  return exp( -(beta * delta_E));
+	}
+
+	//! Remove all tabulated values
+	void clear() { table.clear(); table_valid = false; }
+
+	//! Get-accessor for the number of entries (including not yet calculated ones) of the table
+	std::size_t size() const { return table.size(); }
+	//! Get-accessor for the maximal number of entries of the table
+	std::size_t get_maximal_size() const { return maximal_size; }
+	//! Set-accessor for the maximal number of entries of the table
+	void set_maximal_size(std::size_t value) { maximal_size = value; clear(); }
+
+      private:
+	//! Tabulated Boltzmann factors, not calculated entries are marked by a negative value
+	std::vector<double> table;
+	//! Energy difference corresponding to the first entry of the table
+	long table_offset;
+	//! Inverse temperature of the tabulated values
+	double table_beta;
+	//! Flag indicating whether the table belongs to table_beta
+	bool table_valid;
+	//! Maximal number of entries of the table
+	std::size_t maximal_size;
+
+	//! Clear the table and assign a new inverse temperature
+	void reset(double beta)
+	{
+	  table.clear();
+	  table_beta = beta;
+	  table_valid = true;
+	}
+
+	//! Extend the table to contain the given energy difference, returns false if the maximal size would be exceeded
+	bool make_room(long delta_E)
+	{
+	  if (table.empty())
+	  {
+	    if (maximal_size == 0) return false;
+	    table.assign(1, -1.0);
+	    table_offset = delta_E;
+	    return true;
+	  }
+
+	  const long first = table_offset;
+	  const long last = table_offset + static_cast<long>(table.size()) - 1;
+	  if (delta_E < first)
+	  {
+	    if (static_cast<std::size_t>(last - delta_E + 1) > maximal_size) return false;
+	    table.insert(table.begin(), static_cast<std::size_t>(first - delta_E), -1.0);
+	    table_offset = delta_E;
+	  }
+	  else if (delta_E > last)
+	  {
+	    if (static_cast<std::size_t>(delta_E - first + 1) > maximal_size) return false;
+	    table.resize(static_cast<std::size_t>(delta_E - first + 1), -1.0);
+	  }
+	  return true;
+	}
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,167 @@
+/*!
+  \file autocorrelation_estimator.hpp
+
+  \brief Streaming estimate of the integrated autocorrelation time of a time series by a logarithmic binning analysis
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_AUTOCORRELATION_ESTIMATOR_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_AUTOCORRELATION_ESTIMATOR_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Estimates the integrated autocorrelation time of a time series online with a logarithmic binning analysis
+      /*!
+	\details The samples are averaged in bins of \f$ 2^l \f$ samples on every level l, a new bin of level l+1 is completed whenever two bins of level l are completed. Only the sums and the sums of squares of the bin means are stored, so adding a sample costs amortised \f$ O(1) \f$ and the memory grows logarithmically with the number of samples. For bins much longer than the autocorrelation time the bin means are independent and the integrated autocorrelation time (in units of samples) is
+	\f[
+	  \tau_{\mathrm{int}} = \frac{2^l \sigma_l^2}{2 \sigma_0^2}
+	\f]
+	with the variance \f$ \sigma_l^2 \f$ of the bin means of level l. The estimate uses the highest level with at least minimal_bin_number bins, it is available as soon as level 1 has this number of bins. The same levels give the binning estimate of the standard error of the mean, which is only reliable if the binning analysis has converged (see is_converged()). The samples are shifted by the first sample to avoid cancellations in the variances.
+
+	Energies that are not arithmetic types (e.g. vector energies) are ignored and no estimate becomes available.
+      */
+      class AutocorrelationEstimator
+      {
+      public:
+	//! Constructor taking the minimal number of bins of the level used for the estimate
+	explicit AutocorrelationEstimator(unsigned int minimal_bins = 64)
+	  : minimal_bin_number(minimal_bins > 1 ? minimal_bins : 2), shift(0.0) {}
+
+	//! Add a sample of an arithmetic type to the time series
+	template <class EnergyType>
+	typename boost::enable_if_c<boost::is_arithmetic<EnergyType>::value, void>::type
+	add(const EnergyType& energy) { add_sample(static_cast<double>(energy)); }
+	//! \cond
+	template <class EnergyType>
+	typename boost::enable_if_c<!boost::is_arithmetic<EnergyType>::value, void>::type
+	add(const EnergyType&) { }
+	//! \endcond
+
+	//! Whether enough samples were added for an estimate of the autocorrelation time
+	bool is_available() const { return (levels.size() > 1 && levels[1].count >= minimal_bin_number); }
+	//! Number of samples added to the time series
+	std::size_t get_sample_number() const { return levels.empty() ? 0 : levels[0].count; }
+
+	//! Estimate of the integrated autocorrelation time in units of samples, at least 1/2 (for a constant time series as well) and 0 if no estimate is available
+	double get_autocorrelation_time() const
+	{
+	  if (!is_available()) return 0.0;
+
+	  const double variance_0 = levels[0].variance();
+	  if (!(variance_0 > 0.0)) return 0.5;
+
+	  std::size_t l = levels.size() - 1;
+	  while (levels[l].count < minimal_bin_number) --l;
+	  const double tau = 0.5 * std::ldexp(levels[l].variance(), static_cast<int>(l)) / variance_0;
+	  return (tau > 0.5 ? tau : 0.5);
+	}
+
+	//! Whether the bins of the level used for the estimate are at least eight times longer than the autocorrelation time estimated from them, i.e. the binning analysis has reached its plateau
+	bool is_converged() const
+	{
+	  if (!is_available()) return false;
+	  std::size_t l = levels.size() - 1;
+	  while (levels[l].count < minimal_bin_number) --l;
+	  return (std::ldexp(1.0, static_cast<int>(l)) >= 8.0 * get_autocorrelation_time());
+	}
+
+	//! Estimate of the standard error of the mean of the samples, the largest binning error of the levels with at least minimal_bin_number bins (0 if no estimate is available)
+	double get_standard_error() const
+	{
+	  if (!is_available()) return 0.0;
+
+	  double result = 0.0;
+	  for (std::size_t l = 0; l < levels.size() && levels[l].count >= minimal_bin_number; ++l)
+	  {
+	    const double error = std::sqrt(levels[l].variance() / levels[l].count);
+	    if (error > result) result = error;
+	  }
+	  return result;
+	}
+
+	//! Remove all samples
+	void clear() { levels.clear(); shift = 0.0; }
+
+      private:
+	//! Sums of the bin means of one binning level
+	struct Level
+	{
+	  Level() : count(0), sum(0.0), square_sum(0.0), pending(0.0), has_pending(false) {}
+
+	  //! Number of completed bins
+	  std::size_t count;
+	  //! Sum of the bin means
+	  double sum;
+	  //! Sum of the squares of the bin means
+	  double square_sum;
+	  //! Mean of the last bin if it is not yet paired with a following bin
+	  double pending;
+	  //! Whether the last bin waits for a following bin
+	  bool has_pending;
+
+	  //! Sample variance of the bin means
+	  double variance() const { return (count > 1) ? (square_sum - sum*sum/count) / (count - 1) : 0.0; }
+
+	  template<class Archive> void serialize(Archive & ar, const unsigned int)
+	  {
+	    ar & count; ar & sum; ar & square_sum; ar & pending; ar & has_pending;
+	  }
+	};
+
+	//! Minimal number of bins of the level used for the estimate
+	unsigned int minimal_bin_number;
+	//! Value substracted from all samples
+	double shift;
+	//! Binning levels, level l contains the means of bins of 2^l samples
+	std::vector<Level> levels;
+
+	//! Add the sample to level 0 and propagate the completed pairs of bins to the higher levels
+	void add_sample(double sample)
+	{
+	  if (levels.empty()) shift = sample;
+	  double mean = sample - shift;
+	  for (std::size_t l = 0; ; ++l)
+	  {
+	    if (l == levels.size()) levels.push_back(Level());
+	    Level& level = levels[l];
+	    level.count++;
+	    level.sum += mean;
+	    level.square_sum += mean*mean;
+	    if (!level.has_pending)
+	    {
+	      level.pending = mean;
+	      level.has_pending = true;
+	      return;
+	    }
+	    mean = 0.5*(level.pending + mean);
+	    level.has_pending = false;
+	  }
+	}
+
+	friend class boost::serialization::access;
+	template<class Archive> void serialize(Archive & ar, const unsigned int)
+	{
+	  ar & minimal_bin_number;
+	  ar & shift;
+	  ar & levels;
+	}
+      };
+    }
+  }
+}
+
+#endif
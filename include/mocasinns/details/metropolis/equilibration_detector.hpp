@@ -0,0 +1,120 @@
+/*!
+  \file equilibration_detector.hpp
+
+  \brief Streaming detection of the end of the relaxation from the energy time series with the MSER-m rule
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_EQUILIBRATION_DETECTOR_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_EQUILIBRATION_DETECTOR_HPP
+
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Detects with the marginal standard error rule (MSER-m) whether a time series of energies has become stationary
+      /*!
+	\details The samples are averaged in batches of batch_size samples (MSER-5 for the default batch size). For the k batch means \f$ y_i \f$ the MSER statistic of a truncation point d is
+	\f[
+	  \mathrm{MSER}(d) = \frac{1}{(k - d)^2} \sum_{i = d}^{k-1} (y_i - \overline{y}_d)^2
+	\f]
+	where \f$ \overline{y}_d \f$ is the mean of the batches from d on. The optimal truncation point \f$ d^* \f$ minimises MSER(d) for \f$ 0 \leq d \leq k/2 \f$. As long as the series drifts, the truncation point stays at the end of the admissible range. The series is stationary when at least minimal_batch_number batches were recorded and \f$ d^* \f$ lies in the first quarter of the batches, i.e. the second half of the series has been stationary for at least as long as the discarded part. The statistic is evaluated with suffix sums in \f$ O(k) \f$ after every completed batch. The samples are shifted by the first sample to avoid cancellations in the suffix sums.
+
+	Energies that are not arithmetic types (e.g. vector energies) are ignored, the series never becomes stationary and the relaxation uses the maximal number of steps.
+      */
+      class EquilibrationDetector
+      {
+      public:
+	//! Constructor taking the number of samples per batch and the minimal number of batches before the series can be stationary
+	explicit EquilibrationDetector(unsigned int samples_per_batch = 5, unsigned int minimal_batches = 16)
+	  : batch_size(samples_per_batch > 0 ? samples_per_batch : 1), minimal_batch_number(minimal_batches),
+	    shift(0.0), batch_sum(0.0), batch_fill(0), stationary(false), truncation_batch(0) {}
+
+	//! Add an energy sample of an arithmetic type to the time series
+	template <class EnergyType>
+	typename boost::enable_if_c<boost::is_arithmetic<EnergyType>::value, void>::type
+	add(const EnergyType& energy) { add_sample(static_cast<double>(energy)); }
+	//! \cond
+	template <class EnergyType>
+	typename boost::enable_if_c<!boost::is_arithmetic<EnergyType>::value, void>::type
+	add(const EnergyType&) { }
+	//! \endcond
+
+	//! Whether the time series was stationary at the last completed batch
+	bool is_stationary() const { return stationary; }
+	//! Number of samples before the optimal truncation point at the last completed batch
+	std::size_t get_truncation_samples() const { return truncation_batch * batch_size; }
+	//! Number of completed batches
+	std::size_t get_batch_number() const { return batch_means.size(); }
+
+      private:
+	//! Number of samples averaged in one batch
+	unsigned int batch_size;
+	//! Minimal number of batches before the series can be stationary
+	unsigned int minimal_batch_number;
+	//! First sample, which is subtracted from all samples
+	double shift;
+	//! Means of the completed batches (shifted by the first sample)
+	std::vector<double> batch_means;
+	//! Sum of the samples of the current batch
+	double batch_sum;
+	//! Number of samples in the current batch
+	unsigned int batch_fill;
+	//! Result of the last evaluation
+	bool stationary;
+	//! Optimal truncation point (in batches) of the last evaluation
+	std::size_t truncation_batch;
+
+	//! Add a sample to the current batch and evaluate the MSER statistic if the batch is complete
+	void add_sample(double sample)
+	{
+	  if (batch_means.empty() && batch_fill == 0) shift = sample;
+	  batch_sum += sample - shift;
+	  if (++batch_fill < batch_size) return;
+
+	  batch_means.push_back(batch_sum / batch_size);
+	  batch_sum = 0.0;
+	  batch_fill = 0;
+	  evaluate();
+	}
+
+	//! Determine the optimal truncation point by walking the batches backwards and accumulating the suffix sums
+	void evaluate()
+	{
+	  const std::size_t k = batch_means.size();
+	  double suffix_sum = 0.0;
+	  double suffix_square_sum = 0.0;
+	  double minimal_mser = std::numeric_limits<double>::infinity();
+	  for (std::size_t d = k; d-- > 0; )
+	  {
+	    suffix_sum += batch_means[d];
+	    suffix_square_sum += batch_means[d] * batch_means[d];
+	    if (2*d > k) continue;
+
+	    const double n = static_cast<double>(k - d);
+	    const double mser = (suffix_square_sum - suffix_sum*suffix_sum/n) / (n*n);
+	    // Ties are resolved in favour of the smaller truncation point
+	    if (mser <= minimal_mser)
+	    {
+	      minimal_mser = mser;
+	      truncation_batch = d;
+	    }
+	  }
+	  stationary = (k >= minimal_batch_number && 4*truncation_batch <= k);
+	}
+      };
+    }
+  }
+}
+
+#endif
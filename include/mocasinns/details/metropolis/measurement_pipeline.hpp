@@ -0,0 +1,204 @@
+/*!
+  \file measurement_pipeline.hpp
+
+  \brief Pipeline observing snapshots of the configuration in background threads while the Markov chain continues
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_MEASUREMENT_PIPELINE_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_MEASUREMENT_PIPELINE_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include <boost/optional.hpp>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Copy of the configuration taken at a measurement, together with the energy known by the simulation at this time
+      template <class ConfigurationType, class EnergyType>
+      struct ConfigurationSnapshot
+      {
+	//! Copy of the configuration
+	ConfigurationType configuration;
+	//! Energy of the configuration, only set for observators using the energy known by the simulation
+	EnergyType energy;
+
+	//! Constructor allocating the snapshot as a copy of the given configuration
+	explicit ConfigurationSnapshot(const ConfigurationType& prototype) : configuration(prototype), energy() {}
+      };
+
+      //! Bounded queue of snapshots that are observed by background threads and accumulated in the order of the measurements
+      /*!
+	\details The simulation thread acquires a free buffer of the pool with acquire(), copies the configuration into it and hands it to the observer threads with submit(). The observer threads call <tt>SnapshotObservator::observe(SnapshotType&)</tt> concurrently on different snapshots. Whichever thread finishes the oldest pending observation passes the observables to the accumulator, so the accumulator is called by one thread at a time and in the order in which the snapshots were submitted, independent of the number of threads. A buffer is reused as soon as its observable was accumulated, if all buffers are pending, acquire() blocks until the oldest one is accumulated.
+
+	If an observation or the accumulator throws, no further observables are accumulated and the exception is rethrown by the next call of acquire() or finish().
+	\tparam SnapshotType Type of the copies of the configuration, must be copy-assignable
+	\tparam ObservableType Type of the observables
+	\tparam SnapshotObservator Class with the static member function <tt>ObservableType observe(SnapshotType& snapshot)</tt>
+	\tparam Accumulator \concept{Accumulator}
+      */
+      template <class SnapshotType, class ObservableType, class SnapshotObservator, class Accumulator>
+      class MeasurementPipeline
+      {
+      public:
+	//! Constructor starting the observer threads
+	/*!
+	  \param prototype Snapshot from which all buffers of the pool are copy-constructed
+	  \param observer_thread_number Number of background threads observing the snapshots (at least one is started)
+	  \param buffer_number Number of buffers in the pool, i.e. maximal number of snapshots that are pending at once (at least one)
+	  \param measurement_accumulator Accumulator receiving the observables in the order of the snapshots
+	*/
+	MeasurementPipeline(const SnapshotType& prototype, unsigned int observer_thread_number, unsigned int buffer_number, Accumulator& measurement_accumulator)
+	  : buffers(buffer_number > 0 ? buffer_number : 1, Buffer(prototype)),
+	    accumulator(measurement_accumulator),
+	    submitted(0), observing(0), accumulated(0),
+	    stopping(false), error()
+	{
+	  for (unsigned int t = 0; t < (observer_thread_number > 0 ? observer_thread_number : 1); ++t)
+	    observer_threads.push_back(std::thread(&MeasurementPipeline::observer_loop, this));
+	}
+	//! Destructor waiting for the pending snapshots and the observer threads
+	~MeasurementPipeline() { join(); }
+
+	//! Return a free buffer into which the next snapshot is copied, blocks while all buffers are pending
+	SnapshotType& acquire()
+	{
+	  std::unique_lock<std::mutex> lock(mutex);
+	  buffer_free.wait(lock, [this]() { return submitted - accumulated < buffers.size() || error; });
+	  if (error) std::rethrow_exception(error);
+	  return buffers[submitted % buffers.size()].snapshot;
+	}
+	//! Hand the snapshot copied into the buffer returned by the last call of acquire() to the observer threads
+	void submit()
+	{
+	  {
+	    std::lock_guard<std::mutex> lock(mutex);
+	    ++submitted;
+	  }
+	  snapshot_submitted.notify_one();
+	}
+	//! Wait until all submitted snapshots are observed and accumulated without stopping the observer threads, rethrows the exception of a failed observation
+	void drain()
+	{
+	  std::unique_lock<std::mutex> lock(mutex);
+	  buffer_free.wait(lock, [this]() { return accumulated == submitted || error; });
+	  if (error) std::rethrow_exception(error);
+	}
+	//! Wait until all submitted snapshots are observed and accumulated and stop the observer threads, rethrows the exception of a failed observation
+	void finish()
+	{
+	  join();
+	  if (error) std::rethrow_exception(error);
+	}
+
+      private:
+	//! Buffer of the pool
+	struct Buffer
+	{
+	  //! Snapshot of the configuration
+	  SnapshotType snapshot;
+	  //! Observable of the snapshot, set when the observation is finished and reset when it was accumulated
+	  boost::optional<ObservableType> observable;
+
+	  explicit Buffer(const SnapshotType& prototype) : snapshot(prototype), observable() {}
+	};
+
+	//! Pool of buffers, the snapshot with number n is stored in the buffer n modulo the number of buffers
+	std::vector<Buffer> buffers;
+	//! Accumulator receiving the observables
+	Accumulator& accumulator;
+	//! Observer threads
+	std::vector<std::thread> observer_threads;
+
+	//! Mutex protecting the counters and the observables of the buffers
+	std::mutex mutex;
+	//! Condition notified when a snapshot was submitted or the pipeline is stopping
+	std::condition_variable snapshot_submitted;
+	//! Condition notified when a buffer was freed or an observation failed
+	std::condition_variable buffer_free;
+	//! Number of submitted snapshots
+	std::size_t submitted;
+	//! Number of snapshots whose observation was started
+	std::size_t observing;
+	//! Number of accumulated snapshots
+	std::size_t accumulated;
+	//! Flag indicating that no further snapshots will be submitted
+	bool stopping;
+	//! Exception thrown by the first failed observation
+	std::exception_ptr error;
+
+	//! Stop and join the observer threads after all submitted snapshots are processed
+	void join()
+	{
+	  if (observer_threads.empty()) return;
+	  {
+	    std::lock_guard<std::mutex> lock(mutex);
+	    stopping = true;
+	  }
+	  snapshot_submitted.notify_all();
+	  for (std::vector<std::thread>::iterator thread = observer_threads.begin(); thread != observer_threads.end(); ++thread)
+	    thread->join();
+	  observer_threads.clear();
+	}
+
+	//! Loop of an observer thread, observes the oldest snapshot that is not yet observed and accumulates all observables that are next in order
+	void observer_loop()
+	{
+	  std::unique_lock<std::mutex> lock(mutex);
+	  while (true)
+	  {
+	    snapshot_submitted.wait(lock, [this]() { return observing < submitted || stopping; });
+	    if (observing == submitted) return;
+	    Buffer& buffer = buffers[observing % buffers.size()];
+	    ++observing;
+
+	    // Observe without holding the lock, the buffer is not touched by other threads until it is accumulated
+	    lock.unlock();
+	    try
+	    {
+	      ObservableType observable = SnapshotObservator::observe(buffer.snapshot);
+	      lock.lock();
+	      buffer.observable = observable;
+	    }
+	    catch (...)
+	    {
+	      // The copy of the observable into the buffer may throw while the lock is already held
+	      if (!lock.owns_lock()) lock.lock();
+	      if (!error) error = std::current_exception();
+	    }
+
+	    // Accumulate the observables that are next in order, keeps the lock so that the accumulator is called by one thread at a time
+	    bool freed = false;
+	    try
+	    {
+	      while (!error && accumulated < observing && buffers[accumulated % buffers.size()].observable)
+	      {
+		boost::optional<ObservableType>& next_observable = buffers[accumulated % buffers.size()].observable;
+		accumulator(*next_observable);
+		next_observable = boost::none;
+		++accumulated;
+		freed = true;
+	      }
+	    }
+	    catch (...)
+	    {
+	      if (!error) error = std::current_exception();
+	    }
+	    if (freed || error) buffer_free.notify_one();
+	  }
+	}
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*!
+  \file measurement_spacing.hpp
+
+  \brief Adaption of the number of steps between two measurements to the integrated autocorrelation time of the energy
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_MEASUREMENT_SPACING_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_MEASUREMENT_SPACING_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <stdint.h>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "autocorrelation_estimator.hpp"
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Adapts the number of steps between two measurements to a fraction of the integrated autocorrelation time of the energy
+      /*!
+	\details The energies of one or several replicas are sampled every sample_steps steps and the integrated autocorrelation time of every replica is estimated with an AutocorrelationEstimator. After every measurement update() sets the number of steps between two measurements to the given fraction of the largest autocorrelation time, clamped to the given bounds and rounded up to a multiple of sample_steps (at least one sample). Until an estimate is available, the initial number of steps is used (rounded as well).
+
+	The estimators are never cleared during a simulation, so the number of steps converges with the growing statistics of the estimate.
+      */
+      class MeasurementSpacing
+      {
+      public:
+	//! Type of the step numbers
+	typedef uint64_t step_number_t;
+
+	//! Default constructor, initialises the spacing with one sample of one step
+	MeasurementSpacing() : sample_steps(1), sample_number(1) {}
+
+	//! Start a new adaption for the given number of replicas, number of steps between two energy samples and initial number of steps between two measurements
+	void reset(std::size_t replica_number, step_number_t steps_per_sample, step_number_t initial_steps)
+	{
+	  estimators.assign(replica_number, AutocorrelationEstimator());
+	  sample_steps = (steps_per_sample > 0 ? steps_per_sample : 1);
+	  sample_number = samples_for(initial_steps);
+	}
+
+	//! Add an energy sample of the replica with the given index
+	template <class EnergyType>
+	void add(std::size_t replica, const EnergyType& energy) { estimators[replica].add(energy); }
+
+	//! Set the number of steps between two measurements to the fraction of the largest autocorrelation time, bounded by minimal_steps and maximal_steps (0 imposes no upper bound)
+	void update(double fraction, step_number_t minimal_steps, step_number_t maximal_steps)
+	{
+	  const double tau = get_autocorrelation_time();
+	  if (!(tau > 0.0)) return;
+
+	  double steps = fraction * tau;
+	  if (steps < static_cast<double>(minimal_steps)) steps = static_cast<double>(minimal_steps);
+	  if (maximal_steps > 0 && steps > static_cast<double>(maximal_steps)) steps = static_cast<double>(maximal_steps);
+
+	  sample_number = samples_for(static_cast<step_number_t>(std::ceil(steps)));
+	  // Rounding up must not exceed the upper bound
+	  if (maximal_steps > 0 && sample_number * sample_steps > maximal_steps && sample_number > 1)
+	    sample_number = (maximal_steps / sample_steps > 0 ? maximal_steps / sample_steps : 1);
+	}
+
+	//! Number of steps between two energy samples
+	step_number_t get_sample_steps() const { return sample_steps; }
+	//! Number of energy samples between two measurements
+	step_number_t get_sample_number() const { return sample_number; }
+	//! Number of steps between two measurements
+	step_number_t get_steps_between_measurement() const { return sample_number * sample_steps; }
+	//! Largest integrated autocorrelation time of the energies of the replicas in units of steps, 0 if no estimate is available
+	double get_autocorrelation_time() const
+	{
+	  double result = 0.0;
+	  for (std::size_t i = 0; i < estimators.size(); ++i)
+	  {
+	    const double tau = estimators[i].get_autocorrelation_time() * sample_steps;
+	    if (tau > result) result = tau;
+	  }
+	  return result;
+	}
+
+      private:
+	//! Number of steps between two energy samples
+	step_number_t sample_steps;
+	//! Number of energy samples between two measurements
+	step_number_t sample_number;
+	//! Estimators of the autocorrelation times of the replicas
+	std::vector<AutocorrelationEstimator> estimators;
+
+	//! Number of samples covering the given number of steps, at least one
+	step_number_t samples_for(step_number_t steps) const
+	{
+	  const step_number_t samples = (steps + sample_steps - 1) / sample_steps;
+	  return (samples > 0 ? samples : 1);
+	}
+
+	friend class boost::serialization::access;
+	template<class Archive> void serialize(Archive & ar, const unsigned int)
+	{
+	  ar & sample_steps;
+	  ar & sample_number;
+	  ar & estimators;
+	}
+      };
+    }
+  }
+}
+
+#endif
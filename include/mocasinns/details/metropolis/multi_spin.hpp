@@ -0,0 +1,80 @@
+/*!
+  \file multi_spin.hpp
+
+  \brief File containing the helpers for Metropolis simulations of multi-spin coded configurations
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_MULTI_SPIN_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_MULTI_SPIN_HPP
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include <boost/mpl/vector.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+
+#include "../optional_member_functions.hpp"
+#include "../rejection_free/step_classes.hpp"
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Type of the words storing one bit of each of the replicas of a multi-spin coded configuration
+      typedef uint64_t MultiSpinWord;
+
+      //! Type of the list of replica masks belonging to the positive energy differences of a multi-spin coded step
+      template <class StepType>
+      struct multi_spin_masks_type
+      {
+	typedef std::vector<std::pair<typename RejectionFree::step_energy_difference<StepType>::type, MultiSpinWord> > type;
+      };
+
+      //! Trait deciding whether the steps are multi-spin coded, i.e. provide the member functions <tt>MultiSpinWord multi_spin_masks(std::vector<std::pair<EnergyType, MultiSpinWord> >& masks)</tt> and <tt>void execute(MultiSpinWord flip_mask)</tt>
+      template <class StepType>
+      struct is_multi_spin_step
+	: public boost::integral_constant<bool, has_function_multi_spin_masks<StepType, MultiSpinWord, boost::mpl::vector<typename multi_spin_masks_type<StepType>::type&> >::value> {};
+
+      //! Create a mask in which every bit set in the candidates is set independently with the given probability
+      /*!
+	\details The probability is converted into a threshold with 32 binary digits, which is compared digit by digit with the uniformly distributed random numbers of all replicas in parallel, starting with the most significant digit. The comparison of a replica is finished at the first digit in which its random number and the threshold differ, so on average only a few random words are needed for 64 replicas.
+	\tparam RandomNumberGenerator Random number generator providing the member function <tt>MultiSpinWord random_bits64()</tt>
+	\param probability Probability with which every candidate bit is set
+	\param candidates Mask of the bits that can be set
+	\param rng Random number generator creating the random words
+      */
+      template <class RandomNumberGenerator>
+      inline MultiSpinWord threshold_mask(double probability, MultiSpinWord candidates, RandomNumberGenerator* rng)
+      {
+	if (probability >= 1.0) return candidates;
+	if (!(probability > 0.0)) return 0;
+
+	const MultiSpinWord threshold = static_cast<MultiSpinWord>(probability * 4294967296.0);
+	MultiSpinWord result = 0;
+	MultiSpinWord undecided = candidates;
+	for (int digit = 31; digit >= 0 && undecided != 0; --digit)
+	{
+	  // If all remaining digits of the threshold vanish, the undecided random numbers are not smaller than the threshold
+	  if ((threshold & ((static_cast<MultiSpinWord>(2) << digit) - 1)) == 0) break;
+
+	  const MultiSpinWord random_digits = rng->random_bits64();
+	  if ((threshold >> digit) & 1)
+	  {
+	    result |= undecided & ~random_digits;
+	    undecided &= random_digits;
+	  }
+	  else
+	    undecided &= ~random_digits;
+	}
+	return result;
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,63 @@
+/*!
+  \file precision_monitor.hpp
+
+  \brief Streaming binning error of the designated observable for stopping the measurements at a target precision
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_PRECISION_MONITOR_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_PRECISION_MONITOR_HPP
+
+#include <boost/serialization/access.hpp>
+
+#include "autocorrelation_estimator.hpp"
+#include "../../observables/tuple_observable.hpp"
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Monitors the standard error of the mean of the designated observable of the measurements
+      /*!
+	\details The designated observable is the measured observable itself if it is of an arithmetic type and the first component if it is an Observables::TupleObservable (e.g. the first requested observable of an Observables::FusedObservator). The standard error is estimated with the binning analysis of an AutocorrelationEstimator, so it accounts for the autocorrelations of the measurements. The target precision is only reached if the binning analysis has converged, so at least \f$ 8 \cdot 32 \cdot \tau_{\mathrm{int}} \f$ measurements are taken for the default of 32 bins. Observables of other types are ignored and the target precision is never reached.
+      */
+      class PrecisionMonitor
+      {
+      public:
+	//! Constructor taking the minimal number of bins of the binning levels used for the error estimate
+	explicit PrecisionMonitor(unsigned int minimal_bins = 32) : estimator(minimal_bins) {}
+
+	//! Add the designated observable of a measurement
+	template <class ObservableType>
+	void add(const ObservableType& observable) { estimator.add(observable); }
+	//! Add the first component of a tuple of observables
+	template <class T, class... Ts>
+	void add(const Observables::TupleObservable<T, Ts...>& observable) { add(Observables::get<0>(observable)); }
+
+	//! Remove all measurements
+	void clear() { estimator.clear(); }
+
+	//! Whether enough measurements were added for an error estimate
+	bool is_available() const { return estimator.is_available(); }
+	//! Whether the binning analysis of the error estimate has converged
+	bool is_converged() const { return estimator.is_converged(); }
+	//! Estimate of the standard error of the mean of the designated observable, 0 if no estimate is available
+	double get_standard_error() const { return estimator.get_standard_error(); }
+	//! Whether the binning analysis has converged and the standard error is not larger than the target error
+	bool is_reached(double target_error) const { return (is_converged() && get_standard_error() <= target_error); }
+
+      private:
+	//! Binning analysis of the designated observable
+	AutocorrelationEstimator estimator;
+
+	friend class boost::serialization::access;
+	template<class Archive> void serialize(Archive & ar, const unsigned int) { ar & estimator; }
+      };
+    }
+  }
+}
+
+#endif
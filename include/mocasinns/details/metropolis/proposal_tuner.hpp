@@ -0,0 +1,131 @@
+/*!
+  \file proposal_tuner.hpp
+
+  \brief Adaption of the proposal widths of a continuous configuration to a target acceptance rate
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_PROPOSAL_TUNER_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_PROPOSAL_TUNER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "../optional_member_functions.hpp"
+#include "../../statistics/acceptance_statistics.hpp"
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Adapts the proposal widths of the step types of a configuration to a target acceptance rate
+      /*!
+	\details The widths are the optional member functions <tt>double get_proposal_width(std::size_t step_type)</tt> and <tt>void set_proposal_width(std::size_t step_type, double width)</tt> of the configuration, the types of the steps are given by the optional member function <tt>std::size_t step_type()</tt> of the steps (see Statistics::AcceptanceStatistics). The tuner reads the acceptance of the step types from the acceptance statistics of the simulation. As soon as minimal_proposals steps of a type were proposed since the last adaption of its width, the width is multiplied by the ratio of the measured and the target acceptance rate, clamped to \f$ [1/2, 2] \f$. Larger widths are assumed to lower the acceptance rate. The configuration may restrict the widths in set_proposal_width, the tuner continues with the width read back from the configuration.
+
+	The tuned widths are stored in the tuner, so they can be applied to another configuration (e.g. after a replica exchange moved a configuration to another temperature). Configurations without the member functions are left unchanged.
+      */
+      class ProposalTuner
+      {
+      public:
+	//! Constructor taking the minimal number of proposed steps of a type between two adaptions of its width
+	explicit ProposalTuner(uint64_t minimal_proposal_number = 1000)
+	  : minimal_proposals(minimal_proposal_number > 0 ? minimal_proposal_number : 1) {}
+
+	//! Start the adaption at the given state of the acceptance statistics, the widths tuned so far are kept
+	void start(const Statistics::AcceptanceStatistics& statistics, uint64_t minimal_proposal_number)
+	{
+	  minimal_proposals = (minimal_proposal_number > 0 ? minimal_proposal_number : 1);
+	  proposed.clear();
+	  accepted.clear();
+	  for (std::size_t t = 0; t < statistics.step_type_number(); ++t)
+	  {
+	    proposed.push_back(statistics.proposed_of_type(t));
+	    accepted.push_back(statistics.accepted_of_type(t));
+	  }
+	}
+
+	//! Adapt the widths of the step types with enough proposed steps since their last adaption to the target acceptance rate
+	template <class ConfigurationType>
+	void update(const Statistics::AcceptanceStatistics& statistics, ConfigurationType& configuration, double target_rate)
+	{
+	  if (!(target_rate > 0.0)) return;
+	  for (std::size_t t = 0; t < statistics.step_type_number(); ++t)
+	  {
+	    if (t == proposed.size())
+	    {
+	      proposed.push_back(0);
+	      accepted.push_back(0);
+	    }
+	    const uint64_t proposed_since = statistics.proposed_of_type(t) - proposed[t];
+	    if (proposed_since < minimal_proposals) continue;
+	    const double rate = static_cast<double>(statistics.accepted_of_type(t) - accepted[t]) / static_cast<double>(proposed_since);
+	    proposed[t] = statistics.proposed_of_type(t);
+	    accepted[t] = statistics.accepted_of_type(t);
+
+	    if (t >= widths.size())
+	    {
+	      widths.resize(t + 1, 0.0);
+	      rates.resize(t + 1, 0.0);
+	    }
+	    rates[t] = rate;
+
+	    const double width = OptionalMemberFunctions::optional_get_proposal_width(configuration, t);
+	    if (!(width > 0.0)) continue;
+	    double factor = rate / target_rate;
+	    if (factor < 0.5) factor = 0.5;
+	    if (factor > 2.0) factor = 2.0;
+	    OptionalMemberFunctions::optional_set_proposal_width(configuration, t, width * factor);
+	    widths[t] = OptionalMemberFunctions::optional_get_proposal_width(configuration, t);
+	  }
+	}
+
+	//! Set the tuned widths of the configuration
+	template <class ConfigurationType>
+	void apply(ConfigurationType& configuration) const
+	{
+	  for (std::size_t t = 0; t < widths.size(); ++t)
+	    if (widths[t] > 0.0) OptionalMemberFunctions::optional_set_proposal_width(configuration, t, widths[t]);
+	}
+
+	//! Remove the tuned widths and the measured acceptance rates
+	void clear() { widths.clear(); rates.clear(); proposed.clear(); accepted.clear(); }
+
+	//! Whether a width was tuned
+	bool is_tuned() const { return !widths.empty(); }
+	//! Tuned width of the given step type, 0 if the width of this type was not tuned
+	double get_proposal_width(std::size_t step_type) const { return (step_type < widths.size() ? widths[step_type] : 0.0); }
+	//! Acceptance rate of the given step type measured before the last adaption of its width, 0 if the type was not adapted
+	double get_acceptance_rate(std::size_t step_type) const { return (step_type < rates.size() ? rates[step_type] : 0.0); }
+
+      private:
+	//! Minimal number of proposed steps of a type between two adaptions of its width
+	uint64_t minimal_proposals;
+	//! Tuned widths of the step types, 0 for types that were not tuned
+	std::vector<double> widths;
+	//! Acceptance rates of the step types measured before their last adaption
+	std::vector<double> rates;
+	//! Number of proposed steps of every type in the acceptance statistics at the last adaption
+	std::vector<uint64_t> proposed;
+	//! Number of accepted steps of every type in the acceptance statistics at the last adaption
+	std::vector<uint64_t> accepted;
+
+	friend class boost::serialization::access;
+	template<class Archive> void serialize(Archive & ar, const unsigned int)
+	{
+	  ar & minimal_proposals;
+	  ar & widths;
+	  ar & rates;
+	}
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*!
+  \file tracked_energy_parameter.hpp
+
+  \brief Acceptance probability parameter of the Metropolis algorithm that carries the energy difference of a step to its handler
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_METROPOLIS_TRACKED_ENERGY_PARAMETER_HPP
+#define MOCASINNS_DETAILS_METROPOLIS_TRACKED_ENERGY_PARAMETER_HPP
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace Metropolis
+    {
+      //! Parameter piped through Simulation::do_steps if the Metropolis simulation tracks the total energy
+      /*!
+	\details The acceptance probability stores the energy difference of the step in the parameter, and the handler of an executed step adds it to the tracked energy. Since the rejection-free algorithms restore the parameter of the executed step before it is handled, this also holds for them (as for the multicanonical StepParameter).
+	\tparam TemperatureType Type of the inverse temperature
+	\tparam EnergyDifferenceType Type of the energy differences of the steps
+      */
+      template <class TemperatureType, class EnergyDifferenceType>
+      struct TrackedEnergyParameter
+      {
+	//! Inverse temperature of the steps
+	TemperatureType beta;
+	//! Energy difference of the step of which the acceptance probability was calculated last
+	EnergyDifferenceType delta_E;
+
+	//! Constructor taking the inverse temperature
+	explicit TrackedEnergyParameter(const TemperatureType& inverse_temperature) : beta(inverse_temperature), delta_E() {}
+      };
+
+      //! Inverse temperature of a plain acceptance probability parameter
+      template <class TemperatureType>
+      inline const TemperatureType& inverse_temperature(const TemperatureType& beta) { return beta; }
+      //! Inverse temperature of a parameter tracking the energy
+      template <class TemperatureType, class EnergyDifferenceType>
+      inline const TemperatureType& inverse_temperature(const TrackedEnergyParameter<TemperatureType, EnergyDifferenceType>& parameter) { return parameter.beta; }
+
+      //! Store the energy difference of a step in a plain acceptance probability parameter (does nothing)
+      template <class ParameterType, class EnergyDifferenceType>
+      inline void store_delta_E(ParameterType&, const EnergyDifferenceType&) {}
+      //! Store the energy difference of a step in a parameter tracking the energy
+      template <class TemperatureType, class EnergyDifferenceType>
+      inline void store_delta_E(TrackedEnergyParameter<TemperatureType, EnergyDifferenceType>& parameter, const EnergyDifferenceType& delta_E) { parameter.delta_E = delta_E; }
+    }
+  }
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef MOCASINNS_DETAILS_MULTICANONICAL_PARAMETERS_MULTICANONICAL_HPP
 #define MOCASINNS_DETAILS_MULTICANONICAL_PARAMETERS_MULTICANONICAL_HPP
 
+#include <boost/serialization/version.hpp>
+
 namespace Mocasinns
 {
   namespace Details
@@ -40,6 +42,18 @@ namespace Mocasinns
        //! Flag indicating whether to use the maximal energy cutoff, default value is false
        bool use_energy_cutoff_upper;
 
+       //! Flag indicating whether consecutive rejected steps are applied to the histograms as one weighted update, default value is false
+       /*!
+	 \details If the flag is set, the rejected steps at the current energy are only summed up and applied to the histograms before the next executed step and at the end of every call of the step functions (i.e. before the flatness is checked). This saves the histogram lookups of every rejected step in regions of low acceptance.
+       */
+       bool coalesce_rejected_steps;
+
+       //! Flag indicating whether the total energy is tracked between the calls of the step functions, default value is false
+       /*!
+	 \details Within a call of the step functions the energy is always tracked by adding the energy differences of the executed steps. If the flag is set, the tracked energy is also used for the next call instead of calculating the energy of the configuration again, so the configuration must only be changed by the simulation (or set with set_config_space of the simulation). After a change of the configuration through get_config_space(), invalidate_tracked_energy() of the simulation must be called. Loading a serialized simulation always calculates the energy again.
+       */
+       bool track_energy;
+
        //! Comparator object for comparing with the lower energy cutoff. Pointer to a function taking two const references to the energy type
        bool (*lower_comparison_function)(const EnergyType&, const EnergyType&);
        //! Comparator object for comparing with the upper energy_cutoff. Pointer to a function taking two const references to the energy type
@@ -56,6 +70,8 @@ namespace Mocasinns
 	 energy_cutoff_upper(0),
 	 use_energy_cutoff_lower(false),
 	 use_energy_cutoff_upper(false),
+	 coalesce_rejected_steps(false),
+	 track_energy(false),
 	 lower_comparison_function(&lower_comparison_function_default),
 	 upper_comparison_function(&upper_comparison_function_default) {}
 
@@ -68,6 +84,8 @@ namespace Mocasinns
 	 energy_cutoff_upper(other.energy_cutoff_upper),
 	 use_energy_cutoff_lower(other.use_energy_cutoff_lower),
 	 use_energy_cutoff_upper(other.use_energy_cutoff_upper),
+	 coalesce_rejected_steps(other.coalesce_rejected_steps),
+	 track_energy(other.track_energy),
 	 lower_comparison_function(other.lower_comparison_function),
 	 upper_comparison_function(other.upper_comparison_function) { }
 
@@ -79,7 +97,9 @@ namespace Mocasinns
 		 (energy_cutoff_lower == rhs.energy_cutoff_lower) && 
 		 (energy_cutoff_upper == rhs.energy_cutoff_upper) &
 		 (use_energy_cutoff_lower == rhs.use_energy_cutoff_lower) && 
-		 (use_energy_cutoff_upper == rhs.use_energy_cutoff_upper));
+		 (use_energy_cutoff_upper == rhs.use_energy_cutoff_upper) &&
+		 (coalesce_rejected_steps == rhs.coalesce_rejected_steps) &&
+		 (track_energy == rhs.track_energy));
        }
        //! Test for inequality
        bool operator!=(const ParametersMulticanonical<EnergyType>& rhs) const { return !operator==(rhs); }
@@ -105,8 +125,8 @@ namespace Mocasinns
 
        //! Member variable for boost serialization
        friend class boost::serialization::access;
-       //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
-       template<class Archive> void serialize(Archive & ar, const unsigned int)
+       //! Method to serialize this class, the flags for rejected steps and the tracked energy are stored since version 1
+       template<class Archive> void serialize(Archive & ar, const unsigned int version)
        {
 	 // serialize base class information
 	 ar & binning_reference;
@@ -115,10 +135,28 @@ namespace Mocasinns
 	 ar & energy_cutoff_upper;
 	 ar & use_energy_cutoff_lower;
 	 ar & use_energy_cutoff_upper;
+	 if (version < 1) return;
+	 ar & coalesce_rejected_steps;
+	 ar & track_energy;
        }  
      };
    } 
   }
 }
 
+namespace boost
+{
+  namespace serialization
+  {
+    //! Version 1 of the serialization of ParametersMulticanonical adds the flags for rejected steps and the tracked energy
+    template <class EnergyType>
+    struct version<Mocasinns::Details::Multicanonical::ParametersMulticanonical<EnergyType> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+  }
+}
+
 #endif
@@ -1,7 +1,7 @@
 /*!
   \file step_parameter.hpp
 
-  \brief File containing a struct for using the total energy and the energy difference of a step as parameters passed between the functions acceptance_probability and handle_executed_step
+  \brief File containing a struct for using the total energy and the energy difference of a step as parameters passed between the functions acceptance_probability, handle_executed_step and handle_rejected_step
 
   \author Benedikt Krüger
 */
@@ -23,12 +23,14 @@ namespace Mocasinns
 	EnergyType total_energy;
 	//! Energy difference induced by the step
 	EnergyType delta_E;
+	//! Total time of the rejected steps at the total energy that were not yet applied to the histograms (only used if the rejected steps are coalesced)
+	double rejected_time;
 	
 	//! Standard constructor
-	StepParameter() {}
+	StepParameter() : rejected_time(0.0) {}
 	//! Constructor taking the two members
 	StepParameter(const EnergyType& new_total_energy, const EnergyType& new_delta_E) 
-	  : total_energy(new_total_energy), delta_E(new_delta_E) {}
+	  : total_energy(new_total_energy), delta_E(new_delta_E), rejected_time(0.0) {}
       };
     }
   }
@@ -5,6 +5,13 @@
 #include <boost/utility/enable_if.hpp>
 #include <boost/tti/has_function.hpp>
 #include <boost/tti/has_data.hpp>
+#include <boost/tti/has_static_member_data.hpp>
+#include <boost/tti/has_static_member_function.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <vector>
+#include <string>
+#include <cstddef>
 
 namespace Mocasinns
 {
@@ -13,6 +20,20 @@ namespace Mocasinns
     BOOST_TTI_HAS_FUNCTION(is_executable)
     BOOST_TTI_HAS_FUNCTION(selection_probability_factor)
     BOOST_TTI_HAS_FUNCTION(is_serializable)
+    BOOST_TTI_HAS_FUNCTION(propose_steps)
+    BOOST_TTI_HAS_FUNCTION(update_proposed_steps)
+    BOOST_TTI_HAS_FUNCTION(all_steps)
+    BOOST_TTI_HAS_FUNCTION(affected_steps)
+    BOOST_TTI_HAS_FUNCTION(propose_sweep_step)
+    BOOST_TTI_HAS_FUNCTION(propose_color_step)
+    BOOST_TTI_HAS_FUNCTION(footprint)
+    BOOST_TTI_HAS_FUNCTION(multi_spin_masks)
+    BOOST_TTI_HAS_FUNCTION(prepare_cluster_update)
+    BOOST_TTI_HAS_FUNCTION(step_type)
+    BOOST_TTI_HAS_FUNCTION(set_state)
+    BOOST_TTI_HAS_FUNCTION(set_proposal_width)
+    BOOST_TTI_HAS_STATIC_MEMBER_DATA(local_acceptance_probability)
+    BOOST_TTI_HAS_STATIC_MEMBER_FUNCTION(observe)
 
     //! Class that provides function for checking whether a type given as function template parameter has a certain member function. If the member function exists, the member function is called, otherwise a default value will be returned
     class OptionalMemberFunctions
@@ -46,8 +67,75 @@ namespace Mocasinns
       optional_selection_probability_factor(StepType&) { return 1.0; }
       //! /endcond
 
+      //! /cond
+      template <class ConfigurationType, class StepType>
+      static typename boost::enable_if_c<has_function_update_proposed_steps<ConfigurationType, void, boost::mpl::vector<std::vector<StepType>&, std::size_t, StepType&> >::value, void>::type
+      optional_update_proposed_steps(ConfigurationType& configuration, std::vector<StepType>& proposed_steps, std::size_t first_index, StepType& executed_step) 
+      { configuration.update_proposed_steps(proposed_steps, first_index, executed_step); }
+      template <class ConfigurationType, class StepType>
+      static typename boost::enable_if_c<!has_function_update_proposed_steps<ConfigurationType, void, boost::mpl::vector<std::vector<StepType>&, std::size_t, StepType&> >::value, void>::type
+      optional_update_proposed_steps(ConfigurationType&, std::vector<StepType>&, std::size_t, StepType&) { }
+      //! /endcond
+
+      //! /cond
+      template <class ConfigurationType, class StepType>
+      static typename boost::enable_if_c<has_function_all_steps<ConfigurationType, void, boost::mpl::vector<std::vector<StepType>&> >::value, void>::type
+      optional_all_steps(ConfigurationType& configuration, std::vector<StepType>& steps) { configuration.all_steps(steps); }
+      template <class ConfigurationType, class StepType>
+      static typename boost::enable_if_c<!has_function_all_steps<ConfigurationType, void, boost::mpl::vector<std::vector<StepType>&> >::value, void>::type
+      optional_all_steps(ConfigurationType& configuration, std::vector<StepType>& steps) { steps = configuration.all_steps(); }
+      //! /endcond
+
+      //! /cond
+      template <class ConfigurationType, class RandomNumberGenerator>
+      static typename boost::enable_if_c<has_function_prepare_cluster_update<ConfigurationType, void, boost::mpl::vector<RandomNumberGenerator*> >::value, void>::type
+      optional_prepare_cluster_update(ConfigurationType& configuration, RandomNumberGenerator* rng) { configuration.prepare_cluster_update(rng); }
+      template <class ConfigurationType, class RandomNumberGenerator>
+      static typename boost::enable_if_c<!has_function_prepare_cluster_update<ConfigurationType, void, boost::mpl::vector<RandomNumberGenerator*> >::value, void>::type
+      optional_prepare_cluster_update(ConfigurationType&, RandomNumberGenerator*) { }
+      //! /endcond
+
       // Code only visible for doxygen
       // Doxygen cannot deal with the enable-if structure
+      //! /cond
+      template <class StepType>
+      static typename boost::enable_if_c<has_function_step_type<StepType, std::size_t>::value, std::size_t>::type
+      optional_step_type(StepType& step) { return step.step_type(); }
+      template <class StepType>
+      static typename boost::enable_if_c<!has_function_step_type<StepType, std::size_t>::value, std::size_t>::type
+      optional_step_type(StepType&) { return 0; }
+      //! /endcond
+
+      //! /cond
+      template <class ConfigurationType>
+      static typename boost::enable_if_c<has_function_set_proposal_width<ConfigurationType, void, boost::mpl::vector<std::size_t, double> >::value, double>::type
+      optional_get_proposal_width(ConfigurationType& configuration, std::size_t step_type) { return configuration.get_proposal_width(step_type); }
+      template <class ConfigurationType>
+      static typename boost::enable_if_c<!has_function_set_proposal_width<ConfigurationType, void, boost::mpl::vector<std::size_t, double> >::value, double>::type
+      optional_get_proposal_width(ConfigurationType&, std::size_t) { return 0.0; }
+      template <class ConfigurationType>
+      static typename boost::enable_if_c<has_function_set_proposal_width<ConfigurationType, void, boost::mpl::vector<std::size_t, double> >::value, void>::type
+      optional_set_proposal_width(ConfigurationType& configuration, std::size_t step_type, double width) { configuration.set_proposal_width(step_type, width); }
+      template <class ConfigurationType>
+      static typename boost::enable_if_c<!has_function_set_proposal_width<ConfigurationType, void, boost::mpl::vector<std::size_t, double> >::value, void>::type
+      optional_set_proposal_width(ConfigurationType&, std::size_t, double) { }
+      //! /endcond
+
+      //! /cond
+      template <class RandomNumberGenerator>
+      static typename boost::enable_if_c<has_function_set_state<RandomNumberGenerator, void, boost::mpl::vector<const std::string&> >::value, std::string>::type
+      optional_get_state(RandomNumberGenerator& rng) { return rng.get_state(); }
+      template <class RandomNumberGenerator>
+      static typename boost::enable_if_c<!has_function_set_state<RandomNumberGenerator, void, boost::mpl::vector<const std::string&> >::value, std::string>::type
+      optional_get_state(RandomNumberGenerator&) { return std::string(); }
+      template <class RandomNumberGenerator>
+      static typename boost::enable_if_c<has_function_set_state<RandomNumberGenerator, void, boost::mpl::vector<const std::string&> >::value, void>::type
+      optional_set_state(RandomNumberGenerator& rng, const std::string& state) { if (!state.empty()) rng.set_state(state); }
+      template <class RandomNumberGenerator>
+      static typename boost::enable_if_c<!has_function_set_state<RandomNumberGenerator, void, boost::mpl::vector<const std::string&> >::value, void>::type
+      optional_set_state(RandomNumberGenerator&, const std::string&) { }
+      //! /endcond
+
 #ifdef MOCASINNS_DOXYGEN_DOCUMENTATION
       //! Checks whether the given StepType has the (static) member function <tt>bool is_executable()</tt>. If this is the case, the optional function returns the value of this (static) member function, otherwise it returns true.
       template <class StepType> 
@@ -60,6 +148,38 @@ namespace Mocasinns
       //! Checks whether the given StepType has the (static) member function <tt>double selection_probability_factor()</tt>. If this is the case, the optional function returns the value of this (static) member function, otherwise it returns 1.0.
       template <class StepType> 
       double optional_selection_probability_factor(StepType& step);
+
+      //! Checks whether the given ConfigurationType has the member function <tt>void update_proposed_steps(std::vector<StepType>& proposed_steps, std::size_t first_index, StepType& executed_step)</tt>. If this is the case, the optional function calls this member function to re-evaluate the proposed steps from first_index on that are invalidated by the executed step, otherwise it does nothing.
+      template <class ConfigurationType, class StepType>
+      void optional_update_proposed_steps(ConfigurationType& configuration, std::vector<StepType>& proposed_steps, std::size_t first_index, StepType& executed_step);
+
+      //! Checks whether the given ConfigurationType has the member function <tt>void all_steps(std::vector<StepType>& steps)</tt>. If this is the case, the optional function calls this member function to fill the given vector with all possible steps (reusing its memory), otherwise the result of <tt>all_steps()</tt> is assigned to the vector.
+      template <class ConfigurationType, class StepType>
+      void optional_all_steps(ConfigurationType& configuration, std::vector<StepType>& steps);
+
+      //! Checks whether the given ConfigurationType has the member function <tt>void prepare_cluster_update(RandomNumberGenerator* rng)</tt>. If this is the case, the optional function calls this member function before a cluster is built (e.g. to choose the random reflection of a continuous spin model), otherwise it does nothing.
+      template <class ConfigurationType, class RandomNumberGenerator>
+      void optional_prepare_cluster_update(ConfigurationType& configuration, RandomNumberGenerator* rng);
+
+      //! Checks whether the given StepType has the member function <tt>std::size_t step_type()</tt>. If this is the case, the optional function returns the value of this member function (used to resolve the acceptance statistics by the type of the steps), otherwise it returns 0.
+      template <class StepType>
+      std::size_t optional_step_type(StepType& step);
+
+      //! Checks whether the given ConfigurationType has the member functions <tt>double get_proposal_width(std::size_t step_type)</tt> and <tt>void set_proposal_width(std::size_t step_type, double width)</tt>. If this is the case, the optional function returns the width of the proposed steps of the given type, otherwise it returns 0.0.
+      template <class ConfigurationType>
+      double optional_get_proposal_width(ConfigurationType& configuration, std::size_t step_type);
+
+      //! Checks whether the given ConfigurationType has the member function <tt>void set_proposal_width(std::size_t step_type, double width)</tt>. If this is the case, the optional function sets the width of the proposed steps of the given type (used to tune the proposals of continuous models), otherwise it does nothing.
+      template <class ConfigurationType>
+      void optional_set_proposal_width(ConfigurationType& configuration, std::size_t step_type, double width);
+
+      //! Checks whether the given RandomNumberGenerator has the member functions <tt>std::string get_state() const</tt> and <tt>void set_state(const std::string& state)</tt>. If this is the case, the optional function returns the state of the generator, otherwise it returns an empty string.
+      template <class RandomNumberGenerator>
+      std::string optional_get_state(RandomNumberGenerator& rng);
+
+      //! Checks whether the given RandomNumberGenerator has the member function <tt>void set_state(const std::string& state)</tt>. If this is the case and the given state is not empty, the optional function restores the state of the generator, otherwise it does nothing.
+      template <class RandomNumberGenerator>
+      void optional_set_state(RandomNumberGenerator& rng, const std::string& state);
 #endif
     };
   }
@@ -0,0 +1,142 @@
+/*!
+  \file rate_tree.hpp
+
+  \brief File containing a Fenwick tree for storing and sampling the rates of the steps of a rejection-free simulation
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_REJECTION_FREE_RATE_TREE_HPP
+#define MOCASINNS_DETAILS_REJECTION_FREE_RATE_TREE_HPP
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace RejectionFree
+    {
+      //! Class storing non-negative rates in a Fenwick tree (binary indexed tree)
+      /*!
+	\details Changing a single rate, calculating the total rate and selecting the index belonging to a cumulated rate are done in \f$ O(\log N) \f$.
+	Since the partial sums are updated with differences of the rates, rounding errors would accumulate. Therefore the tree is rebuilt from the single rates after as many updates as the tree has entries, which costs \f$ O(1) \f$ per update on average. Between the rebuilds the total rate may be a tiny positive number although all rates vanish, use reliable_total() to decide whether there is a step with positive rate.
+      */
+      class RateTree
+      {
+      public:
+	//! Standard constructor, creates an empty tree
+	RateTree() : rates(), tree(), updates_since_rebuild(0), updated_rates_sum(0.0) {}
+
+	//! Resize the tree to the given number of entries and set all rates to 0
+	void assign(std::size_t size)
+	{
+	  rates.assign(size, 0.0);
+	  tree.assign(size + 1, 0.0);
+	  updates_since_rebuild = 0;
+	  updated_rates_sum = 0.0;
+	}
+
+	//! Get-accessor for the number of entries of the tree
+	std::size_t size() const { return rates.size(); }
+	//! Get-accessor for the rate at the given index
+	double get_rate(std::size_t index) const { return rates[index]; }
+
+	//! Set the rate at the given index without updating the partial sums, rebuild() must be called afterwards
+	void set_rate_lazy(std::size_t index, double rate) { rates[index] = rate; }
+	//! Set the rate at the given index and update the partial sums
+	void set_rate(std::size_t index, double rate)
+	{
+	  const double difference = rate - rates[index];
+	  rates[index] = rate;
+	  updated_rates_sum += std::fabs(difference);
+	  if (++updates_since_rebuild > rates.size())
+	  {
+	    rebuild();
+	    return;
+	  }
+	  for (std::size_t i = index + 1; i < tree.size(); i += i & (~i + 1))
+	    tree[i] += difference;
+	}
+
+	//! Calculate all partial sums from the single rates in \f$ O(N) \f$
+	void rebuild()
+	{
+	  tree.assign(rates.size() + 1, 0.0);
+	  for (std::size_t i = 1; i < tree.size(); ++i)
+	  {
+	    tree[i] += rates[i - 1];
+	    const std::size_t parent = i + (i & (~i + 1));
+	    if (parent < tree.size()) tree[parent] += tree[i];
+	  }
+	  updates_since_rebuild = 0;
+	  updated_rates_sum = 0.0;
+	}
+
+	//! Calculate the sum of all rates
+	double total() const
+	{
+	  double result = 0.0;
+	  for (std::size_t i = rates.size(); i > 0; i -= i & (~i + 1))
+	    result += tree[i];
+	  return result;
+	}
+
+	//! Calculate the sum of all rates, rebuilds the tree if the sum is not larger than the rounding errors of the updates since the last rebuild
+	/*!
+	  \details If all rates vanish, the returned sum is exactly 0, so a positive result guarantees that find() returns an entry with positive rate.
+	*/
+	double reliable_total()
+	{
+	  const double result = total();
+	  if (result > rounding_error()) return result;
+	  rebuild();
+	  return total();
+	}
+
+	//! Find the index of the entry whose interval of cumulated rates contains the given value
+	/*!
+	  \details Returns the smallest index for which the sum of the rates up to and including this index is larger than the value. Entries with vanishing rates are never returned unless the value is not smaller than the total rate, in which case the last index is returned.
+	*/
+	std::size_t find(double value) const
+	{
+	  std::size_t position = 0;
+	  std::size_t bit = 1;
+	  while (bit * 2 < tree.size()) bit *= 2;
+	  for (; bit > 0; bit /= 2)
+	  {
+	    if (position + bit < tree.size() && tree[position + bit] <= value)
+	    {
+	      position += bit;
+	      value -= tree[position];
+	    }
+	  }
+	  return position < rates.size() ? position : (rates.empty() ? 0 : rates.size() - 1);
+	}
+
+      private:
+	//! Upper bound of the rounding error of the partial sums accumulated by the updates since the last rebuild
+	double rounding_error() const
+	{
+	  unsigned int levels = 1;
+	  for (std::size_t i = tree.size(); i > 1; i /= 2) ++levels;
+	  return levels * std::numeric_limits<double>::epsilon() * updated_rates_sum;
+	}
+
+	//! Single rates of the entries
+	std::vector<double> rates;
+	//! Partial sums of the Fenwick tree, the entry 0 is not used
+	std::vector<double> tree;
+	//! Number of calls of set_rate since the last rebuild
+	std::size_t updates_since_rebuild;
+	//! Sum of the absolute differences of the rates updated since the last rebuild
+	double updated_rates_sum;
+      };
+    }
+  }
+}
+
+#endif
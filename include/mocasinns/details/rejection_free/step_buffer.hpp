@@ -0,0 +1,57 @@
+/*!
+  \file step_buffer.hpp
+
+  \brief File containing the buffers for the steps and the acceptance probability parameters of the rejection-free simulations
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_REJECTION_FREE_STEP_BUFFER_HPP
+#define MOCASINNS_DETAILS_REJECTION_FREE_STEP_BUFFER_HPP
+
+#include <vector>
+
+#include <boost/any.hpp>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace RejectionFree
+    {
+      //! Buffers for all steps of a configuration and the acceptance probability parameters belonging to the steps
+      template <class StepType, class ParameterType>
+      struct StepBuffer
+      {
+	//! All steps of the configuration
+	std::vector<StepType> steps;
+	//! Acceptance probability parameters after the calculation of the acceptance probabilities of the steps
+	std::vector<ParameterType> parameters;
+      };
+
+      //! Class owning the step buffer of a simulation, whose step type is only known to the member functions doing the steps
+      /*!
+	\details The buffer is created by the first call of get() and reused by all further calls with the same types, so the vectors keep their capacity between the calls of Simulation::do_steps.
+      */
+      class StepBufferHolder
+      {
+      public:
+	//! Get the buffer for the given step and parameter types, replaces a buffer of different types
+	template <class StepType, class ParameterType>
+	StepBuffer<StepType, ParameterType>& get()
+	{
+	  StepBuffer<StepType, ParameterType>* buffer = boost::any_cast<StepBuffer<StepType, ParameterType> >(&holder);
+	  if (buffer) return *buffer;
+	  holder = StepBuffer<StepType, ParameterType>();
+	  return *boost::any_cast<StepBuffer<StepType, ParameterType> >(&holder);
+	}
+
+      private:
+	//! Type-erased buffer
+	boost::any holder;
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*!
+  \file step_classes.hpp
+
+  \brief File containing the membership lists of the step classes of the n-fold way (Bortz-Kalos-Lebowitz) algorithm
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_REJECTION_FREE_STEP_CLASSES_HPP
+#define MOCASINNS_DETAILS_REJECTION_FREE_STEP_CLASSES_HPP
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstddef>
+
+#include <boost/typeof/typeof.hpp>
+#include <boost/utility/declval.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+
+#include "../optional_member_functions.hpp"
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace RejectionFree
+    {
+      //! Trait for the type of the energy difference returned by StepType::delta_E()
+      template <class StepType>
+      struct step_energy_difference
+      {
+	typedef BOOST_TYPEOF_TPL(boost::declval<StepType&>().delta_E()) delta_E_result_type;
+	typedef typename boost::remove_cv<typename boost::remove_reference<delta_E_result_type>::type>::type type;
+      };
+
+      //! Trait deciding whether the rejection-free algorithm groups the steps in classes of equal energy difference (n-fold way). Defaults to true for integral energy differences of steps without selection probability factor, specialise it for own discrete energy types.
+      template <class StepType>
+      struct use_step_classes
+	: public boost::integral_constant<bool, boost::is_integral<typename step_energy_difference<StepType>::type>::value
+					  && !has_function_selection_probability_factor<StepType, double>::value> {};
+
+      //! Class storing the membership lists of steps grouped in classes of equal keys
+      /*!
+	\details Every step is identified by its index and belongs to exactly one class. Moving a step to another class costs \f$ O(\log C) \f$ for C classes, the classes are never removed and keep their index.
+	\tparam KeyType Type of the keys identifying the classes, must be comparable with operator<
+      */
+      template <class KeyType>
+      class StepClasses
+      {
+      public:
+	//! Standard constructor, creates an empty set of classes
+	StepClasses() : class_indices(), class_keys(), class_members(), step_class(), step_position() {}
+
+	//! Remove all classes and prepare for the given number of steps that are not yet assigned to a class
+	void assign(std::size_t step_number)
+	{
+	  class_indices.clear();
+	  class_keys.clear();
+	  class_members.clear();
+	  step_class.assign(step_number, not_assigned());
+	  step_position.assign(step_number, 0);
+	}
+
+	//! Get-accessor for the number of classes (including empty ones)
+	std::size_t size() const { return class_keys.size(); }
+	//! Get-accessor for the key of the class with the given index
+	const KeyType& key(std::size_t class_index) const { return class_keys[class_index]; }
+	//! Get-accessor for the number of steps in the class with the given index
+	std::size_t class_size(std::size_t class_index) const { return class_members[class_index].size(); }
+	//! Get-accessor for the index of the step at the given position in the class with the given index
+	std::size_t member(std::size_t class_index, std::size_t position) const { return class_members[class_index][position]; }
+
+	//! Put the step with the given index into the class with the given key, removing it from its previous class
+	void set_class(std::size_t step_index, const KeyType& class_key)
+	{
+	  // Find or create the new class
+	  typename std::map<KeyType, std::size_t>::iterator class_it = class_indices.find(class_key);
+	  if (class_it == class_indices.end())
+	  {
+	    class_it = class_indices.insert(std::make_pair(class_key, class_keys.size())).first;
+	    class_keys.push_back(class_key);
+	    class_members.push_back(std::vector<std::size_t>());
+	  }
+	  const std::size_t new_class = class_it->second;
+	  if (step_class[step_index] == new_class) return;
+
+	  // Remove the step from the old class by moving the last member to its position
+	  if (step_class[step_index] != not_assigned())
+	  {
+	    std::vector<std::size_t>& old_members = class_members[step_class[step_index]];
+	    const std::size_t moved_step = old_members.back();
+	    old_members[step_position[step_index]] = moved_step;
+	    step_position[moved_step] = step_position[step_index];
+	    old_members.pop_back();
+	  }
+
+	  // Append the step to the new class
+	  step_class[step_index] = new_class;
+	  step_position[step_index] = class_members[new_class].size();
+	  class_members[new_class].push_back(step_index);
+	}
+
+      private:
+	//! Map from the keys to the indices of the classes
+	std::map<KeyType, std::size_t> class_indices;
+	//! Keys of the classes
+	std::vector<KeyType> class_keys;
+	//! Indices of the steps belonging to the classes
+	std::vector<std::vector<std::size_t> > class_members;
+	//! Index of the class of every step
+	std::vector<std::size_t> step_class;
+	//! Position of every step in the member list of its class
+	std::vector<std::size_t> step_position;
+
+	//! Class index of steps that are not yet assigned to a class
+	static std::size_t not_assigned() { return static_cast<std::size_t>(-1); }
+      };
+    }
+  }
+}
+
+#endif
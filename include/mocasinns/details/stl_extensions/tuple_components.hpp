@@ -0,0 +1,82 @@
+/*!
+  \file tuple_components.hpp
+
+  \brief Component-wise operations on the entries of STL-tuples, used by TupleObservable and TupleAccumulator
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_DETAILS_STL_EXTENSIONS_TUPLE_COMPONENTS_HPP
+#define MOCASINNS_DETAILS_STL_EXTENSIONS_TUPLE_COMPONENTS_HPP
+
+#include <tuple>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <cstddef>
+
+namespace Mocasinns
+{
+  namespace Details
+  {
+    namespace STL_Extensions
+    {
+      //! Recursion over the components I, ..., N-1 of tuples, applying an operation to every component
+      template <std::size_t I, std::size_t N>
+      struct TupleComponents
+      {
+	//! Add the components of rhs to the components of lhs
+	template <class Tuple> static void add(Tuple& lhs, const Tuple& rhs) { std::get<I>(lhs) += std::get<I>(rhs); TupleComponents<I+1,N>::add(lhs, rhs); }
+	//! Substract the components of rhs from the components of lhs
+	template <class Tuple> static void substract(Tuple& lhs, const Tuple& rhs) { std::get<I>(lhs) -= std::get<I>(rhs); TupleComponents<I+1,N>::substract(lhs, rhs); }
+	//! Multiply the components of lhs with the components of rhs
+	template <class Tuple> static void multiply(Tuple& lhs, const Tuple& rhs) { std::get<I>(lhs) *= std::get<I>(rhs); TupleComponents<I+1,N>::multiply(lhs, rhs); }
+	//! Divide the components of lhs by the components of rhs
+	template <class Tuple> static void divide(Tuple& lhs, const Tuple& rhs) { std::get<I>(lhs) /= std::get<I>(rhs); TupleComponents<I+1,N>::divide(lhs, rhs); }
+	//! Multiply all components with a scalar
+	template <class Tuple, class S> static void scale(Tuple& lhs, const S& rhs) { std::get<I>(lhs) *= rhs; TupleComponents<I+1,N>::scale(lhs, rhs); }
+	//! Divide all components by a scalar
+	template <class Tuple, class S> static void shrink(Tuple& lhs, const S& rhs) { std::get<I>(lhs) /= rhs; TupleComponents<I+1,N>::shrink(lhs, rhs); }
+	//! Exponentiate all components of base with a scalar and store them in result, pow is looked up by argument dependent lookup for observables of the library
+	template <class Tuple, class S> static void power(Tuple& result, const Tuple& base, const S& exponent)
+	{
+	  using std::pow;
+	  std::get<I>(result) = pow(std::get<I>(base), exponent);
+	  TupleComponents<I+1,N>::power(result, base, exponent);
+	}
+	//! Write all components to a stream (seperated by spaces)
+	template <class Tuple> static void write(std::ostream& stream, const Tuple& tuple)
+	{
+	  stream << std::get<I>(tuple);
+	  if (I + 1 < N) stream << " ";
+	  TupleComponents<I+1,N>::write(stream, tuple);
+	}
+	//! Read all components from a stream
+	template <class Tuple> static void read(std::istream& stream, Tuple& tuple) { stream >> std::get<I>(tuple); TupleComponents<I+1,N>::read(stream, tuple); }
+	//! Serialize all components
+	template <class Archive, class Tuple> static void serialize(Archive& ar, Tuple& tuple) { ar & std::get<I>(tuple); TupleComponents<I+1,N>::serialize(ar, tuple); }
+	//! Pass every component of the tuple of values to the operator() of the corresponding element of the tuple of functors
+	template <class FunctorTuple, class Tuple> static void dispatch(FunctorTuple& functors, const Tuple& values) { std::get<I>(functors)(std::get<I>(values)); TupleComponents<I+1,N>::dispatch(functors, values); }
+      };
+
+      //! End of the recursion over the components of tuples
+      template <std::size_t N>
+      struct TupleComponents<N,N>
+      {
+	template <class Tuple> static void add(Tuple&, const Tuple&) {}
+	template <class Tuple> static void substract(Tuple&, const Tuple&) {}
+	template <class Tuple> static void multiply(Tuple&, const Tuple&) {}
+	template <class Tuple> static void divide(Tuple&, const Tuple&) {}
+	template <class Tuple, class S> static void scale(Tuple&, const S&) {}
+	template <class Tuple, class S> static void shrink(Tuple&, const S&) {}
+	template <class Tuple, class S> static void power(Tuple&, const Tuple&, const S&) {}
+	template <class Tuple> static void write(std::ostream&, const Tuple&) {}
+	template <class Tuple> static void read(std::istream&, Tuple&) {}
+	template <class Archive, class Tuple> static void serialize(Archive&, Tuple&) {}
+	template <class FunctorTuple, class Tuple> static void dispatch(FunctorTuple&, const Tuple&) {}
+      };
+    }
+  }
+}
+
+#endif
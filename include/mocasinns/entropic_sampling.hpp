@@ -103,6 +103,10 @@ namespace Mocasinns
     void set_incidence_counter(const HistoType<EnergyType, incidence_counter_y_value_t>& value) { incidence_counter = value; }
     //! Get-Accessor for the current flatness
     const double& get_flatness_current() const { return flatness_current; }
+    //! Set-Accessor for the pointer to the configuration space, the energy of the new configuration is calculated at the next call of the step functions
+    void set_config_space(ConfigurationType* value) { this->configuration_space = value; tracked_energy_valid = false; }
+    //! Notify the simulation that the configuration was changed outside of the step functions (e.g. through get_config_space()), the energy is calculated again at the next call of the step functions
+    void invalidate_tracked_energy() { tracked_energy_valid = false; }
 
     //! Calculate the acceptance probability of a step
     double acceptance_probability(StepType& step_to_execute, Details::Multicanonical::StepParameter<EnergyType>& step_parameters);
@@ -139,6 +143,14 @@ namespace Mocasinns
 
     //! Current value of the flatness of the incidence counter
     double flatness_current;
+
+    //! Energy of the configuration after the last call of do_entropic_sampling_steps, used for the next call if Parameters::track_energy is set
+    EnergyType tracked_energy;
+    //! Flag indicating whether the tracked energy is the energy of the actual configuration
+    bool tracked_energy_valid;
+
+    //! Apply the coalesced rejected steps at the current energy to the incidence counter
+    void apply_rejected_steps(Details::Multicanonical::StepParameter<EnergyType>& step_parameters);
     
     friend class boost::serialization::access;
     //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
@@ -146,6 +158,8 @@ namespace Mocasinns
     {
       // serialize base class information
       ar & boost::serialization::base_object<Simulation<ConfigurationType, RandomNumberGenerator> >(*this);
+      // The loaded configuration replaces the actual one, its energy is calculated again at the next call of the step functions
+      if (Archive::is_loading::value) tracked_energy_valid = false;
       ar & simulation_parameters;
       ar & log_density_of_states;
       ar & incidence_counter;
@@ -0,0 +1,21 @@
+#ifndef MOCASINNS_EXCEPTIONS_CHECKPOINT_EXCEPTION_HPP
+#define MOCASINNS_EXCEPTIONS_CHECKPOINT_EXCEPTION_HPP
+
+#include "mocasinns_exception.hpp"
+
+namespace Mocasinns
+{
+  namespace Exceptions
+  {
+    //! Class for an exception occuring if a checkpoint file cannot be written
+    struct CheckpointException : public MocasinnsException
+    {
+      //! Default constructor for a general message
+      CheckpointException() : MocasinnsException("The checkpoint could not be written.") { }
+      //! Constructor storing the message of the exception
+      CheckpointException(std::string exception_message) : MocasinnsException(exception_message) { }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*!
+  \file hooks.hpp
+
+  \brief Hook policies of the simulations, called at fixed points of the simulation loops
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_HOOKS_HOOKS_HPP
+#define MOCASINNS_HOOKS_HOOKS_HPP
+
+namespace Mocasinns
+{
+  namespace Hooks
+  {
+    //! Hook policy in which every hook does nothing
+    /*!
+      \details The hooks are empty inline member functions, so a simulation using this policy contains no code at all for them. Own policies can be derived from this class and hide only the hooks they need, e.g.
+      \code
+      struct CountMeasurements : public Mocasinns::Hooks::NoHooks
+      {
+        unsigned int count;
+        CountMeasurements() : count(0) {}
+        template <class SimulationType> void measurement(SimulationType*) { ++count; }
+      };
+      \endcode
+      The policy object of a simulation is accessible by its <tt>get_hooks()</tt> member function.
+    */
+    struct NoHooks
+    {
+      //! Hook called at every measurement of Metropolis and ParallelTempering
+      template <class SimulationType> void measurement(SimulationType*) {}
+      //! Hook called after every sweep of WangLandau
+      template <class SimulationType> void sweep(SimulationType*) {}
+      //! Hook called when WangLandau lowers the modification factor
+      template <class SimulationType> void modfac_change(SimulationType*) {}
+      //! Hook called after every replica exchange of ParallelTempering
+      template <class SimulationType> void replica_exchange(SimulationType*) {}
+    };
+
+    //! Hook policy forwarding every hook to the corresponding boost::signals2 signal handler of the simulation
+    /*!
+      \details This is the default policy of the simulations and keeps the signal handlers working. Invoking a boost::signals2 signal locks a mutex and walks the list of slots even if no slot is connected, so simulations with fine-grained measurements or frequent replica exchanges should use NoHooks or an own policy derived from it instead.
+    */
+    struct SignalHooks
+    {
+      //! Invoke the signal_handler_measurement of the simulation
+      template <class SimulationType> void measurement(SimulationType* simulation) { simulation->signal_handler_measurement(simulation); }
+      //! Invoke the signal_handler_sweep of the simulation
+      template <class SimulationType> void sweep(SimulationType* simulation) { simulation->signal_handler_sweep(simulation); }
+      //! Invoke the signal_handler_modfac_change of the simulation
+      template <class SimulationType> void modfac_change(SimulationType* simulation) { simulation->signal_handler_modfac_change(simulation); }
+      //! Invoke the signal_handler_replica_exchange of the simulation
+      template <class SimulationType> void replica_exchange(SimulationType* simulation) { simulation->signal_handler_replica_exchange(simulation); }
+    };
+  }
+}
+
+#endif
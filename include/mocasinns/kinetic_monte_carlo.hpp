@@ -0,0 +1,199 @@
+/**
+ * \file kinetic_monte_carlo.hpp
+ * \brief Class for continuous-time kinetic Monte-Carlo simulations
+ *
+ * Executes events chosen according to their physical rates, advances a physical clock and measures observables at fixed physical times.
+ *
+ * \author Benedikt Krüger
+ */
+
+#ifndef MOCASINNS_KINETIC_MONTE_CARLO_HPP
+#define MOCASINNS_KINETIC_MONTE_CARLO_HPP
+
+#include "simulation.hpp"
+#include "concepts/concepts.hpp"
+#include "details/rejection_free/rate_tree.hpp"
+#include "hooks/hooks.hpp"
+
+// Boost serialization for derived classes
+#include <boost/serialization/base_object.hpp>
+
+// Boost function types for the standard observable
+#include <boost/function_types/result_type.hpp>
+#include <boost/typeof/std/utility.hpp>
+#include <boost/type_traits.hpp>
+
+namespace Mocasinns
+{
+
+//! Class for continuous-time kinetic Monte-Carlo simulations (residence time algorithm)
+/*!
+ * \details In contrast to the other simulations, the steps (events) of a kinetic Monte-Carlo simulation are not accepted with an acceptance probability but occur with a physical rate \f$ r_i \f$ (events per unit of physical time). In every step one event is chosen with probability \f$ r_i / R \f$, where \f$ R = \sum_i r_i \f$ is the total rate, and executed, and the physical clock is advanced by the exponentially distributed waiting time
+ * \f[
+ *    \Delta t = -\frac{\ln(1 - u)}{R}
+ * \f]
+ * with a uniform random number \f$ u \in [0,1) \f$. The rates of all events are stored in a Fenwick tree (Details::RejectionFree::RateTree), so choosing an event and changing a rate costs \f$ O(\log N) \f$ for N events.
+ *
+ * The ConfigurationType must provide the function <tt>all_steps(std::vector<StepType>& steps)</tt> (or <tt>std::vector<StepType> all_steps()</tt>) enumerating all possible events. The events are enumerated once at the beginning of every call of do_kinetic_steps(), do_kinetic_time() and do_kinetic_monte_carlo_simulation(), the event at a given index must always denote the same move evaluated on the actual configuration (as for the incremental rejection-free algorithm of Simulation::do_steps). If the configuration provides <tt>affected_steps(StepType& executed_step, std::vector<std::size_t>& indices)</tt>, only the rates of the events whose indices are appended by this function are recalculated after an event, otherwise the rates of all events are recalculated.
+ *
+ * The StepType must fulfill the Concepts::KineticStepConcept, i.e. provide
+ * - <tt>double rate()</tt>: Non-negative physical rate of the event in the actual configuration (events with rate 0 never occur)
+ * - <tt>void execute()</tt>: Execute the event
+ *
+ * To perform a kinetic Monte-Carlo simulation, use one of the \c KineticMonteCarlo::do_kinetic_monte_carlo_simulation() functions. After a relaxation time the observables are measured in fixed intervals of the physical time, the configuration measured at the physical time \f$ t \f$ is the one after the last event before \f$ t \f$. Since the waiting times are memoryless, the waiting time that would cross a measurement time is discarded and drawn again from the measurement time on, which does not change the dynamics.
+ *
+ * \signalhandlers
+ * \signalhandler{signal_handler_measurement,This handler is called before every measurement.}
+ * \signalhandler{signal_handler_sig...., The check for <tt>POSIX</tt> signals (<tt>SIGTERM</tt>\, <tt>SIGUSR1</tt> and <tt>SIGUSR2</tt>) after every measurment.}
+ * \endsignalhandlers
+ *
+ * \tparam ConfigurationType Class providing the function <tt>all_steps</tt> and optionally <tt>affected_steps</tt>
+ * \tparam StepType Class fulfilling the Concepts::KineticStepConcept
+ * \tparam RandomNumberGenerator \concept{RandomNumberGenerator}
+ * \tparam HookPolicy Class providing the hook <tt>measurement(SimulationType*)</tt>, see Hooks::NoHooks
+ *
+ * \references
+ * \reference{1, Bortz A. B.\, Kalos M. H. and Lebowitz J. L.\, J. Comput. Phys. 17 (1975) 10}
+ * \reference{2, Gillespie D. T.\, J. Comput. Phys. 22 (1976) 403}
+ * \endreferences
+ */
+template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy = Hooks::SignalHooks>
+class KineticMonteCarlo : public Simulation<ConfigurationType, RandomNumberGenerator>
+{
+  // Check the kinetic step concept
+  BOOST_CONCEPT_ASSERT((Concepts::KineticStepConcept<StepType>));
+  // Check the random number generator concept
+  BOOST_CONCEPT_ASSERT((Concepts::RandomNumberGeneratorConcept<RandomNumberGenerator>));
+
+public:
+  // Typedef for the base class
+  typedef Simulation<ConfigurationType, RandomNumberGenerator> Base;
+  // Typedefs for integers
+  typedef typename Base::step_number_t step_number_t;
+  typedef uint32_t measurement_number_t;
+
+  // Forward declaration of the parameters used for a kinetic Monte-Carlo simulation
+  struct Parameters;
+
+  //! Standard class for observing the energy of the system
+  struct ObserveEnergy
+  {
+    typedef BOOST_TYPEOF(&ConfigurationType::energy) energy_function_type;
+    typedef typename boost::function_types::result_type<energy_function_type>::type observable_type;
+    static observable_type observe(ConfigurationType* config) { return config->energy(); }
+  };
+  //! Typedef for the default observable
+  typedef typename KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::ObserveEnergy DefaultObservator;
+
+  //! Boost signal handler invoked before every measurement
+  boost::signals2::signal<void (Simulation<ConfigurationType,RandomNumberGenerator>*)> signal_handler_measurement;
+
+  //! Initialise a kinetic MC simulation with default configuration space and default Parameters
+  KineticMonteCarlo() : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(), physical_time(0.0) {}
+  //! Initialise a kinetic MC simulation with default configuration space and given Parameters
+  KineticMonteCarlo(const Parameters& params) : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(params), physical_time(0.0) {}
+  //! Initialise a kinetic MC simulation with given parameters and given configuration space
+  KineticMonteCarlo(const Parameters& params, ConfigurationType* initial_configuration) : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), simulation_parameters(params), physical_time(0.0) {}
+
+  //! Get-accessor for the hook policy object
+  HookPolicy& get_hooks() { return hooks; }
+
+  //! Get-accessor for the parameters of the kinetic MC simulation
+  const Parameters& get_simulation_parameters() { return simulation_parameters; }
+  //! Set-accessor for the parameters of the kinetic MC simulation
+  void set_parameters(const Parameters& value) { simulation_parameters = value; }
+
+  //! Get-accessor for the physical time of the simulation
+  double get_physical_time() const { return physical_time; }
+  //! Set-accessor for the physical time of the simulation
+  void set_physical_time(double value) { physical_time = value; }
+  //! Get-accessor for the total rate of all events after the last call of a step function
+  double get_total_rate() const { return event_rates.total(); }
+
+  //! Execute the given number of events, returns the number of executed events (smaller if the total rate vanishes)
+  step_number_t do_kinetic_steps(const step_number_t& number);
+  //! Execute events until the physical clock has advanced by the given duration
+  void do_kinetic_time(double duration);
+
+  //! Execute a kinetic MC simulation, returns the observables measured at equidistant physical times
+  template<class Observator = DefaultObservator>
+  std::vector<typename Observator::observable_type> do_kinetic_monte_carlo_simulation();
+  //! Execute a kinetic MC simulation using the given accumulator for the observables measured at equidistant physical times
+  template<class Observator, class Accumulator>
+  void do_kinetic_monte_carlo_simulation(Accumulator& measurement_accumulator);
+
+  //! Load the data of the kinetic MC simulation from a serialization stream
+  virtual void load_serialize(std::istream& input_stream) { Base::load_serialize(*this, input_stream); }
+  //! Load the data of the kinetic MC simulation from a serialization file
+  virtual void load_serialize(const char* filename) { Base::load_serialize(*this, filename); }
+  //! Save the data of the kinetic MC simulation to a serialization stream
+  virtual void save_serialize(std::ostream& output_stream) const { Base::save_serialize(*this, output_stream); }
+  //! Save the data of the kinetic MC simulation to a serialization file
+  virtual void save_serialize(const char* filename) const { Base::save_serialize(*this, filename); }
+
+private:
+  //! Member variable storing the parameters of the simulation
+  Parameters simulation_parameters;
+  //! Hook policy object invoked before every measurement
+  HookPolicy hooks;
+  //! Physical time of the simulation
+  double physical_time;
+
+  //! All events of the configuration
+  std::vector<StepType> events;
+  //! Rates of the events
+  Details::RejectionFree::RateTree event_rates;
+  //! Buffer for the indices of the events affected by an executed event
+  std::vector<std::size_t> affected_indices;
+
+  //! Enumerate all events of the configuration and calculate their rates
+  void initialise_events();
+  //! Draw the waiting time until the next event and the index of the next event, returns false if the total rate vanishes
+  bool choose_event(double& waiting_time, std::size_t& event_index);
+  //! Execute the event with the given index and update the rates
+  void execute_event(std::size_t event_index);
+  //! Execute the events occuring before the given physical time and set the physical time to it
+  void advance_physical_time(double end_time);
+
+  //! \cond
+  template <bool incremental_rates>
+  typename boost::enable_if_c<!incremental_rates, void>::type // Recalculates the rates of all events
+  update_rates(std::size_t event_index);
+  template <bool incremental_rates>
+  typename boost::enable_if_c<incremental_rates, void>::type // Recalculates the rates of the affected events
+  update_rates(std::size_t event_index);
+  //! \endcond
+
+  //! Member variable for boost serialization
+  friend class boost::serialization::access;
+  //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
+  template<class Archive> void serialize(Archive & ar, const unsigned int)
+  {
+    // serialize base class information
+    ar & boost::serialization::base_object<Simulation<ConfigurationType, RandomNumberGenerator> >(*this);
+    ar & physical_time;
+  }
+};
+
+//! Struct storing the parameters of a kinetic Monte-Carlo Simulation
+template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+struct KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::Parameters
+{
+  //! Physical time to simulate before the first measurement
+  double relaxation_time;
+  //! Number of measurements
+  measurement_number_t measurement_number;
+  //! Physical time between two measurements
+  double time_between_measurement;
+
+  //! Standard constructor for setting default values
+  Parameters() : relaxation_time(100.0),
+		 measurement_number(100),
+		 time_between_measurement(1.0) {}
+};
+
+} // of namespace Mocasinns
+
+#include "src/kinetic_monte_carlo.cpp"
+
+#endif
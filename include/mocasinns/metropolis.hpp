@@ -11,6 +11,17 @@
 
 #include "simulation.hpp"
 #include "concepts/concepts.hpp"
+#include "details/metropolis/acceptance_table.hpp"
+#include "details/metropolis/multi_spin.hpp"
+#include "details/metropolis/tracked_energy_parameter.hpp"
+#include "details/metropolis/measurement_pipeline.hpp"
+#include "details/metropolis/equilibration_detector.hpp"
+#include "details/metropolis/measurement_spacing.hpp"
+#include "details/metropolis/precision_monitor.hpp"
+#include "details/metropolis/proposal_tuner.hpp"
+#include "hooks/hooks.hpp"
+
+#include <atomic>
 
 // Boost serialization for derived classes
 #include <boost/serialization/base_object.hpp>
@@ -52,6 +63,48 @@ namespace Mocasinns
    * - <tt>do_metropolis_simulation<Observator>(TemperatureType inverse_temperature, Accumulator& measurement_accumulator)</tt>: Do a Metropolis simulation for a single temperature and accumulate the measured observables in a given accumulator (that fulfills the \ref concept-Accumulator "Accumulator concept"). This can be used e.g. for calculating the mean and the variance of the observables without storing the single measurement results.
    * - <tt>do_metropolis_simulation<Observator>(TemperatureType inverse_temperature, Accumulator& measurement_accumulator)</tt>: Do a Metropolis simulation for a single temperature and accumulate the measured observables in a given accumulator (that fulfills the \ref concept-Accumulator "Accumulator concept"). This can be used e.g. for calculating the mean and the variance of the observables without storing the single measurement results.
    *
+   * If Parameters::sublattice_thread_number is larger than 0 and the configuration declares a coloring of its sites,
+   * the (non rejection-free) Metropolis steps are performed with the sublattice decomposition described at do_metropolis_sublattice_steps().
+   * Otherwise, if Parameters::speculative_thread_number is larger than 0 and the steps declare their footprint on the configuration,
+   * windows of proposed steps are evaluated speculatively in parallel as described at do_metropolis_speculative_steps().
+   * If the steps are multi-spin coded (see Details::Metropolis::is_multi_spin_step), every step updates all replicas of the configuration
+   * independently as described at do_metropolis_multi_spin_steps().
+   *
+   * If Parameters::track_energy is set, the simulation tracks the total energy of the configuration by adding the energy differences of the executed steps
+   * to the energy calculated once at the beginning (see get_energy()). The energy is then neither calculated for the measurements with the default observator
+   * nor for the replica exchanges of ParallelTempering and SerialTempering. Observators can use the tracked energy by providing the static member function
+   * <tt>observable_type observe(ConfigurationType* config, const energy_type& energy)</tt> in addition to the function of the \ref concept-Observator "Observator concept".
+   * To bound the accumulation of rounding errors of continuous energies, the energy is calculated from scratch after Parameters::energy_recalculation_interval executed steps.
+   * The energy is not tracked by the sublattice decomposition and the multi-spin coded steps, it is calculated again when it is needed after them.
+   *
+   * If Parameters::measurement_thread_number is larger than 0, the measurements of do_metropolis_simulation() are taken asynchronously:
+   * The configuration is copied into one of Parameters::measurement_buffer_number reusable snapshots that are observed by background threads
+   * (see Details::Metropolis::MeasurementPipeline), while the Markov chain continues immediately. The accumulator receives the observables in the order of
+   * the measurements, so the results do not depend on the number of threads. The ConfigurationType must be copy-constructible and copy-assignable, the
+   * observator must be safe to call concurrently on different configurations, and the program must be linked with the thread library (e.g. <tt>-pthread</tt>).
+   *
+   * If Parameters::adaptive_measurement_spacing is set, the energy is sampled every Parameters::autocorrelation_sample_steps steps between the measurements
+   * and its integrated autocorrelation time is estimated online (see Details::Metropolis::MeasurementSpacing). After every measurement the number of steps
+   * until the next measurement is set to Parameters::measurement_spacing_fraction times this autocorrelation time, bounded by Parameters::minimal_steps_between_measurement
+   * and Parameters::maximal_steps_between_measurement. The samples are cheap if Parameters::track_energy is set, otherwise the energy is calculated for every sample.
+   *
+   * If Parameters::target_error is larger than 0, the measurements stop as soon as the binning estimate of the standard error of the mean of the designated observable
+   * (the observable itself or the first component of a TupleObservable, see Details::Metropolis::PrecisionMonitor) is not larger than the target error.
+   * Parameters::measurement_number is then the maximal number of measurements. Independent of the target error, the measurements stop after Parameters::step_budget steps.
+   *
+   * If Parameters::adaptive_proposal_tuning is set and the configuration provides the member functions <tt>double get_proposal_width(std::size_t step_type)</tt>
+   * and <tt>void set_proposal_width(std::size_t step_type, double width)</tt> (e.g. the maximal rotation angle of a continuous spin), the widths are tuned during
+   * the relaxation: After every Parameters::proposal_tuning_steps proposed steps of a type (see Statistics::AcceptanceStatistics for the types of the steps), its width is scaled
+   * towards Parameters::target_acceptance_rate (see Details::Metropolis::ProposalTuner). The widths are frozen before the measurements start, so the measurements fulfil detailed balance.
+   *
+   * If the energy differences of the steps are of an integral type (or of a type for which the trait
+   * <tt>Details::Metropolis::use_acceptance_table</tt> is specialised to be true), the acceptance probabilities
+   * are not calculated with <tt>exp</tt> for every step but looked up in a table of Boltzmann factors
+   * that is filled once per inverse temperature.
+   *
+   * The signal handlers are invoked by the hook policy HookPolicy. The default policy Hooks::SignalHooks forwards the hooks to the signal handlers,
+   * with Hooks::NoHooks (or an own policy derived from it) the signal handlers are not invoked and the unused hooks are removed by the compiler.
+   *
    * \signalhandlers
    * \signalhandler{signal_handler_measurement,This handler is called before every measurement.}
    * \signalhandler{signal_handler_sig...., The check for <tt>POSIX</tt> signals (<tt>SIGTERM</tt>\, <tt>SIGUSR1</tt> and <tt>SIGUSR2</tt>) after every measurment.}
@@ -60,13 +113,14 @@ namespace Mocasinns
    * \tparam ConfigurationType \concept{ConfigurationType}
    * \tparam StepType \concept{StepType}
    * \tparam RandomNumberGenerator \concept{RandomNumberGenerator}
+   * \tparam HookPolicy Class providing the hook <tt>measurement(SimulationType*)</tt>, see Hooks::NoHooks
    *
    * \references
    * \reference{1, Metropolis N. et al.\, J. Chem. Phys. 21 (1953) 1087}
    * \reference{2, Metropolis N. and Ulam S.\, J. Amer. Statist. Assoc. 44 (1949) 335}
    * \endreferences
    */
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator, bool rejection_free = false>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, bool rejection_free = false, class HookPolicy = Hooks::SignalHooks>
   class Metropolis : public Simulation<ConfigurationType, RandomNumberGenerator>
   {
     // Check the configuration concept
@@ -80,7 +134,7 @@ namespace Mocasinns
     // Typedef for the base class
     typedef Simulation<ConfigurationType, RandomNumberGenerator> Base;
     //! Typedef of this class
-    typedef Metropolis<ConfigurationType, StepType, RandomNumberGenerator, rejection_free> this_type;
+    typedef Metropolis<ConfigurationType, StepType, RandomNumberGenerator, rejection_free, HookPolicy> this_type;
     // Typedefs for integers
     typedef typename Base::step_number_t step_number_t;
     typedef uint32_t measurement_number_t;
@@ -95,25 +149,57 @@ namespace Mocasinns
       typedef typename boost::function_types::result_type<energy_function_type>::type observable_type;
       //    typedef typename boost::function_traits<energy_function_type>::result_type observable_type;
       static observable_type observe(ConfigurationType* config) { return config->energy(); }
+      //! Observe the energy known by the simulation (tracked or calculated) without calculating it again
+      static observable_type observe(ConfigurationType*, const observable_type& energy) { return energy; }
     };
     //! Typedef for the default observable
-    typedef typename Metropolis<ConfigurationType, StepType, RandomNumberGenerator, rejection_free>::ObserveEnergy DefaultObservator;
+    typedef typename Metropolis<ConfigurationType, StepType, RandomNumberGenerator, rejection_free, HookPolicy>::ObserveEnergy DefaultObservator;
+    //! Type of the energy of the configuration
+    typedef typename ObserveEnergy::observable_type energy_type;
     
     //! Boost signal handler invoked after every measurement
     boost::signals2::signal<void (Simulation<ConfigurationType,RandomNumberGenerator>*)> signal_handler_measurement;
+
+    //! The acceptance probability of a step depends only on the step, allows the incremental update of the rates in the rejection-free algorithm
+    static const bool local_acceptance_probability = true;
     
     //! Initialise a Metropolis-MC simulation with default configuration space and default Parameters
-    Metropolis() : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters() {}
+    Metropolis() : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(), acceptance_table(), tracked_energy(), tracked_energy_valid(false), executed_steps_since_energy_calculation(0), relaxation_steps_performed(0), measurement_spacing(), precision_monitor(), measurement_steps_performed(0), proposal_tuner(), proposal_tuning(false), proposal_tuning_collected_statistics(false) {}
     //! Initialise a Metropolis-MC simulation with default configuration space and given Parameters
-    Metropolis(const Parameters& params) : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(params) {}
+    Metropolis(const Parameters& params) : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(params), acceptance_table(), tracked_energy(), tracked_energy_valid(false), executed_steps_since_energy_calculation(0), relaxation_steps_performed(0), measurement_spacing(), precision_monitor(), measurement_steps_performed(0), proposal_tuner(), proposal_tuning(false), proposal_tuning_collected_statistics(false) {}
     //! Initialise a Metropolis-MC simulation with given parameters and given configuration space
     Metropolis(const Parameters& params, ConfigurationType* initial_configuration) 
       : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), 
-	simulation_parameters(params) {}
+	simulation_parameters(params),
+	acceptance_table(),
+	tracked_energy(),
+	tracked_energy_valid(false),
+	executed_steps_since_energy_calculation(0),
+	relaxation_steps_performed(0),
+	measurement_spacing(),
+	precision_monitor(),
+	measurement_steps_performed(0),
+	proposal_tuner(),
+	proposal_tuning(false),
+	proposal_tuning_collected_statistics(false) {}
     //! Initialise a Metropolis-MC simulation by copying from another one
     Metropolis(const Metropolis& other) 
       : Simulation<ConfigurationType, RandomNumberGenerator>(other.configuration_space),
-	simulation_parameters(other.simulation_parameters) {}
+	simulation_parameters(other.simulation_parameters),
+	acceptance_table(),
+	hooks(other.hooks),
+	tracked_energy(other.tracked_energy),
+	tracked_energy_valid(other.tracked_energy_valid),
+	executed_steps_since_energy_calculation(other.executed_steps_since_energy_calculation),
+	relaxation_steps_performed(other.relaxation_steps_performed),
+	measurement_spacing(other.measurement_spacing),
+	precision_monitor(other.precision_monitor),
+	measurement_steps_performed(other.measurement_steps_performed),
+	proposal_tuner(other.proposal_tuner),
+	proposal_tuning(false),
+	proposal_tuning_collected_statistics(false) {}
+    //! Destructor, deletes the random number generators of the sublattice threads
+    ~Metropolis() { sublattice_threads_clear(); }
     
     //! Assignment operator
     this_type& operator=(const Metropolis& other)
@@ -122,17 +208,57 @@ namespace Mocasinns
       {
 	this->configuration_space = other.get_config_space();
 	this->simulation_parameters = other.simulation_parameters;
+	this->hooks = other.hooks;
+	this->tracked_energy = other.tracked_energy;
+	this->tracked_energy_valid = other.tracked_energy_valid;
+	this->executed_steps_since_energy_calculation = other.executed_steps_since_energy_calculation;
+	this->relaxation_steps_performed = other.relaxation_steps_performed;
+	this->measurement_spacing = other.measurement_spacing;
+	this->precision_monitor = other.precision_monitor;
+	this->measurement_steps_performed = other.measurement_steps_performed;
+	this->proposal_tuner = other.proposal_tuner;
       }
       return *this;
     }
 
+    //! Get-accessor for the hook policy object
+    HookPolicy& get_hooks() { return hooks; }
+
     //! Get-accessor for the parameters of the Metropolis simulation
     const Parameters& get_simulation_parameters() { return simulation_parameters; }
     //! Set-accessor for the parameters of the Metropolis simulation
     void set_parameters(const Parameters& value) { simulation_parameters = value; }
+
+    //! Set-Accessor for the pointer to the configuration space, the energy of the new configuration is calculated when it is needed (the tuned proposal widths are applied if Parameters::adaptive_proposal_tuning is set)
+    void set_config_space(ConfigurationType* value) { this->configuration_space = value; tracked_energy_valid = false; apply_proposal_widths(); }
+    //! Set-Accessor for the pointer to the configuration space together with the known energy of the new configuration (the tuned proposal widths are applied if Parameters::adaptive_proposal_tuning is set)
+    void set_config_space(ConfigurationType* value, const energy_type& energy) { this->configuration_space = value; tracked_energy = energy; tracked_energy_valid = true; apply_proposal_widths(); }
+
+    //! Energy of the configuration, the tracked energy if Parameters::track_energy is set
+    energy_type get_energy();
+    //! Number of relaxation steps performed by the last relaxation (the detected relaxation time if Parameters::adaptive_relaxation is set)
+    step_number_t get_relaxation_steps_performed() const { return relaxation_steps_performed; }
+    //! Number of steps between two measurements, adapted to the autocorrelation time if Parameters::adaptive_measurement_spacing is set
+    step_number_t get_steps_between_measurement() const { return simulation_parameters.adaptive_measurement_spacing ? measurement_spacing.get_steps_between_measurement() : simulation_parameters.steps_between_measurement; }
+    //! Estimate of the integrated autocorrelation time of the energy in units of steps during the last simulation with Parameters::adaptive_measurement_spacing, 0 if no estimate is available
+    double get_autocorrelation_time() const { return measurement_spacing.get_autocorrelation_time(); }
+    //! Binning estimate of the standard error of the mean of the designated observable of the last simulation (see Parameters::target_error), 0 if no estimate is available
+    double get_standard_error() const { return precision_monitor.get_standard_error(); }
+    //! Number of steps performed for the measurements of the last simulation
+    step_number_t get_measurement_steps_performed() const { return measurement_steps_performed; }
+    //! Proposal width of the given step type tuned by the last relaxation with Parameters::adaptive_proposal_tuning, 0 if the width of this type was not tuned
+    double get_tuned_proposal_width(std::size_t step_type) const { return proposal_tuner.get_proposal_width(step_type); }
+    //! Acceptance rate of the given step type measured before the last adaption of its proposal width, 0 if the width of this type was not tuned
+    double get_tuned_acceptance_rate(std::size_t step_type) const { return proposal_tuner.get_acceptance_rate(step_type); }
+    //! Calculate the energy of the configuration from scratch and continue tracking from this value
+    void recalculate_energy();
+    //! Observe the configuration with the given observator, observators accepting the energy are handed the energy known by the simulation
+    template<class Observator>
+    typename Observator::observable_type observe();
     
     //! Calculate the acceptance probability for a given step, must be implemented to use Simulation::do_steps
     /*!
+      \details For discrete energy differences the Boltzmann factor is looked up in the acceptance table of the simulation.
       \tparam TemperatureType Type of the temperatures
       \param step_to_execute Step of which the acceptance probability should be calculated
       \param beta Temperature at which the step is done
@@ -140,27 +266,119 @@ namespace Mocasinns
     template <class TemperatureType>
     inline double acceptance_probability(StepType& step_to_execute, const TemperatureType& beta = 0)
     {
-      return exp( -(beta * step_to_execute.delta_E()));
+      typename Details::RejectionFree::step_energy_difference<StepType>::type step_delta_E;
+      {
+	MOCASINNS_PROFILE_SCOPE(delta_E);
+	step_delta_E = step_to_execute.delta_E();
+      }
+      return acceptance_table(step_delta_E, beta);
+    }
+    //! Calculate the acceptance probability for a given step and store its energy difference for tracking the energy
+    template <class TemperatureType, class EnergyDifferenceType>
+    inline double acceptance_probability(StepType& step_to_execute, Details::Metropolis::TrackedEnergyParameter<TemperatureType, EnergyDifferenceType>& parameter)
+    {
+      {
+	MOCASINNS_PROFILE_SCOPE(delta_E);
+	parameter.delta_E = step_to_execute.delta_E();
+      }
+      return acceptance_table(parameter.delta_E, parameter.beta);
     }
     //! Handle an executed step (do nothing, must be implemented to use Simulation::do_steps)
     template <class NotImportant>
     inline void handle_executed_step(StepType&, double, NotImportant) {}
+    //! Handle an executed step by adding its energy difference to the tracked energy
+    template <class TemperatureType, class EnergyDifferenceType>
+    inline void handle_executed_step(StepType&, double, Details::Metropolis::TrackedEnergyParameter<TemperatureType, EnergyDifferenceType>& parameter)
+    {
+      tracked_energy += parameter.delta_E;
+      ++executed_steps_since_energy_calculation;
+    }
     //! Handle a rejected step (do nothing, must be implemented to use Simulation::do_steps)
     template <class NotImportant>
     inline void handle_rejected_step(StepType&, double, NotImportant) {}
     
     //! Execute a given number of Metropolis-MC steps on the configuration at inverse temperatur beta
     /*!
-      \details This function is just syntax sugar and calls the Simulation::do_steps() function
+      \details This function is just syntax sugar and calls the Simulation::do_steps() function, the Simulation::do_sweep_steps() function if Parameters::sequential_sweep is set, do_metropolis_speculative_steps() if Parameters::speculative_thread_number is larger than 0, do_metropolis_sublattice_steps() if Parameters::sublattice_thread_number is larger than 0 or do_metropolis_multi_spin_steps() if the steps are multi-spin coded. If Parameters::track_energy is set, the energy differences of the executed steps are added to the tracked energy.
       \param number Number of Metropolis steps that will be performed
       \param beta Inverse temperature that will be used for calculation of the acceptance probability of the Metropolis steps.
     */
     template<class TemperaturType = double>
     void do_metropolis_steps(const step_number_t& number, const TemperaturType& beta = 0.0)
     {
-      this->template do_steps<this_type, StepType, rejection_free>(number, beta);
+      if (Details::Metropolis::is_multi_spin_step<StepType>::value)
+	do_metropolis_multi_spin_steps(number, beta);
+      else if (!rejection_free && simulation_parameters.sublattice_thread_number > 0)
+	do_metropolis_sublattice_steps(number, beta);
+      else if (simulation_parameters.track_energy)
+      {
+	if (!tracked_energy_valid) recalculate_energy();
+	Details::Metropolis::TrackedEnergyParameter<TemperaturType, typename Details::RejectionFree::step_energy_difference<StepType>::type> parameter(beta);
+	do_metropolis_single_steps(number, parameter);
+	if (simulation_parameters.energy_recalculation_interval > 0 && executed_steps_since_energy_calculation >= simulation_parameters.energy_recalculation_interval)
+	  recalculate_energy();
+	return;
+      }
+      else
+	do_metropolis_single_steps(number, beta);
+
+      // The energy was not tracked
+      tracked_energy_valid = false;
     }
+
+    //! Perform the relaxation of the configuration at inverse temperature beta, returns the number of performed relaxation steps
+    template<class TemperatureType>
+    step_number_t do_metropolis_relaxation(const TemperatureType& beta);
+
+    //! Start the tuning of the proposal widths, the acceptance statistics are collected until the tuning is finished
+    void begin_proposal_tuning();
+    //! Adapt the proposal widths of the step types with enough proposed steps since their last adaption to Parameters::target_acceptance_rate
+    void tune_proposal_widths();
+    //! Finish the tuning of the proposal widths, the widths are frozen afterwards
+    void end_proposal_tuning();
     
+    //! \cond
+    template<class TemperatureType, class SublatticeStepType = StepType>
+    typename boost::enable_if_c<Details::has_function_propose_color_step<ConfigurationType, SublatticeStepType, boost::mpl::vector<std::size_t, std::size_t, RandomNumberGenerator*> >::value, void>::type
+    do_metropolis_sublattice_steps(const step_number_t& number, const TemperatureType& beta);
+    template<class TemperatureType, class SublatticeStepType = StepType>
+    typename boost::enable_if_c<!Details::has_function_propose_color_step<ConfigurationType, SublatticeStepType, boost::mpl::vector<std::size_t, std::size_t, RandomNumberGenerator*> >::value, void>::type
+    do_metropolis_sublattice_steps(const step_number_t& number, const TemperatureType& beta);
+    //! \endcond
+#ifdef MOCASINNS_DOXYGEN_DOCUMENTATION
+    //! Execute Metropolis-MC steps on the configuration at inverse temperature beta, updating the sites of one sublattice in parallel
+    template<class TemperatureType>
+    void do_metropolis_sublattice_steps(const step_number_t& number, const TemperatureType& beta);
+#endif
+
+    //! \cond
+    template<class ParameterType, class SpeculativeStepType = StepType>
+    typename boost::enable_if_c<Details::has_function_footprint<SpeculativeStepType, void, boost::mpl::vector<std::vector<std::size_t>&> >::value, void>::type
+    do_metropolis_speculative_steps(const step_number_t& number, ParameterType& parameter);
+    template<class ParameterType, class SpeculativeStepType = StepType>
+    typename boost::enable_if_c<!Details::has_function_footprint<SpeculativeStepType, void, boost::mpl::vector<std::vector<std::size_t>&> >::value, void>::type
+    do_metropolis_speculative_steps(const step_number_t& number, ParameterType& parameter);
+    //! \endcond
+#ifdef MOCASINNS_DOXYGEN_DOCUMENTATION
+    //! Execute Metropolis-MC steps on the configuration at the inverse temperature given by the parameter, evaluating windows of proposed steps speculatively in parallel
+    template<class ParameterType>
+    void do_metropolis_speculative_steps(const step_number_t& number, ParameterType& parameter);
+#endif
+
+    //! \cond
+    template<class TemperatureType, class MultiSpinStepType = StepType>
+    typename boost::enable_if_c<Details::Metropolis::is_multi_spin_step<MultiSpinStepType>::value, void>::type
+    do_metropolis_multi_spin_steps(const step_number_t& number, const TemperatureType& beta);
+    template<class TemperatureType, class MultiSpinStepType = StepType>
+    typename boost::enable_if_c<!Details::Metropolis::is_multi_spin_step<MultiSpinStepType>::value, void>::type
+    do_metropolis_multi_spin_steps(const step_number_t& number, const TemperatureType& beta);
+    //! \endcond
+#ifdef MOCASINNS_DOXYGEN_DOCUMENTATION
+    //! Execute Metropolis-MC steps on all replicas of a multi-spin coded configuration at inverse temperature beta
+    template<class TemperatureType>
+    void do_metropolis_multi_spin_steps(const step_number_t& number, const TemperatureType& beta);
+#endif
+
     //! Execute a Metropolis Monte-Carlo simulation at given inverse temperature
     template<class Observator = DefaultObservator, class TemperatureType = double>
     std::vector<typename Observator::observable_type> do_metropolis_simulation(const TemperatureType& beta);
@@ -187,14 +405,198 @@ namespace Mocasinns
   private:
     //! Member variable storing the parameters of the simulation
     Parameters simulation_parameters;
+    //! Member variable storing the Boltzmann factors of discrete energy differences at the actual inverse temperature
+    Details::Metropolis::AcceptanceTable acceptance_table;
+    //! Hook policy object invoked at every measurement
+    HookPolicy hooks;
+    //! Energy of the configuration tracked by adding the energy differences of the executed steps
+    energy_type tracked_energy;
+    //! Flag indicating whether the tracked energy is the energy of the actual configuration
+    bool tracked_energy_valid;
+    //! Number of executed steps since the tracked energy was calculated from scratch
+    step_number_t executed_steps_since_energy_calculation;
+    //! Number of relaxation steps performed by the last relaxation
+    step_number_t relaxation_steps_performed;
+    //! Number of steps between two measurements adapted to the autocorrelation time of the energy
+    Details::Metropolis::MeasurementSpacing measurement_spacing;
+    //! Binning analysis of the designated observable of the measurements
+    Details::Metropolis::PrecisionMonitor precision_monitor;
+    //! Number of steps performed for the measurements of the actual simulation
+    step_number_t measurement_steps_performed;
+    //! Proposal widths tuned to the target acceptance rate
+    Details::Metropolis::ProposalTuner proposal_tuner;
+    //! Flag indicating whether the proposal widths are tuned at the moment
+    bool proposal_tuning;
+    //! Flag indicating whether the acceptance statistics were collected before the tuning of the proposal widths started
+    bool proposal_tuning_collected_statistics;
+    //! Acceptance statistics of the threads before the tuning of the proposal widths started, restored afterwards if they were not collected
+    std::vector<Statistics::AcceptanceStatistics> proposal_tuning_saved_statistics;
+    //! Random number generators of the sublattice threads, seeded from the random number generator of the simulation
+    std::vector<RandomNumberGenerator*> sublattice_thread_rngs;
+    //! Boltzmann factor tables of the sublattice threads
+    std::vector<Details::Metropolis::AcceptanceTable> sublattice_thread_acceptance_tables;
+
+    //! \cond
+    // The sweep is only instantiated for simulations that are not rejection-free, because the configurations of rejection-free simulations need not propose single steps
+    template<class ParameterType, bool sweep_rejection_free = rejection_free>
+    typename boost::enable_if_c<!sweep_rejection_free, void>::type
+    do_metropolis_sweep_steps(const step_number_t& number, ParameterType& parameter) { this->template do_sweep_steps<this_type, StepType>(number, parameter); }
+    template<class ParameterType, bool sweep_rejection_free = rejection_free>
+    typename boost::enable_if_c<sweep_rejection_free, void>::type
+    do_metropolis_sweep_steps(const step_number_t& number, ParameterType& parameter) { this->template do_steps<this_type, StepType, true>(number, parameter); }
+    //! \endcond
+
+    //! Type of the snapshots of the configuration observed asynchronously
+    typedef Details::Metropolis::ConfigurationSnapshot<ConfigurationType, energy_type> snapshot_type;
+
+    //! Take the measurements of a Metropolis simulation asynchronously in the background threads of a Details::Metropolis::MeasurementPipeline
+    template<class Observator, class Accumulator, class TemperatureType>
+    void do_metropolis_pipelined_measurements(const TemperatureType& beta, Accumulator& measurement_accumulator);
+
+    //! Perform the steps between two measurements, sampling the energy and adapting the number of steps if Parameters::adaptive_measurement_spacing is set
+    template<class TemperatureType>
+    void do_metropolis_measurement_steps(const TemperatureType& beta);
+
+    //! Perform relaxation steps, in portions of Parameters::proposal_tuning_steps steps followed by an adaption of the proposal widths while the widths are tuned
+    template<class TemperatureType>
+    void do_metropolis_relaxation_steps(const step_number_t& number, const TemperatureType& beta);
+    //! Set the tuned proposal widths of the configuration if Parameters::adaptive_proposal_tuning is set
+    void apply_proposal_widths() { if (simulation_parameters.adaptive_proposal_tuning && this->configuration_space != NULL) proposal_tuner.apply(*this->configuration_space); }
+
+    //! Whether the standard error of the designated observable has reached Parameters::target_error
+    bool target_error_reached() const { return (simulation_parameters.target_error > 0.0 && precision_monitor.is_reached(simulation_parameters.target_error)); }
+    //! Whether the measurements have used up Parameters::step_budget
+    bool step_budget_exhausted() const { return (simulation_parameters.step_budget > 0 && measurement_steps_performed >= simulation_parameters.step_budget); }
+
+    //! Accumulator of the pipelined measurements forwarding the observables to the accumulator of the simulation and to the precision monitor
+    template<class Accumulator>
+    struct MonitoredAccumulator
+    {
+      MonitoredAccumulator(this_type& sim, Accumulator& acc, std::atomic<bool>& reached) : simulation(sim), accumulator(acc), target_reached(reached) {}
+      template<class ObservableType>
+      void operator()(const ObservableType& observable)
+      {
+	accumulator(observable);
+	simulation.precision_monitor.add(observable);
+	if (simulation.target_error_reached()) target_reached = true;
+      }
+      this_type& simulation;
+      Accumulator& accumulator;
+      std::atomic<bool>& target_reached;
+    };
+
+    //! Execute single Metropolis steps with the given acceptance probability parameter (the inverse temperature or a Details::Metropolis::TrackedEnergyParameter), speculatively, sequentially or at random
+    template<class ParameterType>
+    void do_metropolis_single_steps(const step_number_t& number, ParameterType& parameter)
+    {
+      if (!rejection_free && simulation_parameters.speculative_thread_number > 0)
+	do_metropolis_speculative_steps(number, parameter);
+      else if (!rejection_free && simulation_parameters.sequential_sweep)
+	do_metropolis_sweep_steps(number, parameter);
+      else
+	this->template do_steps<this_type, StepType, rejection_free>(number, parameter);
+    }
+
+    //! Trait checking whether the Observator can observe the energy known by the simulation
+    template<class Observator>
+    struct observes_energy : Details::has_static_member_function_observe<Observator, typename Observator::observable_type, boost::mpl::vector<ConfigurationType*, const energy_type&> > {};
+
+    //! \cond
+    template<class Observator>
+    typename boost::enable_if_c<observes_energy<Observator>::value, typename Observator::observable_type>::type
+    observe_generic()
+    {
+      const energy_type energy = get_energy();
+      MOCASINNS_PROFILE_SCOPE(observe);
+      return Observator::observe(this->configuration_space, energy);
+    }
+    template<class Observator>
+    typename boost::enable_if_c<!observes_energy<Observator>::value, typename Observator::observable_type>::type
+    observe_generic() { return Profiling::observe_configuration<Observator>(this->configuration_space); }
+    //! \endcond
+
+    //! \cond
+    template<class Observator>
+    typename boost::enable_if_c<observes_energy<Observator>::value, void>::type
+    take_snapshot(snapshot_type& snapshot)
+    {
+      snapshot.configuration = *this->configuration_space;
+      snapshot.energy = get_energy();
+    }
+    template<class Observator>
+    typename boost::enable_if_c<!observes_energy<Observator>::value, void>::type
+    take_snapshot(snapshot_type& snapshot) { snapshot.configuration = *this->configuration_space; }
+
+    template<class Observator>
+    static typename boost::enable_if_c<observes_energy<Observator>::value, typename Observator::observable_type>::type
+    observe_snapshot(snapshot_type& snapshot)
+    {
+      MOCASINNS_PROFILE_SCOPE(observe);
+      return Observator::observe(&snapshot.configuration, snapshot.energy);
+    }
+    template<class Observator>
+    static typename boost::enable_if_c<!observes_energy<Observator>::value, typename Observator::observable_type>::type
+    observe_snapshot(snapshot_type& snapshot) { return Profiling::observe_configuration<Observator>(&snapshot.configuration); }
+    //! \endcond
+
+    //! Observator of the snapshots passed to the Details::Metropolis::MeasurementPipeline
+    template<class Observator>
+    struct SnapshotObservator
+    {
+      static typename Observator::observable_type observe(snapshot_type& snapshot) { return this_type::template observe_snapshot<Observator>(snapshot); }
+    };
+
+    //! \cond
+    template<class Archive, class SerializedEnergyType = energy_type>
+    typename boost::enable_if_c<boost::is_arithmetic<SerializedEnergyType>::value, void>::type
+    serialize_tracked_energy(Archive& ar)
+    {
+      ar & tracked_energy;
+      ar & tracked_energy_valid;
+    }
+    template<class Archive, class SerializedEnergyType = energy_type>
+    typename boost::enable_if_c<!boost::is_arithmetic<SerializedEnergyType>::value, void>::type
+    serialize_tracked_energy(Archive&) { }
+    //! \endcond
+
+    //! Delete the random number generators of the sublattice threads
+    void sublattice_threads_clear()
+    {
+      for (typename std::vector<RandomNumberGenerator*>::iterator it = sublattice_thread_rngs.begin(); it != sublattice_thread_rngs.end(); ++it)
+	delete *it;
+      sublattice_thread_rngs.clear();
+      sublattice_thread_acceptance_tables.clear();
+    }
+
+    //! Determine the footprint, the executability, the selection probability factor and the energy difference of a step without changing the configuration, returns whether the step is executable
+    template <class EnergyDifferenceType>
+    static bool speculative_evaluate(StepType& step, std::vector<std::size_t>& footprint, EnergyDifferenceType& delta_E, double& selection_probability_factor)
+    {
+      footprint.clear();
+      step.footprint(footprint);
+      if (!Details::OptionalMemberFunctions::optional_is_executable<StepType>(step)) return false;
+      selection_probability_factor = Details::OptionalMemberFunctions::optional_selection_probability_factor<StepType>(step);
+      delta_E = step.delta_E();
+      return true;
+    }
     
     //! Member variable for boost serialization
     friend class boost::serialization::access;
-    //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
-    template<class Archive> void serialize(Archive & ar, const unsigned int)
+    //! Method to serialize this class, the state of the measurements is stored since version 1
+    template<class Archive> void serialize(Archive & ar, const unsigned int version)
     {
       // serialize base class information
       ar & boost::serialization::base_object<Simulation<ConfigurationType, RandomNumberGenerator> >(*this);
+      // The loaded configuration replaces the actual one, its energy is calculated again unless a tracked energy is stored
+      if (Archive::is_loading::value) tracked_energy_valid = false;
+      if (version < 1) return;
+      // The tracked energy is only stored for arithmetic energy types, otherwise it is calculated again after loading
+      serialize_tracked_energy(ar);
+      // The adapted number of steps between two measurements and the estimate of the autocorrelation time are continued when a checkpoint is resumed
+      ar & measurement_spacing;
+      ar & precision_monitor;
+      ar & measurement_steps_performed;
+      ar & proposal_tuner;
     }
   };
 
@@ -205,8 +607,8 @@ namespace Mocasinns
 #endif
 
   //! Struct storing the definition of the Parameters of a Metropolis-Simulation
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator, bool rejection_free>
-  struct Metropolis<ConfigurationType, StepType, RandomNumberGenerator, rejection_free>::Parameters
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+  struct Metropolis<ConfigurationType, StepType, RandomNumberGenerator, rejection_free, HookPolicy>::Parameters
   {
     //! Number of steps to perform before taking data
     step_number_t relaxation_steps;
@@ -216,15 +618,96 @@ namespace Mocasinns
     step_number_t steps_between_measurement;
     //! Number of measurements to perform before calling each signal
     unsigned int measurements_per_signal;
+    //! Flag indicating whether the steps are taken sequentially from the sweep of the configuration instead of at random (ignored for rejection-free simulations and configurations without sweep)
+    bool sequential_sweep;
+    //! Number of threads updating the sites of one sublattice in parallel, 0 disables the sublattice decomposition (ignored for rejection-free simulations and configurations without coloring)
+    unsigned int sublattice_thread_number;
+    //! Number of threads evaluating proposed steps speculatively in parallel, 0 disables the speculative evaluation (ignored for rejection-free simulations and steps without footprint)
+    /*!
+      \details All steps of a window are proposed before the first of them is executed, so proposing a step must not depend on the state of the configuration. The random number stream is that of the batched proposal of blocks of speculative_window_size steps, it differs from the stream of single proposed steps unless the window size is 1 (see do_metropolis_speculative_steps()).
+    */
+    unsigned int speculative_thread_number;
+    //! Number of proposed steps that are evaluated speculatively at once
+    unsigned int speculative_window_size;
+    //! Flag indicating whether the total energy is tracked by adding the energy differences of the executed steps instead of calculating it for every measurement and replica exchange
+    bool track_energy;
+    //! Number of executed steps after which the tracked energy is calculated from scratch (checked after every call of do_metropolis_steps), 0 disables the recalculation
+    step_number_t energy_recalculation_interval;
+    //! Number of background threads observing snapshots of the configuration while the simulation continues, 0 takes the measurements synchronously
+    unsigned int measurement_thread_number;
+    //! Number of reusable snapshot buffers, i.e. maximal number of measurements pending in the background threads
+    unsigned int measurement_buffer_number;
+    //! Flag indicating whether the relaxation stops as soon as the energy is stationary, relaxation_steps is then the maximal number of relaxation steps
+    bool adaptive_relaxation;
+    //! Number of steps between two energy samples of the adaptive relaxation
+    step_number_t relaxation_sample_steps;
+    //! Number of energy samples averaged in one batch of the MSER test of the adaptive relaxation
+    unsigned int relaxation_batch_size;
+    //! Flag indicating whether the number of steps between two measurements is adapted to the integrated autocorrelation time of the energy, steps_between_measurement is then the initial number of steps
+    bool adaptive_measurement_spacing;
+    //! Number of steps between two energy samples of the estimate of the autocorrelation time, the number of steps between two measurements is a multiple of it (the tempering simulations sample after every replica exchange instead)
+    step_number_t autocorrelation_sample_steps;
+    //! Number of steps between two measurements as fraction of the integrated autocorrelation time of the energy
+    double measurement_spacing_fraction;
+    //! Lower bound of the adapted number of steps between two measurements
+    step_number_t minimal_steps_between_measurement;
+    //! Upper bound of the adapted number of steps between two measurements, 0 imposes no upper bound
+    step_number_t maximal_steps_between_measurement;
+    //! Standard error of the mean of the designated observable at which the measurements stop, 0 disables the stopping criterion (measurement_number is then the maximal number of measurements)
+    double target_error;
+    //! Maximal number of steps performed for the measurements of a simulation, 0 imposes no budget
+    step_number_t step_budget;
+    //! Flag indicating whether the proposal widths of the configuration are tuned to target_acceptance_rate during the relaxation (ignored for configurations without proposal widths)
+    bool adaptive_proposal_tuning;
+    //! Acceptance rate of every step type targeted by the tuning of the proposal widths
+    double target_acceptance_rate;
+    //! Number of proposed steps of a type between two adaptions of its proposal width, the relaxation steps are performed in portions of this number of steps
+    step_number_t proposal_tuning_steps;
     
     //! Standard constructor for setting default values
     Parameters() : relaxation_steps(1000),
 		   measurement_number(100),
 		   steps_between_measurement(100),
-		   measurements_per_signal(1) {}
+		   measurements_per_signal(1),
+		   sequential_sweep(false),
+		   sublattice_thread_number(0),
+		   speculative_thread_number(0),
+		   speculative_window_size(256),
+		   track_energy(false),
+		   energy_recalculation_interval(0),
+		   measurement_thread_number(0),
+		   measurement_buffer_number(4),
+		   adaptive_relaxation(false),
+		   relaxation_sample_steps(100),
+		   relaxation_batch_size(5),
+		   adaptive_measurement_spacing(false),
+		   autocorrelation_sample_steps(100),
+		   measurement_spacing_fraction(1.0),
+		   minimal_steps_between_measurement(1),
+		   maximal_steps_between_measurement(0),
+		   target_error(0.0),
+		   step_budget(0),
+		   adaptive_proposal_tuning(false),
+		   target_acceptance_rate(0.5),
+		   proposal_tuning_steps(1000) {}
   };
 }
 
+namespace boost
+{
+  namespace serialization
+  {
+    //! Version 1 of the serialization of Metropolis adds the tracked energy, the measurement spacing, the precision monitor, the step budget and the proposal tuner
+    template <class ConfigurationType, class StepType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+    struct version<Mocasinns::Metropolis<ConfigurationType, StepType, RandomNumberGenerator, rejection_free, HookPolicy> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+  }
+}
+
 #include "src/metropolis.cpp"
 
 #endif
@@ -0,0 +1,163 @@
+/**
+ * \file metropolis_ensemble.hpp
+ * \brief Class for Metropolis-Monte-Carlo simulations of an ensemble of independent chains advanced in lockstep
+ *
+ * Does Metropolis-Steps in many small independent systems stored in one configuration and determines statistical averages of observables of every system.
+ *
+ * \author Benedikt Krüger
+ */
+
+#ifndef MOCASINNS_METROPOLIS_ENSEMBLE_HPP
+#define MOCASINNS_METROPOLIS_ENSEMBLE_HPP
+
+#include "simulation.hpp"
+#include "concepts/concepts.hpp"
+#include "details/metropolis/acceptance_table.hpp"
+#include "details/metropolis/vector_accumulator.hpp"
+#include "details/ensemble/lane_random.hpp"
+#include "details/ensemble/boltzmann_table.hpp"
+#include "exceptions/unequal_sizes_exception.hpp"
+
+// Boost serialization for derived classes
+#include <boost/serialization/base_object.hpp>
+
+namespace Mocasinns
+{
+
+//! Class for Metropolis-Monte-Carlo simulations of an ensemble of independent chains that are advanced in lockstep
+/*!
+ * \details The ensemble configuration stores K systems of the same shape (e.g. different disorder realisations or different initial states) in structure-of-arrays layout, so that the data of one site of all systems is contiguous. In every step of the ensemble each chain proposes the flip of an independently chosen site, and the energy differences, the acceptance decisions and the flips of all chains are calculated in loops over the chains that can be vectorised by the compiler. For discrete energy types (see Details::Metropolis::use_acceptance_table) the acceptance probabilities of the range of energy differences occurring in the ensemble are tabulated once per inverse temperature in a Details::Ensemble::BoltzmannTable, so the acceptance of every chain is decided by a table load and a comparison without branches. The random numbers of the chains are created by an independent lane of a Details::Ensemble::LaneRandom generator for each chain, which is seeded from the random number generator of the simulation when the number of chains changes and is serialized with the simulation, so a resumed checkpoint continues the same chains.
+ *
+ * The EnsembleConfigurationType must provide
+ * - <tt>typedef ... energy_type</tt>: Type of the energies and energy differences
+ * - <tt>std::size_t chain_number()</tt>: Number K of chains stored in the ensemble
+ * - <tt>std::size_t site_number()</tt>: Number of sites of every chain
+ * - <tt>void ensemble_delta_E(const std::vector<uint32_t>& sites, std::vector<energy_type>& delta_E)</tt>: Calculate for every chain k the energy difference of the step at site sites[k] and store it in delta_E[k]
+ * - <tt>void ensemble_execute(const std::vector<uint32_t>& sites, const std::vector<char>& accepted)</tt>: Execute the step at site sites[k] in every chain k for which accepted[k] is non-zero
+ * - <tt>energy_type energy(std::size_t chain)</tt>: Energy of a chain (used by the default observator)
+ *
+ * The observators used for the measurements must provide a static function <tt>observable_type observe(EnsembleConfigurationType* configuration, std::size_t chain)</tt> measuring the observable of a single chain, the measurements of every chain are fed into an accumulator of its own.
+ *
+ * In contrast to MetropolisParallel, which creates a serial Metropolis simulation with its own configuration for every run and distributes the runs over threads, all chains are advanced by one thread using the SIMD width of the processor.
+ */
+template <class EnsembleConfigurationType, class RandomNumberGenerator>
+class MetropolisEnsemble : public Simulation<EnsembleConfigurationType, RandomNumberGenerator>
+{
+  // Check the random number generator concept
+  BOOST_CONCEPT_ASSERT((Concepts::RandomNumberGeneratorConcept<RandomNumberGenerator>));
+
+public:
+  // Typedef for the base class
+  typedef Simulation<EnsembleConfigurationType, RandomNumberGenerator> Base;
+  // Typedefs for integers
+  typedef typename Base::step_number_t step_number_t;
+  typedef uint32_t measurement_number_t;
+  //! Typedef for the energies of the chains
+  typedef typename EnsembleConfigurationType::energy_type energy_type;
+
+  // Forward declaration of the parameters used for an ensemble Metropolis simulation
+  struct Parameters;
+
+  //! Standard class for observing the energy of a single chain
+  struct ObserveEnergy
+  {
+    typedef energy_type observable_type;
+    static observable_type observe(EnsembleConfigurationType* config, std::size_t chain) { return config->energy(chain); }
+  };
+  //! Typedef for the default observable
+  typedef typename MetropolisEnsemble<EnsembleConfigurationType, RandomNumberGenerator>::ObserveEnergy DefaultObservator;
+
+  //! Boost signal handler invoked after every measurement of all chains
+  boost::signals2::signal<void (Simulation<EnsembleConfigurationType,RandomNumberGenerator>*)> signal_handler_measurement;
+
+  //! Initialise an ensemble Metropolis-MC simulation with default configuration space and default Parameters
+  MetropolisEnsemble() : Simulation<EnsembleConfigurationType, RandomNumberGenerator>(), simulation_parameters() {}
+  //! Initialise an ensemble Metropolis-MC simulation with default configuration space and given Parameters
+  MetropolisEnsemble(const Parameters& params) : Simulation<EnsembleConfigurationType, RandomNumberGenerator>(), simulation_parameters(params) {}
+  //! Initialise an ensemble Metropolis-MC simulation with given parameters and given configuration space
+  MetropolisEnsemble(const Parameters& params, EnsembleConfigurationType* initial_configuration) : Simulation<EnsembleConfigurationType, RandomNumberGenerator>(initial_configuration), simulation_parameters(params) {}
+
+  //! Get-accessor for the parameters of the ensemble Metropolis simulation
+  const Parameters& get_simulation_parameters() { return simulation_parameters; }
+  //! Set-accessor for the parameters of the ensemble Metropolis simulation
+  void set_parameters(const Parameters& value) { simulation_parameters = value; }
+
+  //! Execute the given number of Metropolis steps in every chain at inverse temperature beta
+  template<class TemperatureType = double>
+  void do_ensemble_steps(const step_number_t& number, const TemperatureType& beta = 0.0);
+
+  //! Execute a Metropolis simulation of all chains at given inverse temperature, returns the measurements of every chain (first index: chain, second index: measurement number)
+  template<class Observator = DefaultObservator, class TemperatureType = double>
+  std::vector<std::vector<typename Observator::observable_type> > do_ensemble_simulation(const TemperatureType& beta);
+  //! Execute a Metropolis simulation of all chains at given inverse temperature with one accumulator for the measurement results of every chain
+  template<class Observator, class AccumulatorIterator, class TemperatureType>
+  void do_ensemble_simulation(const TemperatureType& beta, AccumulatorIterator measurement_accumulator_begin, AccumulatorIterator measurement_accumulator_end);
+
+  //! Load the data of the ensemble Metropolis simulation from a serialization stream
+  virtual void load_serialize(std::istream& input_stream) { Base::load_serialize(*this, input_stream); }
+  //! Load the data of the ensemble Metropolis simulation from a serialization file
+  virtual void load_serialize(const char* filename) { Base::load_serialize(*this, filename); }
+  //! Save the data of the ensemble Metropolis simulation to a serialization stream
+  virtual void save_serialize(std::ostream& output_stream) const { Base::save_serialize(*this, output_stream); }
+  //! Save the data of the ensemble Metropolis simulation to a serialization file
+  virtual void save_serialize(const char* filename) const { Base::save_serialize(*this, filename); }
+
+private:
+  //! Member variable storing the parameters of the simulation
+  Parameters simulation_parameters;
+  //! Random number generator with one lane for every chain
+  Details::Ensemble::LaneRandom lane_rng;
+  //! Acceptance probabilities of the range of discrete energy differences of the ensemble at the actual inverse temperature
+  Details::Ensemble::BoltzmannTable boltzmann_table;
+
+  //! Buffer for the sites proposed in every chain
+  std::vector<uint32_t> proposed_sites;
+  //! Buffer for the energy differences of the proposed steps of every chain
+  std::vector<energy_type> energy_differences;
+  //! Buffer for the random numbers deciding about the acceptance in every chain
+  std::vector<double> acceptance_random_numbers;
+  //! Buffer for the acceptance decisions of every chain (char instead of bool for vectorisation)
+  std::vector<char> accepted_steps;
+
+  //! Decide about the acceptance of the proposed steps of all chains using the table of acceptance probabilities
+  template<class TemperatureType, class EnergyType>
+  typename boost::enable_if_c<Details::Metropolis::use_acceptance_table<EnergyType>::value, void>::type
+  decide_acceptance(const TemperatureType& beta);
+  //! Decide about the acceptance of the proposed steps of all chains by calculating the Boltzmann factors
+  template<class TemperatureType, class EnergyType>
+  typename boost::enable_if_c<!Details::Metropolis::use_acceptance_table<EnergyType>::value, void>::type
+  decide_acceptance(const TemperatureType& beta);
+
+  //! Member variable for boost serialization
+  friend class boost::serialization::access;
+  //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
+  template<class Archive> void serialize(Archive & ar, const unsigned int)
+  {
+    // serialize base class information
+    ar & boost::serialization::base_object<Simulation<EnsembleConfigurationType, RandomNumberGenerator> >(*this);
+    ar & lane_rng;
+  }
+};
+
+//! Struct storing the parameters of an ensemble Metropolis Monte-Carlo Simulation
+template <class EnsembleConfigurationType, class RandomNumberGenerator>
+struct MetropolisEnsemble<EnsembleConfigurationType, RandomNumberGenerator>::Parameters
+{
+  //! Number of steps per chain to perform before the first measurement
+  step_number_t relaxation_steps;
+  //! Number of measurements of every chain
+  measurement_number_t measurement_number;
+  //! Number of steps per chain to perform between two measurements
+  step_number_t steps_between_measurement;
+
+  //! Standard constructor for setting default values
+  Parameters() : relaxation_steps(1000),
+		 measurement_number(100),
+		 steps_between_measurement(100) {}
+};
+
+} // of namespace Mocasinns
+
+#include "src/metropolis_ensemble.cpp"
+
+#endif
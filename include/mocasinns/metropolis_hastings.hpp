@@ -126,7 +126,10 @@ namespace Mocasinns
     template <class AcceptanceProbabilityParameters>
     inline double acceptance_probability(StepType& step_to_execute, AcceptanceProbabilityParameters& acceptance_probability_parameters)
     {
-      acceptance_probability_parameters.delta_E = step_to_execute.delta_E();
+      {
+	MOCASINNS_PROFILE_SCOPE(delta_E);
+	acceptance_probability_parameters.delta_E = step_to_execute.delta_E();
+      }
       return acceptance_probability_parameters.acceptance_probability_functor(acceptance_probability_parameters.delta_E, 
 									      acceptance_probability_parameters.actual_energy);
     }
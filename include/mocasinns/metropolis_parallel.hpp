@@ -14,6 +14,8 @@
 #include "metropolis.hpp"
 #include "concepts/concepts.hpp"
 
+#include <cmath>
+
 // Boost serialization for derived classes
 #include <boost/serialization/base_object.hpp>
 
@@ -21,6 +23,9 @@ namespace Mocasinns
 {
 
 //! Class for parallel Metropolis-Monte-Carlo simulations
+/*!
+ * \details The states of the runs are not stored in the serialization, so a parallel simulation cannot be resumed from a checkpoint. If the time budget is exhausted, the runs stop after their actual measurement, but no checkpoint is written.
+ */
 template <class ConfigurationType, class StepType, class RandomNumberGenerator>
 class MetropolisParallel : public Simulation<ConfigurationType, RandomNumberGenerator>
 {
@@ -50,17 +55,24 @@ public:
   boost::signals2::signal<void (Simulation<ConfigurationType,RandomNumberGenerator>*)> signal_handler_run;
 
   //! Initialise a parallel Metropolis-MC simulation with default configuration space and default Parameters
-  MetropolisParallel() : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters() {}
+  MetropolisParallel() : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(), relaxation_steps_performed(), precision_monitors(), measurement_steps_performed(0) { this->checkpoints_resumable = false; }
   //! Initialise a parallel Metropolis-MC simulation with default configuration space and given Parameters
-  MetropolisParallel(const Parameters& params) : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(params) {}
+  MetropolisParallel(const Parameters& params) : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(params), relaxation_steps_performed(), precision_monitors(), measurement_steps_performed(0) { this->checkpoints_resumable = false; }
   //! Initialise a parallel Metropolis-MC simulation with given parameters and given configuration space
-  MetropolisParallel(const Parameters& params, ConfigurationType* initial_configuration) : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), simulation_parameters(params) {}
+  MetropolisParallel(const Parameters& params, ConfigurationType* initial_configuration) : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), simulation_parameters(params), relaxation_steps_performed(), precision_monitors(), measurement_steps_performed(0) { this->checkpoints_resumable = false; }
 
   //! Get-accessor for the parameters of the Metropolis simulation
   const Parameters& get_simulation_parameters() { return simulation_parameters; }
   //! Set-accessor for the parameters of the Metropolis simulation
   void set_parameters(const Parameters& value) { simulation_parameters = value; }
 
+  //! Number of relaxation steps performed by every run of the last simulation (the detected relaxation times if Parameters::adaptive_relaxation is set)
+  const std::vector<step_number_t>& get_relaxation_steps_performed() const { return relaxation_steps_performed; }
+  //! Standard error of the mean of the designated observable over all runs of the last simulation, combined from the binning estimates of the single runs (see Parameters::target_error), 0 if no estimate is available
+  double get_standard_error() const;
+  //! Number of steps performed for the measurements of all runs of the last simulation
+  step_number_t get_measurement_steps_performed() const { return measurement_steps_performed; }
+
   //! Execute a Metropolis Monte-Carlo simulation with given parameters at given inverse temperature
   template<class Observator, class TemperatureType = double>
   std::vector<typename Observator::observable_type> do_parallel_metropolis_simulation(const TemperatureType& beta);
@@ -86,6 +98,22 @@ public:
 
 private:
   Parameters simulation_parameters;
+  //! Number of relaxation steps performed by every run of the last simulation
+  std::vector<step_number_t> relaxation_steps_performed;
+  //! Binning analyses of the designated observable of the measurements, one for every started run
+  std::vector<Details::Metropolis::PrecisionMonitor> precision_monitors;
+  //! Number of steps performed for the measurements of all runs
+  step_number_t measurement_steps_performed;
+
+  //! Whether the binning analyses of all started runs have converged and the combined standard error is not larger than Parameters::target_error
+  bool target_error_reached() const;
+  //! Whether the simulation terminates, the target precision of Parameters::target_error is reached or Parameters::step_budget is exhausted
+  bool measurements_complete() const
+  {
+    return (this->is_terminating
+	    || (simulation_parameters.target_error > 0.0 && target_error_reached())
+	    || (simulation_parameters.step_budget > 0 && measurement_steps_performed >= simulation_parameters.step_budget));
+  }
 
   //! Member variable for boost serialization
   friend class boost::serialization::access;
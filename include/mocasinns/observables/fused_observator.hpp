@@ -0,0 +1,131 @@
+#ifndef MOCASINNS_OBSERVABLES_FUSED_OBSERVATOR_HPP
+#define MOCASINNS_OBSERVABLES_FUSED_OBSERVATOR_HPP
+
+#include <cstddef>
+
+#include <boost/mpl/contains.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/utility/enable_if.hpp>
+
+#include "tuple_observable.hpp"
+
+namespace Mocasinns
+{
+  namespace Observables
+  {
+    //! \cond
+    namespace FusedDetails
+    {
+      // Index of the tag Tag in the list of tags, equal to the length of the list if it is not contained
+      template <class Tag, class... Tags> struct index_of;
+      template <class Tag> struct index_of<Tag> { static const std::size_t value = 0; };
+      template <class Tag, class... Tags> struct index_of<Tag, Tag, Tags...> { static const std::size_t value = 0; };
+      template <class Tag, class Other, class... Tags> struct index_of<Tag, Other, Tags...> { static const std::size_t value = 1 + index_of<Tag, Tags...>::value; };
+
+      // List of tags
+      template <class... Tags> struct tag_list {};
+      // Whether any of the tags is contained in the list
+      template <class List, class... Tags> struct any_contained { static const bool value = false; };
+      template <class... List, class Tag, class... Tags> struct any_contained<tag_list<List...>, Tag, Tags...>
+      {
+	static const bool value = (index_of<Tag, List...>::value < sizeof...(List)) || any_contained<tag_list<List...>, Tags...>::value;
+      };
+
+      // Whether all tags of the list are contained in the boost::mpl sequence
+      template <class Sequence, class... Tags> struct all_contained { static const bool value = true; };
+      template <class Sequence, class Tag, class... Tags> struct all_contained<Sequence, Tag, Tags...>
+      {
+	static const bool value = boost::mpl::contains<Sequence, Tag>::value && all_contained<Sequence, Tags...>::value;
+      };
+    }
+    //! \endcond
+
+    //! Request of a FusedObservator, tells the fused pass at compile time which observables are requested and collects their values
+    /*!
+      \details The fused pass uses <tt>Request::requested<Tags...>::value</tt> (true if any of the given observables is requested) as a compile-time constant to skip the computation of observables and shared intermediates that are not requested, and stores the values with <tt>request.template set<Tag>(value)</tt>, which does nothing for observables that are not requested.
+      \tparam Requested Tags of the requested observables
+    */
+    template <class... Requested>
+    class FusedRequest
+    {
+    public:
+      //! Type of the tuple of the values of the requested observables
+      typedef TupleObservable<typename Requested::observable_type...> observable_type;
+
+      //! Compile-time constant value indicating whether any of the given observables is requested
+      template <class... Tags>
+      struct requested { static const bool value = FusedDetails::any_contained<FusedDetails::tag_list<Requested...>, Tags...>::value; };
+
+      //! Default constructor, value-initialises all requested observables
+      FusedRequest() : values() {}
+
+      //! Store the value of the observable with the given tag if it is requested
+      template <class Tag, class ValueType>
+      typename boost::enable_if_c<requested<Tag>::value, void>::type
+      set(const ValueType& value) { std::get<FusedDetails::index_of<Tag, Requested...>::value>(values.tuple()) = value; }
+      //! \cond
+      template <class Tag, class ValueType>
+      typename boost::disable_if_c<requested<Tag>::value, void>::type
+      set(const ValueType&) {}
+      //! \endcond
+
+      //! Get-accessor for the values of the requested observables
+      const observable_type& get_values() const { return values; }
+
+    private:
+      //! Values of the requested observables
+      observable_type values;
+    };
+
+    //! Observator measuring several observables of a configuration in a single fused pass
+    /*!
+      \details Instead of one observator for every observable, each doing its own pass over the configuration, a fused pass computes all observables together and shares the intermediates, e.g. the local fields of the sites that enter the energy and the local susceptibilities. The observables are identified by tag types with a typedef <tt>observable_type</tt>. The FusedPass declares the tags of all observables it can compute and the fused pass itself:
+      \code
+      struct Energy { typedef int observable_type; };
+      struct Magnetization { typedef int observable_type; };
+      struct IsingPass
+      {
+	typedef boost::mpl::vector<Energy, Magnetization> observables;
+
+	template <class Request>
+	static void observe(IsingConfiguration* config, Request& request)
+	{
+	  int energy = 0, magnetization = 0;
+	  for (...)
+	  {
+	    if (Request::template requested<Energy>::value) energy -= ...;
+	    if (Request::template requested<Magnetization>::value) magnetization += ...;
+	  }
+	  request.template set<Energy>(energy);
+	  request.template set<Magnetization>(magnetization);
+	}
+      };
+      \endcode
+      The FusedObservator fulfills the \ref concept-Observator "Observator concept" with a TupleObservable of the requested observables (in the order of the template parameters) as observable type, so it can be used with every <tt>do_*_simulation</tt> function of the library. Since the request is a compile-time constant, the code for observables that are not requested is removed by the compiler. Use an Accumulators::TupleAccumulator to accumulate every observable in its own accumulator.
+      \tparam FusedPass Class providing the boost::mpl sequence <tt>observables</tt> of the tags of the observables it computes and the static member function template <tt>template <class Request> void observe(ConfigurationType* config, Request& request)</tt>
+      \tparam Requested Tags of the observables that are measured, must be contained in <tt>FusedPass::observables</tt>
+    */
+    template <class FusedPass, class... Requested>
+    class FusedObservator
+    {
+      BOOST_STATIC_ASSERT_MSG((FusedDetails::all_contained<typename FusedPass::observables, Requested...>::value), "The fused pass does not compute all requested observables");
+
+    public:
+      //! Type of the request passed to the fused pass
+      typedef FusedRequest<Requested...> request_type;
+      //! Type of the observable, a TupleObservable of the requested observables
+      typedef typename request_type::observable_type observable_type;
+
+      //! Measure the requested observables of the configuration in a single fused pass
+      template <class ConfigurationType>
+      static observable_type observe(ConfigurationType* configuration)
+      {
+	request_type request;
+	FusedPass::observe(configuration, request);
+	return request.get_values();
+      }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef MOCASINNS_OBSERVABLES_TUPLE_OBSERVABLE_HPP
+#define MOCASINNS_OBSERVABLES_TUPLE_OBSERVABLE_HPP
+
+#include <tuple>
+#include <cmath>
+
+#include <boost/accumulators/numeric/functional.hpp>
+
+#include "../details/stl_extensions/tuple_components.hpp"
+
+// Header for the serialization of the class
+#include <boost/serialization/access.hpp>
+
+namespace Mocasinns
+{
+  namespace Observables
+  {
+    //! Class representing a tuple of observables of different types. Can be used like a std::tuple (access the components with Observables::get) and provides (component-wise) addition, substraction and exponentiation of the observables. The observables measured by a FusedObservator are stored in a TupleObservable.
+    template <class... T>
+    class TupleObservable
+    {
+    public:
+      //! STL-Tuple storing the components
+      typedef std::tuple<T...> data_type;
+
+      //! Default constructor, value-initialises all components (to zero for arithmetic types)
+      TupleObservable() : data() {}
+      //! Constructs a tuple observable from the values of its components
+      template <class U, class... Us>
+      explicit TupleObservable(const U& first, const Us&... values) : data(first, values...) {}
+      //! Creates a tuple observable from the standard tuple
+      TupleObservable(const data_type& std_tuple) : data(std_tuple) {}
+
+      //! Get-accessor for the standard tuple of the components
+      data_type& tuple() { return data; }
+      //! Const get-accessor for the standard tuple of the components
+      const data_type& tuple() const { return data; }
+
+      //! Compare two tuple observables for equality
+      bool operator==(const TupleObservable<T...>& rhs) const { return (data == rhs.data); }
+      //! Compare two tuple observables for inequality
+      bool operator!=(const TupleObservable<T...>& rhs) const { return !operator==(rhs); }
+      //! Compare two tuple observables lexicographically
+      bool operator<(const TupleObservable<T...>& rhs) const { return (data < rhs.data); }
+
+      //! Add another tuple observable component-wise
+      TupleObservable<T...>& operator+=(const TupleObservable<T...>& rhs) { components::add(data, rhs.data); return *this; }
+      //! Substract another tuple observable component-wise
+      TupleObservable<T...>& operator-=(const TupleObservable<T...>& rhs) { components::substract(data, rhs.data); return *this; }
+      //! Multiply this tuple observable component-wise with another tuple observable
+      TupleObservable<T...>& operator*=(const TupleObservable<T...>& rhs) { components::multiply(data, rhs.data); return *this; }
+      //! Divide this tuple observable component-wise by another tuple observable
+      TupleObservable<T...>& operator/=(const TupleObservable<T...>& rhs) { components::divide(data, rhs.data); return *this; }
+      //! Multiply all components with a scalar
+      template <class S>
+      TupleObservable<T...>& operator*=(const S& rhs) { components::scale(data, rhs); return *this; }
+      //! Divide all components by a scalar
+      template <class S>
+      TupleObservable<T...>& operator/=(const S& rhs) { components::shrink(data, rhs); return *this; }
+
+    private:
+      //! Typedef for the component-wise operations
+      typedef Details::STL_Extensions::TupleComponents<0, sizeof...(T)> components;
+
+      //! Components of the tuple observable
+      data_type data;
+
+      friend class boost::serialization::access;
+      template<class Archive> void serialize(Archive & ar, const unsigned int) { components::serialize(ar, data); }
+    };
+
+    //! Access the component with index I of a tuple observable
+    template <std::size_t I, class... T>
+    typename std::tuple_element<I, std::tuple<T...> >::type& get(TupleObservable<T...>& observable) { return std::get<I>(observable.tuple()); }
+    //! Access the component with index I of a constant tuple observable
+    template <std::size_t I, class... T>
+    const typename std::tuple_element<I, std::tuple<T...> >::type& get(const TupleObservable<T...>& observable) { return std::get<I>(observable.tuple()); }
+
+    //! Add two tuple observables component-wise
+    template <class... T>
+    const TupleObservable<T...> operator+(const TupleObservable<T...>& lhs, const TupleObservable<T...>& rhs) { return TupleObservable<T...>(lhs) += rhs; }
+    //! Substract two tuple observables component-wise
+    template <class... T>
+    const TupleObservable<T...> operator-(const TupleObservable<T...>& lhs, const TupleObservable<T...>& rhs) { return TupleObservable<T...>(lhs) -= rhs; }
+    //! Multiply two tuple observables component-wise
+    template <class... T>
+    const TupleObservable<T...> operator*(const TupleObservable<T...>& lhs, const TupleObservable<T...>& rhs) { return TupleObservable<T...>(lhs) *= rhs; }
+    //! Divide two tuple observables component-wise
+    template <class... T>
+    const TupleObservable<T...> operator/(const TupleObservable<T...>& lhs, const TupleObservable<T...>& rhs) { return TupleObservable<T...>(lhs) /= rhs; }
+    //! Multiply a scalar and a tuple observable
+    template <class S, class... T>
+    const TupleObservable<T...> operator*(const S& lhs, const TupleObservable<T...>& rhs) { return TupleObservable<T...>(rhs) *= lhs; }
+    //! Multiply a tuple observable and a scalar
+    template <class S, class... T>
+    const TupleObservable<T...> operator*(const TupleObservable<T...>& lhs, const S& rhs) { return TupleObservable<T...>(lhs) *= rhs; }
+    //! Divide a tuple observable by a scalar
+    template <class S, class... T>
+    const TupleObservable<T...> operator/(const TupleObservable<T...>& lhs, const S& rhs) { return TupleObservable<T...>(lhs) /= rhs; }
+
+    //! Exponentiate the tuple observable with a scalar component-wise
+    template <class S, class... T>
+    const TupleObservable<T...> pow(const TupleObservable<T...>& base, const S& exponent)
+    {
+      TupleObservable<T...> result;
+      Details::STL_Extensions::TupleComponents<0, sizeof...(T)>::power(result.tuple(), base.tuple(), exponent);
+      return result;
+    }
+    //! Takes the square root of the tuple observable component-wise
+    template <class... T>
+    const TupleObservable<T...> sqrt(const TupleObservable<T...>& number)
+    {
+      return pow(number, 0.5);
+    }
+
+    //! Write a tuple observable to a stream (seperated by spaces)
+    template <class... T>
+    std::ostream& operator<<(std::ostream& stream, const TupleObservable<T...>& rhs)
+    {
+      Details::STL_Extensions::TupleComponents<0, sizeof...(T)>::write(stream, rhs.tuple());
+      return stream;
+    }
+    //! Read a tuple observable from a stream
+    template <class... T>
+    std::istream& operator>>(std::istream& stream, TupleObservable<T...>& rhs)
+    {
+      Details::STL_Extensions::TupleComponents<0, sizeof...(T)>::read(stream, rhs.tuple());
+      return stream;
+    }
+  }
+}
+
+namespace boost
+{
+  namespace numeric
+  {
+    namespace functional
+    {
+      // Tag type for TupleObservable
+      template <typename... T>
+      struct TupleObservableTag;
+
+      // Specialise tag<> for TupleObservable
+      template <typename... T> struct tag<Mocasinns::Observables::TupleObservable<T...> >
+      {
+	typedef TupleObservableTag<T...> type;
+      };
+
+      // Specify how to devide a TupleObservable by an integral count (fdiv is used by the mean of boost::accumulators, average derives from it)
+      template <typename Left, typename Right, class... T>
+      struct fdiv<Left, Right, TupleObservableTag<T...>, void>
+      {
+	// Define the type of the result
+	typedef Mocasinns::Observables::TupleObservable<T...> result_type;
+
+	// Define the result operator
+	result_type operator()(Left& left , Right& right) const
+	{
+	  return left / static_cast<double>(right);
+	}
+      };
+    }
+  }
+}
+
+#endif
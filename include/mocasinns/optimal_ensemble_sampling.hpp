@@ -150,6 +150,8 @@ namespace Mocasinns
     HistoType<EnergyType, double> calculate_log_density_of_states() const;
     //! Initialise the histograms with the parameters
     void initialize_with_parameters();
+    //! Apply the coalesced rejected steps at the current energy to the incidence counter of the current walker label
+    void apply_rejected_steps(Details::Multicanonical::StepParameter<EnergyType>& step_parameters);
 
     //! Friend class declaration for boost serialization
     friend class boost::serialization::access;
@@ -189,6 +191,9 @@ namespace Mocasinns
     //! Largest possible energy of the system, used to change the sign of the walker
     EnergyType maximal_energy;
 
+    //! Flag indicating whether consecutive rejected steps are counted in the incidence counters as one update before the next executed step, default value is false
+    bool coalesce_rejected_steps;
+
     //! Prototype histogram for all settings that the histograms of the simulation can have (e.g. binning width ...)
     HistoType<EnergyType, incidence_counter_y_value_t> prototype_histo;
 
@@ -201,6 +206,7 @@ namespace Mocasinns
 		   use_energy_cutoff_upper(false),
 		   minimal_energy(0),
 		   maximal_energy(100),
+		   coalesce_rejected_steps(false),
 		   prototype_histo() {}
   };
   
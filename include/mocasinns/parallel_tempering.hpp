@@ -14,9 +14,11 @@
 #include "metropolis.hpp"
 #include "serial_tempering.hpp"
 #include "concepts/concepts.hpp"
+#include "hooks/hooks.hpp"
 
 // Boost serialization for derived classes
 #include <boost/serialization/base_object.hpp>
+#include <boost/serialization/version.hpp>
 
 // Boost function types for the standard observable
 #include <boost/function_types/result_type.hpp>
@@ -48,6 +50,16 @@ namespace Mocasinns
    * If the chosen temperature range is to small, computation time is wasted since simulations with neighbouring inverse temperatures produce basically the same information.
    * Especially if there are phase transitions present in the system at certain inverse temperatures, the range around these critical temperatures must be sampled mor accuratly as far away from the cricitcal regions.
    *
+   * If Parameters::adaptive_measurement_spacing is set, the energies at the fixed inverse temperatures are sampled after every replica exchange and the number of
+   * replica exchanges between two measurements is adapted to Parameters::measurement_spacing_fraction times the largest of their integrated autocorrelation times.
+   *
+   * If Parameters::adaptive_proposal_tuning is set, the proposal widths of the configurations are tuned separately for every inverse temperature during the relaxation
+   * (see Metropolis::begin_proposal_tuning()). The tuned widths belong to the inverse temperatures: A configuration moved to another inverse temperature by a replica exchange
+   * gets the widths tuned for this temperature, so the widths are fixed for every temperature during the measurements.
+   *
+   * The signal handlers are invoked by the hook policy HookPolicy. The default policy Hooks::SignalHooks forwards the hooks to the signal handlers,
+   * with Hooks::NoHooks (or an own policy derived from it) the signal handlers are not invoked and the unused hooks are removed by the compiler.
+   *
    * \signalhandlers
    * \signalhandler{signal_handler_measurement,This handler is called after every measurement.}
    * \signalhandler{signal_handler_replica_exchange,This handler is called after every replica exchange.}
@@ -57,13 +69,14 @@ namespace Mocasinns
    * \tparam ConfigurationType \concept{ConfigurationType}
    * \tparam StepType \concept{StepType}
    * \tparam RandomNumberGenerator \concept{RandomNumberGenerator}
+   * \tparam HookPolicy Class providing the hooks <tt>measurement(SimulationType*)</tt> and <tt>replica_exchange(SimulationType*)</tt>, see Hooks::NoHooks
    *
    * \references
    * \reference{1, Swendsen R.H. and Wang J.-S.\, PRL 57 (1986) 2607}
    * \reference{2, Hukushima K. and Nemoto K.\, J. Phys. Soc. Japan 65 (1996) 1604}
    * \endreferences
    */
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy = Hooks::SignalHooks>
   class ParallelTempering : public Simulation<ConfigurationType, RandomNumberGenerator>
   {
     // Check the configuration concept
@@ -77,7 +90,7 @@ namespace Mocasinns
     // Typedef for the base class
     typedef Simulation<ConfigurationType, RandomNumberGenerator> Base;
     //! Typedef of this class
-    typedef ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator> this_type;
+    typedef ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy> this_type;
     //! Typedef for a metropolis simulation with the same template paramters
     typedef Metropolis<ConfigurationType, StepType, RandomNumberGenerator> MetropolisType;
     //! Type of the default observable
@@ -115,6 +128,8 @@ namespace Mocasinns
 	result.push_back(get_config_space(i));
       return result;
     }
+    //! Get-accessor for the hook policy object
+    HookPolicy& get_hooks() { return hooks; }
     //! Get-accessor for the parameters of the parallel tempering simulation
     const Parameters& get_simulation_parameters() { return simulation_parameters; }
     //! Set-accessor for the parameters of the parallel tempering simulation
@@ -132,6 +147,15 @@ namespace Mocasinns
     //! Histogram of temperature visits after leaving the maximal inverse temperature
     const InverseTemperatureHistogram& get_inverse_temperature_histogram_down() const { return inverse_temperature_histogram_down; }
 
+    //! Number of relaxation steps performed by the last relaxation (the detected relaxation time if Parameters::adaptive_relaxation is set)
+    step_number_t get_relaxation_steps_performed() const { return relaxation_steps_performed; }
+    //! Number of steps between two measurements, adapted to the largest autocorrelation time of the replicas if Parameters::adaptive_measurement_spacing is set
+    step_number_t get_steps_between_measurement() const { return simulation_parameters.adaptive_measurement_spacing ? measurement_spacing.get_steps_between_measurement() : simulation_parameters.steps_between_measurement; }
+    //! Estimate of the largest integrated autocorrelation time of the energies at the inverse temperatures in units of steps during the last simulation with Parameters::adaptive_measurement_spacing, 0 if no estimate is available
+    double get_autocorrelation_time() const { return measurement_spacing.get_autocorrelation_time(); }
+    //! Proposal width of the given step type tuned for the inverse temperature with the given index by the last relaxation with Parameters::adaptive_proposal_tuning, 0 if the width of this type was not tuned
+    double get_tuned_proposal_width(unsigned int index, std::size_t step_type) const { return metropolis_simulations[index].get_tuned_proposal_width(step_type); }
+
     //! Execute a given number of parallel tempering steps on the configuration at inverse temperatur beta
     template <class TemperatureTypeIterator>
     void do_parallel_tempering_steps(const step_number_t& number, TemperatureTypeIterator inverse_temperatures_begin, TemperatureTypeIterator inverse_temperatures_end);
@@ -139,6 +163,10 @@ namespace Mocasinns
     template <class NumberIterator, class TemperatureTypeIterator>
     void do_parallel_tempering_steps(NumberIterator numbers_begin, NumberIterator numbers_end, TemperatureTypeIterator inverse_temperatures_begin, TemperatureTypeIterator inverse_temperatures_end);
 
+    //! Perform the relaxation of all replicas at the given inverse temperatures, returns the number of performed relaxation steps
+    template <class TemperatureTypeIterator>
+    step_number_t do_parallel_tempering_relaxation(TemperatureTypeIterator inverse_temperatures_begin, TemperatureTypeIterator inverse_temperatures_end);
+
     //! Execute an inverse temperature exchange step
     template <class TemperatureTypeIterator>
     unsigned int do_replica_exchange(TemperatureTypeIterator inverse_temperatures_begin, TemperatureTypeIterator inverse_temperatures_end);
@@ -178,6 +206,8 @@ namespace Mocasinns
 
     //! Member variable for storing the instances of the Metropolis simulations
     std::vector<MetropolisType> metropolis_simulations;
+    //! Hook policy object invoked at every measurement and after every replica exchange
+    HookPolicy hooks;
 
     //! Vector that stores for each configuration pointer whether the minimal inverse temperature (false) or the maximal inverse temperature (true) was left
     std::map<ConfigurationType*, bool> replica_exchange_direction;
@@ -189,6 +219,14 @@ namespace Mocasinns
     InverseTemperatureHistogram inverse_temperature_histogram_up;
     //! Variable for storing the temperature visits after leaving the maximal inverse temperature
     InverseTemperatureHistogram inverse_temperature_histogram_down;
+    //! Number of relaxation steps performed by the last relaxation
+    step_number_t relaxation_steps_performed;
+    //! Number of steps between two measurements adapted to the autocorrelation times of the energies at the inverse temperatures
+    Details::Metropolis::MeasurementSpacing measurement_spacing;
+
+    //! Perform relaxation steps on all replicas, in portions of Parameters::proposal_tuning_steps steps followed by an adaption of the proposal widths of every replica if Parameters::adaptive_proposal_tuning is set
+    template <class TemperatureTypeIterator>
+    void do_parallel_tempering_relaxation_steps(const step_number_t& number, TemperatureTypeIterator inverse_temperatures_begin, TemperatureTypeIterator inverse_temperatures_end);
 
     //! Private function to check whether a given temperature range has the same size as the configuration pointers and throw an error if necessary.
     template <class TemperatureTypeIterator>
@@ -196,17 +234,23 @@ namespace Mocasinns
 
     //! Member variable for boost serialization
     friend class boost::serialization::access;
-    //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
-    template<class Archive> void serialize(Archive & ar, const unsigned int)
+    //! Method to serialize this class, the replicas and the measurement spacing are stored since version 1
+    template<class Archive> void serialize(Archive & ar, const unsigned int version)
     {
       // serialize base class information
       ar & boost::serialization::base_object<Simulation<ConfigurationType, RandomNumberGenerator> >(*this);
+      if (version < 1) return;
+
+      // Serialize the replicas (the random number generators and the tracked energies)
+      ar & metropolis_simulations;
+      // Serialize the adaption of the measurement spacing
+      ar & measurement_spacing;
     }
   };
   
   //! Struct storing the definition of the Parameters of a Metropolis-Simulation
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
-  struct ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::Parameters
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+  struct ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::Parameters
     : SerialTempering<ConfigurationType, StepType, RandomNumberGenerator>::Parameters
   {    
     //! Number of parallel processes to use. The number of considered temperatures should be devidable through this number
@@ -215,6 +259,22 @@ namespace Mocasinns
     Parameters() : SerialTempering<ConfigurationType, StepType, RandomNumberGenerator>::Parameters(), process_number(2) { }
   };
 }
+
+namespace boost
+{
+  namespace serialization
+  {
+    //! Version 1 of the serialization of ParallelTempering adds the replicas and the measurement spacing
+    template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+    struct version<Mocasinns::ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+  }
+}
+
 #include "src/parallel_tempering.cpp"
 
 #endif
@@ -0,0 +1,300 @@
+/*!
+  \file profiling.hpp
+
+  \brief Per-phase profiling of the hot paths of the simulations, enabled at compile time with MOCASINNS_PROFILING
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_PROFILING_PROFILING_HPP
+#define MOCASINNS_PROFILING_PROFILING_HPP
+
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+
+namespace Mocasinns
+{
+  //! Namespace for the per-phase profiling of the simulation loops
+  /*!
+    \details If the macro MOCASINNS_PROFILING is defined before the first header of MoCaSinns is included, Simulation::do_steps and the <tt>do_*_simulation</tt> drivers of the algorithms count the calls and the time spent in each Phase. The counters are kept per thread and aggregated by the functions of this namespace, e.g.
+    \code
+    #define MOCASINNS_PROFILING
+    #include <mocasinns/metropolis.hpp>
+    ...
+    simulation.do_metropolis_simulation(beta);
+    Mocasinns::Profiling::report(std::cout);
+    \endcode
+    The time of nested phases is not charged to the enclosing phase, so the times of all phases add up to the time spent in the instrumented code. If MOCASINNS_PROFILING is not defined, the macro MOCASINNS_PROFILE_SCOPE expands to nothing and the simulations contain no profiling code at all. Defining MOCASINNS_PROFILING also defines MOCASINNS_ACCEPTANCE_RATIO.
+  */
+  namespace Profiling
+  {
+    //! Phases of the simulation loops that are profiled
+    enum Phase
+    {
+      propose,		//!< Proposal of the steps by the configuration
+      is_executable,	//!< Check whether a step is executable
+      delta_E,		//!< Calculation of the energy difference of a step
+      acceptance,	//!< Calculation of the acceptance probability (without the energy difference)
+      random_number,	//!< Random numbers deciding about the acceptance or selecting a step
+      execute,		//!< Execution of accepted steps
+      handle,		//!< The handle_executed_step and handle_rejected_step callbacks of the algorithm
+      observe,		//!< Observation of the configuration by the observator
+      accumulate,	//!< Accumulation of the observed values (without the observation)
+      signal,		//!< Dispatch of the hooks and boost signals of the simulations
+      phase_number	//!< Number of phases, used as marker for code outside of all phases
+    };
+
+    //! Name of a phase as used in the report and the dump
+    inline const char* phase_name(Phase phase)
+    {
+      static const char* const names[phase_number] = { "propose", "is_executable", "delta_E", "acceptance", "random_number",
+						       "execute", "handle", "observe", "accumulate", "signal" };
+      return (phase < phase_number ? names[phase] : "none");
+    }
+
+    //! Counters of a single phase
+    struct PhaseCounter
+    {
+      //! Number of times the phase was entered
+      uint64_t calls;
+      //! Time spent in the phase (excluding nested phases) in nanoseconds
+      uint64_t nanoseconds;
+
+      //! Standard constructor, sets both counters to zero
+      PhaseCounter() : calls(0), nanoseconds(0) {}
+
+      //! Add the counters of another phase counter
+      PhaseCounter& operator+=(const PhaseCounter& rhs) { calls += rhs.calls; nanoseconds += rhs.nanoseconds; return *this; }
+    };
+
+    //! Counters of all phases of one thread
+    /*!
+      \details The profiler stores the phase that is actually running and the time stamp of its last change. When a phase is entered, the time since the last change is charged to the running phase, so the time of nested phases is charged exclusively. Time outside of all phases is not charged.
+    */
+    class ThreadProfiler
+    {
+    public:
+      //! Standard constructor, creates a profiler with vanishing counters outside of all phases
+      ThreadProfiler() : counters(phase_number), running_phase(phase_number), last_change(now()) {}
+
+      //! Enter the given phase and return the phase that was running before
+      Phase enter(Phase phase)
+      {
+	const uint64_t time = now();
+	charge(time);
+	const Phase previous_phase = running_phase;
+	running_phase = phase;
+	++counters[phase].calls;
+	return previous_phase;
+      }
+      //! Leave the running phase and continue the given phase that was running before
+      void leave(Phase previous_phase)
+      {
+	charge(now());
+	running_phase = previous_phase;
+      }
+
+      //! Get-accessor for the counters of all phases
+      const std::vector<PhaseCounter>& get_counters() const { return counters; }
+      //! Set all counters to zero
+      void reset() { counters.assign(phase_number, PhaseCounter()); }
+
+    private:
+      //! Counters of the phases
+      std::vector<PhaseCounter> counters;
+      //! Phase that is actually running, phase_number if no phase is running
+      Phase running_phase;
+      //! Time stamp of the last change of the running phase in nanoseconds
+      uint64_t last_change;
+
+      //! Charge the time since the last change to the running phase
+      void charge(uint64_t time)
+      {
+	if (running_phase < phase_number) counters[running_phase].nanoseconds += time - last_change;
+	last_change = time;
+      }
+      //! Actual time stamp of a monotonic clock in nanoseconds
+      static uint64_t now()
+      {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+      }
+    };
+
+    //! Registry owning the profilers of all threads that entered a phase
+    /*!
+      \details The profilers are not deleted when their threads end, so the counters of the worker threads of a parallel region are still available after the region.
+    */
+    class Registry
+    {
+    public:
+      //! Delete all registered profilers
+      ~Registry()
+      {
+	for (std::size_t t = 0; t < profilers.size(); ++t) delete profilers[t];
+      }
+
+      //! Create and register a new profiler
+      ThreadProfiler* create()
+      {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	profilers.push_back(new ThreadProfiler());
+	return profilers.back();
+      }
+
+      //! Copy the counters of all registered profilers (first index: thread, second index: phase)
+      std::vector<std::vector<PhaseCounter> > counters()
+      {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	std::vector<std::vector<PhaseCounter> > result;
+	result.reserve(profilers.size());
+	for (std::size_t t = 0; t < profilers.size(); ++t) result.push_back(profilers[t]->get_counters());
+	return result;
+      }
+
+      //! Set the counters of all registered profilers to zero
+      void reset()
+      {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	for (std::size_t t = 0; t < profilers.size(); ++t) profilers[t]->reset();
+      }
+
+    private:
+      //! Mutex protecting the list of profilers
+      std::mutex registry_mutex;
+      //! Profilers of all threads in the order of registration
+      std::vector<ThreadProfiler*> profilers;
+    };
+
+    //! Global registry of the profilers
+    inline Registry& registry()
+    {
+      static Registry global_registry;
+      return global_registry;
+    }
+
+    //! Profiler of the calling thread, created and registered at the first call in every thread
+    inline ThreadProfiler& thread_profiler()
+    {
+      static thread_local ThreadProfiler* profiler = registry().create();
+      return *profiler;
+    }
+
+    //! Counters of all threads (first index: thread in the order in which the threads entered their first phase, second index: phase)
+    /*!
+      \details The counters should only be read while no thread is inside a profiled phase.
+    */
+    inline std::vector<std::vector<PhaseCounter> > thread_counters() { return registry().counters(); }
+
+    //! Counters of every phase summed over all threads
+    inline std::vector<PhaseCounter> aggregate()
+    {
+      const std::vector<std::vector<PhaseCounter> > counters = thread_counters();
+      std::vector<PhaseCounter> result(phase_number);
+      for (std::size_t t = 0; t < counters.size(); ++t)
+	for (std::size_t p = 0; p < phase_number; ++p) result[p] += counters[t][p];
+      return result;
+    }
+
+    //! Set the counters of all threads to zero
+    inline void reset() { registry().reset(); }
+
+    //! Write a human readable table of the aggregated counters with the share of every phase in the total time
+    inline void report(std::ostream& output_stream)
+    {
+      const std::vector<PhaseCounter> counters = aggregate();
+      const std::ios_base::fmtflags stream_flags = output_stream.flags();
+      const std::streamsize stream_precision = output_stream.precision();
+      uint64_t total_nanoseconds = 0;
+      for (std::size_t p = 0; p < phase_number; ++p) total_nanoseconds += counters[p].nanoseconds;
+
+      output_stream << std::left << std::setw(16) << "phase" << std::right << std::setw(16) << "calls" << std::setw(16) << "time [ms]"
+		    << std::setw(16) << "ns per call" << std::setw(10) << "share" << std::endl;
+      for (std::size_t p = 0; p < phase_number; ++p)
+      {
+	if (counters[p].calls == 0) continue;
+	output_stream << std::left << std::setw(16) << phase_name(static_cast<Phase>(p)) << std::right
+		      << std::setw(16) << counters[p].calls
+		      << std::setw(16) << std::fixed << std::setprecision(3) << counters[p].nanoseconds * 1e-6
+		      << std::setw(16) << std::setprecision(1) << static_cast<double>(counters[p].nanoseconds) / counters[p].calls
+		      << std::setw(9) << (total_nanoseconds > 0 ? 100.0 * counters[p].nanoseconds / total_nanoseconds : 0.0) << "%" << std::endl;
+      }
+      output_stream.flags(stream_flags);
+      output_stream.precision(stream_precision);
+    }
+
+    //! Write the counters of every thread and the aggregated counters as tab separated values
+    /*!
+      \details The dump starts with the header line <tt>thread phase calls nanoseconds</tt>, followed by one line for every phase of every thread. The aggregated counters are written with the thread <tt>all</tt>.
+    */
+    inline void dump(std::ostream& output_stream)
+    {
+      const std::vector<std::vector<PhaseCounter> > counters = thread_counters();
+      output_stream << "thread\tphase\tcalls\tnanoseconds\n";
+      for (std::size_t t = 0; t < counters.size(); ++t)
+	for (std::size_t p = 0; p < phase_number; ++p)
+	  output_stream << t << "\t" << phase_name(static_cast<Phase>(p)) << "\t" << counters[t][p].calls << "\t" << counters[t][p].nanoseconds << "\n";
+
+      const std::vector<PhaseCounter> total = aggregate();
+      for (std::size_t p = 0; p < phase_number; ++p)
+	output_stream << "all\t" << phase_name(static_cast<Phase>(p)) << "\t" << total[p].calls << "\t" << total[p].nanoseconds << "\n";
+      output_stream.flush();
+    }
+
+    //! Class entering a phase in the constructor and leaving it in the destructor
+    class ScopedPhase
+    {
+    public:
+      //! Enter the given phase in the profiler of the calling thread
+      explicit ScopedPhase(Phase phase) : profiler(thread_profiler()), previous_phase(profiler.enter(phase)) {}
+      //! Leave the phase and continue the phase that was running before
+      ~ScopedPhase() { profiler.leave(previous_phase); }
+
+    private:
+      ScopedPhase(const ScopedPhase&);
+      ScopedPhase& operator=(const ScopedPhase&);
+
+      //! Profiler of the thread that entered the phase
+      ThreadProfiler& profiler;
+      //! Phase that was running before
+      Phase previous_phase;
+    };
+
+    //! Observe the configuration with the given observator in the phase observe
+    template <class Observator, class ConfigurationType>
+    inline typename Observator::observable_type observe_configuration(ConfigurationType* configuration)
+    {
+#ifdef MOCASINNS_PROFILING
+      ScopedPhase scope(observe);
+#endif
+      return Observator::observe(configuration);
+    }
+    //! Observe a single chain of an ensemble configuration with the given observator in the phase observe
+    template <class Observator, class ConfigurationType>
+    inline typename Observator::observable_type observe_configuration(ConfigurationType* configuration, std::size_t chain)
+    {
+#ifdef MOCASINNS_PROFILING
+      ScopedPhase scope(observe);
+#endif
+      return Observator::observe(configuration, chain);
+    }
+  }
+}
+
+//! \cond
+#define MOCASINNS_PROFILE_CONCATENATE_IMPL(first, second) first ## second
+#define MOCASINNS_PROFILE_CONCATENATE(first, second) MOCASINNS_PROFILE_CONCATENATE_IMPL(first, second)
+//! \endcond
+
+//! Profile the rest of the enclosing block as the given phase of Mocasinns::Profiling::Phase, expands to nothing if MOCASINNS_PROFILING is not defined
+#ifdef MOCASINNS_PROFILING
+#define MOCASINNS_PROFILE_SCOPE(phase) ::Mocasinns::Profiling::ScopedPhase MOCASINNS_PROFILE_CONCATENATE(mocasinns_profile_scope_, __LINE__)(::Mocasinns::Profiling::phase)
+#else
+#define MOCASINNS_PROFILE_SCOPE(phase)
+#endif
+
+#endif
@@ -2,6 +2,8 @@
 #define MOCASINNS_RANDOM_BOOST_RANDOM_INTERFACE
 
 #include <cstdint>
+#include <string>
+#include <sstream>
 
 // Boost headers for distributions
 #include <boost/random/uniform_01.hpp>
@@ -29,9 +31,11 @@ namespace Mocasinns
 	
 	double_01_distribution = new boost::random::uniform_01<double>();
 	int_distribution = new boost::random::uniform_int_distribution<RandomIntType>();
+	bits64_distribution = new boost::random::uniform_int_distribution<uint64_t>();
       }
       ~BoostRandomInterface()
       {
+	delete bits64_distribution;
 	delete int_distribution;
 	delete double_01_distribution;
 
@@ -40,6 +44,19 @@ namespace Mocasinns
 
       //! Set the seed of the random number generator
       void set_seed(const RandomIntType& new_seed) { rng->seed(new_seed); }
+      //! Write the state of the random number generator into a string (used to store it in checkpoints)
+      std::string get_state() const
+      {
+	std::ostringstream state_stream;
+	state_stream << *rng;
+	return state_stream.str();
+      }
+      //! Restore the state of the random number generator from a string written by get_state()
+      void set_state(const std::string& state)
+      {
+	std::istringstream state_stream(state);
+	state_stream >> *rng;
+      }
       //! Return the minimal integer that is created by \::random_int32()
       RandomIntType get_int_min() const { return int_distribution->min(); }
       //! Return the maximal integer that is created by \::random_int32()
@@ -73,12 +90,18 @@ namespace Mocasinns
 	boost::random::uniform_int_distribution<RandomIntType> temp_distribution(min, max);
 	return temp_distribution(*rng);
       }
+      //! Create 64 independent and uniformly distributed random bits (used for multi-spin coding)
+      uint64_t random_bits64()
+      {
+	return (*bits64_distribution)(*rng);
+      }
 
     private:
       BoostRandomNumberGenerator* rng;
       
       boost::random::uniform_01<double>* double_01_distribution;
       boost::random::uniform_int_distribution<RandomIntType>* int_distribution;
+      boost::random::uniform_int_distribution<uint64_t>* bits64_distribution;
     };
   }
 }
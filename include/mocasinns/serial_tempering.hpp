@@ -16,6 +16,7 @@
 
 // Boost serialization for derived classes
 #include <boost/serialization/base_object.hpp>
+#include <boost/serialization/version.hpp>
 
 // Boost function types for the standard observable
 #include <boost/function_types/result_type.hpp>
@@ -67,6 +68,10 @@ namespace Mocasinns
     void set_simulation_parameters(const Parameters& value) { simulation_parameters = value; }
     //! Get-accessor for the log of the executed replica exchanges. At index 0 the number of non-executed replica exchanges is stored, at index i the number of executed exchanges between inverse temperature index (i-1) and i.
     const std::vector<unsigned int>& get_replica_exchange_log() { return replica_exchange_log; }
+    //! Number of steps between two measurements, adapted to the largest autocorrelation time of the replicas if Parameters::adaptive_measurement_spacing is set
+    step_number_t get_steps_between_measurement() const { return simulation_parameters.adaptive_measurement_spacing ? measurement_spacing.get_steps_between_measurement() : simulation_parameters.steps_between_measurement; }
+    //! Estimate of the largest integrated autocorrelation time of the energies at the inverse temperatures in units of steps during the last simulation with Parameters::adaptive_measurement_spacing, 0 if no estimate is available
+    double get_autocorrelation_time() const { return measurement_spacing.get_autocorrelation_time(); }
 
     //! Execute a given number of parallel tempering steps on the configuration at inverse temperatur beta
     template <class TemperatureTypeIterator>
@@ -112,6 +117,15 @@ namespace Mocasinns
     std::vector<MetropolisType> metropolis_simulations;
     //! Member variable for storing the done replica exchanges. 
     std::vector<unsigned int> replica_exchange_log;
+    //! Number of steps between two measurements adapted to the autocorrelation times of the energies at the inverse temperatures
+    Details::Metropolis::MeasurementSpacing measurement_spacing;
+
+    //! Add the energies at the fixed inverse temperatures to the estimate of the autocorrelation times
+    void sample_energies()
+    {
+      for (unsigned int i = 0; i < metropolis_simulations.size(); ++i)
+	measurement_spacing.add(i, metropolis_simulations[i].get_energy());
+    }
 
     //! Private function to check whether a given temperature range has the same size as the configuration pointers and throw an error if necessary.
     template <class TemperatureTypeIterator>
@@ -119,8 +133,8 @@ namespace Mocasinns
     
     //! Member variable for boost serialization
     friend class boost::serialization::access;
-    //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
-    template<class Archive> void serialize(Archive & ar, const unsigned int)
+    //! Method to serialize this class, the measurement spacing is stored since version 1
+    template<class Archive> void serialize(Archive & ar, const unsigned int version)
     {
       // serialize base class information
       ar & boost::serialization::base_object<Simulation<ConfigurationType, RandomNumberGenerator> >(*this);
@@ -129,6 +143,7 @@ namespace Mocasinns
       ar & configuration_pointers;
       ar & metropolis_simulations;
       ar & replica_exchange_log;
+      if (version >= 1) ar & measurement_spacing;
     }
   };
   
@@ -145,6 +160,21 @@ namespace Mocasinns
   
 } // of namespace Mocasinns
 
+namespace boost
+{
+  namespace serialization
+  {
+    //! Version 1 of the serialization of SerialTempering adds the measurement spacing
+    template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+    struct version<Mocasinns::SerialTempering<ConfigurationType, StepType, RandomNumberGenerator> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+  }
+}
+
 #include "src/serial_tempering.cpp"
 
 #endif
@@ -16,18 +16,46 @@
 #include <cstdlib>
 #include <csignal>
 #include <ctime>
+#include <chrono>
+#include <vector>
+#include <cstddef>
 
 // Header for the serialization of the class
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/serialization/string.hpp>
+#include <boost/serialization/version.hpp>
 // Header for signal handling
 #include <boost/signals2/signal.hpp>
+// Header for conditional compile based on template parameters
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <boost/mpl/and.hpp>
 
 // Header for the standard random number generator
 #include "random/boost_random.hpp"
+// Header for the per-phase profiling of the simulation loops
+#include "profiling/profiling.hpp"
+// Header for the acceptance statistics resolved by energy difference and step type
+#include "statistics/acceptance_statistics.hpp"
 // Header for checking whether the step type exposes certain functions
 #include "details/optional_member_functions.hpp"
+// Header for the rates of the incremental rejection-free algorithm
+#include "details/rejection_free/rate_tree.hpp"
+// Header for the step classes of the n-fold way algorithm
+#include "details/rejection_free/step_classes.hpp"
+// Header for the step buffers of the rejection-free algorithm
+#include "details/rejection_free/step_buffer.hpp"
+// Header for the wall-clock time budget of the simulations
+#include "details/checkpoint/time_budget.hpp"
+// Header for the exception thrown if a checkpoint cannot be written
+#include "exceptions/checkpoint_exception.hpp"
+
+// The profiling includes the counting of the accepted and rejected steps
+#if defined(MOCASINNS_PROFILING) && !defined(MOCASINNS_ACCEPTANCE_RATIO)
+#define MOCASINNS_ACCEPTANCE_RATIO
+#endif
 
 namespace Mocasinns
 {
@@ -68,15 +96,50 @@ public:
   const std::string& get_dump_filename() const { return dump_filename; }
   //! Set-Accesspr for the path and name of the dumped file
   void set_dump_filename(const std::string& value) { dump_filename = value; }
+  //! Get-Accessor for the number of steps proposed at once if the configuration supports batched proposals
+  std::size_t get_step_block_size() const { return step_block_size; }
+  //! Set-Accessor for the number of steps proposed at once if the configuration supports batched proposals
+  void set_step_block_size(std::size_t value) { step_block_size = value; }
 
 #ifdef MOCASINNS_ACCEPTANCE_RATIO
+  //! Ratio of the accepted steps and all steps since the construction or the last reset (only if MOCASINNS_ACCEPTANCE_RATIO or MOCASINNS_PROFILING is defined)
   double acceptance_ratio() const { return static_cast<double>(accepted_steps) / static_cast<double>(accepted_steps + rejected_steps); }
+  //! Reset the counters of the accepted and rejected steps (only if MOCASINNS_ACCEPTANCE_RATIO or MOCASINNS_PROFILING is defined)
   void reset_acceptance_ratio() { accepted_steps = 0; rejected_steps = 0; }
 #endif
 
+  //! Get-Accessor for the flag whether the acceptance statistics are collected
+  bool get_collect_acceptance_statistics() const { return collect_acceptance_statistics; }
+  //! Set-Accessor for the flag whether the acceptance statistics are collected
+  void set_collect_acceptance_statistics(bool value) { collect_acceptance_statistics = value; }
+  //! Set the width of the energy bins of the acceptance statistics, clears the acceptance statistics
+  void set_acceptance_statistics_bin_width(double value);
+  //! Acceptance statistics of all threads since the construction or the last reset
+  Statistics::AcceptanceStatistics get_acceptance_statistics() const;
+  //! Clear the acceptance statistics of all threads
+  void reset_acceptance_statistics();
+
   //! Calculate the real time (in seconds) that passed since the start of the simulation
   int simulation_time_real() const { return time(NULL) - simulation_start; }
 
+  //! Set the wall-clock time budget (in seconds, counted from now) after which the simulation writes a checkpoint and stops, a budget of 0 disables it
+  void set_time_budget(double seconds);
+  //! Remaining wall-clock time budget in seconds, infinity if no time budget is set
+  double get_time_budget_remaining() const { return time_budget.remaining_seconds(); }
+  //! Get-Accessor for the factor by which the estimated duration of the next chunk is multiplied when checking the time budget
+  double get_time_budget_safety_factor() const { return time_budget.get_safety_factor(); }
+  //! Set-Accessor for the factor by which the estimated duration of the next chunk is multiplied when checking the time budget
+  void set_time_budget_safety_factor(double value) { time_budget.set_safety_factor(value); }
+  //! Get-Accessor for the flag indicating that the simulation was stopped by SIGTERM or the exhausted time budget
+  bool get_is_terminating() const { return is_terminating; }
+  //! Get-Accessor for the flag indicating that the simulation was stopped because the time budget was exhausted
+  bool get_time_budget_exhausted() const { return time_budget_exhausted; }
+
+  //! Save a checkpoint of the simulation to a file, replaces the file only after the checkpoint was written completely
+  void save_checkpoint(const char* filename);
+  //! Load a checkpoint of the simulation, the next call of the interrupted simulation function resumes the simulation at the point where it stopped
+  void load_checkpoint(const char* filename);
+
   //! Load the data of the simulation from a serialization stream
   virtual void load_serialize(std::istream& input_stream) { load_serialize(*this, input_stream); }
   //! Load the data of the simulation from a serialization file
@@ -106,9 +169,31 @@ protected:
   static void handle_posix_signal(int signal_number);
   //! Check whether a POSIX signal was caught and call the corresponding boost signals
   //! \returns True if termination signal was caught, false otherwise
-  bool check_for_posix_signal();
+  bool check_for_posix_signal() { return check_for_posix_signal(&Simulation::synchronize_nothing); }
+  //! Check for POSIX signals as check_for_posix_signal(), but call synchronize() before a signal handler is invoked or a checkpoint is written
+  template <class Synchronize> bool check_for_posix_signal(Synchronize synchronize);
+  //! Default synchronization of check_for_posix_signal(), there is no work pending in other threads
+  static void synchronize_nothing() {}
   //! Bool that indicates whether the simulation is terminating
   bool is_terminating;
+  //! Bool that indicates whether the simulation is terminating because the time budget was exhausted
+  bool time_budget_exhausted;
+  //! Wall-clock time budget and durations of the chunks between two checks for POSIX signals
+  Details::Checkpoint::TimeBudget time_budget;
+  //! Number of chunks (usually measurements) finished by the running simulation function, stored in the checkpoints
+  step_number_t finished_chunks;
+  //! Bool that indicates whether the next simulation function resumes a loaded checkpoint
+  bool resuming_checkpoint;
+  //! Bool that indicates whether the simulation functions can be resumed from a checkpoint, otherwise no checkpoint is written when the time budget is exhausted
+  bool checkpoints_resumable;
+  //! Number of steps proposed at once if the configuration supports batched proposals
+  std::size_t step_block_size;
+  //! Position of the next step in the sweep of the configuration
+  std::size_t sweep_position;
+  //! Flag whether the acceptance statistics are collected
+  bool collect_acceptance_statistics;
+  //! Acceptance statistics of every thread, the statistics with index 0 belong to the thread running the simulation
+  std::vector<Statistics::AcceptanceStatistics> thread_acceptance_statistics;
 
   //! \cond
   template <class Derived, class StepType, bool rejection_free, class AcceptanceProbabilityParameterType>
@@ -131,16 +216,22 @@ protected:
    * -# The acceptance probability of the step is calculated using the acceptance_probability function of the Dervied algorithm. Afterwards it is devided by the selection probability ratio if applicable.
    * -# A random number is generated that deterimines whether the step will be executed. According to the outcome of the random number the step is executed and the handle_executed_step function of the Derived algorithm is called, otherwise the handle_rejected_step function of the Derived algorithm is called.
    *
+   * If the ConfigurationType provides the member function <tt>propose_steps(RandomNumberGenerator* rng, std::vector<StepType>& steps)</tt>, the steps of the non rejection-free algorithm are proposed in blocks of get_step_block_size() steps. The configuration fills all steps of the given vector in one call (and can therefore evaluate the energy differences into a contiguous buffer and prefetch the lattice sites). The steps of a block are accepted or rejected sequentially as described above, a random number is only drawn for acceptance probabilities between 0 and 1. With a block size of 1 the batched proposal therefore yields the same Markov chain as the proposal of single steps, if propose_steps uses the random number generator like propose_step. If a step is executed and the ConfigurationType provides the member function <tt>update_proposed_steps(std::vector<StepType>& steps, std::size_t first_index, StepType& executed_step)</tt>, it is called to re-evaluate the remaining steps of the block that are invalidated by the executed step.
+   *
    * If the simulation is rejection-free (specified by the template parameter of the function), one step is executed in the following way (by calling the function do_steps_generic_rejection_free)
-   * -# All possible steps of the current configurations are proposed using the ConfigurationType::all_steps() function.
+   * -# All possible steps of the current configurations are proposed using the ConfigurationType::all_steps() function. If the ConfigurationType provides the member function <tt>all_steps(std::vector<StepType>& steps)</tt>, the steps are written into a buffer that is reused for all steps.
    * -# For each step it is determined whether it is executable (if the StepType does not provide an is_executable function, this is automatically assumed). If this is not the case, the acceptance probability of the step is set to 0.0
    * -# If the StepType provides the function selection_probability_factor, it is calculated for the current step.
    * -# The acceptance probability of the step is calculated using the acceptance_probability function of the Dervied algorithm. Afterwards it is devided by the selection probability ratio if applicable.
-   * -# After the exception probabilities of all steps were calculated, the step to execute is determined by randomly choosing an step weighted with their acceptance probability, and the time that a non-rejection free algorithm would spent in the actual state is calculated by inverting the sum of all acceptance probabilities.
-   * -# The acceptance probability of the step that will be executed is calculated again to get the acceptance_probability_parameter right
-   * -# If the calculated time is infinite (this is the case if all acceptance probabilities are 0), the step is rejected and the handle_rejected_step of the Derived algorithm is called
+   * -# After the exception probabilities of all steps were calculated, the step to execute is determined by randomly choosing an step weighted with their acceptance probability (using a binary search in the cumulated acceptance probabilities), and the time that a non-rejection free algorithm would spent in the actual state is calculated by inverting the sum of all acceptance probabilities.
+   * -# The acceptance_probability_parameter is set to the value it had after the calculation of the acceptance probability of the step that will be executed
+   * -# If the calculated time is infinite (this is the case if all acceptance probabilities are 0), the step is rejected and the handle_rejected_step of the Derived algorithm is called. If the Derived algorithm declares the static member <tt>local_acceptance_probability</tt>, the acceptance probabilities cannot change anymore and do_steps returns before the given number of steps is reached.
    * -# If there is a finite time the step is executed and the handle_executed_step function of the Derived algorithm is called with the time as parameter.
    *
+   * If the ConfigurationType additionally provides the member function <tt>affected_steps(StepType& executed_step, std::vector<std::size_t>& indices)</tt>, the rejection-free algorithm enumerates all steps only once per call of do_steps and stores their acceptance probabilities in a Fenwick tree (Details::RejectionFree::RateTree). The step at a given index of all_steps() must then always denote the same move evaluated on the actual configuration, and affected_steps appends the indices of all steps whose acceptance probabilities change by executing the given step. Selecting a step is done in \f$ O(\log N) \f$. If the Derived algorithm declares the static member <tt>local_acceptance_probability</tt> (the acceptance probability of a step depends only on the step itself, as for Metropolis), only the rates of the affected steps are recalculated after an executed step. Otherwise (e.g. for WangLandau and EntropicSampling, where the acceptance probabilities depend on the total energy and the density of states) all rates are recalculated after each executed or rejected step, but the steps are not enumerated again. If all acceptance probabilities vanish, the step is rejected; for local acceptance probabilities the rates cannot change anymore and do_steps returns before the given number of steps is reached.
+   *
+   * If in addition the energy differences of the steps are discrete (see Details::RejectionFree::use_step_classes), the n-fold way algorithm of Bortz, Kalos and Lebowitz is used instead of the Fenwick tree. The steps are grouped in classes of equal energy difference (Details::RejectionFree::StepClasses) and only the affected steps are moved between the classes after an executed step. The rate of a class is the acceptance probability of one of its members times the number of members, so choosing a step costs \f$ O(C) \f$ for C classes, independent of the system size and of whether the acceptance probabilities are local. The time handed to handle_executed_step is the same as for the other rejection-free variants. If all class rates vanish (e.g. in a frozen state or if the acceptance probabilities underflow at low temperatures), the step is rejected and for local acceptance probabilities do_steps returns as well.
+   *
    * \tparam Derived Type of the derived algorithm
    * \tparam StepType Type of the steps proposed by the ConfigurationType
    * \tparam rejection_free Boolean template parameter specifying whether to execute rejection free steps.
@@ -153,8 +244,43 @@ protected:
   void do_steps(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
 #endif
 
+  //! \cond
+  template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+  typename boost::enable_if_c<Details::has_function_propose_sweep_step<ConfigurationType, StepType, boost::mpl::vector<std::size_t, RandomNumberGenerator*> >::value, void>::type
+  do_sweep_steps(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+
+  template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+  typename boost::enable_if_c<!Details::has_function_propose_sweep_step<ConfigurationType, StepType, boost::mpl::vector<std::size_t, RandomNumberGenerator*> >::value, void>::type
+  do_sweep_steps(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+  //! \endcond
+
+  // Doxygen-Documentation for the do-sweep-steps routine
+  /*!
+   * \details Executes a number of steps like the non rejection-free version of do_steps, but the steps are not proposed at random. Instead the sequence of steps given by the ConfigurationType is walked deterministically, so the random number generator is only used for the acceptance decision (and by the configuration if it needs random numbers to create a step). The ConfigurationType must provide the member functions <tt>std::size_t sweep_length()</tt> returning the number of steps of one sweep and <tt>StepType propose_sweep_step(std::size_t position, RandomNumberGenerator* rng)</tt> returning the step at the given position of the sweep. The order of the sweep (e.g. typewriter or Morton order) is chosen by the configuration. A sequential sweep fulfills the balance condition but not detailed balance. The position in the sweep is kept between the calls.
+   *
+   * If the ConfigurationType does not provide the sweep functions, the steps are proposed at random as in do_steps.
+   *
+   * \tparam Derived Type of the derived algorithm
+   * \tparam StepType Type of the steps proposed by the ConfigurationType
+   * \tparam AcceptanceProbabilityParameterType Type of the data that is piped to the acceptance probability calculation of the derived algorithm
+   * \param step_number Number of steps to perform (= number of executed steps + number of rejected steps)
+   * \param acceptance_probability_parameter Some object or quantity that piped to the acceptance probability calculation of the derived algorithm.
+   */
+#ifdef MOCASINNS_DOXYGEN_DOCUMENTATION
+  template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+  void do_sweep_steps(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+#endif
+
   //! Function to log the simulation start, stores the time of start of the simulation
-  void simulation_start_log() { simulation_start = time(NULL); }
+  void simulation_start_log() { simulation_start = time(NULL); time_budget.reset_chunks(); }
+
+  //! Start the loop over the chunks of a simulation function, returns the index of the first chunk
+  step_number_t begin_chunks();
+  //! Finish the chunk with the given index, check for POSIX signals and the time budget
+  //! \returns True if the simulation should be terminated, false otherwise
+  bool end_chunk(step_number_t chunk_index) { finished_chunks = chunk_index + 1; return check_for_posix_signal(); }
+  //! Finish the chunk as end_chunk(), but call synchronize() to wait for the work of the chunk pending in other threads before a signal handler is invoked or a checkpoint is written
+  template <class Synchronize> bool end_chunk(step_number_t chunk_index, Synchronize synchronize) { finished_chunks = chunk_index + 1; return check_for_posix_signal(synchronize); }
 
   //! Load a serialized simulation from a stream
   template <class Algorithm> static void load_serialize(Algorithm& simulation, std::istream& input_stream);
@@ -165,7 +291,76 @@ protected:
   //! Save a simulation to a file using serialization
   template <class Algorithm> static void save_serialize(const Algorithm& simulation, const char* filename);
 
+  //! Calculate the acceptance probability of a proposed step divided by the selection probability factor, returns 0.0 for steps that are not executable
+  template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+  double step_probability(StepType& step, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+  //! Decide with a random number whether a step with the given probability is accepted, no random number is drawn for probabilities outside of (0,1)
+  bool accept_step(double probability);
+  //! Make sure that there are acceptance statistics for the given number of threads, must be called before the threads record steps
+  void acceptance_statistics_reserve(std::size_t thread_number);
+  //! Count a proposed step with the given energy difference in the acceptance statistics of the given thread
+  template <class StepType, class EnergyDifferenceType>
+  void record_acceptance(std::size_t thread, StepType& step, const EnergyDifferenceType& delta_E, bool accepted)
+  {
+    thread_acceptance_statistics[thread].record(delta_E, Details::OptionalMemberFunctions::optional_step_type<StepType>(step), accepted);
+  }
+  //! Time stamp in seconds for measuring the time of the steps, 0.0 if no acceptance statistics are collected
+  double acceptance_statistics_start() const;
+  //! Add the time since the given time stamp to the acceptance statistics, if they are collected
+  void acceptance_statistics_stop(double start_time);
+  //! Execute or reject a proposed step and call the corresponding handler of the derived algorithm, returns whether the step was executed
+  template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+  bool execute_or_reject_step(StepType& step, bool accepted, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+
 private:
+  //! \cond
+  template <class Derived, class StepType, bool batched_proposal, class AcceptanceProbabilityParameterType>
+  typename boost::enable_if_c<!batched_proposal, void>::type // Proposes the steps one by one
+  do_steps_sequential(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+
+  template <class Derived, class StepType, bool batched_proposal, class AcceptanceProbabilityParameterType>
+  typename boost::enable_if_c<batched_proposal, void>::type // Proposes the steps in blocks
+  do_steps_sequential(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+  //! \endcond
+
+  //! \cond
+  template <class Derived, class StepType, bool incremental_rates, bool step_classes, class AcceptanceProbabilityParameterType>
+  typename boost::enable_if_c<!incremental_rates, void>::type // Enumerates all steps for every step
+  do_steps_rejection_free(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+
+  template <class Derived, class StepType, bool incremental_rates, bool step_classes, class AcceptanceProbabilityParameterType>
+  typename boost::enable_if_c<incremental_rates && !step_classes, void>::type // Updates the rates of the affected steps in a Fenwick tree
+  do_steps_rejection_free(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+
+  template <class Derived, class StepType, bool incremental_rates, bool step_classes, class AcceptanceProbabilityParameterType>
+  typename boost::enable_if_c<incremental_rates && step_classes, void>::type // Updates the classes of the affected steps (n-fold way)
+  do_steps_rejection_free(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+  //! \endcond
+
+  //! Calculate the key of the n-fold way class of a step (executability and energy difference)
+  template <class EnergyDifferenceType, class StepType>
+  static std::pair<bool, EnergyDifferenceType> step_class_key(StepType& step);
+
+  //! Execute or reject the selected step of a rejection-free algorithm with given total rate and decrease the remaining simulation time, returns whether the step was executed
+  template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+  bool execute_rejection_free_step(StepType& step, double total_rate, double& remaining_simulation_time, AcceptanceProbabilityParameterType& acceptance_probability_parameter);
+
+  //! \cond
+  template <class AcceptanceProbabilityParameterType>
+  static typename boost::enable_if_c<!boost::is_const<AcceptanceProbabilityParameterType>::value, void>::type
+  restore_acceptance_probability_parameter(AcceptanceProbabilityParameterType& acceptance_probability_parameter, const AcceptanceProbabilityParameterType& stored_value) { acceptance_probability_parameter = stored_value; }
+  template <class AcceptanceProbabilityParameterType>
+  static typename boost::enable_if_c<boost::is_const<AcceptanceProbabilityParameterType>::value, void>::type
+  restore_acceptance_probability_parameter(AcceptanceProbabilityParameterType&, const AcceptanceProbabilityParameterType&) { }
+  //! \endcond
+
+  //! Buffer for the cumulated acceptance probabilities of the rejection-free algorithm, reused for all steps
+  std::vector<double> cumulative_acceptance_probabilities;
+  //! Buffers for the steps and their acceptance probability parameters of the rejection-free algorithm, reused for all steps
+  Details::RejectionFree::StepBufferHolder rejection_free_step_buffer;
+  //! Rates of the steps of the incremental rejection-free algorithm
+  Details::RejectionFree::RateTree rejection_free_rates;
+
 #ifdef MOCASINNS_ACCEPTANCE_RATIO
   // Variable storing the accepted steps
   step_number_t accepted_steps;
@@ -175,7 +370,7 @@ private:
 
   //! Member variable for boost serialization
   friend class boost::serialization::access;
-  //! Method for serializing the class
+  //! Method for serializing the class, the checkpoint state is stored since version 1
   template<class Archive>
   void serialize(Archive & ar, const unsigned int version)
   {
@@ -183,17 +378,28 @@ private:
   }
 
   template<class ConfigurationTypeFunction, class Archive, typename boost::enable_if_c<Details::has_function_is_serializable<ConfigurationTypeFunction, bool>::value, bool>::type = false>
-  void serialize_generic(Archive & ar, const unsigned int)
+  void serialize_generic(Archive & ar, const unsigned int version)
   {
     ar & configuration_space;
     ar & rng_seed;
     ar & simulation_start;
+    if (version >= 1) serialize_checkpoint_state(ar);
   }
   template<class ConfigurationTypeFunction, class Archive, typename boost::enable_if_c<!Details::has_function_is_serializable<ConfigurationTypeFunction, bool>::value, bool>::type = false>
-  void serialize_generic(Archive & ar, const unsigned int)
+  void serialize_generic(Archive & ar, const unsigned int version)
   {
     ar & rng_seed;
     ar & simulation_start;
+    if (version >= 1) serialize_checkpoint_state(ar);
+  }
+  //! Serialize the state of the random number generator (if it provides get_state and set_state) and the number of finished chunks
+  template<class Archive>
+  void serialize_checkpoint_state(Archive & ar)
+  {
+    std::string rng_state = Details::OptionalMemberFunctions::optional_get_state(*rng);
+    ar & rng_state;
+    ar & finished_chunks;
+    if (Archive::is_loading::value) Details::OptionalMemberFunctions::optional_set_state(*rng, rng_state);
   }
 
   //! Set the signals for POSIX signals
@@ -207,6 +413,21 @@ private:
 
 } // of namespace Mocasinns
 
+namespace boost
+{
+  namespace serialization
+  {
+    //! Version 1 of the serialization of Simulation adds the state of the random number generator and the number of finished chunks
+    template <class ConfigurationType, class RandomNumberGenerator>
+    struct version<Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator> >
+    {
+      typedef mpl::int_<1> type;
+      typedef mpl::integral_c_tag tag;
+      BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+  }
+}
+
 #include "src/simulation.cpp"
 
 #endif
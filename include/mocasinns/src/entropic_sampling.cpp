@@ -45,15 +45,15 @@ namespace Mocasinns
   
   template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
   EntropicSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::EntropicSampling()
-    : Simulation<ConfigurationType, RandomNumberGenerator>(static_cast<ConfigurationType*>(0)), simulation_parameters(Parameters()) { }
+    : Simulation<ConfigurationType, RandomNumberGenerator>(static_cast<ConfigurationType*>(0)), simulation_parameters(Parameters()), tracked_energy_valid(false) { }
   
   template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
   EntropicSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::EntropicSampling(const Parameters& params) 
-    : Simulation<ConfigurationType, RandomNumberGenerator>(static_cast<ConfigurationType*>(0)), simulation_parameters(params) { } 
+    : Simulation<ConfigurationType, RandomNumberGenerator>(static_cast<ConfigurationType*>(0)), simulation_parameters(params), tracked_energy_valid(false) { } 
   
   template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
   EntropicSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::EntropicSampling(const Parameters& params, ConfigurationType* initial_configuration) 
-    : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), simulation_parameters(params) { } 
+    : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), simulation_parameters(params), tracked_energy_valid(false) { } 
   
   /*! \fn AUTO_TEMPLATE_1
    * \details The acceptance probability of the entropic sampling simulation is calculated using the following formula:
@@ -68,7 +68,10 @@ namespace Mocasinns
   double EntropicSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::acceptance_probability(StepType& step_to_execute, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
   {
     // Calculate the energy difference of the step
-    step_parameters.delta_E = step_to_execute.delta_E();
+    {
+      MOCASINNS_PROFILE_SCOPE(delta_E);
+      step_parameters.delta_E = step_to_execute.delta_E();
+    }
     EnergyType total_energy_after_step = step_parameters.total_energy + step_parameters.delta_E;
     
     // If an energy cutoff is used and the step would violate the energy cutoff, return 0.0
@@ -91,6 +94,9 @@ namespace Mocasinns
   template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
   void EntropicSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::handle_executed_step(StepType&, double time, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
   {
+    // Apply the rejected steps at the old energy
+    apply_rejected_steps(step_parameters);
+
     // Increment the total energy
     step_parameters.total_energy += step_parameters.delta_E;
     // Update the histograms
@@ -100,18 +106,41 @@ namespace Mocasinns
   /*! \fn AUTO_TEMPLATE_1
    * \details Increase the incidence histogram at the current energy of the system.
    *
+   * If <tt>Parameters::coalesce_rejected_steps</tt> is set, the time of the step is only added to the rejected time of the \c step_parameters, and the incidence counter is updated by apply_rejected_steps before the next executed step or at the end of do_entropic_sampling_steps. Since the acceptance probabilities do not depend on the incidence counter, the simulation is not changed by this.
+   *
    * \param time Specifies the time the algorithm has been in the previous state if doing a rejection free algorithm
    * \param step_parameters Structure for storing the actual energy of the system and the energy difference of the simulation. (Used for performance reasons)
    */
   template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
   void EntropicSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::handle_rejected_step(StepType&, double time, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
   {
+    // Only sum up the rejected steps if they are coalesced
+    if (simulation_parameters.coalesce_rejected_steps)
+    {
+      step_parameters.rejected_time += time;
+      return;
+    }
+
     // Update the histograms
     incidence_counter[step_parameters.total_energy] += time;
   }
+
+  /*! \fn AUTO_TEMPLATE_1
+   * \details Adds the rejected time stored in the \c step_parameters to the incidence counter at the current energy and resets the rejected time.
+   *
+   * \param step_parameters Structure for storing the actual energy of the system and the energy difference of the simulation. (Used for performance reasons)
+   */
+  template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
+  void EntropicSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::apply_rejected_steps(Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
+  {
+    if (step_parameters.rejected_time == 0.0) return;
+
+    incidence_counter[step_parameters.total_energy] += step_parameters.rejected_time;
+    step_parameters.rejected_time = 0.0;
+  }
   
   /*! \fn AUTO_TEMPLATE_1
-   * \details Performs the given number of entropic sampling steps and updates the incidence counter
+   * \details Performs the given number of entropic sampling steps and updates the incidence counter. If Parameters::track_energy is set, the energy tracked by the last call is used instead of calculating it again.
    * \param number Number of steps to perform.
    */
   template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
@@ -119,10 +148,20 @@ namespace Mocasinns
   {
     // Variable to track the energy
     Details::Multicanonical::StepParameter<EnergyType> step_parameters;
-    step_parameters.total_energy = this->configuration_space->energy();
+    if (simulation_parameters.track_energy && tracked_energy_valid)
+      step_parameters.total_energy = tracked_energy;
+    else
+      step_parameters.total_energy = this->configuration_space->energy();
     
     // Call the generic function of Simulation
     this->template do_steps<EntropicSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>, StepType, rejection_free>(number, step_parameters);
+
+    // Apply the remaining rejected steps before the flatness is checked
+    apply_rejected_steps(step_parameters);
+
+    // Store the energy for the next call
+    tracked_energy = step_parameters.total_energy;
+    tracked_energy_valid = true;
   }
   
   /*! \fn AUTO_TEMPLATE_1
@@ -133,6 +172,7 @@ namespace Mocasinns
   {
     // Log the start of the simulation
     this->simulation_start_log();
+    this->begin_chunks();
     
     double flatness_current = 0.0;
     
@@ -151,7 +191,10 @@ namespace Mocasinns
       // Check for signals and return if simulation should be terminated
       if (this->check_for_posix_signal()) return;
       // Handle the sweep signal handler
-      signal_handler_sweep(this);
+      {
+	MOCASINNS_PROFILE_SCOPE(signal);
+	signal_handler_sweep(this);
+      }
       
       // Reset the incidence counter
       incidence_counter.set_all_y_values(0);
@@ -172,6 +215,7 @@ namespace Mocasinns
   {
     // Log the start of the simulation
     this->simulation_start_log();
+    this->begin_chunks();
     
     for (unsigned int i = 0; i < iterations; ++i)
     {
@@ -185,7 +229,10 @@ namespace Mocasinns
       // Check for signals and return if simulation should be terminated
       if (this->check_for_posix_signal()) return;
       // Handle the sweep signal handler
-      signal_handler_sweep(this);
+      {
+	MOCASINNS_PROFILE_SCOPE(signal);
+	signal_handler_sweep(this);
+      }
       
       // Reset the incidence counter
       incidence_counter.set_all_y_values(0);
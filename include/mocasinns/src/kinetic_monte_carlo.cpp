@@ -0,0 +1,214 @@
+/*!
+ * \file kinetic_monte_carlo.cpp
+ * \brief Implementation of the libMoCaSinns kinetic Monte-Carlo template interface
+ *
+ * \author Benedikt Krüger
+ */
+
+#ifdef MOCASINNS_KINETIC_MONTE_CARLO_HPP
+
+#include <cmath>
+
+#include "../details/metropolis/vector_accumulator.hpp"
+
+namespace Mocasinns
+{
+
+/*!
+  \details The events are enumerated using the function all_steps of the configuration and their rates are stored in the Fenwick tree. Called once at the beginning of every public step and simulation function, so the configuration may be changed between the calls.
+*/
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+void KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::initialise_events()
+{
+  MOCASINNS_PROFILE_SCOPE(acceptance);
+  events.clear();
+  Details::OptionalMemberFunctions::optional_all_steps<ConfigurationType, StepType>(*this->configuration_space, events);
+  event_rates.assign(events.size());
+  for (std::size_t e = 0; e < events.size(); ++e)
+    event_rates.set_rate_lazy(e, events[e].rate());
+  event_rates.rebuild();
+}
+
+/*!
+  \param waiting_time Variable in which the exponentially distributed waiting time until the next event is stored
+  \param event_index Variable in which the index of the next event is stored, the event is chosen with a probability proportional to its rate
+*/
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+bool KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::choose_event(double& waiting_time, std::size_t& event_index)
+{
+  // The incrementally updated total may keep a rounding error if all rates vanish, which must not be taken for a non-absorbing state
+  const double total_rate = event_rates.reliable_total();
+  if (!(total_rate > 0.0)) return false;
+
+  double random_time, random_event;
+  {
+    MOCASINNS_PROFILE_SCOPE(random_number);
+    random_time = this->rng->random_double();
+    random_event = this->rng->random_double();
+  }
+  waiting_time = -std::log(1.0 - random_time) / total_rate;
+  event_index = event_rates.find(random_event * total_rate);
+  return true;
+}
+
+/*!
+  \details If the configuration provides the function affected_steps, only the rates of the affected events are recalculated, otherwise the rates of all events.
+*/
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+void KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::execute_event(std::size_t event_index)
+{
+  {
+    MOCASINNS_PROFILE_SCOPE(execute);
+    events[event_index].execute();
+  }
+  update_rates<Details::has_function_affected_steps<ConfigurationType, void, boost::mpl::vector<StepType&, std::vector<std::size_t>&> >::value>(event_index);
+}
+
+//! \cond
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+template<bool incremental_rates>
+typename boost::enable_if_c<!incremental_rates, void>::type
+KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::update_rates(std::size_t)
+{
+  MOCASINNS_PROFILE_SCOPE(acceptance);
+  for (std::size_t e = 0; e < events.size(); ++e)
+    event_rates.set_rate_lazy(e, events[e].rate());
+  event_rates.rebuild();
+}
+
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+template<bool incremental_rates>
+typename boost::enable_if_c<incremental_rates, void>::type
+KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::update_rates(std::size_t event_index)
+{
+  MOCASINNS_PROFILE_SCOPE(acceptance);
+  affected_indices.clear();
+  this->configuration_space->affected_steps(events[event_index], affected_indices);
+  for (std::vector<std::size_t>::const_iterator index = affected_indices.begin(); index != affected_indices.end(); ++index)
+    event_rates.set_rate(*index, events[*index].rate());
+}
+//! \endcond
+
+/*!
+  \details The physical clock is advanced by the waiting time before every event. If the total rate of all events vanishes (absorbing state), no further event is executed.
+  \param number Number of events to execute
+  \returns Number of executed events
+*/
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+typename KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::step_number_t KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::do_kinetic_steps(const step_number_t& number)
+{
+  initialise_events();
+
+  double waiting_time;
+  std::size_t event_index;
+  for (step_number_t i = 0; i < number; ++i)
+  {
+    {
+      MOCASINNS_PROFILE_SCOPE(propose);
+      if (!choose_event(waiting_time, event_index)) return i;
+    }
+    physical_time += waiting_time;
+    execute_event(event_index);
+  }
+  return number;
+}
+
+/*!
+  \details The events are enumerated once, afterwards the clock is advanced as described at advance_physical_time().
+  \param duration Physical time by which the clock is advanced
+*/
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+void KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::do_kinetic_time(double duration)
+{
+  initialise_events();
+  advance_physical_time(physical_time + duration);
+}
+
+/*!
+  \details Events are executed as long as they occur before the given end time, afterwards the physical time is set to the end time. The waiting time that crosses the end time is discarded, this is exact because the waiting times are exponentially distributed (memoryless). If the total rate vanishes, the physical time is advanced to the end time without executing events. The events must have been enumerated by initialise_events().
+  \param end_time Physical time to which the clock is advanced
+*/
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+void KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::advance_physical_time(double end_time)
+{
+  double waiting_time;
+  std::size_t event_index;
+  while (true)
+  {
+    {
+      MOCASINNS_PROFILE_SCOPE(propose);
+      if (!choose_event(waiting_time, event_index) || physical_time + waiting_time > end_time) break;
+    }
+    physical_time += waiting_time;
+    execute_event(event_index);
+  }
+  physical_time = end_time;
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \returns Vector containing the single measurements, the measurement with index m is taken at the physical time <tt>relaxation_time + (m + 1)*time_between_measurement</tt> after the start of the simulation
+*/
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+template<class Observator>
+std::vector<typename Observator::observable_type> KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::do_kinetic_monte_carlo_simulation()
+{
+  // Check the concept of the observator
+  BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
+  // Check the concept of the observable
+  BOOST_CONCEPT_ASSERT((Concepts::ObservableConcept<typename Observator::observable_type>));
+
+  // Call the accumulator function using the VectorAccumulator
+  Details::Metropolis::VectorAccumulator<typename Observator::observable_type> measurements_accumulator;
+  do_kinetic_monte_carlo_simulation<Observator>(measurements_accumulator);
+
+  // Return the plain data
+  return measurements_accumulator.internal_vector;
+}
+
+/*!
+  \tparam Observator \concept{Observator}
+  \tparam Accumulator \concept{Accumulator}
+  \param measurement_accumulator Reference to the accumulator that stores the simulation results
+*/
+template<class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+template<class Observator, class Accumulator>
+void KineticMonteCarlo<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::do_kinetic_monte_carlo_simulation(Accumulator& measurement_accumulator)
+{
+  // Check the concept of the observator
+  BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
+  // Check the concept of the observable
+  BOOST_CONCEPT_ASSERT((Concepts::ObservableConcept<typename Observator::observable_type>));
+  // Check the concept of the accumulator
+  BOOST_CONCEPT_ASSERT((Concepts::AccumulatorConcept<Accumulator, typename Observator::observable_type>));
+
+  // Log the start of the simulation
+  this->simulation_start_log();
+
+  // Enumerate the events once and relax the system (unless a checkpoint is resumed, then the physical time of the start is calculated from the finished measurements)
+  initialise_events();
+  const double start_time = this->resuming_checkpoint ? physical_time - simulation_parameters.relaxation_time - this->finished_chunks*simulation_parameters.time_between_measurement : physical_time;
+  if (!this->resuming_checkpoint)
+    advance_physical_time(start_time + simulation_parameters.relaxation_time);
+
+  // For each measurement, advance the physical clock, invoke the hook, take the measurement and check for posix signals
+  for (measurement_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
+  {
+    advance_physical_time(start_time + simulation_parameters.relaxation_time + (m + 1)*simulation_parameters.time_between_measurement);
+
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      hooks.measurement(this);
+    }
+
+    {
+      MOCASINNS_PROFILE_SCOPE(accumulate);
+      measurement_accumulator(Profiling::observe_configuration<Observator>(this->configuration_space));
+    }
+    if (this->end_chunk(m)) return;
+  }
+}
+
+} // of namespace Mocasinns
+
+#endif
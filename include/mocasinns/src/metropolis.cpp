@@ -12,6 +12,10 @@
 
 #include <iterator>
 #include <cmath>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // Includes for boost accumulators
 #include <boost/accumulators/accumulators.hpp>
@@ -25,15 +29,279 @@ namespace ba = boost::accumulators;
 #include "../details/metropolis/vector_accumulator.hpp"
 #include "../exceptions/iterator_range_exception.hpp"
 
+/*!
+  \details If Parameters::track_energy is set, the tracked energy is returned. It is calculated from scratch only if it is not known, e.g. before the first steps, after a new configuration was set without its energy or after steps that do not track the energy. Otherwise the energy of the configuration is calculated.
+  \returns Energy of the actual configuration
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+typename Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::energy_type
+Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::get_energy()
+{
+  if (!simulation_parameters.track_energy) return this->configuration_space->energy();
+
+  if (!tracked_energy_valid) recalculate_energy();
+  return tracked_energy;
+}
+
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::recalculate_energy()
+{
+  tracked_energy = this->configuration_space->energy();
+  tracked_energy_valid = true;
+  executed_steps_since_energy_calculation = 0;
+}
+
+/*! \fn AUTO_TEMPLATE_2
+  \details If the Observator provides the static member function <tt>observable_type observe(ConfigurationType* config, const energy_type& energy)</tt>, it is called with the energy returned by get_energy(), so the energy is not calculated again if it is tracked. Otherwise the function <tt>observe(ConfigurationType* config)</tt> of the \ref concept-Observator "Observator concept" is called.
+  \tparam Observator \concept{Observator}
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class Observator>
+typename Observator::observable_type Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::observe()
+{
+  return observe_generic<Observator>();
+}
+
+/*! \fn AUTO_TEMPLATE_2
+  \details The sites of the configuration are decomposed into sublattices (colors) such that the energy difference of a step does not depend on the other sites of the same color, e.g. a checkerboard decomposition for nearest-neighbour interactions on a bipartite lattice. The configuration declares the coloring with the member functions <tt>std::size_t color_number()</tt>, <tt>std::size_t color_size(std::size_t color)</tt> and <tt>StepType propose_color_step(std::size_t color, std::size_t position, RandomNumberGenerator* rng)</tt>. Executing steps of the same color on different threads must be safe.
+
+  The steps of one color are performed in parallel by Parameters::sublattice_thread_number OpenMP threads, each with its own random number generator (seeded from the random number generator of the simulation) and its own table of Boltzmann factors. Since every color update consists of independent single-site Metropolis steps, it fulfills detailed balance on its own. The colors are visited in a random order in each sweep, so the combined update fulfills detailed balance as well. The steps are performed in units of complete colors, so the number of performed steps can exceed the given number by less than the size of one color. The signal handlers of the derived algorithm are not called for the single steps.
+
+  If the configuration does not declare a coloring, the steps are performed with Simulation::do_steps.
+
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \param number Number of Metropolis steps that will be performed
+  \param beta Inverse temperature that will be used for calculation of the acceptance probability of the Metropolis steps.
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class TemperatureType, class SublatticeStepType>
+typename boost::enable_if_c<Mocasinns::Details::has_function_propose_color_step<ConfigurationType, SublatticeStepType, boost::mpl::vector<std::size_t, std::size_t, RandomNumberGenerator*> >::value, void>::type
+Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::do_metropolis_sublattice_steps(const step_number_t& number, const TemperatureType& beta)
+{
+  const unsigned int thread_number = simulation_parameters.sublattice_thread_number;
+
+  // Create the random number generators and Boltzmann factor tables of the threads
+  if (sublattice_thread_rngs.size() != thread_number)
+  {
+    sublattice_threads_clear();
+    for (unsigned int t = 0; t < thread_number; ++t)
+    {
+      sublattice_thread_rngs.push_back(new RandomNumberGenerator());
+      sublattice_thread_rngs.back()->set_seed(this->rng->random_int32());
+    }
+    sublattice_thread_acceptance_tables.resize(thread_number);
+  }
+  this->acceptance_statistics_reserve(thread_number);
+  const bool collect_statistics = this->collect_acceptance_statistics;
+  const double start_time = this->acceptance_statistics_start();
+
+  const std::size_t color_number = this->configuration_space->color_number();
+  std::vector<std::size_t> color_order(color_number);
+  for (std::size_t c = 0; c < color_number; ++c) color_order[c] = c;
+
+  step_number_t performed_steps = 0;
+  while (performed_steps < number && color_number > 0)
+  {
+    // Visit the colors in a random order to preserve detailed balance
+    for (std::size_t c = color_number - 1; c > 0; --c)
+      std::swap(color_order[c], color_order[this->rng->random_int32(0, static_cast<int>(c))]);
+
+    for (std::size_t c = 0; c < color_number && performed_steps < number; ++c)
+    {
+      const std::size_t color = color_order[c];
+      const long color_size = this->configuration_space->color_size(color);
+      ConfigurationType* configuration = this->configuration_space;
+
+      // Update all sites of the color in parallel
+#pragma omp parallel for schedule(static) num_threads(thread_number)
+      for (long position = 0; position < color_size; ++position)
+      {
+	unsigned int thread = 0;
+#ifdef _OPENMP
+	thread = omp_get_thread_num();
+#endif
+	RandomNumberGenerator* thread_rng = sublattice_thread_rngs[thread];
+	Step next_step = configuration->propose_color_step(color, position, thread_rng);
+	if (!Details::OptionalMemberFunctions::optional_is_executable<Step>(next_step))
+	{
+	  if (collect_statistics) this->thread_acceptance_statistics[thread].record_not_executable(Details::OptionalMemberFunctions::optional_step_type<Step>(next_step));
+	  continue;
+	}
+
+	// Calculate the acceptance probability and do the step with the correct probability
+	const typename Details::RejectionFree::step_energy_difference<Step>::type delta_E = next_step.delta_E();
+	double probability = sublattice_thread_acceptance_tables[thread](delta_E, beta);
+	probability /= Details::OptionalMemberFunctions::optional_selection_probability_factor<Step>(next_step);
+	const bool accepted = (probability > 0.0 && (probability >= 1.0 || thread_rng->random_double() < probability));
+	if (collect_statistics) this->record_acceptance(thread, next_step, delta_E, accepted);
+	if (accepted) next_step.execute();
+      }
+      performed_steps += color_size;
+    }
+  }
+
+  this->acceptance_statistics_stop(start_time);
+}
+
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class TemperatureType, class SublatticeStepType>
+typename boost::enable_if_c<!Mocasinns::Details::has_function_propose_color_step<ConfigurationType, SublatticeStepType, boost::mpl::vector<std::size_t, std::size_t, RandomNumberGenerator*> >::value, void>::type
+Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::do_metropolis_sublattice_steps(const step_number_t& number, const TemperatureType& beta)
+{
+  // The configuration does not declare a coloring, propose the steps at random
+  this->template do_steps<this_type, Step, rejection_free>(number, beta);
+}
+
+/*! \fn AUTO_TEMPLATE_2
+  \details The steps must declare the sites of the configuration they read or write with the member function <tt>void footprint(std::vector<std::size_t>& sites)</tt>, which appends the indices of the sites to the given vector. Windows of Parameters::speculative_window_size steps are proposed with the random number generator of the simulation. Afterwards the footprints, the executability, the selection probability factors and the energy differences of all steps of the window are evaluated on the unchanged configuration by Parameters::speculative_thread_number OpenMP threads. The steps are then accepted or rejected in proposal order, and every step whose footprint overlaps with the footprint of a step executed before in the same window is evaluated again. The random numbers deciding about the acceptance are drawn in this order and only for acceptance probabilities between 0 and 1, as in Simulation::do_steps.
+
+  Therefore the Markov chain does not depend on the number of threads. It is the same as the chain of Simulation::do_steps with a batched proposal of blocks of Parameters::speculative_window_size steps (if <tt>propose_steps</tt> of the configuration draws the random numbers like repeated calls of <tt>propose_step</tt>), and for a window size of 1 it is the same as the chain of single proposed steps. For larger windows the random number stream differs from the single proposed steps, since all proposals of a window are drawn before the first acceptance decision.
+
+  The evaluation of a step must only read the sites of its footprint, and proposing a step must not depend on the state of the configuration, since all steps of a window are proposed before the first of them is executed. The steps are executed and the handlers of the derived algorithm are called sequentially.
+
+  If the steps do not declare a footprint, the steps are performed with Simulation::do_steps.
+
+  \tparam ParameterType Inverse temperature (\concept{InverseTemperatureType}) or Details::Metropolis::TrackedEnergyParameter if the energy is tracked
+  \param number Number of Metropolis steps that will be performed
+  \param parameter Inverse temperature that will be used for calculation of the acceptance probability of the Metropolis steps, or the parameter tracking the energy containing it.
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class ParameterType, class SpeculativeStepType>
+typename boost::enable_if_c<Mocasinns::Details::has_function_footprint<SpeculativeStepType, void, boost::mpl::vector<std::vector<std::size_t>&> >::value, void>::type
+Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::do_metropolis_speculative_steps(const step_number_t& number, ParameterType& parameter)
+{
+  typedef typename Details::RejectionFree::step_energy_difference<Step>::type EnergyDifferenceType;
+  const std::size_t window_size = std::max(static_cast<std::size_t>(simulation_parameters.speculative_window_size), static_cast<std::size_t>(1));
+
+  std::vector<Step> proposed_steps;
+  std::vector<std::vector<std::size_t> > footprints(window_size);
+  std::vector<EnergyDifferenceType> energy_differences(window_size);
+  std::vector<double> selection_probability_factors(window_size, 1.0);
+  // Use char instead of bool, since the elements of std::vector<bool> cannot be written concurrently
+  std::vector<char> executable(window_size);
+  // Number of the last window in which a site was modified by an executed step, 0 for unmodified sites
+  std::vector<step_number_t> site_modification_window;
+  step_number_t window_number = 0;
+  proposed_steps.reserve(window_size);
+  const double start_time = this->acceptance_statistics_start();
+
+  for (step_number_t i = 0; i < number; i += proposed_steps.size())
+  {
+    // Propose a window of steps
+    const std::size_t actual_window_size = static_cast<std::size_t>(std::min(static_cast<step_number_t>(window_size), number - i));
+    proposed_steps.clear();
+    for (std::size_t s = 0; s < actual_window_size; ++s)
+      proposed_steps.push_back(this->configuration_space->propose_step(this->rng));
+
+    // Evaluate all steps of the window in parallel on the unchanged configuration
+    const long window_end = static_cast<long>(actual_window_size);
+#pragma omp parallel for schedule(static) num_threads(simulation_parameters.speculative_thread_number) if(simulation_parameters.speculative_thread_number > 1)
+    for (long s = 0; s < window_end; ++s)
+      executable[s] = speculative_evaluate(proposed_steps[s], footprints[s], energy_differences[s], selection_probability_factors[s]);
+
+    // Accept or reject the steps in proposal order (drawing the random numbers in this order), re-evaluate the steps that overlap with an executed step
+    ++window_number;
+    bool window_modified = false;
+    for (std::size_t s = 0; s < actual_window_size; ++s)
+    {
+      if (window_modified)
+      {
+	for (std::vector<std::size_t>::const_iterator site = footprints[s].begin(); site != footprints[s].end(); ++site)
+	{
+	  if (*site < site_modification_window.size() && site_modification_window[*site] == window_number)
+	  {
+	    executable[s] = speculative_evaluate(proposed_steps[s], footprints[s], energy_differences[s], selection_probability_factors[s]);
+	    break;
+	  }
+	}
+      }
+
+      double probability = 0.0;
+      if (executable[s])
+      {
+	probability = acceptance_table(energy_differences[s], Details::Metropolis::inverse_temperature(parameter)) / selection_probability_factors[s];
+	Details::Metropolis::store_delta_E(parameter, energy_differences[s]);
+      }
+      if (this->template execute_or_reject_step<this_type>(proposed_steps[s], this->accept_step(probability), parameter))
+      {
+	// Mark the footprint of the executed step as modified
+	for (std::vector<std::size_t>::const_iterator site = footprints[s].begin(); site != footprints[s].end(); ++site)
+	{
+	  if (*site >= site_modification_window.size()) site_modification_window.resize(*site + 1, 0);
+	  site_modification_window[*site] = window_number;
+	}
+	window_modified = true;
+      }
+    }
+  }
+
+  this->acceptance_statistics_stop(start_time);
+}
+
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class ParameterType, class SpeculativeStepType>
+typename boost::enable_if_c<!Mocasinns::Details::has_function_footprint<SpeculativeStepType, void, boost::mpl::vector<std::vector<std::size_t>&> >::value, void>::type
+Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::do_metropolis_speculative_steps(const step_number_t& number, ParameterType& parameter)
+{
+  // The steps do not declare a footprint, evaluate them one after another
+  this->template do_steps<this_type, Step, rejection_free>(number, parameter);
+}
+
+/*! \fn AUTO_TEMPLATE_2
+  \details A multi-spin coded configuration stores the state of up to 64 independent replicas of a system bitwise in words of type Details::Metropolis::MultiSpinWord, and a step acts on the same site of all replicas. The step calculates the energy differences of all replicas with bitwise operations in the member function <tt>MultiSpinWord multi_spin_masks(std::vector<std::pair<EnergyType, MultiSpinWord> >& masks)</tt>. It appends a pair of energy difference and mask of the concerned replicas for every positive energy difference and returns the mask of the replicas with non-positive energy difference. The replicas with positive energy difference are selected independently with their Boltzmann factor (taken from the acceptance table of the simulation) using Details::Metropolis::threshold_mask(), and all selected replicas are flipped by calling <tt>void execute(MultiSpinWord flip_mask)</tt> of the step. Since the acceptance of every replica is decided with its own random bits, every replica follows its own Metropolis Markov chain. Since the replicas are updated at the same sites, their measurements are not completely uncorrelated.
+
+  The random number generator must provide the member function <tt>MultiSpinWord random_bits64()</tt> returning 64 uniformly distributed random bits. The executability and the selection probability factor of the steps are not considered and the signal handlers of the derived algorithm are not called for the single steps.
+
+  If the steps are not multi-spin coded, the steps are performed with Simulation::do_steps.
+
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \param number Number of Metropolis steps that will be performed (each step acts on all replicas)
+  \param beta Inverse temperature that will be used for calculation of the acceptance probability of the Metropolis steps.
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class TemperatureType, class MultiSpinStepType>
+typename boost::enable_if_c<Mocasinns::Details::Metropolis::is_multi_spin_step<MultiSpinStepType>::value, void>::type
+Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::do_metropolis_multi_spin_steps(const step_number_t& number, const TemperatureType& beta)
+{
+  typename Details::Metropolis::multi_spin_masks_type<Step>::type energy_masks;
+
+  for (step_number_t i = 0; i < number; ++i)
+  {
+    // Propose a new step and calculate the masks of the replicas for the energy differences
+    Step next_step = this->configuration_space->propose_step(this->rng);
+    energy_masks.clear();
+    Details::Metropolis::MultiSpinWord flip_mask = next_step.multi_spin_masks(energy_masks);
+
+    // Select the replicas with positive energy difference according to their Boltzmann factor
+    for (typename Details::Metropolis::multi_spin_masks_type<Step>::type::const_iterator energy_mask = energy_masks.begin(); energy_mask != energy_masks.end(); ++energy_mask)
+    {
+      if (energy_mask->second != 0)
+	flip_mask |= Details::Metropolis::threshold_mask(acceptance_table(energy_mask->first, beta), energy_mask->second, this->rng);
+    }
+
+    // Flip the selected replicas
+    next_step.execute(flip_mask);
+  }
+}
+
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class TemperatureType, class MultiSpinStepType>
+typename boost::enable_if_c<!Mocasinns::Details::Metropolis::is_multi_spin_step<MultiSpinStepType>::value, void>::type
+Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::do_metropolis_multi_spin_steps(const step_number_t& number, const TemperatureType& beta)
+{
+  // The steps are not multi-spin coded, perform them as usual
+  this->template do_steps<this_type, Step, rejection_free>(number, beta);
+}
+
 /*! \fn AUTO_TEMPLATE_2
   \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
   \tparam TemperatureType \concept{InverseTemperatureType}
   \param beta Inverse temperature at which the simulation is performed.
   \returns Vector containing the single measurements performed
 */
-template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free>
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
 template<class Observator, class TemperatureType>
-std::vector<typename Observator::observable_type> Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free>::do_metropolis_simulation(const TemperatureType& beta)
+std::vector<typename Observator::observable_type> Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::do_metropolis_simulation(const TemperatureType& beta)
 {
   // Check the concept of the observator
   BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
@@ -48,6 +316,130 @@ std::vector<typename Observator::observable_type> Mocasinns::Metropolis<Configur
   return measurements_accumulator.internal_vector;
 }
 
+/*!
+  \details Performs Parameters::relaxation_steps steps. If Parameters::adaptive_relaxation is set, the steps are performed in portions of Parameters::relaxation_sample_steps and the energy is sampled after each portion (the tracked energy if Parameters::track_energy is set, otherwise it is calculated). The relaxation stops as soon as the MSER test (see Details::Metropolis::EquilibrationDetector) finds the energy time series stationary, Parameters::relaxation_steps is then only the maximal number of relaxation steps. The number of performed steps is also available with get_relaxation_steps_performed(). If Parameters::adaptive_proposal_tuning is set, the proposal widths of the configuration are tuned to Parameters::target_acceptance_rate during the relaxation and frozen at its end (see begin_proposal_tuning()).
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \param beta Inverse temperature at which the relaxation is performed
+  \returns Number of performed relaxation steps
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class TemperatureType>
+typename Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::step_number_t Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::do_metropolis_relaxation(const TemperatureType& beta)
+{
+  if (simulation_parameters.adaptive_proposal_tuning) begin_proposal_tuning();
+
+  if (!simulation_parameters.adaptive_relaxation || simulation_parameters.relaxation_sample_steps == 0)
+  {
+    do_metropolis_relaxation_steps(simulation_parameters.relaxation_steps, beta);
+    relaxation_steps_performed = simulation_parameters.relaxation_steps;
+  }
+  else
+  {
+    // Sample the energy until the time series is stationary or the maximal number of relaxation steps is reached
+    Details::Metropolis::EquilibrationDetector equilibration_detector(simulation_parameters.relaxation_batch_size);
+    relaxation_steps_performed = 0;
+    while (relaxation_steps_performed < simulation_parameters.relaxation_steps && !equilibration_detector.is_stationary())
+    {
+      const step_number_t steps = std::min(simulation_parameters.relaxation_sample_steps, simulation_parameters.relaxation_steps - relaxation_steps_performed);
+      do_metropolis_relaxation_steps(steps, beta);
+      relaxation_steps_performed += steps;
+      equilibration_detector.add(get_energy());
+    }
+  }
+
+  // Freeze the proposal widths before the measurements start
+  if (simulation_parameters.adaptive_proposal_tuning) end_proposal_tuning();
+  return relaxation_steps_performed;
+}
+
+/*!
+  \details The tuning starts from the proposal widths of the actual configuration (see Details::Metropolis::ProposalTuner). While the widths are tuned, the acceptance statistics of the simulation are collected to measure the acceptance rate of every step type. If they were not collected before, they are restored by end_proposal_tuning(). Between begin_proposal_tuning() and end_proposal_tuning() the proposal widths change, so the steps do not fulfil detailed balance and must not be used for measurements.
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::begin_proposal_tuning()
+{
+  proposal_tuning_collected_statistics = this->collect_acceptance_statistics;
+  if (!proposal_tuning_collected_statistics) proposal_tuning_saved_statistics = this->thread_acceptance_statistics;
+  this->collect_acceptance_statistics = true;
+  proposal_tuning = true;
+
+  proposal_tuner.clear();
+  proposal_tuner.start(this->get_acceptance_statistics(), simulation_parameters.proposal_tuning_steps);
+}
+
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::tune_proposal_widths()
+{
+  if (!proposal_tuning) return;
+  proposal_tuner.update(this->get_acceptance_statistics(), *this->configuration_space, simulation_parameters.target_acceptance_rate);
+}
+
+/*!
+  \details The proposal widths of the configuration are not changed any more. If Parameters::adaptive_proposal_tuning is set, the tuned widths are applied to every configuration set with set_config_space(), so the widths stay with the simulation (e.g. with the temperature of a replica of ParallelTempering) when configurations are exchanged.
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::end_proposal_tuning()
+{
+  if (!proposal_tuning) return;
+  proposal_tuning = false;
+  this->collect_acceptance_statistics = proposal_tuning_collected_statistics;
+  if (!proposal_tuning_collected_statistics)
+  {
+    this->thread_acceptance_statistics = proposal_tuning_saved_statistics;
+    proposal_tuning_saved_statistics.clear();
+  }
+}
+
+/*!
+  \details While the proposal widths are tuned, the steps are performed in portions of at most Parameters::proposal_tuning_steps steps and tune_proposal_widths() is called after every portion.
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \param number Number of relaxation steps
+  \param beta Inverse temperature at which the steps are performed
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class TemperatureType>
+void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::do_metropolis_relaxation_steps(const step_number_t& number, const TemperatureType& beta)
+{
+  if (!proposal_tuning || simulation_parameters.proposal_tuning_steps == 0)
+  {
+    do_metropolis_steps(number, beta);
+    return;
+  }
+
+  for (step_number_t performed = 0; performed < number; )
+  {
+    const step_number_t steps = std::min(simulation_parameters.proposal_tuning_steps, number - performed);
+    do_metropolis_steps(steps, beta);
+    performed += steps;
+    tune_proposal_widths();
+  }
+}
+
+/*!
+  \details Without Parameters::adaptive_measurement_spacing Parameters::steps_between_measurement steps are performed. Otherwise the steps are performed in portions of Parameters::autocorrelation_sample_steps steps, the energy after every portion is added to the estimate of the autocorrelation time and afterwards the number of steps until the next measurement is adapted to this estimate.
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \param beta Inverse temperature at which the steps are performed
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class TemperatureType>
+void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::do_metropolis_measurement_steps(const TemperatureType& beta)
+{
+  if (!simulation_parameters.adaptive_measurement_spacing)
+  {
+    do_metropolis_steps(simulation_parameters.steps_between_measurement, beta);
+    return;
+  }
+
+  for (step_number_t s = 0; s < measurement_spacing.get_sample_number(); ++s)
+  {
+    do_metropolis_steps(measurement_spacing.get_sample_steps(), beta);
+    measurement_spacing.add(0, get_energy());
+  }
+  measurement_spacing.update(simulation_parameters.measurement_spacing_fraction,
+			     simulation_parameters.minimal_steps_between_measurement,
+			     simulation_parameters.maximal_steps_between_measurement);
+}
+
 /*! \fn AUTO_TEMPLATE_2 
   \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
   \tparam InputIterator \conceptiterator{InverseTemperatureType}
@@ -55,9 +447,9 @@ std::vector<typename Observator::observable_type> Mocasinns::Metropolis<Configur
   \param last_beta Iterator pointing on position after the last inverse temperature that is calculated
   \returns Vector containing the vectors of measurments performed for each temperature. (First index: inverse temperature, second index: measurment number)
 */
-template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free>
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
 template<class Observator, class InputIterator>
-std::vector<std::vector<typename Observator::observable_type> > Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free>::do_metropolis_simulation(InputIterator first_beta, InputIterator last_beta)
+std::vector<std::vector<typename Observator::observable_type> > Mocasinns::Metropolis<ConfigurationType, Step, RandomNumberGenerator, rejection_free, HookPolicy>::do_metropolis_simulation(InputIterator first_beta, InputIterator last_beta)
 {
   // Check the concept of the observator
   BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
@@ -79,9 +471,9 @@ std::vector<std::vector<typename Observator::observable_type> > Mocasinns::Metro
   \param beta Inverse temperature at which the simulation is performed
   \param measurement_accumulator Reference to the accumulator that stores the simulation results
 */
-template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free>
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
 template<class Observator, class Accumulator, class TemperatureType>
-void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free>::do_metropolis_simulation(const TemperatureType& beta, Accumulator& measurement_accumulator)
+void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::do_metropolis_simulation(const TemperatureType& beta, Accumulator& measurement_accumulator)
 {
   // Check the concept of the observator
   BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
@@ -93,22 +485,88 @@ void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejectio
   // Log the start of the simulation
   this->simulation_start_log();
 
- // Perform the relaxation steps
-  do_metropolis_steps(simulation_parameters.relaxation_steps, beta);
+  // Perform the relaxation steps and start the adaption of the measurement spacing (unless a checkpoint is resumed)
+  if (!this->resuming_checkpoint)
+  {
+    do_metropolis_relaxation(beta);
+    measurement_spacing.reset(1, simulation_parameters.autocorrelation_sample_steps, simulation_parameters.steps_between_measurement);
+    precision_monitor.clear();
+    measurement_steps_performed = 0;
+  }
   
+  // Take the measurements in background threads if requested
+  if (simulation_parameters.measurement_thread_number > 0)
+  {
+    do_metropolis_pipelined_measurements<Observator>(beta, measurement_accumulator);
+    return;
+  }
+
   // For each measurement, perform the steps, invoke the signal handler, take the measurement and check for posix signals
-  for (unsigned int m = 0; m < simulation_parameters.measurement_number; ++m)
+  for (step_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
   {
     // Do the steps
-    do_metropolis_steps(simulation_parameters.steps_between_measurement, beta);
+    measurement_steps_performed += get_steps_between_measurement();
+    do_metropolis_measurement_steps(beta);
+
+    // Call the measurement hook
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      hooks.measurement(this);
+    }
+
+    // Observe and check for posix signals, the target precision and the step budget
+    {
+      MOCASINNS_PROFILE_SCOPE(accumulate);
+      const typename Observator::observable_type observable = observe_generic<Observator>();
+      measurement_accumulator(observable);
+      precision_monitor.add(observable);
+    }
+    if (this->end_chunk(m) || target_error_reached() || step_budget_exhausted()) return;
+  }
+}
+
+/*!
+  \details Performs the steps and invokes the measurement hook as the synchronous simulation, but instead of observing the configuration it is copied into a free snapshot buffer that is observed by one of Parameters::measurement_thread_number background threads. If all Parameters::measurement_buffer_number buffers are pending, the simulation waits until the oldest measurement is accumulated. Before returning (also after a posix signal) the function waits until all snapshots are observed and accumulated. It also waits for them before a signal handler is invoked or a checkpoint is written, so the precision monitor is not read while the background threads feed it and the checkpoint contains all finished measurements. The copy of the configuration is charged to the phase Profiling::accumulate, the observation in the background threads to Profiling::observe. The background threads also pass the observables to the precision monitor, so with Parameters::target_error the measurements stop with up to Parameters::measurement_buffer_number pending snapshots that are still accumulated.
+  \tparam Observator \concept{Observator}
+  \tparam Accumulator \concept{Accumulator}
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \param beta Inverse temperature at which the simulation is performed
+  \param measurement_accumulator Reference to the accumulator that stores the simulation results, called by the background threads in the order of the measurements
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+template<class Observator, class Accumulator, class TemperatureType>
+void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::do_metropolis_pipelined_measurements(const TemperatureType& beta, Accumulator& measurement_accumulator)
+{
+  // The precision monitor is fed by the background threads, the simulation thread only reads whether the target error is reached
+  std::atomic<bool> target_reached(target_error_reached());
+  MonitoredAccumulator<Accumulator> monitored_accumulator(*this, measurement_accumulator, target_reached);
+  typedef Details::Metropolis::MeasurementPipeline<snapshot_type, typename Observator::observable_type, SnapshotObservator<Observator>, MonitoredAccumulator<Accumulator> > pipeline_type;
+  pipeline_type pipeline(snapshot_type(*this->configuration_space), simulation_parameters.measurement_thread_number, simulation_parameters.measurement_buffer_number, monitored_accumulator);
 
-    // Call the measurement signal handler
-    signal_handler_measurement(this);
+  for (step_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
+  {
+    // Do the steps
+    measurement_steps_performed += get_steps_between_measurement();
+    do_metropolis_measurement_steps(beta);
 
-    // Observe and check for posix signals
-    measurement_accumulator(Observator::observe(this->configuration_space));
-    if (this->check_for_posix_signal()) return;
+    // Call the measurement hook
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      hooks.measurement(this);
+    }
+
+    // Copy the configuration into a free buffer and hand it to the background threads
+    {
+      MOCASINNS_PROFILE_SCOPE(accumulate);
+      take_snapshot<Observator>(pipeline.acquire());
+      pipeline.submit();
+    }
+    // The pending measurements are accumulated before a signal handler or a checkpoint reads the simulation
+    if (this->end_chunk(m, [&pipeline]() { pipeline.drain(); }) || target_reached || step_budget_exhausted()) break;
   }
+
+  // Wait for the pending measurements
+  pipeline.finish();
 }
 
 /*! \fn AUTO_TEMPLATE_2
@@ -120,9 +578,9 @@ void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejectio
   \param measurement_accumulator_begin Iterator pointing to the first accumulator that gathers the data for the first inverse temperature.
   \param measurement_accumulator_end Iterator pointing one position after the last accumulator that gathers the data for the last inverse temperature. The number of accumulators must match the number of inverse temperatures.
 */
-template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free>
+template<class ConfigurationType, class Step, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
 template<class Observator, class AccumulatorIterator, class InverseTemperatureIterator>
-void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free>::do_metropolis_simulation(InverseTemperatureIterator beta_begin, InverseTemperatureIterator beta_end, AccumulatorIterator measurement_accumulator_begin, AccumulatorIterator measurement_accumulator_end)
+void Mocasinns::Metropolis<ConfigurationType,Step,RandomNumberGenerator,rejection_free,HookPolicy>::do_metropolis_simulation(InverseTemperatureIterator beta_begin, InverseTemperatureIterator beta_end, AccumulatorIterator measurement_accumulator_begin, AccumulatorIterator measurement_accumulator_end)
 {  
   // Check the concept of the observator
   BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
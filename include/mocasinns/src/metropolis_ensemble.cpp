@@ -0,0 +1,178 @@
+/*!
+ * \file metropolis_ensemble.cpp
+ * \brief Implementation of the libMoCaSinns Ensemble Metropolis template interface
+ *
+ * \author Benedikt Krüger
+ */
+
+#ifdef MOCASINNS_METROPOLIS_ENSEMBLE_HPP
+
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+
+namespace Mocasinns
+{
+
+/*!
+  \details In every step each chain proposes a site, and the steps of all chains are accepted or rejected independently according to the Metropolis criterion. If the number of lanes of the random number generator does not match the number of chains (e.g. for the first call), the lanes are seeded from the random number generator of the simulation.
+  \tparam TemperatureType Type of the inverse temperature, there must be an operator* defined this class and the energy type of the configuration.
+  \param number Number of steps that will be performed in every chain
+  \param beta Inverse temperature that will be used for calculation of the acceptance probability of the steps.
+*/
+template<class EnsembleConfigurationType, class RandomNumberGenerator>
+template<class TemperatureType>
+void MetropolisEnsemble<EnsembleConfigurationType, RandomNumberGenerator>::do_ensemble_steps(const step_number_t& number, const TemperatureType& beta)
+{
+  const std::size_t chain_number = this->configuration_space->chain_number();
+  const uint32_t site_number = static_cast<uint32_t>(this->configuration_space->site_number());
+  if (lane_rng.size() != chain_number) lane_rng.seed(chain_number, this->rng);
+  accepted_steps.resize(chain_number);
+
+  for (step_number_t i = 0; i < number; ++i)
+  {
+    // Propose a site in every chain and calculate the energy differences
+    lane_rng.fill_below(site_number, proposed_sites);
+    this->configuration_space->ensemble_delta_E(proposed_sites, energy_differences);
+
+    // Decide about the acceptance in every chain
+    lane_rng.fill_uniform(acceptance_random_numbers);
+    decide_acceptance<TemperatureType, energy_type>(beta);
+
+    // Execute the accepted steps
+    this->configuration_space->ensemble_execute(proposed_sites, accepted_steps);
+  }
+}
+
+/*!
+  \details The range of the energy differences of the chains is determined first and the table of acceptance probabilities is extended to it if necessary, which happens only a few times for every inverse temperature. If the range exceeds the maximal size of the table, the Boltzmann factors are calculated directly.
+  \tparam TemperatureType Type of the inverse temperature
+  \tparam EnergyType Type of the energy differences of the configuration
+  \param beta Inverse temperature that will be used for calculation of the acceptance probability of the steps.
+*/
+template<class EnsembleConfigurationType, class RandomNumberGenerator>
+template<class TemperatureType, class EnergyType>
+typename boost::enable_if_c<Details::Metropolis::use_acceptance_table<EnergyType>::value, void>::type
+MetropolisEnsemble<EnsembleConfigurationType, RandomNumberGenerator>::decide_acceptance(const TemperatureType& beta)
+{
+  const std::size_t chain_number = energy_differences.size();
+  if (chain_number == 0) return;
+
+  // Determine the range of the energy differences
+  long minimal_delta_E = static_cast<long>(energy_differences[0]);
+  long maximal_delta_E = minimal_delta_E;
+  for (std::size_t k = 1; k < chain_number; ++k)
+  {
+    const long delta_E = static_cast<long>(energy_differences[k]);
+    minimal_delta_E = std::min(minimal_delta_E, delta_E);
+    maximal_delta_E = std::max(maximal_delta_E, delta_E);
+  }
+
+  if (boltzmann_table.cover(minimal_delta_E, maximal_delta_E, static_cast<double>(beta)))
+  {
+    // The acceptance probabilities of non-positive energy differences are 1, so no branch is needed
+    const double* probabilities = boltzmann_table.data();
+    const long offset = boltzmann_table.offset();
+    for (std::size_t k = 0; k < chain_number; ++k)
+      accepted_steps[k] = (acceptance_random_numbers[k] < probabilities[static_cast<long>(energy_differences[k]) - offset]);
+  }
+  else
+  {
+    for (std::size_t k = 0; k < chain_number; ++k)
+      accepted_steps[k] = (acceptance_random_numbers[k] < exp(-(beta * energy_differences[k])));
+  }
+}
+
+/*!
+  \details Since the random numbers are in [0,1), the comparison with the Boltzmann factor accepts all steps with non-positive energy difference.
+  \tparam TemperatureType Type of the inverse temperature
+  \tparam EnergyType Type of the energy differences of the configuration
+  \param beta Inverse temperature that will be used for calculation of the acceptance probability of the steps.
+*/
+template<class EnsembleConfigurationType, class RandomNumberGenerator>
+template<class TemperatureType, class EnergyType>
+typename boost::enable_if_c<!Details::Metropolis::use_acceptance_table<EnergyType>::value, void>::type
+MetropolisEnsemble<EnsembleConfigurationType, RandomNumberGenerator>::decide_acceptance(const TemperatureType& beta)
+{
+  const std::size_t chain_number = energy_differences.size();
+  for (std::size_t k = 0; k < chain_number; ++k)
+    accepted_steps[k] = (acceptance_random_numbers[k] < exp(-(beta * energy_differences[k])));
+}
+
+/*!
+  \tparam Observator Class with static function Observator::observe(EnsembleConfigurationType*, std::size_t) taking a pointer to the configuration and the index of a chain and returning the value of a arbitrary observable. The class must contain a typedef ::observable_type classifying the return type of the functor.
+  \tparam TemperatureType Type of the inverse temperature, there must be an operator* defined this class and the energy type of the configuration.
+  \param beta Inverse temperature at which the simulation is performed.
+  \returns Vector containing the vectors of measurements performed for each chain (first index: chain, second index: measurement number)
+*/
+template<class EnsembleConfigurationType, class RandomNumberGenerator>
+template<class Observator, class TemperatureType>
+std::vector<std::vector<typename Observator::observable_type> > MetropolisEnsemble<EnsembleConfigurationType, RandomNumberGenerator>::do_ensemble_simulation(const TemperatureType& beta)
+{
+  // Check the concept of the observable
+  BOOST_CONCEPT_ASSERT((Concepts::ObservableConcept<typename Observator::observable_type>));
+
+  // Call the accumulator function using a VectorAccumulator for every chain
+  std::vector<Details::Metropolis::VectorAccumulator<typename Observator::observable_type> > measurement_accumulators(this->configuration_space->chain_number());
+  do_ensemble_simulation<Observator>(beta, measurement_accumulators.begin(), measurement_accumulators.end());
+
+  // Return the plain data
+  std::vector<std::vector<typename Observator::observable_type> > results;
+  results.reserve(measurement_accumulators.size());
+  for (std::size_t k = 0; k < measurement_accumulators.size(); ++k)
+    results.push_back(measurement_accumulators[k].internal_vector);
+  return results;
+}
+
+/*!
+ \tparam Observator Class with static function Observator::observe(EnsembleConfigurationType*, std::size_t) taking a pointer to the configuration and the index of a chain and returning the value of an arbitrary observable. The class must contain a typedef ::observable_type classifying the return type of the functor.
+ \tparam AccumulatorIterator Iterator of a container of a class that accepts the observable in operator() and gathers the required informations about the observables (e.g. boost::accumulator)
+ \tparam TemperatureType Type of the inverse temperature, there must be an operator* defined this class and the energy type of the configuration.
+ \param beta Inverse temperature at which the simulation is performed
+ \param measurement_accumulator_begin Iterator pointing to the accumulator that gathers the measurements of the first chain.
+ \param measurement_accumulator_end Iterator pointing one position after the accumulator of the last chain. The number of accumulators must match the number of chains, otherwise an Exceptions::UnequalSizesException is thrown.
+*/
+template<class EnsembleConfigurationType, class RandomNumberGenerator>
+template<class Observator, class AccumulatorIterator, class TemperatureType>
+void MetropolisEnsemble<EnsembleConfigurationType, RandomNumberGenerator>::do_ensemble_simulation(const TemperatureType& beta, AccumulatorIterator measurement_accumulator_begin, AccumulatorIterator measurement_accumulator_end)
+{
+  // Check the concept of the observable
+  BOOST_CONCEPT_ASSERT((Concepts::ObservableConcept<typename Observator::observable_type>));
+  // Check the concept of the accumulator
+  BOOST_CONCEPT_ASSERT((Concepts::AccumulatorConcept<typename std::iterator_traits<AccumulatorIterator>::value_type, typename Observator::observable_type>));
+
+  const std::size_t chain_number = this->configuration_space->chain_number();
+  if (static_cast<std::size_t>(std::distance(measurement_accumulator_begin, measurement_accumulator_end)) != chain_number)
+    throw Exceptions::UnequalSizesException("The number of accumulators must match the number of chains of the ensemble.");
+
+  // Log the start of the simulation, the lanes of the chains are seeded by the first steps
+  this->simulation_start_log();
+
+  // Perform the relaxation steps (unless a checkpoint is resumed)
+  if (!this->resuming_checkpoint)
+    do_ensemble_steps(simulation_parameters.relaxation_steps, beta);
+
+  // For each measurement, perform the steps, invoke the signal handler, measure every chain and check for posix signals
+  for (measurement_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
+  {
+    do_ensemble_steps(simulation_parameters.steps_between_measurement, beta);
+
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      signal_handler_measurement(this);
+    }
+
+    {
+      MOCASINNS_PROFILE_SCOPE(accumulate);
+      AccumulatorIterator measurement_accumulator = measurement_accumulator_begin;
+      for (std::size_t k = 0; k < chain_number; ++k, ++measurement_accumulator)
+	(*measurement_accumulator)(Profiling::observe_configuration<Observator>(this->configuration_space, k));
+    }
+
+    if (this->end_chunk(m)) return;
+  }
+}
+
+} // of namespace Mocasinns
+
+#endif
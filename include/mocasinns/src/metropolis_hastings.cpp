@@ -79,21 +79,28 @@ void MetropolisHastings<ConfigurationType,Step,RandomNumberGenerator>::do_metrop
   acceptance_probability_parameters.actual_energy = this->configuration_space->energy();
   acceptance_probability_parameters.acceptance_probability_functor = acceptance_probability_functor;
 
-  // Perform the relaxation steps
-  do_metropolis_hastings_steps(simulation_parameters.relaxation_steps, acceptance_probability_parameters);
+  // Perform the relaxation steps (unless a checkpoint is resumed)
+  if (!this->resuming_checkpoint)
+    do_metropolis_hastings_steps(simulation_parameters.relaxation_steps, acceptance_probability_parameters);
   
   // For each measurement, perform the steps, invoke the signal handler, take the measurement and check for posix signals
-  for (unsigned int m = 0; m < simulation_parameters.measurement_number; ++m)
+  for (measurement_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
   {
     // Do the steps
     do_metropolis_hastings_steps(simulation_parameters.steps_between_measurement, acceptance_probability_parameters);
 
     // Call the signal handler
-    signal_handler_measurement(this);
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      signal_handler_measurement(this);
+    }
 
     // Observe and check for posix signals
-    measurement_accumulator(Observator::observe(this->configuration_space));
-    if (this->check_for_posix_signal()) return;
+    {
+      MOCASINNS_PROFILE_SCOPE(accumulate);
+      measurement_accumulator(Profiling::observe_configuration<Observator>(this->configuration_space));
+    }
+    if (this->end_chunk(m)) return;
   }
 }
 
@@ -81,6 +81,14 @@ void MetropolisParallel<ConfigurationType,Step,RandomNumberGenerator>::do_parall
   // Check the concept of the accumulator
   BOOST_CONCEPT_ASSERT((Concepts::AccumulatorConcept<Accumulator, typename Observator::observable_type>));
 
+  // Start the timing of the measurements for the time budget
+  this->begin_chunks();
+  // Each run stores its number of relaxation steps at its own index
+  relaxation_steps_performed.assign(simulation_parameters.run_number, 0);
+  // Every run has its own precision monitor, the measurements of all runs are pooled for the step budget
+  precision_monitors.clear();
+  measurement_steps_performed = 0;
+
   // Perform a parallel for-loop for the different runs
   // The signal handlers and the simulation parameters need not to be shared, because class members are allways shared
   omp_set_num_threads(simulation_parameters.process_number);
@@ -90,29 +98,51 @@ void MetropolisParallel<ConfigurationType,Step,RandomNumberGenerator>::do_parall
     // Forward declare a pointer for the configuration and the simulation
     ConfigurationType* copied_configuration;
     Metropolis<ConfigurationType, Step, RandomNumberGenerator>* run_simulation;
+    bool run_stopped;
+    std::size_t run_monitor;
 #pragma omp critical
     {
-      // Copy a configuration from the initial one
-      copied_configuration = new ConfigurationType(*(this->get_config_space()));
-      // Create the new configuration
-      run_simulation = new Metropolis<ConfigurationType, Step, RandomNumberGenerator>(simulation_parameters, copied_configuration);
+      // No further runs are started after a posix signal, if the target precision is reached or the step budget is exhausted
+      run_stopped = measurements_complete();
+      if (!run_stopped)
+      {
+	// Copy a configuration from the initial one
+	copied_configuration = new ConfigurationType(*(this->get_config_space()));
+	// Create the new configuration
+	run_simulation = new Metropolis<ConfigurationType, Step, RandomNumberGenerator>(simulation_parameters, copied_configuration);
+	// Create the precision monitor of the run
+	run_monitor = precision_monitors.size();
+	precision_monitors.push_back(Details::Metropolis::PrecisionMonitor());
+      }
     }
+    if (run_stopped) continue;
     
     // Set the seed of the simulation to the seed of this simulation plus the run number
     run_simulation->set_random_seed(this->get_random_seed() + run);
 
     // Perform the relaxation steps
-    run_simulation->do_metropolis_steps(simulation_parameters.relaxation_steps, beta);
+    relaxation_steps_performed[run] = run_simulation->do_metropolis_relaxation(beta);
 
-    // For each measurement, perform the steps, invoke the signal handler, take the measurement and check for posix signals
-    for (unsigned int m = 0; m < simulation_parameters.measurement_number && !this->check_for_posix_signal(); ++m)
+    // For each measurement, perform the steps, invoke the signal handler, take the measurement and check for posix signals (and the time budget, the target precision and the step budget, only one thread at a time)
+    for (unsigned int m = 0; m < simulation_parameters.measurement_number && !run_stopped; ++m)
     {
       run_simulation->do_metropolis_steps(simulation_parameters.steps_between_measurement, beta);
 
  #pragma omp critical
       {
-	signal_handler_measurement(this);
-	measurement_accumulator(Observator::observe(run_simulation->get_config_space()));
+	{
+	  MOCASINNS_PROFILE_SCOPE(signal);
+	  signal_handler_measurement(this);
+	}
+	{
+	  MOCASINNS_PROFILE_SCOPE(accumulate);
+	  const typename Observator::observable_type observable = Profiling::observe_configuration<Observator>(run_simulation->get_config_space());
+	  measurement_accumulator(observable);
+	  precision_monitors[run_monitor].add(observable);
+	}
+	measurement_steps_performed += simulation_parameters.steps_between_measurement;
+	this->check_for_posix_signal();
+	run_stopped = measurements_complete();
       }
     }
     
@@ -120,7 +150,10 @@ void MetropolisParallel<ConfigurationType,Step,RandomNumberGenerator>::do_parall
     {
       // Call the signal handler for run finishing
       if (!this->is_terminating)
+      {
+	MOCASINNS_PROFILE_SCOPE(signal);
 	signal_handler_run(this);
+      }
 
       // Delete the created configuration and the simulation
       delete run_simulation->get_config_space();
@@ -129,6 +162,34 @@ void MetropolisParallel<ConfigurationType,Step,RandomNumberGenerator>::do_parall
   }
 }
 
+/*!
+  \details The measurements of the runs are independent, but they are interleaved in the accumulator. Therefore every run has its own binning analysis, and the standard error of the mean over the K started runs is combined from their standard errors as
+  \f[
+    \sigma^2 = \frac{1}{K^2} \sum_{i=1}^{K} \sigma_i^2 .
+  \f]
+  The combined estimate is only available if the estimates of all started runs are available.
+*/
+template<class ConfigurationType, class Step, class RandomNumberGenerator>
+double MetropolisParallel<ConfigurationType,Step,RandomNumberGenerator>::get_standard_error() const
+{
+  if (precision_monitors.empty()) return 0.0;
+  double variance_sum = 0.0;
+  for (typename std::vector<Details::Metropolis::PrecisionMonitor>::const_iterator monitor = precision_monitors.begin(); monitor != precision_monitors.end(); ++monitor)
+  {
+    if (!monitor->is_available()) return 0.0;
+    variance_sum += monitor->get_standard_error() * monitor->get_standard_error();
+  }
+  return std::sqrt(variance_sum) / precision_monitors.size();
+}
+
+template<class ConfigurationType, class Step, class RandomNumberGenerator>
+bool MetropolisParallel<ConfigurationType,Step,RandomNumberGenerator>::target_error_reached() const
+{
+  for (typename std::vector<Details::Metropolis::PrecisionMonitor>::const_iterator monitor = precision_monitors.begin(); monitor != precision_monitors.end(); ++monitor)
+    if (!monitor->is_converged()) return false;
+  return (!precision_monitors.empty() && get_standard_error() <= simulation_parameters.target_error);
+}
+
 /*!
  \tparam Observator Class with static function Observator::observe(ConfigurationType*) taking a pointer to the simulation and returning the value of an arbitrary observable. The class must contain a typedef ::observable_type classifying the return type of the functor.
  \tparam AccumulatorIterator Iterator of a container of a class that accepts the observable in operator() and gathers the required informations about the observables (e.g. boost::accumulator)
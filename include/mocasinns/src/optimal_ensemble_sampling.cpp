@@ -50,7 +50,10 @@ namespace Mocasinns
   double OptimalEnsembleSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator>::acceptance_probability(StepType& step_to_execute, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
   {
     // Calculate the energy difference of the step
-    step_parameters.delta_E = step_to_execute.delta_E();
+    {
+      MOCASINNS_PROFILE_SCOPE(delta_E);
+      step_parameters.delta_E = step_to_execute.delta_E();
+    }
     EnergyType total_energy_after_step = step_parameters.total_energy + step_parameters.delta_E;
 
     // If an energy cutoff is used and the step would violate the energy cutoff, return 0.0
@@ -94,6 +97,9 @@ namespace Mocasinns
   template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator>
   void OptimalEnsembleSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator>::handle_executed_step(StepType&, double time, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
   {
+    // Apply the rejected steps at the old energy with the old walker label
+    apply_rejected_steps(step_parameters);
+
     // Increment the total energy
     step_parameters.total_energy += step_parameters.delta_E;
 
@@ -115,12 +121,21 @@ namespace Mocasinns
    * \details the following updates are performed:
    * - The positive or the negative incidence counter (which one depends on the actual label of the walker) at the current total energy is increase by one
    *
+   * If <tt>Parameters::coalesce_rejected_steps</tt> is set, the step is only counted in the rejected time of the \c step_parameters, and the incidence counter is updated by apply_rejected_steps before the next executed step or at the end of do_optimal_ensemble_sampling_steps. The walker label can only change in executed steps, so the counts end up in the same histogram.
+   *
    * \param time Specifies the time the algorithm has been in the previous state if doing a rejection free algorithm
    * \param step_parameters Structure for storing the actual energy of the system and the energy difference of the simulation. (Used for performance reasons)
    */
   template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator>
   void OptimalEnsembleSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator>::handle_rejected_step(StepType&, double, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
   {
+    // Only count the rejected steps if they are coalesced
+    if (simulation_parameters.coalesce_rejected_steps)
+    {
+      step_parameters.rejected_time += 1.0;
+      return;
+    }
+
     // Update the counting histograms
     if (walker_label == positive)
       incidence_counter_positive[step_parameters.total_energy]++;
@@ -128,6 +143,23 @@ namespace Mocasinns
       incidence_counter_negative[step_parameters.total_energy]++;
   }
 
+  /*! \fn AUTO_TEMPLATE_1
+   * \details Adds the number of rejected steps stored in the \c step_parameters to the positive or the negative incidence counter (which one depends on the actual label of the walker) at the current energy and resets the number.
+   *
+   * \param step_parameters Structure for storing the actual energy of the system and the energy difference of the simulation. (Used for performance reasons)
+   */
+  template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator>
+  void OptimalEnsembleSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator>::apply_rejected_steps(Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
+  {
+    if (step_parameters.rejected_time == 0.0) return;
+
+    if (walker_label == positive)
+      incidence_counter_positive[step_parameters.total_energy] += step_parameters.rejected_time;
+    else
+      incidence_counter_negative[step_parameters.total_energy] += step_parameters.rejected_time;
+    step_parameters.rejected_time = 0.0;
+  }
+
   /*! \fn AUTO_TEMPLATE_1
    * \details Checks whether the next iteration of the weights can be calculated iterativly. Three conditions must be fulfilled for the function to return true: (1) The positive and the negative incidence counter must have at least one entry, (2) the positive and the negative incidence counter must not have more than one zero entry (for the maximal or the minimal energy) and (3) the derivative of the fraction histogram must be positive everywhere.
    */
@@ -210,6 +242,9 @@ namespace Mocasinns
     
     // Call the generic method
     this->template do_steps<OptimalEnsembleSampling<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator>,StepType, false>(number, step_parameters);
+
+    // Apply the remaining rejected steps before the weights are recalculated
+    apply_rejected_steps(step_parameters);
   }
 
   /*! \fn AUTO_TEMPLATE_2
@@ -226,6 +261,7 @@ namespace Mocasinns
   {
     // Log the start of the simulation
     this->simulation_start_log();
+    this->begin_chunks();
 
     // Create the fraction histogram
     HistoType<EnergyType, double> fraction_histogram;
@@ -251,7 +287,10 @@ namespace Mocasinns
       recalculate_weights();
 
       // Invoke the signal handler after iteration
-      signal_handler_iteration(this);
+      {
+	MOCASINNS_PROFILE_SCOPE(signal);
+	signal_handler_iteration(this);
+      }
     }
       
     // Calculate and return the density of states
@@ -11,6 +11,7 @@
 
 #include <cassert>
 #include <iterator>
+#include <algorithm>
 #include <omp.h>
 
 #include "../exceptions/iterator_range_exception.hpp"
@@ -23,15 +24,16 @@ namespace Mocasinns
     \param configuration_pointers_begin Begin of the range of pointers to configurations to work on
     \param configuration_pointers_end End of the range of pointers to configurations to work on
   */    
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
   template <class ConfigurationPointerIterator>
-  ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::ParallelTempering(const Parameters& params, ConfigurationPointerIterator configuration_pointers_begin, ConfigurationPointerIterator configuration_pointers_end) 
+  ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::ParallelTempering(const Parameters& params, ConfigurationPointerIterator configuration_pointers_begin, ConfigurationPointerIterator configuration_pointers_end) 
     : simulation_parameters(params),
       replica_exchange_direction(),
       replica_exchange_log_rejected(std::distance(configuration_pointers_begin, configuration_pointers_end) - 1, 0),
       replica_exchange_log_executed(std::distance(configuration_pointers_begin, configuration_pointers_end) - 1, 0),
       inverse_temperature_histogram_up(std::distance(configuration_pointers_begin, configuration_pointers_end), 0),
-      inverse_temperature_histogram_down(std::distance(configuration_pointers_begin, configuration_pointers_end), 0)
+      inverse_temperature_histogram_down(std::distance(configuration_pointers_begin, configuration_pointers_end), 0),
+      relaxation_steps_performed(0)
   {
     // Go through all configurations, store the pointers and set up a Metropolis simulation
     for (ConfigurationPointerIterator configuration_pointers_it = configuration_pointers_begin;
@@ -48,9 +50,9 @@ namespace Mocasinns
     \param inverse_temperatures_begin Begin of the range of inverse temperatures
     \param inverse_temperatures_end End of the range of inverse temperatures.
   */
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
   template <class TemperatureTypeIterator>
-  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::
+  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::
   do_parallel_tempering_steps(const step_number_t& number, 
 			      TemperatureTypeIterator inverse_temperatures_begin, 
 			      TemperatureTypeIterator inverse_temperatures_end)
@@ -70,9 +72,9 @@ namespace Mocasinns
     \param inverse_temperatures_begin Begin of the range of inverse temperatures
     \param inverse_temperatures_end End of the range of inverse temperatures.
   */
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
   template <class NumberIterator, class TemperatureTypeIterator>
-  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::
+  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::
   do_parallel_tempering_steps(NumberIterator numbers_begin, 
 			      NumberIterator numbers_end, 
 			      TemperatureTypeIterator inverse_temperatures_begin, 
@@ -97,6 +99,85 @@ namespace Mocasinns
     }
   }
 
+  /*!
+    \details Without Parameters::adaptive_relaxation all replicas perform Parameters::relaxation_steps steps. Otherwise the replicas perform portions of Parameters::relaxation_sample_steps steps and the energy of every replica is passed to its own equilibration detector (see Details::Metropolis::EquilibrationDetector). The relaxation stops as soon as all replicas are stationary, but after at most Parameters::relaxation_steps steps. If Parameters::adaptive_proposal_tuning is set, the proposal widths of every replica are tuned during the relaxation and frozen at its end.
+    \tparam TemperatureTypeIterator Iterator to a range of inverse temperatures. It must be possible to calculate an inner product of an inverse temperature and the energy of the system.
+    \param inverse_temperatures_begin Begin of the range of inverse temperatures
+    \param inverse_temperatures_end End of the range of inverse temperatures.
+    \returns Number of relaxation steps performed by every replica
+  */
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+  template <class TemperatureTypeIterator>
+  typename ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::step_number_t
+  ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::do_parallel_tempering_relaxation(TemperatureTypeIterator inverse_temperatures_begin,
+														     TemperatureTypeIterator inverse_temperatures_end)
+  {
+    if (simulation_parameters.adaptive_proposal_tuning)
+      for (unsigned int i = 0; i < metropolis_simulations.size(); ++i)
+	metropolis_simulations[i].begin_proposal_tuning();
+
+    if (!simulation_parameters.adaptive_relaxation || simulation_parameters.relaxation_sample_steps == 0)
+    {
+      do_parallel_tempering_relaxation_steps(simulation_parameters.relaxation_steps, inverse_temperatures_begin, inverse_temperatures_end);
+      relaxation_steps_performed = simulation_parameters.relaxation_steps;
+    }
+    else
+    {
+      // Sample the energies of all replicas until all time series are stationary or the maximal number of relaxation steps is reached
+      std::vector<Details::Metropolis::EquilibrationDetector> equilibration_detectors(metropolis_simulations.size(), Details::Metropolis::EquilibrationDetector(simulation_parameters.relaxation_batch_size));
+      relaxation_steps_performed = 0;
+      bool stationary = false;
+      while (relaxation_steps_performed < simulation_parameters.relaxation_steps && !stationary)
+      {
+	const step_number_t steps = std::min(simulation_parameters.relaxation_sample_steps, simulation_parameters.relaxation_steps - relaxation_steps_performed);
+	do_parallel_tempering_relaxation_steps(steps, inverse_temperatures_begin, inverse_temperatures_end);
+	relaxation_steps_performed += steps;
+
+	stationary = true;
+	for (unsigned int i = 0; i < metropolis_simulations.size(); ++i)
+	{
+	  equilibration_detectors[i].add(metropolis_simulations[i].get_energy());
+	  stationary = stationary && equilibration_detectors[i].is_stationary();
+	}
+      }
+    }
+
+    // Freeze the proposal widths of all replicas before the measurements start
+    if (simulation_parameters.adaptive_proposal_tuning)
+      for (unsigned int i = 0; i < metropolis_simulations.size(); ++i)
+	metropolis_simulations[i].end_proposal_tuning();
+    return relaxation_steps_performed;
+  }
+
+  /*!
+    \details Without Parameters::adaptive_proposal_tuning the steps are performed at once. Otherwise all replicas perform portions of at most Parameters::proposal_tuning_steps steps and the proposal widths of every replica are adapted to its acceptance rates after every portion (see Metropolis::tune_proposal_widths()). There are no replica exchanges during the relaxation, so every replica tunes the widths for its own inverse temperature.
+    \tparam TemperatureTypeIterator Iterator to a range of inverse temperatures. It must be possible to calculate an inner product of an inverse temperature and the energy of the system.
+    \param number Number of relaxation steps performed by every replica
+    \param inverse_temperatures_begin Begin of the range of inverse temperatures
+    \param inverse_temperatures_end End of the range of inverse temperatures.
+  */
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
+  template <class TemperatureTypeIterator>
+  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::do_parallel_tempering_relaxation_steps(const step_number_t& number,
+															 TemperatureTypeIterator inverse_temperatures_begin,
+															 TemperatureTypeIterator inverse_temperatures_end)
+  {
+    if (!simulation_parameters.adaptive_proposal_tuning || simulation_parameters.proposal_tuning_steps == 0)
+    {
+      do_parallel_tempering_steps(number, inverse_temperatures_begin, inverse_temperatures_end);
+      return;
+    }
+
+    for (step_number_t performed = 0; performed < number; )
+    {
+      const step_number_t steps = std::min(simulation_parameters.proposal_tuning_steps, number - performed);
+      do_parallel_tempering_steps(steps, inverse_temperatures_begin, inverse_temperatures_end);
+      performed += steps;
+      for (unsigned int i = 0; i < metropolis_simulations.size(); ++i)
+	metropolis_simulations[i].tune_proposal_widths();
+    }
+  }
+
   /*!
     \details Two neighbouring temperatures are selected randomly and the acceptance probability of an temperature exchange is calculated (the index of the lower inverse temperature is the return value). The exchange is executed with this acceptance probability
     \tparam TemperatureTypeIterator Iterator to a range of inverse temperatures. It must be possible to calculate an inner product of an inverse temperature and the energy of the system.
@@ -104,9 +185,9 @@ namespace Mocasinns
     \param inverse_temperatures_end End of the range of inverse temperatures.
     \returns 0 if the exchange was rejected and i if there was an exchange between the configuration at (i-1) and the configuration at i.
    */
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
   template <class TemperatureTypeIterator>
-  unsigned int ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::do_replica_exchange(TemperatureTypeIterator inverse_temperatures_begin, 
+  unsigned int ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::do_replica_exchange(TemperatureTypeIterator inverse_temperatures_begin, 
 													  TemperatureTypeIterator inverse_temperatures_end)
   {
     // Check the range of temperatures
@@ -121,9 +202,10 @@ namespace Mocasinns
     TemperatureTypeIterator inverse_temperature_iterator_2 = inverse_temperatures_begin;
     std::advance(inverse_temperature_iterator_2, exchange_index);
 
-    // Calculate the acceptance probability
-    double acceptance_probability = exp((*inverse_temperature_iterator_1 - *inverse_temperature_iterator_2) * 
-  					(metropolis_simulations[exchange_index - 1].get_config_space()->energy() - metropolis_simulations[exchange_index].get_config_space()->energy()));
+    // Calculate the acceptance probability, the energies are tracked by the Metropolis simulations if Parameters::track_energy is set
+    const typename MetropolisType::energy_type energy_1 = metropolis_simulations[exchange_index - 1].get_energy();
+    const typename MetropolisType::energy_type energy_2 = metropolis_simulations[exchange_index].get_energy();
+    double acceptance_probability = exp((*inverse_temperature_iterator_1 - *inverse_temperature_iterator_2) * (energy_1 - energy_2));
 
     // Write the inverse temperature log
     for (unsigned int b = 0; b < metropolis_simulations.size(); ++b)
@@ -152,9 +234,9 @@ namespace Mocasinns
       else if (exchange_index == metropolis_simulations.size() - 1)
 	replica_exchange_direction[metropolis_simulations[exchange_index - 1].get_config_space()] = true;
 
-      // Exchange the configurations in the metropolis simulations
-      metropolis_simulations[exchange_index - 1].set_config_space(metropolis_simulations[exchange_index].get_config_space());
-      metropolis_simulations[exchange_index].set_config_space(temp);
+      // Exchange the configurations and their energies in the metropolis simulations
+      metropolis_simulations[exchange_index - 1].set_config_space(metropolis_simulations[exchange_index].get_config_space(), energy_2);
+      metropolis_simulations[exchange_index].set_config_space(temp, energy_1);
 
       return exchange_index;
     }
@@ -167,10 +249,10 @@ namespace Mocasinns
     }
   }
 
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
   template <class Observator, class TemperatureTypeIterator>
   std::vector<std::vector<typename Observator::observable_type> > 
-  ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::
+  ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::
   do_parallel_tempering_simulation(TemperatureTypeIterator inverse_temperatures_begin, 
 				   TemperatureTypeIterator inverse_temperatures_end)
   {
@@ -191,9 +273,9 @@ namespace Mocasinns
     return result;
   }
 
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
   template <class Observator, class Accumulator, class TemperatureTypeIterator>
-  std::vector<Accumulator> ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::
+  std::vector<Accumulator> ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::
   do_parallel_tempering_simulation(const Accumulator& measurement_accumulator,
 				   TemperatureTypeIterator inverse_temperatures_begin, 
 				   TemperatureTypeIterator inverse_temperatures_end)
@@ -207,9 +289,9 @@ namespace Mocasinns
     return accumulators;
   }
 
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
   template <class Observator, class AccumulatorIterator, class TemperatureTypeIterator>
-  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::
+  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::
   do_parallel_tempering_simulation(AccumulatorIterator measurement_accumulators_begin, 
 				   AccumulatorIterator measurement_accumulators_end,
 				   TemperatureTypeIterator inverse_temperatures_begin, 
@@ -224,43 +306,68 @@ namespace Mocasinns
     assert(std::distance(measurement_accumulators_begin, measurement_accumulators_end) == 
 	   std::distance(inverse_temperatures_begin, inverse_temperatures_end));
 
-    // Do the relaxation steps
-    do_parallel_tempering_steps(simulation_parameters.relaxation_steps, inverse_temperatures_begin, inverse_temperatures_end);
+    // Do the relaxation steps and start the adaption of the measurement spacing (unless a checkpoint is resumed)
+    if (!this->resuming_checkpoint)
+    {
+      do_parallel_tempering_relaxation(inverse_temperatures_begin, inverse_temperatures_end);
+      measurement_spacing.reset(metropolis_simulations.size(), simulation_parameters.steps_between_replica_exchange, simulation_parameters.steps_between_measurement);
+    }
 
     // For each measurement, perform the steps, invoke the signal handler, take the measurement and check for posix signals
-    for (unsigned int m = 0; m < simulation_parameters.measurement_number; ++m)
+    for (step_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
     {
       // Accumulate into the accumulators (Measure)
       AccumulatorIterator measurement_accumulator_it = measurement_accumulators_begin;
       for (unsigned int i = 0; i < metropolis_simulations.size(); ++i)
       {
-  	(*measurement_accumulator_it)(Observator::observe(metropolis_simulations[i].get_config_space()));
+	{
+	  MOCASINNS_PROFILE_SCOPE(accumulate);
+	  (*measurement_accumulator_it)(metropolis_simulations[i].template observe<Observator>());
+	}
   	measurement_accumulator_it++;
       }
       // Call the measurement handler
-      signal_handler_measurement(this);
+      {
+	MOCASINNS_PROFILE_SCOPE(signal);
+	hooks.measurement(this);
+      }
 
-      // Calculate the number of replica exchanges
-      unsigned int replica_exchange_number = simulation_parameters.steps_between_measurement / simulation_parameters.steps_between_replica_exchange;
+      // Calculate the number of replica exchanges (the number of energy samples if the measurement spacing is adapted)
+      const bool adaptive_spacing = simulation_parameters.adaptive_measurement_spacing;
+      unsigned int replica_exchange_number = adaptive_spacing ? measurement_spacing.get_sample_number() : simulation_parameters.steps_between_measurement / simulation_parameters.steps_between_replica_exchange;
 
       // Do the replica exchanges and the steps
       for (unsigned int r = 0; r < replica_exchange_number; ++r)
       {
 	// Replica exchange and signal handler
   	do_replica_exchange(inverse_temperatures_begin, inverse_temperatures_end);
-	signal_handler_replica_exchange(this);
+	{
+	  MOCASINNS_PROFILE_SCOPE(signal);
+	  hooks.replica_exchange(this);
+	}
 
 	// Do the relaxation steps afterwards
   	do_parallel_tempering_steps(simulation_parameters.steps_between_replica_exchange, inverse_temperatures_begin, inverse_temperatures_end);
+
+	// Sample the energies at the fixed inverse temperatures for the estimate of the autocorrelation times
+	if (adaptive_spacing)
+	  for (unsigned int i = 0; i < metropolis_simulations.size(); ++i)
+	    measurement_spacing.add(i, metropolis_simulations[i].get_energy());
       }
 
-      // Check for POSIX
-      if (this->check_for_posix_signal()) return;
+      // Adapt the number of steps until the next measurement to the largest autocorrelation time
+      if (adaptive_spacing)
+	measurement_spacing.update(simulation_parameters.measurement_spacing_fraction,
+				   simulation_parameters.minimal_steps_between_measurement,
+				   simulation_parameters.maximal_steps_between_measurement);
+
+      // Check for POSIX signals and the time budget
+      if (this->end_chunk(m)) return;
     }
   }
 
-  template <class ConfigurationType, class Step, class RandomNumberGenerator>
-  void ParallelTempering<ConfigurationType, Step, RandomNumberGenerator>::replica_exchanges_reset()
+  template <class ConfigurationType, class Step, class RandomNumberGenerator, class HookPolicy>
+  void ParallelTempering<ConfigurationType, Step, RandomNumberGenerator, HookPolicy>::replica_exchanges_reset()
   {
     for (unsigned int i = 0; i < metropolis_simulations.size() - 1; ++i)
     {
@@ -269,8 +376,8 @@ namespace Mocasinns
     }
   }
 
-  template <class ConfigurationType, class Step, class RandomNumberGenerator>
-  void ParallelTempering<ConfigurationType, Step, RandomNumberGenerator>::inverse_temperature_histograms_reset()
+  template <class ConfigurationType, class Step, class RandomNumberGenerator, class HookPolicy>
+  void ParallelTempering<ConfigurationType, Step, RandomNumberGenerator, HookPolicy>::inverse_temperature_histograms_reset()
   {
     for (unsigned int i = 0; i < metropolis_simulations.size(); ++i)
     {
@@ -279,9 +386,9 @@ namespace Mocasinns
     }
   }
   
-  template <class ConfigurationType, class StepType, class RandomNumberGenerator>
+  template <class ConfigurationType, class StepType, class RandomNumberGenerator, class HookPolicy>
   template <class TemperatureTypeIterator>
-  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator>::check_temperature_range(TemperatureTypeIterator inverse_temperatures_begin, 
+  void ParallelTempering<ConfigurationType, StepType, RandomNumberGenerator, HookPolicy>::check_temperature_range(TemperatureTypeIterator inverse_temperatures_begin, 
 												    TemperatureTypeIterator inverse_temperatures_end)
   {
     if (std::distance(inverse_temperatures_begin, inverse_temperatures_end) != static_cast<int>(metropolis_simulations.size()))
@@ -106,9 +106,10 @@ namespace Mocasinns
     TemperatureTypeIterator inverse_temperature_iterator_2 = inverse_temperatures_begin;
     std::advance(inverse_temperature_iterator_2, exchange_index);
 
-    // Calculate the acceptance probability
-    double acceptance_probability = exp((*inverse_temperature_iterator_1 - *inverse_temperature_iterator_2) * 
-  					(configuration_pointers[exchange_index - 1]->energy() - configuration_pointers[exchange_index]->energy()));
+    // Calculate the acceptance probability, the energies are tracked by the Metropolis simulations if Parameters::track_energy is set
+    const typename MetropolisType::energy_type energy_1 = metropolis_simulations[exchange_index - 1].get_energy();
+    const typename MetropolisType::energy_type energy_2 = metropolis_simulations[exchange_index].get_energy();
+    double acceptance_probability = exp((*inverse_temperature_iterator_1 - *inverse_temperature_iterator_2) * (energy_1 - energy_2));
 
     // Do the step with the acceptance probability
     if (this->rng->random_double() < acceptance_probability)
@@ -118,8 +119,8 @@ namespace Mocasinns
       configuration_pointers[exchange_index - 1] = configuration_pointers[exchange_index];
       configuration_pointers[exchange_index] = temp;
       // Exchange the configurations in the metropolis simulations
-      metropolis_simulations[exchange_index - 1].set_config_space(configuration_pointers[exchange_index - 1]);
-      metropolis_simulations[exchange_index].set_config_space(configuration_pointers[exchange_index]);
+      metropolis_simulations[exchange_index - 1].set_config_space(configuration_pointers[exchange_index - 1], energy_2);
+      metropolis_simulations[exchange_index].set_config_space(configuration_pointers[exchange_index], energy_1);
       replica_exchange_log[exchange_index] += 1;
       return exchange_index;
     }
@@ -183,42 +184,60 @@ namespace Mocasinns
     // Assert that the size of the measurment accumulators matches the size of the inverse temperatures
     assert(std::distance(measurement_accumulators_begin, measurement_accumulators_end) == 
 	   std::distance(inverse_temperatures_begin, inverse_temperatures_end));
-    // Set up the replica exchange log
-    replica_exchange_log = std::vector<unsigned int>(configuration_pointers.size(), 0);
-
-    // Do the relaxation steps
-    do_serial_tempering_steps(simulation_parameters.relaxation_steps, inverse_temperatures_begin, inverse_temperatures_end);
+    // Set up the replica exchange log and do the relaxation steps (unless a checkpoint is resumed)
+    if (!this->resuming_checkpoint)
+    {
+      replica_exchange_log = std::vector<unsigned int>(configuration_pointers.size(), 0);
+      do_serial_tempering_steps(simulation_parameters.relaxation_steps, inverse_temperatures_begin, inverse_temperatures_end);
+      measurement_spacing.reset(configuration_pointers.size(), simulation_parameters.steps_between_replica_exchange, simulation_parameters.steps_between_measurement);
+    }
 
     // For each measurement, perform the steps, invoke the signal handler, take the measurement and check for posix signals
-    for (unsigned int m = 0; m < simulation_parameters.measurement_number; ++m)
+    for (step_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
     {
       // Call the measurement handler
-      signal_handler_measurement(this);
+      {
+	MOCASINNS_PROFILE_SCOPE(signal);
+	signal_handler_measurement(this);
+      }
 
-      // Calculate the number of replica exchanges
-      unsigned int replica_exchange_number = simulation_parameters.steps_between_measurement / simulation_parameters.steps_between_replica_exchange;
+      // Calculate the number of replica exchanges (the number of energy samples if the measurement spacing is adapted)
+      const bool adaptive_spacing = simulation_parameters.adaptive_measurement_spacing;
+      unsigned int replica_exchange_number = adaptive_spacing ? measurement_spacing.get_sample_number() : simulation_parameters.steps_between_measurement / simulation_parameters.steps_between_replica_exchange;
 
       // Do the steps and the replica exchanges
       for (unsigned int r = 0; r < replica_exchange_number - 1; ++r)
       {
   	do_serial_tempering_steps(simulation_parameters.steps_between_replica_exchange, inverse_temperatures_begin, inverse_temperatures_end);
+	if (adaptive_spacing) sample_energies();
   	do_replica_exchange(inverse_temperatures_begin, inverse_temperatures_end);
       }
 
       // Do the last number of steps
       do_serial_tempering_steps(simulation_parameters.steps_between_replica_exchange, inverse_temperatures_begin, inverse_temperatures_end);
+      // Adapt the number of steps until the next measurement to the largest autocorrelation time
+      if (adaptive_spacing)
+      {
+	sample_energies();
+	measurement_spacing.update(simulation_parameters.measurement_spacing_fraction,
+				   simulation_parameters.minimal_steps_between_measurement,
+				   simulation_parameters.maximal_steps_between_measurement);
+      }
       // Accumulate into the accumulators
       AccumulatorIterator measurement_accumulator_it = measurement_accumulators_begin;
       for (unsigned int i = 0; i < configuration_pointers.size(); ++i)
       {
-  	(*measurement_accumulator_it)(Observator::observe(configuration_pointers[i]));
+	{
+	  MOCASINNS_PROFILE_SCOPE(accumulate);
+	  (*measurement_accumulator_it)(metropolis_simulations[i].template observe<Observator>());
+	}
   	measurement_accumulator_it++;
       }
       // Do the replica exchange afterwards
       do_replica_exchange(inverse_temperatures_begin, inverse_temperatures_end);
 
-      // Check for POSIX
-      if (this->check_for_posix_signal()) return;
+      // Check for POSIX signals and the time budget
+      if (this->end_chunk(m)) return;
     }
   }
   
@@ -9,6 +9,10 @@
 #ifdef MOCASINNS_SIMULATION_HPP
 
 #include <limits>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
 
 template <class ConfigurationType, class RandomNumberGenerator>
 void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::register_posix_signal_handler()
@@ -30,71 +34,285 @@ void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::handle_pos
   if (signal_number == SIGUSR2) signal_number_caught = 3;
 }
 
+/*!
+ * \details Called by the simulation functions after every chunk of work (usually after each measurement or sweep). Besides the POSIX signals the time budget is checked: the duration of the finished chunk is recorded, and if the next chunk is not expected to end before the deadline (see set_time_budget), a checkpoint is written to the dump file (if a dump filename is set) and the simulation terminates. Before a signal handler is invoked or the checkpoint is written, synchronize() is called, so that simulations with work pending in other threads (e.g. pipelined measurements) can wait for it.
+ */
 template <class ConfigurationType, class RandomNumberGenerator>
-bool Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::check_for_posix_signal()
+template <class Synchronize>
+bool Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::check_for_posix_signal(Synchronize synchronize)
 {
   switch(signal_number_caught)
   {
   case 1: // SIGTERM
+    synchronize();
     signal_handler_sigterm(this);
     is_terminating = true;
     return true;
   case 2: // SIGUSR1
+    synchronize();
     signal_handler_sigusr1(this);
     signal_number_caught = 0;
-    return false;
+    break;
   case 3: // SIGUSR2
+    synchronize();
     signal_handler_sigusr2(this);
     signal_number_caught = 0;
-    return false;
+    break;
   default: // Avoid compiler warning
-    return false;
+    break;
   }
+
+  // Check whether the next chunk fits into the time budget
+  if (!time_budget.is_active()) return false;
+  if (time_budget_exhausted) return true;
+  time_budget.end_chunk();
+  if (time_budget.next_chunk_fits()) return false;
+
+  // Write the checkpoint (if it can be resumed) and terminate
+  if (!dump_filename.empty() && checkpoints_resumable)
+  {
+    synchronize();
+    save_checkpoint(dump_filename.c_str());
+  }
+  time_budget_exhausted = true;
+  is_terminating = true;
+  return true;
+}
+
+/*!
+ * \details The simulation functions check the time budget after each chunk of work (usually after each measurement or sweep, when they check for POSIX signals). They estimate the duration of the next chunk from the durations of the previous chunks (see Details::Checkpoint::TimeBudget) and stop before the deadline would be exceeded: a checkpoint is written to the file given by set_dump_filename() (if it is set), get_is_terminating() and get_time_budget_exhausted() return true and the simulation function returns. The checkpoint is written after a completed chunk, so it is consistent and the run can be continued with load_checkpoint() in a later job.
+ * \param seconds Wall-clock time in seconds that the simulation may use from now on, a value of 0 disables the time budget
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::set_time_budget(double seconds)
+{
+  time_budget.set(seconds);
+  time_budget.reset_chunks();
+  time_budget_exhausted = false;
+  is_terminating = false;
+}
+
+/*!
+ * \details The checkpoint is written with save_serialize() into the file <tt>filename.tmp</tt>, which is renamed to the given filename afterwards. Therefore an existing checkpoint is never replaced by an incomplete one, even if the job is killed while writing. If the temporary file cannot be written or renamed, an Exceptions::CheckpointException is thrown. Besides the data of the simulation the checkpoint contains the state of the random number generator (if it provides the member functions <tt>std::string get_state() const</tt> and <tt>void set_state(const std::string&)</tt>) and the number of chunks finished by the running simulation function.
+ * \param filename Path of the checkpoint file
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::save_checkpoint(const char* filename)
+{
+  const Details::Checkpoint::TimeBudget::clock_type::time_point start = Details::Checkpoint::TimeBudget::clock_type::now();
+
+  const std::string temporary_filename = std::string(filename) + ".tmp";
+  {
+    std::ofstream output_filestream(temporary_filename.c_str());
+    if (!output_filestream)
+      throw Exceptions::CheckpointException("The checkpoint file " + temporary_filename + " could not be opened: " + std::strerror(errno));
+    save_serialize(output_filestream);
+    output_filestream.close();
+    if (output_filestream.fail())
+      throw Exceptions::CheckpointException("The checkpoint could not be written to " + temporary_filename + ".");
+  }
+  if (std::rename(temporary_filename.c_str(), filename) != 0)
+    throw Exceptions::CheckpointException("The checkpoint " + temporary_filename + " could not be renamed to " + filename + ": " + std::strerror(errno));
+
+  // Remember the duration, the time budget leaves room for the next checkpoint
+  time_budget.set_checkpoint_seconds(std::chrono::duration<double>(Details::Checkpoint::TimeBudget::clock_type::now() - start).count());
+}
+
+/*!
+ * \details Loads the simulation with load_serialize(). The next call of the simulation function that was interrupted (with the same parameters) resumes the run: the relaxation is skipped and the loop over the measurements (or the chunks of work of the simulation function) continues with the first chunk that was not finished. The accumulator of the resumed call receives only the measurements that were not taken before the checkpoint. Simulation functions that keep their whole progress in the simulation data (e.g. WangLandau::do_wang_landau_simulation) continue from the loaded state anyway.
+ *
+ * Simulation functions iterating over ranges of inverse temperatures resume only the temperature that was interrupted, the remaining temperatures must be simulated by a new call.
+ * \param filename Path of the checkpoint file
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::load_checkpoint(const char* filename)
+{
+  load_serialize(filename);
+  resuming_checkpoint = true;
+  time_budget_exhausted = false;
+  is_terminating = false;
+}
+
+/*!
+ * \details Must be called by the simulation functions directly before the loop over the chunks (after the relaxation), restarts the timing of the chunks for the time budget. If a checkpoint was loaded, the number of chunks finished before the checkpoint is returned and the checkpoint is marked as resumed, otherwise the number of finished chunks is reset to 0.
+ * \returns Index of the first chunk that must be simulated
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+typename Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::step_number_t Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::begin_chunks()
+{
+  if (!resuming_checkpoint) finished_chunks = 0;
+  resuming_checkpoint = false;
+  time_budget.reset_chunks();
+  return finished_chunks;
 }
 
 template <class ConfigurationType, class RandomNumberGenerator>
 template <class Derived, class StepType, bool function_rejection_free, class AcceptanceProbabilityParameterType>
 typename boost::enable_if_c<!function_rejection_free, void>::type
 Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_steps(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  const double start_time = acceptance_statistics_start();
+
+  // Use the batched proposal if the configuration provides it
+  do_steps_sequential<Derived, StepType, 
+		      Details::has_function_propose_steps<ConfigurationType, void, boost::mpl::vector<RandomNumberGenerator*, std::vector<StepType>&> >::value>
+    (step_number, acceptance_probability_parameter);
+
+  acceptance_statistics_stop(start_time);
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, bool batched_proposal, class AcceptanceProbabilityParameterType>
+typename boost::enable_if_c<!batched_proposal, void>::type
+Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_steps_sequential(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
 {
   for (step_number_t i = 0; i < step_number; ++i)
   {
+    // The time of the loop that is not spent in the nested phases is charged to the proposal
+    MOCASINNS_PROFILE_SCOPE(propose);
+
     // Propose a new step
     StepType next_step = this->configuration_space->propose_step(this->rng);
     
-    // If the next step is executable, calculate the acceptance probability
-    if (Details::OptionalMemberFunctions::optional_is_executable<StepType>(next_step))
-    {
-      // Calculate selection probability factor and acceptance probability
-      double selection_probability_factor = Details::OptionalMemberFunctions::optional_selection_probability_factor<StepType>(next_step);
-      double step_probability(static_cast<Derived*>(this)->acceptance_probability(next_step, acceptance_probability_parameter));
-      step_probability /= selection_probability_factor;
+    // Calculate the acceptance probability and do the step with the correct probability
+    double probability = step_probability<Derived>(next_step, acceptance_probability_parameter);
+    execute_or_reject_step<Derived>(next_step, accept_step(probability), acceptance_probability_parameter);
+  }
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, bool batched_proposal, class AcceptanceProbabilityParameterType>
+typename boost::enable_if_c<batched_proposal, void>::type
+Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_steps_sequential(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  const std::size_t block_size = std::max(step_block_size, static_cast<std::size_t>(1));
+  std::vector<StepType> proposed_steps;
+  proposed_steps.reserve(block_size);
+
+  for (step_number_t i = 0; i < step_number; i += proposed_steps.size())
+  {
+    // The time of the loop that is not spent in the nested phases is charged to the proposal
+    MOCASINNS_PROFILE_SCOPE(propose);
+
+    // Propose a block of steps
+    const std::size_t actual_block_size = static_cast<std::size_t>(std::min(static_cast<step_number_t>(block_size), step_number - i));
+    proposed_steps.resize(actual_block_size);
+    this->configuration_space->propose_steps(this->rng, proposed_steps);
 
-      // Do the step with the correct probability and call the handlers
-      if (step_probability > 0.0 && (step_probability >= 1.0 || this->rng->random_double() < step_probability))
+    // Accept or reject the steps sequentially, re-evaluate the remaining steps after each executed step
+    for (std::size_t s = 0; s < actual_block_size; ++s)
+    {
+      double probability = step_probability<Derived>(proposed_steps[s], acceptance_probability_parameter);
+      if (execute_or_reject_step<Derived>(proposed_steps[s], accept_step(probability), acceptance_probability_parameter)
+	  && s + 1 < actual_block_size)
       {
-	next_step.execute();
-#ifdef MOCASINNS_ACCEPTANCE_RATIO
-	accepted_steps++;
-#endif
-	static_cast<Derived*>(this)->handle_executed_step(next_step, 1.0, acceptance_probability_parameter);
+	Details::OptionalMemberFunctions::optional_update_proposed_steps<ConfigurationType, StepType>(*this->configuration_space, proposed_steps, s + 1, proposed_steps[s]);
       }
-      else
-      {
-#ifdef MOCASINNS_ACCEPTANCE_RATIO
-	rejected_steps++;
-#endif
-	static_cast<Derived*>(this)->handle_rejected_step(next_step, 1.0, acceptance_probability_parameter);
-      }
-    } // of if (next_step.is_executable())
+    }
+  }
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+typename boost::enable_if_c<Mocasinns::Details::has_function_propose_sweep_step<ConfigurationType, StepType, boost::mpl::vector<std::size_t, RandomNumberGenerator*> >::value, void>::type
+Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_sweep_steps(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  const std::size_t sweep_length = this->configuration_space->sweep_length();
+  if (sweep_length == 0) return;
+  const double start_time = acceptance_statistics_start();
+
+  for (step_number_t i = 0; i < step_number; ++i)
+  {
+    // The time of the loop that is not spent in the nested phases is charged to the proposal
+    MOCASINNS_PROFILE_SCOPE(propose);
+
+    // Take the next step of the sweep
+    if (sweep_position >= sweep_length) sweep_position = 0;
+    StepType next_step = this->configuration_space->propose_sweep_step(sweep_position++, this->rng);
+
+    // Calculate the acceptance probability and do the step with the correct probability
+    double probability = step_probability<Derived>(next_step, acceptance_probability_parameter);
+    execute_or_reject_step<Derived>(next_step, accept_step(probability), acceptance_probability_parameter);
+  }
+
+  acceptance_statistics_stop(start_time);
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+typename boost::enable_if_c<!Mocasinns::Details::has_function_propose_sweep_step<ConfigurationType, StepType, boost::mpl::vector<std::size_t, RandomNumberGenerator*> >::value, void>::type
+Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_sweep_steps(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  // The configuration does not provide a sweep, propose the steps at random
+  do_steps<Derived, StepType, false>(step_number, acceptance_probability_parameter);
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+double Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::step_probability(StepType& step, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  // If the step is not executable, it will be rejected
+  {
+    MOCASINNS_PROFILE_SCOPE(is_executable);
+    if (!Details::OptionalMemberFunctions::optional_is_executable<StepType>(step)) return 0.0;
+  }
+
+  // Calculate selection probability factor and acceptance probability
+  MOCASINNS_PROFILE_SCOPE(acceptance);
+  double selection_probability_factor = Details::OptionalMemberFunctions::optional_selection_probability_factor<StepType>(step);
+  double probability(static_cast<Derived*>(this)->acceptance_probability(step, acceptance_probability_parameter));
+  return probability / selection_probability_factor;
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+bool Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::execute_or_reject_step(StepType& step, bool accepted, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  // Record the step before its execution changes the energy difference
+  if (collect_acceptance_statistics)
+  {
+    if (Details::OptionalMemberFunctions::optional_is_executable<StepType>(step))
+      record_acceptance(0, step, step.delta_E(), accepted);
     else
+      thread_acceptance_statistics[0].record_not_executable(Details::OptionalMemberFunctions::optional_step_type<StepType>(step));
+  }
+
+  if (accepted)
+  {
     {
+      MOCASINNS_PROFILE_SCOPE(execute);
+      step.execute();
+    }
 #ifdef MOCASINNS_ACCEPTANCE_RATIO
-      rejected_steps++;
+    accepted_steps++;
 #endif
-      static_cast<Derived*>(this)->handle_rejected_step(next_step, 1.0, acceptance_probability_parameter);
-    }
+    MOCASINNS_PROFILE_SCOPE(handle);
+    static_cast<Derived*>(this)->handle_executed_step(step, 1.0, acceptance_probability_parameter);
   }
+  else
+  {
+#ifdef MOCASINNS_ACCEPTANCE_RATIO
+    rejected_steps++;
+#endif
+    MOCASINNS_PROFILE_SCOPE(handle);
+    static_cast<Derived*>(this)->handle_rejected_step(step, 1.0, acceptance_probability_parameter);
+  }
+  return accepted;
+}
+
+/*!
+ * \details The comparison with the random number is done in the phase Profiling::random_number if the profiling is enabled.
+ * \param probability Acceptance probability of the step, may be larger than one or not executable (0.0)
+ * \returns True if the step is accepted, false otherwise
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+bool Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::accept_step(double probability)
+{
+  if (!(probability > 0.0)) return false;
+  if (probability >= 1.0) return true;
+
+  MOCASINNS_PROFILE_SCOPE(random_number);
+  return rng->random_double() < probability;
 }
  
 template <class ConfigurationType, class RandomNumberGenerator>
@@ -102,99 +320,341 @@ template <class Derived, class StepType, bool function_rejection_free, class Acc
 typename boost::enable_if_c<function_rejection_free, void>::type
 Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_steps(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
 {
+  // Use the incremental update of the rates if the configuration reports the steps affected by an executed step
+  // Group the steps in classes of equal energy differences if the energy differences are discrete
+  do_steps_rejection_free<Derived, StepType,
+			  Details::has_function_affected_steps<ConfigurationType, void, boost::mpl::vector<StepType&, std::vector<std::size_t>&> >::value,
+			  boost::mpl::and_<Details::has_function_affected_steps<ConfigurationType, void, boost::mpl::vector<StepType&, std::vector<std::size_t>&> >,
+					   Details::RejectionFree::use_step_classes<StepType> >::value>
+    (step_number, acceptance_probability_parameter);
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, bool incremental_rates, bool step_classes, class AcceptanceProbabilityParameterType>
+typename boost::enable_if_c<!incremental_rates, void>::type
+Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_steps_rejection_free(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  // If the acceptance probability of the derived algorithm depends on the total energy or on histograms, the acceptance probabilities may change after a rejected step
+  const bool local_acceptance_probability = Details::has_static_member_data_local_acceptance_probability<Derived, const bool>::value;
+
   double remaining_simulation_time = step_number;
 
+  // Buffers for the steps and the acceptance probability parameters owned by the simulation
+  // Constant parameters cannot be changed by the acceptance probability, so they are not stored for every step
+  typedef typename boost::remove_const<AcceptanceProbabilityParameterType>::type ParameterValueType;
+  const bool store_step_parameters = !boost::is_const<AcceptanceProbabilityParameterType>::value;
+  Details::RejectionFree::StepBuffer<StepType, ParameterValueType>& buffer = rejection_free_step_buffer.template get<StepType, ParameterValueType>();
+  std::vector<StepType>& all_steps = buffer.steps;
+  std::vector<ParameterValueType>& step_parameters = buffer.parameters;
+
   while (remaining_simulation_time > 0)
   {
+    // The time of the selection that is not spent in the nested phases is charged to the proposal
+    MOCASINNS_PROFILE_SCOPE(propose);
+
     // Propose all possible steps
-    std::vector<StepType> all_steps = this->configuration_space->all_steps();
-    std::vector<double> acceptance_probabilities(all_steps.size(), 0.0);
+    Details::OptionalMemberFunctions::optional_all_steps<ConfigurationType, StepType>(*this->configuration_space, all_steps);
+    if (store_step_parameters) step_parameters.resize(all_steps.size(), acceptance_probability_parameter);
 
-    // Iterate all steps and calculate the acceptance probabilities
+    // Iterate all steps and calculate the cumulated acceptance probabilities
+    // If a step at position r is not executable, its acceptance probability is 0 and cumulative_acceptance_probabilities[r + 1] = cumulative_acceptance_probabilities[r]
+    cumulative_acceptance_probabilities.resize(all_steps.size() + 1);
+    cumulative_acceptance_probabilities[0] = 0.0;
     for (unsigned int s = 0; s < all_steps.size(); ++s)
     {
-      // If the step is executable, calculate the acceptance probability
-      // If the step is not executable, the acceptance probability remains 0
-      if (Details::OptionalMemberFunctions::optional_is_executable<StepType>(all_steps[s]))
-      {
-	// Calculate selection probability factor and acceptance probability
-	double selection_probability_factor = Details::OptionalMemberFunctions::optional_selection_probability_factor<StepType>(all_steps[s]);
-	double step_probability(static_cast<Derived*>(this)->acceptance_probability(all_steps[s], acceptance_probability_parameter));
-	step_probability /= selection_probability_factor;
-
-	// Store the acceptance probability
-	acceptance_probabilities[s] = std::min(1.0, step_probability);
-      }
+      AcceptanceProbabilityParameterType& step_parameter = (store_step_parameters ? (step_parameters[s] = acceptance_probability_parameter) : acceptance_probability_parameter);
+      double probability = step_probability<Derived>(all_steps[s], step_parameter);
+      cumulative_acceptance_probabilities[s + 1] = cumulative_acceptance_probabilities[s] + std::min(1.0, probability);
     } 
 
-    // Calculate the cumulated acceptance probabilities
-    // If a step at position r is not executable, cumulative_acceptance_probabilities[r + 1] = cumulative_acceptance_probabilities[r]
-    std::vector<double> cumulative_acceptance_probabilities(all_steps.size() + 1);
-    cumulative_acceptance_probabilities[0] = 0.0;
-    for (unsigned int s = 1; s < all_steps.size() + 1; ++s)
-    {
-      cumulative_acceptance_probabilities[s] = cumulative_acceptance_probabilities[s - 1] + acceptance_probabilities[s - 1];
-    }
-
     // Create a random number and determine which step to execute
     double rnd = rng->random_double()*cumulative_acceptance_probabilities[all_steps.size()];
-    unsigned int step_index = 0;
-    for (unsigned int s = 0; s < all_steps.size(); ++s)
-    {
-      if (cumulative_acceptance_probabilities[s] <= rnd && cumulative_acceptance_probabilities[s+1] > rnd)
-	step_index = s;
-    }
+    unsigned int step_index = std::upper_bound(cumulative_acceptance_probabilities.begin() + 1, cumulative_acceptance_probabilities.end(), rnd) 
+      - (cumulative_acceptance_probabilities.begin() + 1);
+    if (step_index >= all_steps.size()) step_index = 0;
 
-    // Calculate again the acceptance probability to get the acceptance probability parameter right.
-    // TODO: Correct this in the future because this is not efficient
-    static_cast<Derived*>(this)->acceptance_probability(all_steps[step_index], acceptance_probability_parameter);
+    // Use the acceptance probability parameter of the step that will be executed
+    if (store_step_parameters) restore_acceptance_probability_parameter<AcceptanceProbabilityParameterType>(acceptance_probability_parameter, step_parameters[step_index]);
 
-    // Check that the maximal cumulative acceptance probability is not 0 (this means that the entropy difference of the neighbouring bins is to high for double precission and we would stay infinitesimal long in the state
-    // If this is the case, do not execute the step, but handle a rejected step
-    double time = 1.0 / cumulative_acceptance_probabilities[all_steps.size()];
-    // ToDo: Check whether updating with another factor makes sense
-    if (time == std::numeric_limits<double>::infinity() || time != time)
-      static_cast<Derived*>(this)->handle_rejected_step(all_steps[step_index], 1.0, acceptance_probability_parameter);
-    else
+    // Execute the step and handle the time
+    // A step is only rejected if all acceptance probabilities vanish (or at the end of the simulation time), local acceptance probabilities cannot change without an executed step
+    if (!execute_rejection_free_step<Derived>(all_steps[step_index], cumulative_acceptance_probabilities[all_steps.size()], remaining_simulation_time, acceptance_probability_parameter)
+	&& local_acceptance_probability) break;
+  } // of while (remaining_simulation_time > 0.0)
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, bool incremental_rates, bool step_classes, class AcceptanceProbabilityParameterType>
+typename boost::enable_if_c<incremental_rates && !step_classes, void>::type
+Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_steps_rejection_free(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  // If the acceptance probability of the derived algorithm depends on the total energy or on histograms, all rates change after every executed step
+  const bool local_acceptance_probability = Details::has_static_member_data_local_acceptance_probability<Derived, const bool>::value;
+
+  double remaining_simulation_time = step_number;
+
+  // Enumerate all steps once, the configuration guarantees that the step at an index always denotes the same move
+  std::vector<StepType> all_steps;
+  std::vector<typename boost::remove_const<AcceptanceProbabilityParameterType>::type> step_parameters;
+  std::vector<std::size_t> affected_indices;
+  Details::OptionalMemberFunctions::optional_all_steps<ConfigurationType, StepType>(*this->configuration_space, all_steps);
+  step_parameters.assign(all_steps.size(), acceptance_probability_parameter);
+
+  // Calculate all rates
+  rejection_free_rates.assign(all_steps.size());
+  for (unsigned int s = 0; s < all_steps.size(); ++s)
+    rejection_free_rates.set_rate_lazy(s, std::min(1.0, step_probability<Derived>(all_steps[s], step_parameters[s])));
+  rejection_free_rates.rebuild();
+
+  while (remaining_simulation_time > 0)
+  {
+    // The time of the selection that is not spent in the nested phases is charged to the proposal
+    MOCASINNS_PROFILE_SCOPE(propose);
+
+    // Create a random number and determine which step to execute
+    const double total_rate = rejection_free_rates.reliable_total();
+    std::size_t step_index = rejection_free_rates.find(rng->random_double()*total_rate);
+
+    // Use the acceptance probability parameter of the step that will be executed
+    restore_acceptance_probability_parameter<AcceptanceProbabilityParameterType>(acceptance_probability_parameter, step_parameters[step_index]);
+
+    // Execute the step and update the rates of the affected steps (or of all steps for non-local acceptance probabilities)
+    const bool executed = execute_rejection_free_step<Derived>(all_steps[step_index], total_rate, remaining_simulation_time, acceptance_probability_parameter);
+    if (!(remaining_simulation_time > 0)) break;
+    if (local_acceptance_probability)
     {
-      if (remaining_simulation_time - time > 0)
+      // A step is only rejected if all rates vanish, local acceptance probabilities cannot change without an executed step
+      if (!executed) break;
+      affected_indices.clear();
+      this->configuration_space->affected_steps(all_steps[step_index], affected_indices);
+      for (std::vector<std::size_t>::const_iterator index = affected_indices.begin(); index != affected_indices.end(); ++index)
       {
-	all_steps[step_index].execute();
-	// Handle the executed step with time
-	static_cast<Derived*>(this)->handle_executed_step(all_steps[step_index], time, acceptance_probability_parameter);
-	remaining_simulation_time -= time;
+	step_parameters[*index] = acceptance_probability_parameter;
+	rejection_free_rates.set_rate(*index, std::min(1.0, step_probability<Derived>(all_steps[*index], step_parameters[*index])));
       }
-      else
+    }
+    else
+    {
+      // The rejected step may have changed the acceptance probabilities as well (e.g. the density of states of WangLandau)
+      for (unsigned int s = 0; s < all_steps.size(); ++s)
       {
-	// Randomly choose whether the step should be executed or not
-	if (rng->random_double() < remaining_simulation_time / time)
-	{
-	  all_steps[step_index].execute();
-	  // Handle the executed step with the remaining time
-	  static_cast<Derived*>(this)->handle_executed_step(all_steps[step_index], remaining_simulation_time, acceptance_probability_parameter);
-	}
-	else
-	{
-	  // Handle the rejected step with the remaining time
-	  static_cast<Derived*>(this)->handle_rejected_step(all_steps[step_index], remaining_simulation_time, acceptance_probability_parameter);
-	}
-	remaining_simulation_time = -1.0;
+	step_parameters[s] = acceptance_probability_parameter;
+	rejection_free_rates.set_rate_lazy(s, std::min(1.0, step_probability<Derived>(all_steps[s], step_parameters[s])));
       }
+      rejection_free_rates.rebuild();
     }
   } // of while (remaining_simulation_time > 0.0)
 }
 
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, bool incremental_rates, bool step_classes, class AcceptanceProbabilityParameterType>
+typename boost::enable_if_c<incremental_rates && step_classes, void>::type
+Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::do_steps_rejection_free(const step_number_t& step_number, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  typedef typename Details::RejectionFree::step_energy_difference<StepType>::type EnergyDifferenceType;
+
+  // If the acceptance probability of the derived algorithm depends on the total energy or on histograms, the class rates may change after a rejected step
+  const bool local_acceptance_probability = Details::has_static_member_data_local_acceptance_probability<Derived, const bool>::value;
+
+  double remaining_simulation_time = step_number;
+
+  // Enumerate all steps once and group them in classes of equal energy difference, the configuration guarantees that the step at an index always denotes the same move
+  std::vector<StepType> all_steps;
+  std::vector<typename boost::remove_const<AcceptanceProbabilityParameterType>::type> class_parameters;
+  std::vector<std::size_t> affected_indices;
+  Details::RejectionFree::StepClasses<std::pair<bool, EnergyDifferenceType> > classes;
+  Details::OptionalMemberFunctions::optional_all_steps<ConfigurationType, StepType>(*this->configuration_space, all_steps);
+  classes.assign(all_steps.size());
+  for (unsigned int s = 0; s < all_steps.size(); ++s)
+    classes.set_class(s, step_class_key<EnergyDifferenceType>(all_steps[s]));
+
+  while (remaining_simulation_time > 0)
+  {
+    // The time of the selection that is not spent in the nested phases is charged to the proposal
+    MOCASINNS_PROFILE_SCOPE(propose);
+
+    // Calculate the rates of the classes using one member of each class, not executable steps have rate 0
+    class_parameters.assign(classes.size(), acceptance_probability_parameter);
+    cumulative_acceptance_probabilities.resize(classes.size() + 1);
+    cumulative_acceptance_probabilities[0] = 0.0;
+    for (unsigned int c = 0; c < classes.size(); ++c)
+    {
+      double class_rate = 0.0;
+      if (classes.key(c).first && classes.class_size(c) > 0)
+	class_rate = std::min(1.0, step_probability<Derived>(all_steps[classes.member(c, 0)], class_parameters[c])) * classes.class_size(c);
+      cumulative_acceptance_probabilities[c + 1] = cumulative_acceptance_probabilities[c] + class_rate;
+    }
+
+    // Create a random number and determine the class of the step to execute
+    const double total_rate = cumulative_acceptance_probabilities[classes.size()];
+    double rnd = rng->random_double()*total_rate;
+    unsigned int class_index = std::upper_bound(cumulative_acceptance_probabilities.begin() + 1, cumulative_acceptance_probabilities.end(), rnd) 
+      - (cumulative_acceptance_probabilities.begin() + 1);
+    if (class_index >= classes.size()) class_index = 0;
+
+    // Choose the member of the class uniformly using the remainder of the random number
+    std::size_t step_index = 0;
+    if (classes.size() > 0 && classes.class_size(class_index) > 0)
+    {
+      const double class_rate = cumulative_acceptance_probabilities[class_index + 1] - cumulative_acceptance_probabilities[class_index];
+      std::size_t position = 0;
+      if (class_rate > 0.0)
+	position = static_cast<std::size_t>((rnd - cumulative_acceptance_probabilities[class_index]) / class_rate * classes.class_size(class_index));
+      step_index = classes.member(class_index, std::min(position, classes.class_size(class_index) - 1));
+      restore_acceptance_probability_parameter<AcceptanceProbabilityParameterType>(acceptance_probability_parameter, class_parameters[class_index]);
+    }
+
+    // Execute the step and move the affected steps to their new classes
+    if (!execute_rejection_free_step<Derived>(all_steps[step_index], total_rate, remaining_simulation_time, acceptance_probability_parameter))
+    {
+      // A step is only rejected if all class rates vanish (or at the end of the simulation time), local acceptance probabilities cannot change without an executed step
+      if (local_acceptance_probability) break;
+      continue;
+    }
+    affected_indices.clear();
+    this->configuration_space->affected_steps(all_steps[step_index], affected_indices);
+    for (std::vector<std::size_t>::const_iterator index = affected_indices.begin(); index != affected_indices.end(); ++index)
+      classes.set_class(*index, step_class_key<EnergyDifferenceType>(all_steps[*index]));
+  } // of while (remaining_simulation_time > 0.0)
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class EnergyDifferenceType, class StepType>
+std::pair<bool, EnergyDifferenceType> Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::step_class_key(StepType& step)
+{
+  if (Details::OptionalMemberFunctions::optional_is_executable<StepType>(step))
+    return std::pair<bool, EnergyDifferenceType>(true, step.delta_E());
+  else
+    return std::pair<bool, EnergyDifferenceType>(false, EnergyDifferenceType());
+}
+
+/*!
+ * \details Determines the time that a non rejection-free algorithm would stay in the actual state from the total rate. If the total rate vanishes, the step is rejected. If the time exceeds the remaining simulation time, the step is executed with the probability given by the ratio of the remaining time and the time in the state.
+ * \returns True if the step was executed, false otherwise
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+template <class Derived, class StepType, class AcceptanceProbabilityParameterType>
+bool Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::execute_rejection_free_step(StepType& step, double total_rate, double& remaining_simulation_time, AcceptanceProbabilityParameterType& acceptance_probability_parameter)
+{
+  // Check that the maximal cumulative acceptance probability is not 0 (this means that the entropy difference of the neighbouring bins is to high for double precission and we would stay infinitesimal long in the state
+  // If this is the case, do not execute the step, but handle a rejected step
+  double time = 1.0 / total_rate;
+  // ToDo: Check whether updating with another factor makes sense
+  if (time == std::numeric_limits<double>::infinity() || time != time)
+  {
+    MOCASINNS_PROFILE_SCOPE(handle);
+    static_cast<Derived*>(this)->handle_rejected_step(step, 1.0, acceptance_probability_parameter);
+    return false;
+  }
+  
+  if (remaining_simulation_time - time > 0)
+  {
+    {
+      MOCASINNS_PROFILE_SCOPE(execute);
+      step.execute();
+    }
+    // Handle the executed step with time
+    MOCASINNS_PROFILE_SCOPE(handle);
+    static_cast<Derived*>(this)->handle_executed_step(step, time, acceptance_probability_parameter);
+    remaining_simulation_time -= time;
+    return true;
+  }
+
+  // Randomly choose whether the step should be executed or not
+  const double remaining_time = remaining_simulation_time;
+  remaining_simulation_time = -1.0;
+  if (rng->random_double() < remaining_time / time)
+  {
+    {
+      MOCASINNS_PROFILE_SCOPE(execute);
+      step.execute();
+    }
+    // Handle the executed step with the remaining time
+    MOCASINNS_PROFILE_SCOPE(handle);
+    static_cast<Derived*>(this)->handle_executed_step(step, remaining_time, acceptance_probability_parameter);
+    return true;
+  }
+  else
+  {
+    // Handle the rejected step with the remaining time
+    MOCASINNS_PROFILE_SCOPE(handle);
+    static_cast<Derived*>(this)->handle_rejected_step(step, remaining_time, acceptance_probability_parameter);
+    return false;
+  }
+}
+
+/*!
+ * \details The statistics of all threads are cleared and get the new bin width.
+ * \param value Width of the bins in which the energy differences of the steps are grouped
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::set_acceptance_statistics_bin_width(double value)
+{
+  for (std::size_t t = 0; t < thread_acceptance_statistics.size(); ++t)
+    thread_acceptance_statistics[t].set_bin_width(value);
+}
+
+/*!
+ * \details The acceptance statistics are only collected if set_collect_acceptance_statistics(true) was called. Every step proposed by Simulation::do_steps, Simulation::do_sweep_steps or the sublattice and speculative steps of Metropolis is counted by its energy difference and by its type. The energy difference is calculated again for the statistics, so collecting the statistics slows down the simulation. Rejection-free and multi-spin coded steps are not counted. The statistics of the threads of a parallel algorithm are merged into the returned object, which can be stored using boost serialization.
+ * \returns Copy of the merged acceptance statistics of all threads
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+Mocasinns::Statistics::AcceptanceStatistics Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::get_acceptance_statistics() const
+{
+  Statistics::AcceptanceStatistics result(thread_acceptance_statistics[0]);
+  for (std::size_t t = 1; t < thread_acceptance_statistics.size(); ++t)
+    result += thread_acceptance_statistics[t];
+  return result;
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::reset_acceptance_statistics()
+{
+  for (std::size_t t = 0; t < thread_acceptance_statistics.size(); ++t)
+    thread_acceptance_statistics[t].clear();
+}
+
+/*!
+ * \param thread_number Number of threads that will record steps, the statistics of additional threads get the bin width of the statistics of the first thread
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::acceptance_statistics_reserve(std::size_t thread_number)
+{
+  if (thread_number > thread_acceptance_statistics.size())
+    thread_acceptance_statistics.resize(thread_number, Statistics::AcceptanceStatistics(thread_acceptance_statistics[0].get_bin_width()));
+}
+
+template <class ConfigurationType, class RandomNumberGenerator>
+double Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::acceptance_statistics_start() const
+{
+  if (!collect_acceptance_statistics) return 0.0;
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+ * \param start_time Time stamp returned by acceptance_statistics_start() at the beginning of the steps
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+void Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::acceptance_statistics_stop(double start_time)
+{
+  if (!collect_acceptance_statistics) return;
+  thread_acceptance_statistics[0].add_seconds(acceptance_statistics_start() - start_time);
+}
+
 /*! \fn AUTO_TEMPLATE_1
  * \details The configuration space is allocated during the construction of the simulation.
  */
 template <class ConfigurationType, class RandomNumberGenerator>
 Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::Simulation()
-  : rng_seed(0), is_terminating(false)
+  : rng_seed(0), is_terminating(false), time_budget_exhausted(false), finished_chunks(0), resuming_checkpoint(false), checkpoints_resumable(true), step_block_size(64), sweep_position(0), collect_acceptance_statistics(false), thread_acceptance_statistics(1)
 {
   rng = new RandomNumberGenerator();
   rng->set_seed(rng_seed);
   configuration_space = new ConfigurationType();
   register_posix_signal_handler();
+#ifdef MOCASINNS_ACCEPTANCE_RATIO
+  reset_acceptance_ratio();
+#endif
 }
 
 /*! \fn AUTO_TEMPLATE_1
@@ -202,12 +662,15 @@ Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::Simulation()
  */
 template <class ConfigurationType, class RandomNumberGenerator>
 Mocasinns::Simulation<ConfigurationType, RandomNumberGenerator>::Simulation(ConfigurationType* new_configuration)
-  : rng_seed(0), is_terminating(false)
+  : rng_seed(0), is_terminating(false), time_budget_exhausted(false), finished_chunks(0), resuming_checkpoint(false), checkpoints_resumable(true), step_block_size(64), sweep_position(0), collect_acceptance_statistics(false), thread_acceptance_statistics(1)
 {
   rng = new RandomNumberGenerator();
   rng->set_seed(rng_seed);
   configuration_space = new_configuration;
   register_posix_signal_handler();
+#ifdef MOCASINNS_ACCEPTANCE_RATIO
+  reset_acceptance_ratio();
+#endif
 }
 
 template <class ConfigurationType, class RandomNumberGenerator>
@@ -0,0 +1,221 @@
+/*!
+ * \file swendsen_wang.cpp
+ * \brief Implementation of the libMoCaSinns Swendsen-Wang template interface
+ *
+ * \author Benedikt Krüger
+ */
+
+#ifdef MOCASINNS_SWENDSEN_WANG_HPP
+
+#include <iterator>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../details/metropolis/vector_accumulator.hpp"
+#include "../exceptions/iterator_range_exception.hpp"
+
+namespace Mocasinns
+{
+
+/*!
+  \details The bond is activated if the random number is not smaller than the Boltzmann factor of the bond energy, bonds with non-positive energy are never activated and need no random number.
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class EnergyType, class TemperatureType>
+bool SwendsenWang<ConfigurationType, RandomNumberGenerator>::activate_bond(const EnergyType& bond_energy, const TemperatureType& beta, RandomNumberGenerator* rng, Details::Metropolis::AcceptanceTable& acceptance_table)
+{
+  if (!(bond_energy > 0)) return false;
+  return rng->random_double() >= acceptance_table(bond_energy, beta);
+}
+
+/*!
+  \details The buffers of the labels and flip decisions are (re-)allocated only if the number of sites of the configuration has changed, and the random number generators of the threads only if the number of threads has changed. If the configuration provides the member function <tt>void prepare_cluster_update(RandomNumberGenerator* rng)</tt>, it is called before every decomposition.
+  \tparam TemperatureType Type of the inverse temperature, there must be an operator* defined this class and the bond energy type of the configuration.
+  \param number Number of cluster decompositions that will be performed
+  \param beta Inverse temperature that will be used for calculation of the bond activation probabilities.
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class TemperatureType>
+void SwendsenWang<ConfigurationType, RandomNumberGenerator>::do_swendsen_wang_steps(const step_number_t& number, const TemperatureType& beta)
+{
+  const unsigned int thread_number = std::max(simulation_parameters.thread_number, 1u);
+
+  // Create the random number generators and Boltzmann factor tables of the threads
+  if (thread_rngs.size() != thread_number)
+  {
+    threads_clear();
+    for (unsigned int t = 0; t < thread_number; ++t)
+    {
+      thread_rngs.push_back(new RandomNumberGenerator());
+      thread_rngs.back()->set_seed(this->rng->random_int32());
+    }
+    thread_acceptance_tables.resize(thread_number);
+  }
+
+  ConfigurationType* configuration = this->configuration_space;
+  const long site_number = static_cast<long>(configuration->site_number());
+  cluster_labels.resize(site_number);
+  flip_decisions.resize(site_number);
+
+  for (step_number_t i = 0; i < number; ++i)
+  {
+    Details::OptionalMemberFunctions::optional_prepare_cluster_update(*configuration, this->rng);
+
+#pragma omp parallel num_threads(thread_number) if(thread_number > 1)
+    {
+      unsigned int thread = 0;
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+#endif
+      RandomNumberGenerator* thread_rng = thread_rngs[thread];
+      Details::Metropolis::AcceptanceTable& thread_acceptance_table = thread_acceptance_tables[thread];
+
+      // Every site forms a cluster of its own
+#pragma omp for schedule(static)
+      for (long site = 0; site < site_number; ++site)
+	cluster_labels.make_set(site);
+
+      // Activate the bonds to the neighbours with larger index and unite the clusters of the activated bonds
+#pragma omp for schedule(static)
+      for (long site = 0; site < site_number; ++site)
+      {
+	const std::size_t neighbour_number = configuration->neighbour_number(site);
+	for (std::size_t n = 0; n < neighbour_number; ++n)
+	{
+	  const std::size_t neighbour = configuration->neighbour(site, n);
+	  if (neighbour <= static_cast<std::size_t>(site)) continue;
+
+	  if (activate_bond(configuration->bond_energy(site, neighbour), beta, thread_rng, thread_acceptance_table))
+	    cluster_labels.unite(site, neighbour);
+	}
+	flip_decisions[site] = (thread_rng->random_double() < 0.5);
+      }
+
+      // Flip the sites whose cluster root has decided to flip
+#pragma omp for schedule(static)
+      for (long site = 0; site < site_number; ++site)
+	if (flip_decisions[cluster_labels.find(site)]) configuration->flip_site(site);
+    }
+  }
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \param beta Inverse temperature at which the simulation is performed.
+  \returns Vector containing the single measurements performed
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class Observator, class TemperatureType>
+std::vector<typename Observator::observable_type> SwendsenWang<ConfigurationType, RandomNumberGenerator>::do_swendsen_wang_simulation(const TemperatureType& beta)
+{
+  // Check the concept of the observator
+  BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
+  // Check the concept of the observable
+  BOOST_CONCEPT_ASSERT((Concepts::ObservableConcept<typename Observator::observable_type>));
+
+  // Call the accumulator function using the VectorAccumulator
+  Details::Metropolis::VectorAccumulator<typename Observator::observable_type> measurements_accumulator;
+  do_swendsen_wang_simulation<Observator>(beta, measurements_accumulator);
+
+  // Return the plain data
+  return measurements_accumulator.internal_vector;
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \tparam InputIterator \conceptiterator{InverseTemperatureType}
+  \param beta_begin Iterator pointing to the first inverse temperature that is calculated
+  \param beta_end Iterator pointing on position after the last inverse temperature that is calculated
+  \returns Vector containing the vectors of measurments performed for each temperature. (First index: inverse temperature, second index: measurment number)
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class Observator, class InputIterator>
+std::vector<std::vector<typename Observator::observable_type> > SwendsenWang<ConfigurationType, RandomNumberGenerator>::do_swendsen_wang_simulation(InputIterator beta_begin, InputIterator beta_end)
+{
+  std::vector<std::vector<typename Observator::observable_type> > results;
+  for (InputIterator beta = beta_begin; beta != beta_end; ++beta)
+  {
+    results.push_back(do_swendsen_wang_simulation<Observator>(*beta));
+    if (this->is_terminating) break;
+  }
+  return results;
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \tparam Accumulator \concept{Accumulator}
+  \param beta Inverse temperature at which the simulation is performed
+  \param measurement_accumulator Reference to the accumulator that stores the simulation results
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class Observator, class Accumulator, class TemperatureType>
+void SwendsenWang<ConfigurationType, RandomNumberGenerator>::do_swendsen_wang_simulation(const TemperatureType& beta, Accumulator& measurement_accumulator)
+{
+  // Check the concept of the observator
+  BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
+  // Check the concept of the observable
+  BOOST_CONCEPT_ASSERT((Concepts::ObservableConcept<typename Observator::observable_type>));
+  // Check the concept of the accumulator
+  BOOST_CONCEPT_ASSERT((Concepts::AccumulatorConcept<Accumulator, typename Observator::observable_type>));
+
+  // Log the start of the simulation
+  this->simulation_start_log();
+
+  // Perform the relaxation steps (unless a checkpoint is resumed)
+  if (!this->resuming_checkpoint)
+    do_swendsen_wang_steps(simulation_parameters.relaxation_steps, beta);
+
+  // For each measurement, perform the steps, invoke the signal handler, take the measurement and check for posix signals
+  for (measurement_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
+  {
+    do_swendsen_wang_steps(simulation_parameters.steps_between_measurement, beta);
+
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      signal_handler_measurement(this);
+    }
+
+    {
+      MOCASINNS_PROFILE_SCOPE(accumulate);
+      measurement_accumulator(Profiling::observe_configuration<Observator>(this->configuration_space));
+    }
+    if (this->end_chunk(m)) return;
+  }
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \tparam AccumulatorIterator \conceptiterator{Accumulator}
+  \tparam InverseTemperatureIterator \conceptiterator{InverseTemperatureType}
+  \param beta_begin Iterator pointing to the first inverse temperature that is calculated.
+  \param beta_end Iterator pointing on position after the last inverse temperature that is calculated.
+  \param measurement_accumulator_begin Iterator pointing to the first accumulator that gathers the data for the first inverse temperature.
+  \param measurement_accumulator_end Iterator pointing one position after the last accumulator that gathers the data for the last inverse temperature. The number of accumulators must match the number of inverse temperatures.
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class Observator, class AccumulatorIterator, class InverseTemperatureIterator>
+void SwendsenWang<ConfigurationType, RandomNumberGenerator>::do_swendsen_wang_simulation(InverseTemperatureIterator beta_begin, InverseTemperatureIterator beta_end, AccumulatorIterator measurement_accumulator_begin, AccumulatorIterator measurement_accumulator_end)
+{
+  // Check the concept of the accumulator
+  BOOST_CONCEPT_ASSERT((Concepts::AccumulatorConcept<typename std::iterator_traits<AccumulatorIterator>::value_type, typename Observator::observable_type>));
+
+  // Check that the number of inverse temperatures and the number of accumulators matches
+  if (std::distance(beta_begin, beta_end) != std::distance(measurement_accumulator_begin, measurement_accumulator_end))
+    throw Exceptions::IteratorRangeException("The range of given inverse temperatures and accumulators must have the same size.");
+
+  InverseTemperatureIterator beta_iterator = beta_begin;
+  AccumulatorIterator measurement_accumulator_iterator = measurement_accumulator_begin;
+  for (; beta_iterator != beta_end; ++beta_iterator, ++measurement_accumulator_iterator)
+  {
+    do_swendsen_wang_simulation<Observator>(*beta_iterator, *measurement_accumulator_iterator);
+    if (this->is_terminating) break;
+  }
+}
+
+} // of namespace Mocasinns
+
+#endif
@@ -11,9 +11,9 @@
 /*! \fn AUTO_TEMPLATE_1
  * \details Construct a Wang-Landau simulation with standard parameters and a new ConfigurationType
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::WangLandau()
-  : Simulation<ConfigurationType, RandomNumberGenerator>(static_cast<ConfigurationType*>(0)), sweep_counter(0)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::WangLandau()
+  : Simulation<ConfigurationType, RandomNumberGenerator>(static_cast<ConfigurationType*>(0)), sweep_counter(0), tracked_energy_valid(false)
 {
   simulation_parameters = Parameters();
   initialise_with_parameters();
@@ -23,9 +23,9 @@ Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumb
  * \details Construct a Wang-Landau simulation with given parameters and a new ConfigurationType
  * \param params Wang-Landau parameter object with the parameters of the simulation.
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::WangLandau(const Parameters& params) 
-  : Simulation<ConfigurationType, RandomNumberGenerator>(static_cast<ConfigurationType*>(0)), sweep_counter(0)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::WangLandau(const Parameters& params) 
+  : Simulation<ConfigurationType, RandomNumberGenerator>(static_cast<ConfigurationType*>(0)), sweep_counter(0), tracked_energy_valid(false)
 {
   simulation_parameters = params;
   initialise_with_parameters();
@@ -36,9 +36,9 @@ Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumb
  * \param params Wang-Landau parameter object with the parameters of the simulation.
  * \param initial_configuration Pointer to a ConfigurationType onto which the simulation will be performed.
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::WangLandau(const Parameters& params, ConfigurationType* initial_configuration) 
-  : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), sweep_counter(0)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::WangLandau(const Parameters& params, ConfigurationType* initial_configuration) 
+  : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), sweep_counter(0), tracked_energy_valid(false)
 {
   simulation_parameters = params;
   initialise_with_parameters();
@@ -49,9 +49,9 @@ Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumb
  * \tparam rejection_free_other Automatically determined from parameter
  * \param other WangLandau or WangLandauRejectionFree simulation object that will be copied.
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::WangLandau(const WangLandau<ConfigurationType, StepType, EnergyType, HistoType, RandomNumberGenerator>& other)
-  : Simulation<ConfigurationType, RandomNumberGenerator>(this->configuration_space), sweep_counter(0)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::WangLandau(const WangLandau<ConfigurationType, StepType, EnergyType, HistoType, RandomNumberGenerator>& other)
+  : Simulation<ConfigurationType, RandomNumberGenerator>(this->configuration_space), sweep_counter(0), tracked_energy_valid(false)
 {
   log_density_of_states = other.log_density_of_states;
   incidence_counter = other.incidence_counter;
@@ -69,11 +69,14 @@ Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumb
  * \param step_to_execute Step of which the acceptance probability will be calculated
  * \param step_parameters Structure for storing the actual energy of the system and the energy difference of the simulation. (Used for performance reasons)
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-double Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::acceptance_probability(StepType& step_to_execute, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+double Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::acceptance_probability(StepType& step_to_execute, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
 {
   // Calculate the energy difference of the step
-  step_parameters.delta_E = step_to_execute.delta_E();
+  {
+    MOCASINNS_PROFILE_SCOPE(delta_E);
+    step_parameters.delta_E = step_to_execute.delta_E();
+  }
   
   // If an energy cutoff is used and the step would violate the energy cutoff, return 0.0
   if (!simulation_parameters.energy_in_range(step_parameters.total_energy + step_parameters.delta_E))
@@ -83,7 +86,13 @@ double Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Ran
   // If the new energy is not contained in the density of the states, return an acceptance probability of 1.0
   typename HistoType<EnergyType, double>::iterator new_energy_bin = log_density_of_states.find(step_parameters.total_energy + step_parameters.delta_E);
   if (new_energy_bin != log_density_of_states.end())
-    return exp(log_density_of_states[step_parameters.total_energy] - new_energy_bin->second);
+  {
+    // The coalesced rejected steps are part of the density of states at the current energy
+    double& log_density_of_states_current = log_density_of_states[step_parameters.total_energy];
+    if (&log_density_of_states_current == &new_energy_bin->second)
+      return 1.0;
+    return exp(log_density_of_states_current + modification_factor_current*step_parameters.rejected_time - new_energy_bin->second);
+  }
   else
     return 1.0;
 }
@@ -99,9 +108,12 @@ double Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Ran
  * \param time Specifies the time the algorithm has been in the previous state if doing a rejection free algorithm
  * \param step_parameters Structure for storing the actual energy of the system and the energy difference of the simulation. (Used for performance reasons)
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::handle_executed_step(StepType&, double time, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::handle_executed_step(StepType&, double time, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
 {
+  // Apply the rejected steps at the old energy
+  apply_rejected_steps(step_parameters);
+
   // Increment the total energy
   step_parameters.total_energy += step_parameters.delta_E;
   
@@ -121,39 +133,73 @@ void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Rando
 }
   
 /*! \fn AUTO_TEMPLATE_1
- * \details Increase the incidence histogram at the current energy of the system.
+ * \details Increase the incidence histogram and the density of states at the current energy of the system.
+ *
+ * If <tt>Parameters::coalesce_rejected_steps</tt> is set, the time of the step is only added to the rejected time of the \c step_parameters, and the histograms are updated by apply_rejected_steps before the next executed step or at the end of do_wang_landau_steps. Since the rejected steps are added to the density of states without the clamping of handle_executed_step and acceptance_probability takes the rejected time into account, this is equivalent to the direct update up to the rounding of the summation.
  *
  * \param time Specifies the time the algorithm has been in the previous state if doing a rejection free algorithm
  * \param step_parameters Structure for storing the actual energy of the system and the energy difference of the simulation. (Used for performance reasons)
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::handle_rejected_step(StepType&, double time, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::handle_rejected_step(StepType&, double time, Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
 {
+  // Only sum up the rejected steps if they are coalesced
+  if (simulation_parameters.coalesce_rejected_steps)
+  {
+    step_parameters.rejected_time += time;
+    return;
+  }
+
   // Update the histograms
   log_density_of_states[step_parameters.total_energy] += modification_factor_current*time;
   incidence_counter[step_parameters.total_energy] += time;
 }
 
 /*! \fn AUTO_TEMPLATE_1
- * \details The incidence counter and the density of states are modified using the actual modification factor.
+ * \details Adds the rejected time stored in the \c step_parameters (multiplied by the modification factor) to the density of states and the incidence counter at the current energy and resets the rejected time.
+ *
+ * \param step_parameters Structure for storing the actual energy of the system and the energy difference of the simulation. (Used for performance reasons)
+ */
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::apply_rejected_steps(Details::Multicanonical::StepParameter<EnergyType>& step_parameters)
+{
+  if (step_parameters.rejected_time == 0.0) return;
+
+  log_density_of_states[step_parameters.total_energy] += modification_factor_current*step_parameters.rejected_time;
+  incidence_counter[step_parameters.total_energy] += step_parameters.rejected_time;
+  step_parameters.rejected_time = 0.0;
+}
+
+/*! \fn AUTO_TEMPLATE_1
+ * \details The incidence counter and the density of states are modified using the actual modification factor. The energy of the configuration is calculated at the beginning and tracked during the steps. If Parameters::track_energy is set, the energy tracked by the last call is used instead of calculating it again.
  * \param number Number of steps to perform.
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::do_wang_landau_steps(const step_number_t& number)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::do_wang_landau_steps(const step_number_t& number)
 {
   // Variable to track the energy
   Details::Multicanonical::StepParameter<EnergyType> step_parameters;
-  step_parameters.total_energy = this->configuration_space->energy();
+  if (simulation_parameters.track_energy && tracked_energy_valid)
+    step_parameters.total_energy = tracked_energy;
+  else
+    step_parameters.total_energy = this->configuration_space->energy();
   
   // Call the generic function of Simulation
-  this->template do_steps<WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>, StepType, rejection_free>(number, step_parameters);
+  this->template do_steps<WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>, StepType, rejection_free>(number, step_parameters);
+
+  // Apply the remaining rejected steps before the histograms are used
+  apply_rejected_steps(step_parameters);
+
+  // Store the energy for the next call
+  tracked_energy = step_parameters.total_energy;
+  tracked_energy_valid = true;
 }
   
 /*! \fn AUTO_TEMPLATE_1
  * \details The steps are executed in portions of the sweep steps given by the parameter object. Before each sweep a check for POSIX signals takes place and the signal_handler_sweep is called.
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::do_wang_landau_steps()
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::do_wang_landau_steps()
 {
   // Set a local sweep counter
   unsigned int modfac_sweep_counter = 0;
@@ -164,7 +210,10 @@ void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Rando
     // Check for signals and return if simulation should be terminated
     if (this->check_for_posix_signal()) return;
     // Handle the sweep signal handler
-    signal_handler_sweep(this);
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      hooks.sweep(this);
+    }
     
     do_wang_landau_steps(simulation_parameters.sweep_steps);
     modfac_sweep_counter++;
@@ -184,11 +233,12 @@ void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Rando
  *
  * If the incidence counter is flat, the modification factor will be decreased, the incidence counter will be resetted, the density of states will be normalized and the signal_handler_modfac_change is called.
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::do_wang_landau_simulation()
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::do_wang_landau_simulation()
 {
-  // Log the start of the simulation
+  // Log the start of the simulation, the progress is stored in the histograms and the modification factor, so a loaded checkpoint is continued anyway
   this->simulation_start_log();
+  this->begin_chunks();
 
   while (modification_factor_current > simulation_parameters.modification_factor_final)
   {
@@ -199,7 +249,10 @@ void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Rando
     if (this->is_terminating) break;
     
     // Invoke the information signal handler
-    signal_handler_modfac_change(this);
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      hooks.modfac_change(this);
+    }
     
     // Reset the incidence counter
     incidence_counter.set_all_y_values(0);
@@ -217,13 +270,16 @@ void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Rando
  * - The flatness of the incidence histogram is not checked, it does only matter that every energy has to be visited once
  * - If the new modfication factor is smaller than 1/t (where t is the Monte-Carlo time), it is not multiplied with the modification_factor multiplier, but chosen according to 1/t.
  *
+ * After every sweep of the first part and after every Monte-Carlo time unit of the second part a check for POSIX signals and the time budget takes place, and the simulation stops if it should be terminated.
+ *
  * \param monte_carlo_time_unit Number that specifies how many single steps are one Monte-Carlo time unit
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::do_wang_landau_simulation_1_t(step_number_t monte_carlo_time_unit)
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::do_wang_landau_simulation_1_t(step_number_t monte_carlo_time_unit)
 {
-  // Log the start of the simulation
+  // Log the start of the simulation, the progress is stored in the histograms and the modification factor, so a loaded checkpoint is continued anyway
   this->simulation_start_log();
+  this->begin_chunks();
 
   // Set the sweep counter to 0
   sweep_counter = 0;
@@ -233,17 +289,21 @@ void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Rando
 	 (sweep_counter == 0 || // Needed to avoid dividing by one
 	  modification_factor_current > static_cast<double>(monte_carlo_time_unit)/(sweep_counter * simulation_parameters.sweep_steps)))
   {
-    // Do steps until each energy has been reached at least once
+    // Do steps until each energy has been reached at least once, check for signals and the time budget after each sweep
     while (incidence_counter.min_y_value()->second == 0)
     {
       do_wang_landau_steps(simulation_parameters.sweep_steps);
       sweep_counter++;
+      if (this->check_for_posix_signal()) break;
     }
 
-    // Invoke the information signal handler
-    signal_handler_modfac_change(this);
     // If the simulation was aborted, exit the loop
     if (this->is_terminating) break;
+    // Invoke the information signal handler
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      hooks.modfac_change(this);
+    }
     
     // Reset the incidence counter
     incidence_counter.set_all_y_values(0);
@@ -255,19 +315,22 @@ void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Rando
 
   // Do the second part of the algorithm (modification factor is smaller than the inverse Monte-Carlo time)
   unsigned long monte_carlo_time_counter = 0;
-  while (modification_factor_current > simulation_parameters.modification_factor_final)
+  while (!this->is_terminating && modification_factor_current > simulation_parameters.modification_factor_final)
   {
     do_wang_landau_steps(monte_carlo_time_unit);
     monte_carlo_time_counter++;
+
+    // Check for signals and the time budget after each Monte-Carlo time unit and exit the loop if the simulation should be terminated
+    if (this->check_for_posix_signal()) break;
     
     // Decrease the modification factor
     modification_factor_current = 1.0 / (monte_carlo_time_counter + static_cast<double>(sweep_counter * simulation_parameters.sweep_steps) / monte_carlo_time_unit);
 
     // Invoke the information signal handler
-    signal_handler_modfac_change(this);
-
-    // If the simulation was aborted, exit the loop
-    if (this->is_terminating) break;  
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      hooks.modfac_change(this);
+    }
   }
     
   // Renormalize the density of states
@@ -279,8 +342,8 @@ void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,Rando
  *
  * If the incidence counter is flat, the modification factor will be decreased, the incidence counter will be resetted, the density of states will be normalized and the signal_handler_modfac_change is called.
  */
-template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free>::initialise_with_parameters()
+template <class ConfigurationType, class StepType, class EnergyType, template <class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+void Mocasinns::WangLandau<ConfigurationType,StepType,EnergyType,HistoType,RandomNumberGenerator,rejection_free,HookPolicy>::initialise_with_parameters()
 {
   // Set the current modification factor to the initial modification factor
   modification_factor_current = simulation_parameters.modification_factor_initial;
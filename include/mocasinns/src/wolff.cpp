@@ -0,0 +1,201 @@
+/*!
+ * \file wolff.cpp
+ * \brief Implementation of the libMoCaSinns Wolff template interface
+ *
+ * \author Benedikt Krüger
+ */
+
+#ifdef MOCASINNS_WOLFF_HPP
+
+#include <iterator>
+
+#include "../details/metropolis/vector_accumulator.hpp"
+#include "../exceptions/iterator_range_exception.hpp"
+
+namespace Mocasinns
+{
+
+/*!
+  \details The bond is activated if the random number is not smaller than the Boltzmann factor of the bond energy, bonds with non-positive energy are never activated and need no random number.
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class EnergyType, class TemperatureType>
+bool Wolff<ConfigurationType, RandomNumberGenerator>::activate_bond(const EnergyType& bond_energy, const TemperatureType& beta)
+{
+  if (!(bond_energy > 0)) return false;
+  return this->rng->random_double() >= acceptance_table(bond_energy, beta);
+}
+
+/*!
+  \details The buffers of the cluster are (re-)allocated only if the number of sites of the configuration has changed. After the flip only the bits of the sites of the cluster are cleared in the bitmap, so the costs of a step are proportional to the size of the cluster.
+  \tparam TemperatureType Type of the inverse temperature, there must be an operator* defined this class and the bond energy type of the configuration.
+  \param number Number of clusters that will be grown and flipped
+  \param beta Inverse temperature that will be used for calculation of the bond activation probabilities.
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class TemperatureType>
+void Wolff<ConfigurationType, RandomNumberGenerator>::do_wolff_steps(const step_number_t& number, const TemperatureType& beta)
+{
+  const std::size_t site_number = this->configuration_space->site_number();
+  if (cluster_visited.size() != site_number)
+  {
+    cluster_visited.assign(site_number, false);
+    cluster_sites.clear();
+    cluster_sites.reserve(site_number);
+  }
+
+  for (step_number_t i = 0; i < number; ++i)
+  {
+    Details::OptionalMemberFunctions::optional_prepare_cluster_update(*this->configuration_space, this->rng);
+
+    // Choose the seed of the cluster
+    const std::size_t seed_site = static_cast<std::size_t>(this->rng->random_int32(0, static_cast<int>(site_number) - 1));
+    cluster_sites.clear();
+    cluster_sites.push_back(seed_site);
+    cluster_visited[seed_site] = true;
+
+    // Grow the cluster, the sites in the buffer behind the actual position are the ones whose bonds are not yet tested
+    for (std::size_t c = 0; c < cluster_sites.size(); ++c)
+    {
+      const std::size_t site = cluster_sites[c];
+      const std::size_t neighbour_number = this->configuration_space->neighbour_number(site);
+      for (std::size_t n = 0; n < neighbour_number; ++n)
+      {
+	const std::size_t neighbour = this->configuration_space->neighbour(site, n);
+	if (cluster_visited[neighbour]) continue;
+	if (activate_bond(this->configuration_space->bond_energy(site, neighbour), beta))
+	{
+	  cluster_visited[neighbour] = true;
+	  cluster_sites.push_back(neighbour);
+	}
+      }
+    }
+
+    // Flip the cluster and clear its sites in the bitmap
+    for (std::size_t c = 0; c < cluster_sites.size(); ++c)
+    {
+      this->configuration_space->flip_site(cluster_sites[c]);
+      cluster_visited[cluster_sites[c]] = false;
+    }
+    last_cluster_size = cluster_sites.size();
+  }
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \param beta Inverse temperature at which the simulation is performed.
+  \returns Vector containing the single measurements performed
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class Observator, class TemperatureType>
+std::vector<typename Observator::observable_type> Wolff<ConfigurationType, RandomNumberGenerator>::do_wolff_simulation(const TemperatureType& beta)
+{
+  // Check the concept of the observator
+  BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
+  // Check the concept of the observable
+  BOOST_CONCEPT_ASSERT((Concepts::ObservableConcept<typename Observator::observable_type>));
+
+  // Call the accumulator function using the VectorAccumulator
+  Details::Metropolis::VectorAccumulator<typename Observator::observable_type> measurements_accumulator;
+  do_wolff_simulation<Observator>(beta, measurements_accumulator);
+
+  // Return the plain data
+  return measurements_accumulator.internal_vector;
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \tparam InputIterator \conceptiterator{InverseTemperatureType}
+  \param beta_begin Iterator pointing to the first inverse temperature that is calculated
+  \param beta_end Iterator pointing on position after the last inverse temperature that is calculated
+  \returns Vector containing the vectors of measurments performed for each temperature. (First index: inverse temperature, second index: measurment number)
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class Observator, class InputIterator>
+std::vector<std::vector<typename Observator::observable_type> > Wolff<ConfigurationType, RandomNumberGenerator>::do_wolff_simulation(InputIterator beta_begin, InputIterator beta_end)
+{
+  std::vector<std::vector<typename Observator::observable_type> > results;
+  for (InputIterator beta = beta_begin; beta != beta_end; ++beta)
+  {
+    results.push_back(do_wolff_simulation<Observator>(*beta));
+    if (this->is_terminating) break;
+  }
+  return results;
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \tparam TemperatureType \concept{InverseTemperatureType}
+  \tparam Accumulator \concept{Accumulator}
+  \param beta Inverse temperature at which the simulation is performed
+  \param measurement_accumulator Reference to the accumulator that stores the simulation results
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class Observator, class Accumulator, class TemperatureType>
+void Wolff<ConfigurationType, RandomNumberGenerator>::do_wolff_simulation(const TemperatureType& beta, Accumulator& measurement_accumulator)
+{
+  // Check the concept of the observator
+  BOOST_CONCEPT_ASSERT((Concepts::ObservatorConcept<Observator,ConfigurationType>));
+  // Check the concept of the observable
+  BOOST_CONCEPT_ASSERT((Concepts::ObservableConcept<typename Observator::observable_type>));
+  // Check the concept of the accumulator
+  BOOST_CONCEPT_ASSERT((Concepts::AccumulatorConcept<Accumulator, typename Observator::observable_type>));
+
+  // Log the start of the simulation
+  this->simulation_start_log();
+
+  // Perform the relaxation steps (unless a checkpoint is resumed)
+  if (!this->resuming_checkpoint)
+    do_wolff_steps(simulation_parameters.relaxation_steps, beta);
+
+  // For each measurement, perform the steps, invoke the signal handler, take the measurement and check for posix signals
+  for (measurement_number_t m = this->begin_chunks(); m < simulation_parameters.measurement_number; ++m)
+  {
+    do_wolff_steps(simulation_parameters.steps_between_measurement, beta);
+
+    {
+      MOCASINNS_PROFILE_SCOPE(signal);
+      signal_handler_measurement(this);
+    }
+
+    {
+      MOCASINNS_PROFILE_SCOPE(accumulate);
+      measurement_accumulator(Profiling::observe_configuration<Observator>(this->configuration_space));
+    }
+    if (this->end_chunk(m)) return;
+  }
+}
+
+/*!
+  \tparam Observator \concept{Observator} If no observator is given, a default observator which measures the energy is used.
+  \tparam AccumulatorIterator \conceptiterator{Accumulator}
+  \tparam InverseTemperatureIterator \conceptiterator{InverseTemperatureType}
+  \param beta_begin Iterator pointing to the first inverse temperature that is calculated.
+  \param beta_end Iterator pointing on position after the last inverse temperature that is calculated.
+  \param measurement_accumulator_begin Iterator pointing to the first accumulator that gathers the data for the first inverse temperature.
+  \param measurement_accumulator_end Iterator pointing one position after the last accumulator that gathers the data for the last inverse temperature. The number of accumulators must match the number of inverse temperatures.
+*/
+template<class ConfigurationType, class RandomNumberGenerator>
+template<class Observator, class AccumulatorIterator, class InverseTemperatureIterator>
+void Wolff<ConfigurationType, RandomNumberGenerator>::do_wolff_simulation(InverseTemperatureIterator beta_begin, InverseTemperatureIterator beta_end, AccumulatorIterator measurement_accumulator_begin, AccumulatorIterator measurement_accumulator_end)
+{
+  // Check the concept of the accumulator
+  BOOST_CONCEPT_ASSERT((Concepts::AccumulatorConcept<typename std::iterator_traits<AccumulatorIterator>::value_type, typename Observator::observable_type>));
+
+  // Check that the number of inverse temperatures and the number of accumulators matches
+  if (std::distance(beta_begin, beta_end) != std::distance(measurement_accumulator_begin, measurement_accumulator_end))
+    throw Exceptions::IteratorRangeException("The range of given inverse temperatures and accumulators must have the same size.");
+
+  InverseTemperatureIterator beta_iterator = beta_begin;
+  AccumulatorIterator measurement_accumulator_iterator = measurement_accumulator_begin;
+  for (; beta_iterator != beta_end; ++beta_iterator, ++measurement_accumulator_iterator)
+  {
+    do_wolff_simulation<Observator>(*beta_iterator, *measurement_accumulator_iterator);
+    if (this->is_terminating) break;
+  }
+}
+
+} // of namespace Mocasinns
+
+#endif
@@ -0,0 +1,231 @@
+/*!
+  \file acceptance_statistics.hpp
+
+  \brief Counters of proposed and accepted steps resolved by the energy difference and by the type of the steps
+
+  \author Benedikt Krüger
+*/
+
+#ifndef MOCASINNS_STATISTICS_ACCEPTANCE_STATISTICS_HPP
+#define MOCASINNS_STATISTICS_ACCEPTANCE_STATISTICS_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/serialization/vector.hpp>
+
+namespace Mocasinns
+{
+  //! Namespace for the statistics that the simulations collect about themselves
+  namespace Statistics
+  {
+    //! Class counting the proposed and the accepted steps of a simulation, resolved by the energy difference and by the type of the steps
+    /*!
+      \details The energy differences are grouped in bins of equal width, the bin with index k contains the energy differences in \f$ [k w, (k+1) w) \f$ for the bin width w. For integral energy differences and the default width 1 every energy difference has a bin of its own. The counters of the bins are stored densely in a vector covering the range between the smallest and the largest bin that occured. Energy differences that are not arithmetic (e.g. VectorEnergy) are all counted in the bin 0.
+
+      The type of a step is the value of its optional member function <tt>std::size_t step_type()</tt>, steps without this function have the type 0. The counters of the types are stored densely as well. Steps that are not executable have no energy difference, they are counted for their type and in not_executable_steps() but in no energy bin.
+
+      In addition the time spent in the simulation steps is stored, so the throughput of the simulation can be estimated by steps_per_second(). The statistics of several threads can be merged with operator+=, and the statistics can be stored with boost serialization.
+    */
+    class AcceptanceStatistics
+    {
+    public:
+      //! Create empty statistics with the given width of the energy bins
+      explicit AcceptanceStatistics(double energy_bin_width = 1.0) : bin_width(energy_bin_width), first_bin(0), not_executable(0), seconds(0.0) {}
+
+      //! Get-accessor for the width of the energy bins
+      double get_bin_width() const { return bin_width; }
+      //! Set-accessor for the width of the energy bins, clears the statistics
+      void set_bin_width(double value) { bin_width = value; clear(); }
+
+      //! Count a proposed step with given energy difference and type that was accepted or rejected
+      template <class EnergyDifferenceType>
+      void record(const EnergyDifferenceType& delta_E, std::size_t step_type, bool accepted)
+      {
+	record_bin(bin_index(delta_E), step_type, accepted);
+      }
+      //! Count a proposed step with given index of the energy bin and type that was accepted or rejected
+      void record_bin(long bin, std::size_t step_type, bool accepted)
+      {
+	const std::size_t index = bin_position(bin);
+	type_reserve(step_type + 1);
+	++proposed_bins[index];
+	++proposed_types[step_type];
+	if (accepted)
+	{
+	  ++accepted_bins[index];
+	  ++accepted_types[step_type];
+	}
+      }
+      //! Count a proposed step of the given type that was not executable
+      void record_not_executable(std::size_t step_type)
+      {
+	type_reserve(step_type + 1);
+	++proposed_types[step_type];
+	++not_executable;
+      }
+      //! Add the time spent in the simulation steps
+      void add_seconds(double value) { seconds += value; }
+
+      //! Index of the energy bin of the given energy difference
+      template <class EnergyDifferenceType>
+      typename boost::enable_if<boost::is_arithmetic<EnergyDifferenceType>, long>::type
+      bin_index(const EnergyDifferenceType& delta_E) const { return static_cast<long>(std::floor(static_cast<double>(delta_E) / bin_width)); }
+      //! \cond
+      template <class EnergyDifferenceType>
+      typename boost::disable_if<boost::is_arithmetic<EnergyDifferenceType>, long>::type
+      bin_index(const EnergyDifferenceType&) const { return 0; }
+      //! \endcond
+
+      //! Total number of proposed steps
+      uint64_t proposed_steps() const { return sum(proposed_types); }
+      //! Total number of accepted steps
+      uint64_t accepted_steps() const { return sum(accepted_types); }
+      //! Number of proposed steps that were not executable
+      uint64_t not_executable_steps() const { return not_executable; }
+      //! Ratio of the accepted and the proposed steps, 0.0 if no step was proposed
+      double acceptance_ratio() const { return ratio(accepted_steps(), proposed_steps()); }
+      //! Time spent in the simulation steps in seconds
+      double get_seconds() const { return seconds; }
+      //! Number of proposed steps per second of the time spent in the simulation steps, 0.0 if no time was measured
+      double steps_per_second() const { return (seconds > 0.0 ? proposed_steps() / seconds : 0.0); }
+
+      //! Number of energy bins between the lowest and the highest bin in which a step was proposed
+      std::size_t bin_number() const { return proposed_bins.size(); }
+      //! Index of the energy bin at the given position (the lower boundary of the bin is the index times the bin width)
+      long bin_at(std::size_t position) const { return first_bin + static_cast<long>(position); }
+      //! Lower boundary of the energy bin at the given position
+      double bin_energy(std::size_t position) const { return bin_at(position) * bin_width; }
+      //! Number of proposed steps in the energy bin at the given position
+      uint64_t proposed_in_bin(std::size_t position) const { return proposed_bins[position]; }
+      //! Number of accepted steps in the energy bin at the given position
+      uint64_t accepted_in_bin(std::size_t position) const { return accepted_bins[position]; }
+      //! Acceptance ratio in the energy bin at the given position, 0.0 if no step was proposed
+      double acceptance_ratio_in_bin(std::size_t position) const { return ratio(accepted_bins[position], proposed_bins[position]); }
+      //! Acceptance ratio of the steps with the given energy difference, 0.0 if no step of this energy difference was proposed
+      template <class EnergyDifferenceType>
+      double acceptance_ratio_of_energy(const EnergyDifferenceType& delta_E) const
+      {
+	const long bin = bin_index(delta_E);
+	if (proposed_bins.empty() || bin < first_bin || bin - first_bin >= static_cast<long>(proposed_bins.size())) return 0.0;
+	return acceptance_ratio_in_bin(static_cast<std::size_t>(bin - first_bin));
+      }
+
+      //! Number of step types up to the highest type that was proposed
+      std::size_t step_type_number() const { return proposed_types.size(); }
+      //! Number of proposed steps of the given type
+      uint64_t proposed_of_type(std::size_t step_type) const { return (step_type < proposed_types.size() ? proposed_types[step_type] : 0); }
+      //! Number of accepted steps of the given type
+      uint64_t accepted_of_type(std::size_t step_type) const { return (step_type < accepted_types.size() ? accepted_types[step_type] : 0); }
+      //! Acceptance ratio of the steps of the given type, 0.0 if no step of this type was proposed
+      double acceptance_ratio_of_type(std::size_t step_type) const { return ratio(accepted_of_type(step_type), proposed_of_type(step_type)); }
+
+      //! Set all counters and the time to zero
+      void clear()
+      {
+	first_bin = 0;
+	proposed_bins.clear();
+	accepted_bins.clear();
+	proposed_types.clear();
+	accepted_types.clear();
+	not_executable = 0;
+	seconds = 0.0;
+      }
+
+      //! Add the counters and the time of other statistics with the same bin width
+      AcceptanceStatistics& operator+=(const AcceptanceStatistics& rhs)
+      {
+	for (std::size_t position = 0; position < rhs.proposed_bins.size(); ++position)
+	{
+	  if (rhs.proposed_bins[position] == 0) continue;
+	  const std::size_t index = bin_position(rhs.bin_at(position));
+	  proposed_bins[index] += rhs.proposed_bins[position];
+	  accepted_bins[index] += rhs.accepted_bins[position];
+	}
+	type_reserve(rhs.proposed_types.size());
+	for (std::size_t step_type = 0; step_type < rhs.proposed_types.size(); ++step_type)
+	{
+	  proposed_types[step_type] += rhs.proposed_types[step_type];
+	  accepted_types[step_type] += rhs.accepted_types[step_type];
+	}
+	not_executable += rhs.not_executable;
+	seconds += rhs.seconds;
+	return *this;
+      }
+
+    private:
+      //! Width of the energy bins
+      double bin_width;
+      //! Index of the energy bin stored at position 0
+      long first_bin;
+      //! Number of proposed steps in every energy bin
+      std::vector<uint64_t> proposed_bins;
+      //! Number of accepted steps in every energy bin
+      std::vector<uint64_t> accepted_bins;
+      //! Number of proposed steps of every type
+      std::vector<uint64_t> proposed_types;
+      //! Number of accepted steps of every type
+      std::vector<uint64_t> accepted_types;
+      //! Number of proposed steps that were not executable
+      uint64_t not_executable;
+      //! Time spent in the simulation steps in seconds
+      double seconds;
+
+      //! Position of the counters of the given energy bin, the range of the stored bins is extended if necessary
+      std::size_t bin_position(long bin)
+      {
+	if (proposed_bins.empty()) first_bin = bin;
+	if (bin < first_bin)
+	{
+	  proposed_bins.insert(proposed_bins.begin(), first_bin - bin, 0);
+	  accepted_bins.insert(accepted_bins.begin(), first_bin - bin, 0);
+	  first_bin = bin;
+	}
+	const std::size_t position = static_cast<std::size_t>(bin - first_bin);
+	if (position >= proposed_bins.size())
+	{
+	  proposed_bins.resize(position + 1, 0);
+	  accepted_bins.resize(position + 1, 0);
+	}
+	return position;
+      }
+      //! Extend the counters of the step types to the given number of types
+      void type_reserve(std::size_t step_type_number)
+      {
+	if (step_type_number <= proposed_types.size()) return;
+	proposed_types.resize(step_type_number, 0);
+	accepted_types.resize(step_type_number, 0);
+      }
+      //! Sum of the counters of a vector
+      static uint64_t sum(const std::vector<uint64_t>& counters)
+      {
+	uint64_t result = 0;
+	for (std::size_t i = 0; i < counters.size(); ++i) result += counters[i];
+	return result;
+      }
+      //! Ratio of two counters, 0.0 if the denominator vanishes
+      static double ratio(uint64_t numerator, uint64_t denominator) { return (denominator > 0 ? static_cast<double>(numerator) / static_cast<double>(denominator) : 0.0); }
+
+      //! Member variable for boost serialization
+      friend class boost::serialization::access;
+      //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
+      template<class Archive> void serialize(Archive & ar, const unsigned int)
+      {
+	ar & bin_width;
+	ar & first_bin;
+	ar & proposed_bins;
+	ar & accepted_bins;
+	ar & proposed_types;
+	ar & accepted_types;
+	ar & not_executable;
+	ar & seconds;
+      }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * \file swendsen_wang.hpp
+ * \brief Class for Monte-Carlo simulations using the multi-cluster algorithm of Swendsen and Wang
+ *
+ * Decomposes the whole configuration into clusters of sites connected by activated bonds, flips every cluster with probability one half and determines canonical averages of observables. The bond activation, the labelling of the clusters and the flips are performed by several threads.
+ *
+ * \author Benedikt Krüger
+ */
+
+#ifndef MOCASINNS_SWENDSEN_WANG_HPP
+#define MOCASINNS_SWENDSEN_WANG_HPP
+
+#include "simulation.hpp"
+#include "concepts/concepts.hpp"
+#include "details/metropolis/acceptance_table.hpp"
+#include "details/cluster/concurrent_union_find.hpp"
+
+// Boost serialization for derived classes
+#include <boost/serialization/base_object.hpp>
+
+// Boost function types for the standard observable
+#include <boost/function_types/result_type.hpp>
+#include <boost/typeof/std/utility.hpp>
+#include <boost/type_traits.hpp>
+
+namespace Mocasinns
+{
+
+//! Class for Monte-Carlo simulations using the multi-cluster algorithm of Swendsen and Wang
+/*!
+ * \details In every step of the Swendsen-Wang algorithm every bond of the configuration is activated with the probability
+ * \f[
+ *    p = 1 - \exp\left(-\beta E_{\mathrm{bond}}\right) \quad (p = 0 \text{ if } E_{\mathrm{bond}} \leq 0),
+ * \f]
+ * the sites connected by activated bonds form the clusters, and every cluster is flipped with probability one half. The algorithm uses the same Concepts::ClusterConfigurationConcept as the single-cluster algorithm of Wolff, see there for the description of the member functions the ConfigurationType must provide.
+ *
+ * The step is performed in two phases by Parameters::thread_number OpenMP threads:
+ * - The bonds from every site to its neighbours with larger index are activated in parallel, each thread has its own random number generator (seeded from the random number generator of the simulation) and its own table of Boltzmann factors. The clusters are labelled at the same time by uniting the sites of every activated bond in a lock-free Details::Cluster::ConcurrentUnionFind, and every site draws the flip decision that is used if it turns out to be the root of its cluster.
+ * - Every site is flipped in parallel if the root of its cluster has decided to flip. Since the root of a cluster is its site with the smallest index, the labels do not depend on the order in which the threads have united the sites.
+ *
+ * The neighbour relation must be symmetric and the bond energy must not depend on the order of the two sites. Flipping different sites on different threads must be safe.
+ *
+ * To perform a Swendsen-Wang simulation, use one of the \c SwendsenWang::do_swendsen_wang_simulation() functions, which have the same interface as Metropolis::do_metropolis_simulation(). A step of the Swendsen-Wang simulation is one decomposition of the whole configuration into clusters.
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+class SwendsenWang : public Simulation<ConfigurationType, RandomNumberGenerator>
+{
+  // Check the cluster configuration concept
+  BOOST_CONCEPT_ASSERT((Concepts::ClusterConfigurationConcept<ConfigurationType>));
+  // Check the random number generator concept
+  BOOST_CONCEPT_ASSERT((Concepts::RandomNumberGeneratorConcept<RandomNumberGenerator>));
+
+public:
+  // Typedef for the base class
+  typedef Simulation<ConfigurationType, RandomNumberGenerator> Base;
+  // Typedefs for integers
+  typedef typename Base::step_number_t step_number_t;
+  typedef uint32_t measurement_number_t;
+
+  // Forward declaration of the parameters used for a Swendsen-Wang simulation
+  struct Parameters;
+
+  //! Standard class for observing the energy of the system
+  struct ObserveEnergy
+  {
+    typedef BOOST_TYPEOF(&ConfigurationType::energy) energy_function_type;
+    typedef typename boost::function_types::result_type<energy_function_type>::type observable_type;
+    static observable_type observe(ConfigurationType* config) { return config->energy(); }
+  };
+  //! Typedef for the default observable
+  typedef typename SwendsenWang<ConfigurationType, RandomNumberGenerator>::ObserveEnergy DefaultObservator;
+
+  //! Boost signal handler invoked after every measurement
+  boost::signals2::signal<void (Simulation<ConfigurationType,RandomNumberGenerator>*)> signal_handler_measurement;
+
+  //! Initialise a Swendsen-Wang-MC simulation with default configuration space and default Parameters
+  SwendsenWang() : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters() {}
+  //! Initialise a Swendsen-Wang-MC simulation with default configuration space and given Parameters
+  SwendsenWang(const Parameters& params) : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(params) {}
+  //! Initialise a Swendsen-Wang-MC simulation with given parameters and given configuration space
+  SwendsenWang(const Parameters& params, ConfigurationType* initial_configuration) : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), simulation_parameters(params) {}
+  //! Initialise a Swendsen-Wang-MC simulation by copying from another one, the random number generators of the threads are created again by the first step
+  SwendsenWang(const SwendsenWang& other) : Simulation<ConfigurationType, RandomNumberGenerator>(other.configuration_space), simulation_parameters(other.simulation_parameters) {}
+  //! Destructor, deletes the random number generators of the threads
+  ~SwendsenWang() { threads_clear(); }
+
+  //! Assignment operator, the random number generators of the threads are created again by the first step
+  SwendsenWang& operator=(const SwendsenWang& other)
+  {
+    if (this != &other)
+    {
+      this->configuration_space = other.get_config_space();
+      this->simulation_parameters = other.simulation_parameters;
+      threads_clear();
+    }
+    return *this;
+  }
+
+  //! Get-accessor for the parameters of the Swendsen-Wang simulation
+  const Parameters& get_simulation_parameters() { return simulation_parameters; }
+  //! Set-accessor for the parameters of the Swendsen-Wang simulation
+  void set_parameters(const Parameters& value) { simulation_parameters = value; }
+
+  //! Decompose the configuration into clusters and flip them the given number of times at inverse temperature beta
+  template<class TemperatureType = double>
+  void do_swendsen_wang_steps(const step_number_t& number, const TemperatureType& beta = 0.0);
+
+  //! Execute a Swendsen-Wang simulation at given inverse temperature, returns the measured observables
+  template<class Observator = DefaultObservator, class TemperatureType = double>
+  std::vector<typename Observator::observable_type> do_swendsen_wang_simulation(const TemperatureType& beta);
+  //! Execute a Swendsen-Wang simulation on a range of given inverse temperatures, returns the measured observables for every inverse temperature
+  template<class Observator = DefaultObservator, class InputIterator>
+  std::vector<std::vector<typename Observator::observable_type> > do_swendsen_wang_simulation(InputIterator beta_begin, InputIterator beta_end);
+  //! Execute a Swendsen-Wang simulation at given inverse temperature using the given accumulator for the measurement results
+  template<class Observator = DefaultObservator, class Accumulator, class TemperatureType = double>
+  void do_swendsen_wang_simulation(const TemperatureType& beta, Accumulator& measurement_accumulator);
+  //! Execute a Swendsen-Wang simulation on a range of given inverse temperatures using the given accumulators for the measurement results
+  template<class Observator = DefaultObservator, class AccumulatorIterator, class InverseTemperatureIterator>
+  void do_swendsen_wang_simulation(InverseTemperatureIterator beta_begin, InverseTemperatureIterator beta_end, AccumulatorIterator measurement_accumulator_begin, AccumulatorIterator measurement_accumulator_end);
+
+  //! Load the data of the Swendsen-Wang simulation from a serialization stream
+  virtual void load_serialize(std::istream& input_stream) { Base::load_serialize(*this, input_stream); }
+  //! Load the data of the Swendsen-Wang simulation from a serialization file
+  virtual void load_serialize(const char* filename) { Base::load_serialize(*this, filename); }
+  //! Save the data of the Swendsen-Wang simulation to a serialization stream
+  virtual void save_serialize(std::ostream& output_stream) const { Base::save_serialize(*this, output_stream); }
+  //! Save the data of the Swendsen-Wang simulation to a serialization file
+  virtual void save_serialize(const char* filename) const { Base::save_serialize(*this, filename); }
+
+private:
+  //! Member variable storing the parameters of the simulation
+  Parameters simulation_parameters;
+
+  //! Random number generators of the threads
+  std::vector<RandomNumberGenerator*> thread_rngs;
+  //! Boltzmann factor tables of the threads
+  std::vector<Details::Metropolis::AcceptanceTable> thread_acceptance_tables;
+  //! Delete the random number generators and Boltzmann factor tables of the threads
+  void threads_clear()
+  {
+    for (typename std::vector<RandomNumberGenerator*>::iterator it = thread_rngs.begin(); it != thread_rngs.end(); ++it)
+      delete *it;
+    thread_rngs.clear();
+    thread_acceptance_tables.clear();
+  }
+
+  //! Cluster labels of the sites
+  Details::Cluster::ConcurrentUnionFind cluster_labels;
+  //! Flip decisions of the sites, the decision of the root of a cluster applies to the whole cluster (char instead of bool for concurrent writes)
+  std::vector<char> flip_decisions;
+
+  //! Decide whether a bond with the given bond energy is activated at inverse temperature beta using the given random number generator and Boltzmann factor table
+  template<class EnergyType, class TemperatureType>
+  static bool activate_bond(const EnergyType& bond_energy, const TemperatureType& beta, RandomNumberGenerator* rng, Details::Metropolis::AcceptanceTable& acceptance_table);
+
+  //! Member variable for boost serialization
+  friend class boost::serialization::access;
+  //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
+  template<class Archive> void serialize(Archive & ar, const unsigned int)
+  {
+    // serialize base class information
+    ar & boost::serialization::base_object<Simulation<ConfigurationType, RandomNumberGenerator> >(*this);
+  }
+};
+
+//! Struct storing the parameters of a Swendsen-Wang Monte-Carlo Simulation
+template <class ConfigurationType, class RandomNumberGenerator>
+struct SwendsenWang<ConfigurationType, RandomNumberGenerator>::Parameters
+{
+  //! Number of cluster decompositions to perform before the first measurement
+  step_number_t relaxation_steps;
+  //! Number of measurements
+  measurement_number_t measurement_number;
+  //! Number of cluster decompositions to perform between two measurements
+  step_number_t steps_between_measurement;
+  //! Number of threads activating the bonds and flipping the clusters
+  unsigned int thread_number;
+
+  //! Standard constructor for setting default values
+  Parameters() : relaxation_steps(100),
+		 measurement_number(100),
+		 steps_between_measurement(1),
+		 thread_number(1) {}
+};
+
+} // of namespace Mocasinns
+
+#include "src/swendsen_wang.cpp"
+
+#endif
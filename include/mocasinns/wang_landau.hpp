@@ -14,6 +14,7 @@
 #include "concepts/concepts.hpp"
 #include "details/multicanonical/step_parameter.hpp"
 #include "details/multicanonical/parameters_multicanonical.hpp"
+#include "hooks/hooks.hpp"
 
 // Boost serialization for derived classes
 #include <boost/serialization/base_object.hpp>
@@ -47,6 +48,9 @@ namespace Mocasinns
    * As in the entropic sampling algorithm the logarithm of the density of states is stored, and one adds the logarithm of the modification factor to this entropy in each step. 
    * So also the parameters for the modification factors must be provided in logarithmic form by the user.
    *
+   * The signal handlers are invoked by the hook policy HookPolicy. The default policy Hooks::SignalHooks forwards the hooks to the signal handlers,
+   * with Hooks::NoHooks (or an own policy derived from it) the signal handlers are not invoked and the unused hooks are removed by the compiler.
+   *
    * \signalhandlers
    * \signalhandler{signal_handler_modfac_change,This handler is called if the flatness criterion was reached and the current modification factor will be decreased.}
    * \signalhandler{signal_handler_sweep, This handler is called after every sweep of <tt>Parameters::sweep_steps</tt> steps.}
@@ -58,13 +62,14 @@ namespace Mocasinns
    * \tparam EnergyType \concept{EnergyType}
    * \tparam HistoType \concept{HistoType}
    * \tparam RandomNumberGenerator \concept{RandomNumberGenerator}
+   * \tparam HookPolicy Class providing the hooks <tt>sweep(SimulationType*)</tt> and <tt>modfac_change(SimulationType*)</tt>, see Hooks::NoHooks
    *
    * \references
    * \reference{1, Wang F. and Landau D.P.\, PRL 86 (2001) 2050-2053}
    * \reference{2, Wang F. and Landau D.P.\, PRE 64 (2001) 056101}
    * \endreferences
    */
-  template <class ConfigurationType, class StepType, class EnergyType, template<class,class> class HistoType, class RandomNumberGenerator, bool rejection_free = false>
+  template <class ConfigurationType, class StepType, class EnergyType, template<class,class> class HistoType, class RandomNumberGenerator, bool rejection_free = false, class HookPolicy = Hooks::SignalHooks>
   class WangLandau : public Simulation<ConfigurationType, RandomNumberGenerator>
   {
     // Check the configuration concept
@@ -126,6 +131,12 @@ namespace Mocasinns
     void set_incidence_counter(const HistoType<EnergyType, incidence_counter_y_value_t>& value) { incidence_counter = value; }
     //! Get-Accessor for the sweep counter
     step_number_t get_sweep_counter() const { return sweep_counter; }
+    //! Get-Accessor for the hook policy object
+    HookPolicy& get_hooks() { return hooks; }
+    //! Set-Accessor for the pointer to the configuration space, the energy of the new configuration is calculated at the next call of the step functions
+    void set_config_space(ConfigurationType* value) { this->configuration_space = value; tracked_energy_valid = false; }
+    //! Notify the simulation that the configuration was changed outside of the step functions (e.g. through get_config_space()), the energy is calculated again at the next call of the step functions
+    void invalidate_tracked_energy() { tracked_energy_valid = false; }
     
     //! Calculate the acceptance probability of a step
     double acceptance_probability(StepType& step_to_execute, Details::Multicanonical::StepParameter<EnergyType>& step_parameters);
@@ -167,9 +178,19 @@ namespace Mocasinns
     
     //! Counter for the number of sweeps
     step_number_t sweep_counter;
+
+    //! Hook policy object invoked after every sweep and at every change of the modification factor
+    HookPolicy hooks;
+
+    //! Energy of the configuration after the last call of do_wang_landau_steps, used for the next call if Parameters::track_energy is set
+    EnergyType tracked_energy;
+    //! Flag indicating whether the tracked energy is the energy of the actual configuration
+    bool tracked_energy_valid;
     
     //! Set the class properties that depend on the parameters, this function can be called each time the parameters will be updated
     void initialise_with_parameters();
+    //! Apply the coalesced rejected steps at the current energy to the histograms
+    void apply_rejected_steps(Details::Multicanonical::StepParameter<EnergyType>& step_parameters);
     
     friend class boost::serialization::access;
     //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
@@ -177,6 +198,8 @@ namespace Mocasinns
     {
       // serialize base class information
       ar & boost::serialization::base_object<Simulation<ConfigurationType, RandomNumberGenerator> >(*this);
+      // The loaded configuration replaces the actual one, its energy is calculated again at the next call of the step functions
+      if (Archive::is_loading::value) tracked_energy_valid = false;
       ar & simulation_parameters;
       ar & modification_factor_current;
       ar & log_density_of_states;
@@ -192,8 +215,8 @@ namespace Mocasinns
   #endif
 
   //! Struct for dealing with the parameters of a Wang-Landau-simulation
-  template<class ConfigurationType, class StepType, class EnergyType, template<class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-  struct WangLandau<ConfigurationType, StepType, EnergyType, HistoType, RandomNumberGenerator, rejection_free>::Parameters : public Details::Multicanonical::ParametersMulticanonical<EnergyType>
+  template<class ConfigurationType, class StepType, class EnergyType, template<class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+  struct WangLandau<ConfigurationType, StepType, EnergyType, HistoType, RandomNumberGenerator, rejection_free, HookPolicy>::Parameters : public Details::Multicanonical::ParametersMulticanonical<EnergyType>
   {
   public:
     //! Typedef for the base class
@@ -276,8 +299,8 @@ namespace Mocasinns
   };  
 
   //! Struct used for signals to write the simulation status into std::cout
-  template<class ConfigurationType, class StepType, class EnergyType, template<class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-  struct WangLandau<ConfigurationType, StepType, EnergyType, HistoType, RandomNumberGenerator, rejection_free>::SimulationStatus
+  template<class ConfigurationType, class StepType, class EnergyType, template<class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+  struct WangLandau<ConfigurationType, StepType, EnergyType, HistoType, RandomNumberGenerator, rejection_free, HookPolicy>::SimulationStatus
   {
     //! Operator for for calling the SimulationStatus function
     /*!
@@ -294,8 +317,8 @@ namespace Mocasinns
   };
 
   //! Struct used for signals to dump the whole simulation into the specified file
-  template<class ConfigurationType, class StepType, class EnergyType, template<class,class> class HistoType, class RandomNumberGenerator, bool rejection_free>
-  struct WangLandau<ConfigurationType, StepType, EnergyType, HistoType, RandomNumberGenerator, rejection_free>::SimulationDump
+  template<class ConfigurationType, class StepType, class EnergyType, template<class,class> class HistoType, class RandomNumberGenerator, bool rejection_free, class HookPolicy>
+  struct WangLandau<ConfigurationType, StepType, EnergyType, HistoType, RandomNumberGenerator, rejection_free, HookPolicy>::SimulationDump
   {
     //! Operator for calling the SimulationDump function
     /*!
@@ -0,0 +1,169 @@
+/**
+ * \file wolff.hpp
+ * \brief Class for Monte-Carlo simulations using the single-cluster algorithm of Wolff
+ *
+ * Grows and flips clusters of sites connected by activated bonds and determines canonical averages of observables.
+ *
+ * \author Benedikt Krüger
+ */
+
+#ifndef MOCASINNS_WOLFF_HPP
+#define MOCASINNS_WOLFF_HPP
+
+#include "simulation.hpp"
+#include "concepts/concepts.hpp"
+#include "details/metropolis/acceptance_table.hpp"
+
+// Boost serialization for derived classes
+#include <boost/serialization/base_object.hpp>
+
+// Boost function types for the standard observable
+#include <boost/function_types/result_type.hpp>
+#include <boost/typeof/std/utility.hpp>
+#include <boost/type_traits.hpp>
+
+namespace Mocasinns
+{
+
+//! Class for Monte-Carlo simulations using the single-cluster algorithm of Wolff
+/*!
+ * \details In every step of the Wolff algorithm a random seed site is chosen and a cluster is grown from it: every bond between a site of the cluster and a neighbour that is not yet part of the cluster is activated with the probability
+ * \f[
+ *    p = 1 - \exp\left(-\beta E_{\mathrm{bond}}\right) \quad (p = 0 \text{ if } E_{\mathrm{bond}} \leq 0),
+ * \f]
+ * where \f$ E_{\mathrm{bond}} \f$ is the energy by which the bond would rise if only one of the two sites were flipped, and the neighbour is added to the cluster if the bond is activated. Afterwards all sites of the cluster are flipped together, which is accepted with probability one. Close to a critical point this reduces the autocorrelation times drastically compared to the single-site updates of the Metropolis algorithm.
+ *
+ * The sites of a cluster are gathered in a buffer that is used as stack during the growth and a bitmap marks the visited sites, both are allocated once for the size of the configuration, so no memory is allocated during the cluster updates.
+ *
+ * The ConfigurationType must fulfill the Concepts::ClusterConfigurationConcept, i.e. provide
+ * - <tt>std::size_t site_number()</tt>: Number of sites of the configuration
+ * - <tt>std::size_t neighbour_number(std::size_t site)</tt>: Number of neighbours of a site
+ * - <tt>std::size_t neighbour(std::size_t site, std::size_t n)</tt>: Index of the n-th neighbour of a site
+ * - <tt>energy_type bond_energy(std::size_t site, std::size_t neighbour)</tt>: Energy by which the bond between the two sites would rise if only the first one were flipped (for the Ising model \f$ 2J \f$ for parallel and \f$ -2J \f$ for anti-parallel spins)
+ * - <tt>void flip_site(std::size_t site)</tt>: Flip a site of the cluster
+ * - <tt>energy_type energy()</tt>: Energy of the configuration (used by the default observator)
+ *
+ * If the configuration provides the member function <tt>void prepare_cluster_update(RandomNumberGenerator* rng)</tt>, it is called before every cluster is grown, e.g. to choose the random reflection of a continuous spin model that is applied by flip_site.
+ *
+ * To perform a Wolff simulation, use one of the \c Wolff::do_wolff_simulation() functions, which have the same interface as Metropolis::do_metropolis_simulation(). A step of the Wolff simulation is the growth and the flip of one cluster.
+ */
+template <class ConfigurationType, class RandomNumberGenerator>
+class Wolff : public Simulation<ConfigurationType, RandomNumberGenerator>
+{
+  // Check the cluster configuration concept
+  BOOST_CONCEPT_ASSERT((Concepts::ClusterConfigurationConcept<ConfigurationType>));
+  // Check the random number generator concept
+  BOOST_CONCEPT_ASSERT((Concepts::RandomNumberGeneratorConcept<RandomNumberGenerator>));
+
+public:
+  // Typedef for the base class
+  typedef Simulation<ConfigurationType, RandomNumberGenerator> Base;
+  // Typedefs for integers
+  typedef typename Base::step_number_t step_number_t;
+  typedef uint32_t measurement_number_t;
+
+  // Forward declaration of the parameters used for a Wolff simulation
+  struct Parameters;
+
+  //! Standard class for observing the energy of the system
+  struct ObserveEnergy
+  {
+    typedef BOOST_TYPEOF(&ConfigurationType::energy) energy_function_type;
+    typedef typename boost::function_types::result_type<energy_function_type>::type observable_type;
+    static observable_type observe(ConfigurationType* config) { return config->energy(); }
+  };
+  //! Typedef for the default observable
+  typedef typename Wolff<ConfigurationType, RandomNumberGenerator>::ObserveEnergy DefaultObservator;
+
+  //! Boost signal handler invoked after every measurement
+  boost::signals2::signal<void (Simulation<ConfigurationType,RandomNumberGenerator>*)> signal_handler_measurement;
+
+  //! Initialise a Wolff-MC simulation with default configuration space and default Parameters
+  Wolff() : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(), last_cluster_size(0) {}
+  //! Initialise a Wolff-MC simulation with default configuration space and given Parameters
+  Wolff(const Parameters& params) : Simulation<ConfigurationType, RandomNumberGenerator>(), simulation_parameters(params), last_cluster_size(0) {}
+  //! Initialise a Wolff-MC simulation with given parameters and given configuration space
+  Wolff(const Parameters& params, ConfigurationType* initial_configuration) : Simulation<ConfigurationType, RandomNumberGenerator>(initial_configuration), simulation_parameters(params), last_cluster_size(0) {}
+
+  //! Get-accessor for the parameters of the Wolff simulation
+  const Parameters& get_simulation_parameters() { return simulation_parameters; }
+  //! Set-accessor for the parameters of the Wolff simulation
+  void set_parameters(const Parameters& value) { simulation_parameters = value; }
+  //! Get-accessor for the number of sites of the last flipped cluster
+  std::size_t get_last_cluster_size() const { return last_cluster_size; }
+
+  //! Grow and flip the given number of clusters at inverse temperature beta
+  template<class TemperatureType = double>
+  void do_wolff_steps(const step_number_t& number, const TemperatureType& beta = 0.0);
+
+  //! Execute a Wolff simulation at given inverse temperature, returns the measured observables
+  template<class Observator = DefaultObservator, class TemperatureType = double>
+  std::vector<typename Observator::observable_type> do_wolff_simulation(const TemperatureType& beta);
+  //! Execute a Wolff simulation on a range of given inverse temperatures, returns the measured observables for every inverse temperature
+  template<class Observator = DefaultObservator, class InputIterator>
+  std::vector<std::vector<typename Observator::observable_type> > do_wolff_simulation(InputIterator beta_begin, InputIterator beta_end);
+  //! Execute a Wolff simulation at given inverse temperature using the given accumulator for the measurement results
+  template<class Observator = DefaultObservator, class Accumulator, class TemperatureType = double>
+  void do_wolff_simulation(const TemperatureType& beta, Accumulator& measurement_accumulator);
+  //! Execute a Wolff simulation on a range of given inverse temperatures using the given accumulators for the measurement results
+  template<class Observator = DefaultObservator, class AccumulatorIterator, class InverseTemperatureIterator>
+  void do_wolff_simulation(InverseTemperatureIterator beta_begin, InverseTemperatureIterator beta_end, AccumulatorIterator measurement_accumulator_begin, AccumulatorIterator measurement_accumulator_end);
+
+  //! Load the data of the Wolff simulation from a serialization stream
+  virtual void load_serialize(std::istream& input_stream) { Base::load_serialize(*this, input_stream); }
+  //! Load the data of the Wolff simulation from a serialization file
+  virtual void load_serialize(const char* filename) { Base::load_serialize(*this, filename); }
+  //! Save the data of the Wolff simulation to a serialization stream
+  virtual void save_serialize(std::ostream& output_stream) const { Base::save_serialize(*this, output_stream); }
+  //! Save the data of the Wolff simulation to a serialization file
+  virtual void save_serialize(const char* filename) const { Base::save_serialize(*this, filename); }
+
+private:
+  //! Member variable storing the parameters of the simulation
+  Parameters simulation_parameters;
+  //! Boltzmann factors of discrete bond energies at the actual inverse temperature
+  Details::Metropolis::AcceptanceTable acceptance_table;
+
+  //! Sites of the actual cluster, used as stack while the cluster is grown (capacity of the number of sites)
+  std::vector<std::size_t> cluster_sites;
+  //! Bitmap marking the sites that belong to the actual cluster
+  std::vector<bool> cluster_visited;
+  //! Number of sites of the last flipped cluster
+  std::size_t last_cluster_size;
+
+  //! Decide whether a bond with the given bond energy is activated at inverse temperature beta
+  template<class EnergyType, class TemperatureType>
+  bool activate_bond(const EnergyType& bond_energy, const TemperatureType& beta);
+
+  //! Member variable for boost serialization
+  friend class boost::serialization::access;
+  //! Method to serialize this class (omitted version name to avoid unused parameter warnings)
+  template<class Archive> void serialize(Archive & ar, const unsigned int)
+  {
+    // serialize base class information
+    ar & boost::serialization::base_object<Simulation<ConfigurationType, RandomNumberGenerator> >(*this);
+  }
+};
+
+//! Struct storing the parameters of a Wolff Monte-Carlo Simulation
+template <class ConfigurationType, class RandomNumberGenerator>
+struct Wolff<ConfigurationType, RandomNumberGenerator>::Parameters
+{
+  //! Number of cluster updates to perform before the first measurement
+  step_number_t relaxation_steps;
+  //! Number of measurements
+  measurement_number_t measurement_number;
+  //! Number of cluster updates to perform between two measurements
+  step_number_t steps_between_measurement;
+
+  //! Standard constructor for setting default values
+  Parameters() : relaxation_steps(1000),
+		 measurement_number(100),
+		 steps_between_measurement(10) {}
+};
+
+} // of namespace Mocasinns
+
+#include "src/wolff.cpp"
+
+#endif
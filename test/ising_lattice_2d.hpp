@@ -0,0 +1,136 @@
+#ifndef TEST_ISING_LATTICE_2D_HPP
+#define TEST_ISING_LATTICE_2D_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+
+#include <boost/serialization/vector.hpp>
+
+class IsingLattice2d;
+
+// Step flipping a single spin of a periodic two-dimensional Ising lattice
+class IsingLattice2dStep
+{
+public:
+  IsingLattice2d* configuration;
+  std::size_t site;
+
+  IsingLattice2dStep() : configuration(0), site(0) {}
+  IsingLattice2dStep(IsingLattice2d* config, std::size_t index) : configuration(config), site(index) {}
+
+  int delta_E();
+  void execute();
+  // Append the flipped site and its neighbours (used by the speculative evaluation)
+  void footprint(std::vector<std::size_t>& sites);
+};
+
+// Periodic two-dimensional Ising lattice providing the interfaces of the sweeps, the sublattice decomposition and the cluster algorithms
+// The sites are numbered in typewriter order (y index runs fastest)
+class IsingLattice2d
+{
+public:
+  std::size_t size_x;
+  std::size_t size_y;
+  std::vector<int> spins;
+
+  IsingLattice2d() : size_x(0), size_y(0), spins() {}
+  IsingLattice2d(std::size_t length_x, std::size_t length_y) : size_x(length_x), size_y(length_y), spins(length_x * length_y, 1) {}
+
+  bool operator==(const IsingLattice2d& other) const { return size_x == other.size_x && size_y == other.size_y && spins == other.spins; }
+
+  int energy() const
+  {
+    int result = 0;
+    for (std::size_t site = 0; site < spins.size(); ++site)
+      result -= spins[site] * (spins[neighbour(site, 1)] + spins[neighbour(site, 3)]);
+    return result;
+  }
+  int magnetization() const
+  {
+    int result = 0;
+    for (std::size_t site = 0; site < spins.size(); ++site) result += spins[site];
+    return result;
+  }
+
+  void commit(const IsingLattice2dStep& step) { spins[step.site] *= -1; }
+  template <class RandomNumberGenerator>
+  IsingLattice2dStep propose_step(RandomNumberGenerator* rng) { return IsingLattice2dStep(this, rng->random_int32(0, spins.size() - 1)); }
+
+  // Sequential sweep in typewriter order
+  std::size_t sweep_length() { return spins.size(); }
+  template <class RandomNumberGenerator>
+  IsingLattice2dStep propose_sweep_step(std::size_t position, RandomNumberGenerator*) { return IsingLattice2dStep(this, position); }
+
+  // Checkerboard decomposition, requires an even size_y
+  std::size_t color_number() { return 2; }
+  std::size_t color_size(std::size_t) { return spins.size() / 2; }
+  template <class RandomNumberGenerator>
+  IsingLattice2dStep propose_color_step(std::size_t color, std::size_t position, RandomNumberGenerator*)
+  {
+    const std::size_t index_x = position / (size_y / 2);
+    const std::size_t index_y = 2 * (position % (size_y / 2)) + (index_x + color) % 2;
+    return IsingLattice2dStep(this, index_x * size_y + index_y);
+  }
+
+  // Interface of the cluster algorithms
+  std::size_t site_number() { return spins.size(); }
+  std::size_t neighbour_number(std::size_t) { return 4; }
+  std::size_t neighbour(std::size_t site, std::size_t n) const
+  {
+    const std::size_t index_x = site / size_y;
+    const std::size_t index_y = site % size_y;
+    switch (n)
+    {
+    case 0: return (index_x == 0 ? size_x - 1 : index_x - 1) * size_y + index_y;
+    case 1: return (index_x == size_x - 1 ? 0 : index_x + 1) * size_y + index_y;
+    case 2: return index_x * size_y + (index_y == 0 ? size_y - 1 : index_y - 1);
+    default: return index_x * size_y + (index_y == size_y - 1 ? 0 : index_y + 1);
+    }
+  }
+  int bond_energy(std::size_t site, std::size_t neighbour) { return 2 * spins[site] * spins[neighbour]; }
+  void flip_site(std::size_t site) { spins[site] *= -1; }
+
+  template<class Archive> void serialize(Archive & ar, const unsigned int)
+  {
+    ar & size_x;
+    ar & size_y;
+    ar & spins;
+  }
+};
+
+inline int IsingLattice2dStep::delta_E()
+{
+  int neighbour_sum = 0;
+  for (std::size_t n = 0; n < 4; ++n) neighbour_sum += configuration->spins[configuration->neighbour(site, n)];
+  return 2 * configuration->spins[site] * neighbour_sum;
+}
+inline void IsingLattice2dStep::execute() { configuration->commit(*this); }
+inline void IsingLattice2dStep::footprint(std::vector<std::size_t>& sites)
+{
+  sites.push_back(site);
+  for (std::size_t n = 0; n < 4; ++n) sites.push_back(configuration->neighbour(site, n));
+}
+
+// Exact canonical mean energy of a small lattice, calculated by enumerating all configurations
+inline double ising_lattice_2d_mean_energy(std::size_t size_x, std::size_t size_y, double beta)
+{
+  IsingLattice2d lattice(size_x, size_y);
+  const unsigned long configuration_number = 1ul << lattice.spins.size();
+  // Shift the energies by the ground state energy to avoid overflows of the Boltzmann factors
+  const int ground_state_energy = lattice.energy();
+  double partition_function = 0.0;
+  double energy_sum = 0.0;
+  for (unsigned long state = 0; state < configuration_number; ++state)
+  {
+    for (std::size_t site = 0; site < lattice.spins.size(); ++site)
+      lattice.spins[site] = ((state >> site) & 1ul) ? -1 : 1;
+    const int energy = lattice.energy();
+    const double boltzmann_factor = exp(-beta * (energy - ground_state_energy));
+    partition_function += boltzmann_factor;
+    energy_sum += energy * boltzmann_factor;
+  }
+  return energy_sum / partition_function;
+}
+
+#endif
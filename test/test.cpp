@@ -15,12 +15,18 @@
 #include "test_entropic_sampling.hpp"
 #include "test_metropolis.hpp"
 #include "test_metropolis_parallel.hpp"
+#include "test_metropolis_rejection_free.hpp"
+#include "test_metropolis_ensemble.hpp"
 #include "test_serial_tempering.hpp"
 #include "test_parallel_tempering.hpp"
 #include "test_wang_landau.hpp"
 #include "test_optimal_ensemble_sampling.hpp"
+#include "test_kinetic_monte_carlo.hpp"
+#include "test_wolff.hpp"
+#include "test_swendsen_wang.hpp"
 #include "test_accumulators/test_histogram_accumulator.hpp"
 #include "test_accumulators/test_file_accumulator.hpp"
+#include "test_accumulators/test_tuple_accumulator.hpp"
 #include "test_histograms/test_constant_width_binning.hpp"
 #include "test_histograms/test_fixed_boundary_binning.hpp"
 #include "test_histograms/test_histobase.hpp"
@@ -34,6 +40,7 @@
 #include "test_observables/test_array_observable.hpp"
 #include "test_observables/test_histogram_observable.hpp"
 #include "test_observables/test_pair_observable.hpp"
+#include "test_observables/test_tuple_observable.hpp"
 #include "test_analysis/test_binning_analysis.hpp"
 #include "test_analysis/test_jackknife_analysis.hpp"
 #include "test_analysis/test_bootstrap_analysis.hpp"
@@ -42,6 +49,18 @@
 #include "test_details/test_stl_extensions/test_array_addable.hpp"
 #include "test_details/test_stl_extensions/test_pair_addable.hpp"
 #include "test_details/test_parallel_tempering/test_inverse_temperature_optimization.hpp"
+#include "test_details/test_metropolis/test_acceptance_table.hpp"
+#include "test_details/test_metropolis/test_multi_spin.hpp"
+#include "test_details/test_metropolis/test_precision_monitor.hpp"
+#include "test_details/test_metropolis/test_equilibration_detector.hpp"
+#include "test_details/test_metropolis/test_measurement_pipeline.hpp"
+#include "test_details/test_metropolis/test_proposal_tuner.hpp"
+#include "test_details/test_rejection_free/test_rate_tree.hpp"
+#include "test_details/test_rejection_free/test_step_classes.hpp"
+#include "test_details/test_ensemble/test_lane_random.hpp"
+#include "test_details/test_cluster/test_concurrent_union_find.hpp"
+#include "test_profiling/test_profiling.hpp"
+#include "test_statistics/test_acceptance_statistics.hpp"
 // #include "test_details/test_stl_extensions/test_tuple_addable.hpp"
 
 bool read_test_name(int argc, char *argv[], std::string& test_name);
@@ -63,6 +82,10 @@ int main(int argc, char *argv[])
     runner.addTest(TestMetropolis::suite());
   if (test_all || test_name == "MetropolisParallel")
     runner.addTest(TestMetropolisParallel::suite());
+  if (test_all || test_name == "MetropolisRejectionFree")
+    runner.addTest(TestMetropolisRejectionFree::suite());
+  if (test_all || test_name == "MetropolisEnsemble")
+    runner.addTest(TestMetropolisEnsemble::suite());
   if (test_all || test_name == "SerialTempering")
     runner.addTest(TestSerialTempering::suite());
   if (test_all || test_name == "ParallelTempering")
@@ -74,10 +97,17 @@ int main(int argc, char *argv[])
     runner.addTest(TestWangLandau::suite());
   if (test_all || test_name == "OptimalEnsembleSampling")
     runner.addTest(TestOptimalEnsembleSampling::suite());
+  if (test_all || test_name == "KineticMonteCarlo")
+    runner.addTest(TestKineticMonteCarlo::suite());
+  if (test_all || test_name == "Wolff")
+    runner.addTest(TestWolff::suite());
+  if (test_all || test_name == "SwendsenWang")
+    runner.addTest(TestSwendsenWang::suite());
   if (test_all || test_name == "Accumulators")
   {
     runner.addTest(TestFileAccumulator::suite());
     runner.addTest(TestHistogramAccumulator::suite());
+    runner.addTest(TestTupleAccumulator::suite());
   }
   if (test_all || test_name == "Histograms")
   {
@@ -95,6 +125,7 @@ int main(int argc, char *argv[])
     runner.addTest(TestArrayObservable::suite());
     runner.addTest(TestHistogramObservable::suite());
     runner.addTest(TestPairObservable::suite());
+    runner.addTest(TestTupleObservable::suite());
     runner.addTest(TestBinningAnalysis::suite());
     runner.addTest(TestJackknifeAnalysis::suite());
     runner.addTest(TestBootstrapAnalysis::suite());
@@ -112,7 +143,21 @@ int main(int argc, char *argv[])
     runner.addTest(TestArrayAddable::suite());
     runner.addTest(TestPairAddable::suite());
     //    runner.addTest(TestTupleAddable::suite());
+    runner.addTest(TestAcceptanceTable::suite());
+    runner.addTest(TestMultiSpin::suite());
+    runner.addTest(TestPrecisionMonitor::suite());
+    runner.addTest(TestEquilibrationDetector::suite());
+    runner.addTest(TestMeasurementPipeline::suite());
+    runner.addTest(TestProposalTuner::suite());
+    runner.addTest(TestRateTree::suite());
+    runner.addTest(TestStepClasses::suite());
+    runner.addTest(TestLaneRandom::suite());
+    runner.addTest(TestConcurrentUnionFind::suite());
   }
+  if (test_all || test_name == "Profiling")
+    runner.addTest(TestProfiling::suite());
+  if (test_all || test_name == "Statistics")
+    runner.addTest(TestAcceptanceStatistics::suite());
 
   CppUnit::BriefTestProgressListener listener;
   runner.eventManager().addListener(&listener);
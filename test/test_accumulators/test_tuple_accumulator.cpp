@@ -0,0 +1,89 @@
+#include "test_tuple_accumulator.hpp"
+
+#include <boost/mpl/vector.hpp>
+
+using Mocasinns::Details::Metropolis::VectorAccumulator;
+
+//! Number of local fields calculated by the fused pass
+static unsigned int local_field_evaluations = 0;
+
+//! Fused pass calculating the energy and the squared local fields from the shared local fields of a periodic chain of spins
+struct TestTupleAccumulator::ChainPass
+{
+  typedef boost::mpl::vector<Energy, Magnetization, LocalFieldSquared> observables;
+
+  template <class Request>
+  static void observe(std::vector<int>* spins, Request& request)
+  {
+    int energy = 0;
+    int magnetization = 0;
+    double local_field_squared = 0.0;
+    for (unsigned int i = 0; i < spins->size(); ++i)
+    {
+      if (Request::template requested<Magnetization>::value) magnetization += (*spins)[i];
+      if (Request::template requested<Energy, LocalFieldSquared>::value)
+      {
+	++local_field_evaluations;
+	const int local_field = (*spins)[(i + 1) % spins->size()] + (*spins)[(i + spins->size() - 1) % spins->size()];
+	energy -= (*spins)[i]*local_field;
+	local_field_squared += local_field*local_field;
+      }
+    }
+    request.template set<Energy>(energy / 2);
+    request.template set<Magnetization>(magnetization);
+    request.template set<LocalFieldSquared>(local_field_squared);
+  }
+};
+
+CppUnit::Test* TestTupleAccumulator::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestAccumulators/TestTupleAccumulator");
+
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTupleAccumulator>("TestAccumulators/TestTupleAccumulator: test_operator_accumulate", &TestTupleAccumulator::test_operator_accumulate) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTupleAccumulator>("TestAccumulators/TestTupleAccumulator: test_unrequested_observables", &TestTupleAccumulator::test_unrequested_observables) );
+
+  return suite_of_tests;
+}
+
+void TestTupleAccumulator::setUp()
+{
+  // Chain of four spins with one domain wall pair
+  spins.clear();
+  spins.push_back(1); spins.push_back(1); spins.push_back(-1); spins.push_back(1);
+  local_field_evaluations = 0;
+}
+
+void TestTupleAccumulator::tearDown()
+{
+}
+
+void TestTupleAccumulator::test_operator_accumulate()
+{
+  typedef TupleAccumulator<Accumulate<Energy, VectorAccumulator<int> >, Accumulate<LocalFieldSquared, VectorAccumulator<double> > > AccumulatorType;
+  AccumulatorType accumulator;
+  accumulator(AccumulatorType::observator<ChainPass>::observe(&spins));
+  spins[2] = 1;
+  accumulator(AccumulatorType::observator<ChainPass>::observe(&spins));
+
+  CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(accumulator.get<Energy>().internal_vector.size()));
+  CPPUNIT_ASSERT_EQUAL(0, accumulator.get<Energy>().internal_vector[0]);
+  CPPUNIT_ASSERT_EQUAL(-4, accumulator.get<Energy>().internal_vector[1]);
+  CPPUNIT_ASSERT_EQUAL(8.0, accumulator.get<LocalFieldSquared>().internal_vector[0]);
+  CPPUNIT_ASSERT_EQUAL(16.0, accumulator.get<LocalFieldSquared>().internal_vector[1]);
+}
+
+void TestTupleAccumulator::test_unrequested_observables()
+{
+  // The shared local fields are calculated once per site for both observables
+  typedef TupleAccumulator<Accumulate<Energy, VectorAccumulator<int> >, Accumulate<LocalFieldSquared, VectorAccumulator<double> > > FieldAccumulatorType;
+  FieldAccumulatorType field_accumulator;
+  field_accumulator(FieldAccumulatorType::observator<ChainPass>::observe(&spins));
+  CPPUNIT_ASSERT_EQUAL(4u, local_field_evaluations);
+
+  // If only the magnetization is requested, the local fields are not calculated
+  typedef TupleAccumulator<Accumulate<Magnetization, VectorAccumulator<int> > > MagnetizationAccumulatorType;
+  MagnetizationAccumulatorType magnetization_accumulator;
+  magnetization_accumulator(MagnetizationAccumulatorType::observator<ChainPass>::observe(&spins));
+  CPPUNIT_ASSERT_EQUAL(4u, local_field_evaluations);
+  CPPUNIT_ASSERT_EQUAL(2, magnetization_accumulator.get<Magnetization>().internal_vector[0]);
+}
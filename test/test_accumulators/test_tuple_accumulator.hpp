@@ -0,0 +1,39 @@
+#ifndef TEST_TUPLE_ACCUMULATOR_HPP
+#define TEST_TUPLE_ACCUMULATOR_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+#include <mocasinns/accumulators/tuple_accumulator.hpp>
+#include <mocasinns/details/metropolis/vector_accumulator.hpp>
+
+using namespace Mocasinns::Accumulators;
+
+class TestTupleAccumulator : CppUnit::TestFixture
+{
+private:
+  // Tags of the observables of a chain of spins
+  struct Energy { typedef int observable_type; };
+  struct Magnetization { typedef int observable_type; };
+  struct LocalFieldSquared { typedef double observable_type; };
+  // Fused pass over a chain of spins
+  struct ChainPass;
+
+  std::vector<int> spins;
+
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_operator_accumulate();
+  void test_unrequested_observables();
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "test_concurrent_union_find.hpp"
+
+CppUnit::Test* TestConcurrentUnionFind::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestConcurrentUnionFind");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestConcurrentUnionFind>("TestConcurrentUnionFind: test_make_set", &TestConcurrentUnionFind::test_make_set) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestConcurrentUnionFind>("TestConcurrentUnionFind: test_unite", &TestConcurrentUnionFind::test_unite) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestConcurrentUnionFind>("TestConcurrentUnionFind: test_root_independent_of_order", &TestConcurrentUnionFind::test_root_independent_of_order) );
+
+  return suite_of_tests;
+}
+
+void TestConcurrentUnionFind::setUp()
+{
+  test_union_find = new Details::Cluster::ConcurrentUnionFind;
+  test_union_find->resize(10);
+  for (std::size_t i = 0; i < 10; ++i) test_union_find->make_set(i);
+}
+
+void TestConcurrentUnionFind::tearDown()
+{
+  delete test_union_find;
+}
+
+void TestConcurrentUnionFind::test_make_set()
+{
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(10), test_union_find->size());
+  for (std::size_t i = 0; i < 10; ++i)
+    CPPUNIT_ASSERT_EQUAL(i, test_union_find->find(i));
+}
+
+void TestConcurrentUnionFind::test_unite()
+{
+  // Create the sets {1,3,5,7} and {2,4}
+  test_union_find->unite(7, 5);
+  test_union_find->unite(3, 5);
+  test_union_find->unite(1, 7);
+  test_union_find->unite(4, 2);
+  test_union_find->unite(3, 7);
+
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_union_find->find(3));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_union_find->find(5));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_union_find->find(7));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), test_union_find->find(4));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), test_union_find->find(0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(9), test_union_find->find(9));
+
+  // Make all elements a set of their own again
+  for (std::size_t i = 0; i < 10; ++i) test_union_find->make_set(i);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(7), test_union_find->find(7));
+}
+
+void TestConcurrentUnionFind::test_root_independent_of_order()
+{
+  // Unite a chain in reversed order, the root must be the element with the smallest index
+  for (std::size_t i = 9; i > 2; --i)
+    test_union_find->unite(i, i - 1);
+  for (std::size_t i = 2; i < 10; ++i)
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), test_union_find->find(i));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_union_find->find(1));
+}
@@ -0,0 +1,30 @@
+#ifndef TEST_DETAILS_CLUSTER_CONCURRENT_UNION_FIND_HPP
+#define TEST_DETAILS_CLUSTER_CONCURRENT_UNION_FIND_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/details/cluster/concurrent_union_find.hpp>
+
+using namespace Mocasinns;
+
+class TestConcurrentUnionFind : CppUnit::TestFixture
+{
+private:
+  Details::Cluster::ConcurrentUnionFind* test_union_find;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_make_set();
+  void test_unite();
+  void test_root_independent_of_order();
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "test_lane_random.hpp"
+
+#include <vector>
+#include <cmath>
+
+CppUnit::Test* TestLaneRandom::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestLaneRandom");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestLaneRandom>("TestLaneRandom: test_seed", &TestLaneRandom::test_seed) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestLaneRandom>("TestLaneRandom: test_fill_uniform", &TestLaneRandom::test_fill_uniform) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestLaneRandom>("TestLaneRandom: test_fill_below", &TestLaneRandom::test_fill_below) );
+
+  return suite_of_tests;
+}
+
+void TestLaneRandom::setUp()
+{
+  test_rng = new Random::Boost_MT19937;
+  test_rng->set_seed(42);
+  test_lanes = new Details::Ensemble::LaneRandom;
+  test_lanes->seed(16, test_rng);
+}
+
+void TestLaneRandom::tearDown()
+{
+  delete test_lanes;
+  delete test_rng;
+}
+
+void TestLaneRandom::test_seed()
+{
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(16), test_lanes->size());
+
+  // Lanes seeded with the same seed create the same numbers
+  Random::Boost_MT19937 other_rng;
+  other_rng.set_seed(42);
+  Details::Ensemble::LaneRandom other_lanes;
+  other_lanes.seed(16, &other_rng);
+  std::vector<double> numbers, other_numbers;
+  test_lanes->fill_uniform(numbers);
+  other_lanes.fill_uniform(other_numbers);
+  for (unsigned int k = 0; k < 16; ++k)
+    CPPUNIT_ASSERT_EQUAL(numbers[k], other_numbers[k]);
+
+  // Different lanes create different numbers
+  for (unsigned int k = 1; k < 16; ++k)
+    CPPUNIT_ASSERT(numbers[k] != numbers[0]);
+}
+
+void TestLaneRandom::test_fill_uniform()
+{
+  // The numbers of every lane must lie in [0,1) and have mean 1/2
+  const unsigned int samples = 10000;
+  std::vector<double> sums(16, 0.0);
+  std::vector<double> numbers;
+  for (unsigned int i = 0; i < samples; ++i)
+  {
+    test_lanes->fill_uniform(numbers);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(16), numbers.size());
+    for (unsigned int k = 0; k < 16; ++k)
+    {
+      CPPUNIT_ASSERT(numbers[k] >= 0.0 && numbers[k] < 1.0);
+      sums[k] += numbers[k];
+    }
+  }
+  for (unsigned int k = 0; k < 16; ++k)
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, sums[k] / samples, 5.0 * sqrt(1.0 / 12.0 / samples));
+}
+
+void TestLaneRandom::test_fill_below()
+{
+  // Every integer below the bound must occur with the same frequency
+  const unsigned int samples = 10000;
+  std::vector<unsigned int> counts(5, 0);
+  std::vector<uint32_t> numbers;
+  for (unsigned int i = 0; i < samples; ++i)
+  {
+    test_lanes->fill_below(5, numbers);
+    for (unsigned int k = 0; k < 16; ++k)
+    {
+      CPPUNIT_ASSERT(numbers[k] < 5);
+      counts[numbers[k]]++;
+    }
+  }
+  for (unsigned int n = 0; n < 5; ++n)
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, static_cast<double>(counts[n]) / (16 * samples), 5.0 * sqrt(0.16 / (16 * samples)));
+}
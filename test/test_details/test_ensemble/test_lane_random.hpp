@@ -0,0 +1,32 @@
+#ifndef TEST_DETAILS_ENSEMBLE_LANE_RANDOM_HPP
+#define TEST_DETAILS_ENSEMBLE_LANE_RANDOM_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/details/ensemble/lane_random.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+using namespace Mocasinns;
+
+class TestLaneRandom : CppUnit::TestFixture
+{
+private:
+  Random::Boost_MT19937* test_rng;
+  Details::Ensemble::LaneRandom* test_lanes;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_seed();
+  void test_fill_uniform();
+  void test_fill_below();
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "test_acceptance_table.hpp"
+
+#include <cmath>
+
+CppUnit::Test* TestAcceptanceTable::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestAcceptanceTable");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceTable>("TestAcceptanceTable: test_lookup", &TestAcceptanceTable::test_lookup) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceTable>("TestAcceptanceTable: test_temperature_change", &TestAcceptanceTable::test_temperature_change) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceTable>("TestAcceptanceTable: test_maximal_size", &TestAcceptanceTable::test_maximal_size) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceTable>("TestAcceptanceTable: test_continuous_energy", &TestAcceptanceTable::test_continuous_energy) );
+
+  return suite_of_tests;
+}
+
+void TestAcceptanceTable::setUp()
+{
+  test_table = new Details::Metropolis::AcceptanceTable(16);
+}
+
+void TestAcceptanceTable::tearDown()
+{
+  delete test_table;
+}
+
+void TestAcceptanceTable::test_lookup()
+{
+  // Fill the table with the energy differences of the 2d Ising model
+  for (int delta_E = -8; delta_E <= 8; delta_E += 4)
+    CPPUNIT_ASSERT_EQUAL(exp(-0.4*delta_E), (*test_table)(delta_E, 0.4));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(13), test_table->size());
+
+  // Looking up the values again must not change the table
+  for (int delta_E = 8; delta_E >= -8; delta_E -= 4)
+    CPPUNIT_ASSERT_EQUAL(exp(-0.4*delta_E), (*test_table)(delta_E, 0.4));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(13), test_table->size());
+}
+
+void TestAcceptanceTable::test_temperature_change()
+{
+  CPPUNIT_ASSERT_EQUAL(exp(-0.4*4), (*test_table)(4, 0.4));
+  CPPUNIT_ASSERT_EQUAL(exp(-0.5*4), (*test_table)(4, 0.5));
+  CPPUNIT_ASSERT_EQUAL(exp(0.5*8), (*test_table)(-8, 0.5));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(13), test_table->size());
+
+  // Returning to the old temperature refills the table
+  CPPUNIT_ASSERT_EQUAL(exp(-0.4*4), (*test_table)(4, 0.4));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_table->size());
+}
+
+void TestAcceptanceTable::test_maximal_size()
+{
+  // Energy differences exceeding the maximal size are calculated directly
+  CPPUNIT_ASSERT_EQUAL(exp(-0.1*0), (*test_table)(0, 0.1));
+  CPPUNIT_ASSERT_EQUAL(exp(-0.1*100), (*test_table)(100, 0.1));
+  CPPUNIT_ASSERT_EQUAL(exp(0.1*100), (*test_table)(-100, 0.1));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_table->size());
+  CPPUNIT_ASSERT_EQUAL(exp(-0.1*15), (*test_table)(15, 0.1));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(16), test_table->size());
+  CPPUNIT_ASSERT_EQUAL(exp(-0.1*16), (*test_table)(16, 0.1));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(16), test_table->size());
+}
+
+void TestAcceptanceTable::test_continuous_energy()
+{
+  // Floating point energy differences are never tabulated
+  CPPUNIT_ASSERT_EQUAL(exp(-0.4*1.5), (*test_table)(1.5, 0.4));
+  CPPUNIT_ASSERT_EQUAL(exp(-0.4*2.5), (*test_table)(2.5, 0.4));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), test_table->size());
+}
@@ -0,0 +1,31 @@
+#ifndef TEST_DETAILS_METROPOLIS_ACCEPTANCE_TABLE_HPP
+#define TEST_DETAILS_METROPOLIS_ACCEPTANCE_TABLE_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/details/metropolis/acceptance_table.hpp>
+
+using namespace Mocasinns;
+
+class TestAcceptanceTable : CppUnit::TestFixture
+{
+private:
+  Details::Metropolis::AcceptanceTable* test_table;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_lookup();
+  void test_temperature_change();
+  void test_maximal_size();
+  void test_continuous_energy();
+};
+
+#endif
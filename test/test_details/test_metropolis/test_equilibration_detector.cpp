@@ -0,0 +1,61 @@
+#include "test_equilibration_detector.hpp"
+
+#include <cmath>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+
+CppUnit::Test* TestEquilibrationDetector::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestEquilibrationDetector");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestEquilibrationDetector>("TestEquilibrationDetector: test_stationary", &TestEquilibrationDetector::test_stationary) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestEquilibrationDetector>("TestEquilibrationDetector: test_large_offset", &TestEquilibrationDetector::test_large_offset) );
+
+  return suite_of_tests;
+}
+
+void TestEquilibrationDetector::setUp()
+{
+  // Exponential relaxation from 100 with a decay time of 50 samples plus unit noise
+  boost::random::mt19937 rng(42);
+  boost::random::normal_distribution<double> noise;
+  for (unsigned int i = 0; i < 4000; ++i)
+    test_series.push_back(100.0*exp(-(i/50.0)) + noise(rng));
+}
+
+void TestEquilibrationDetector::tearDown()
+{
+  test_series.clear();
+}
+
+void TestEquilibrationDetector::test_stationary()
+{
+  Details::Metropolis::EquilibrationDetector detector;
+
+  // The series is not stationary before the minimal number of batches is recorded
+  for (unsigned int i = 0; i < 50; ++i)
+    detector.add(test_series[i]);
+  CPPUNIT_ASSERT(!detector.is_stationary());
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(10), detector.get_batch_number());
+
+  // The whole series is stationary and the truncation point lies behind the relaxation
+  for (unsigned int i = 50; i < test_series.size(); ++i)
+    detector.add(test_series[i]);
+  CPPUNIT_ASSERT(detector.is_stationary());
+  CPPUNIT_ASSERT(detector.get_truncation_samples() >= 100);
+  CPPUNIT_ASSERT(detector.get_truncation_samples() <= 1000);
+}
+
+void TestEquilibrationDetector::test_large_offset()
+{
+  // Energies of a large lattice, the MSER statistic must not cancel in the suffix sums
+  Details::Metropolis::EquilibrationDetector detector;
+  Details::Metropolis::EquilibrationDetector detector_offset;
+  for (unsigned int i = 0; i < test_series.size(); ++i)
+  {
+    detector.add(test_series[i]);
+    detector_offset.add(test_series[i] - 1e9);
+    CPPUNIT_ASSERT_EQUAL(detector.is_stationary(), detector_offset.is_stationary());
+    CPPUNIT_ASSERT_EQUAL(detector.get_truncation_samples(), detector_offset.get_truncation_samples());
+  }
+}
@@ -0,0 +1,32 @@
+#ifndef TEST_DETAILS_METROPOLIS_EQUILIBRATION_DETECTOR_HPP
+#define TEST_DETAILS_METROPOLIS_EQUILIBRATION_DETECTOR_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+#include <mocasinns/details/metropolis/equilibration_detector.hpp>
+
+using namespace Mocasinns;
+
+class TestEquilibrationDetector : CppUnit::TestFixture
+{
+private:
+  //! Time series relaxing exponentially to a stationary noise around zero
+  std::vector<double> test_series;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_stationary();
+  void test_large_offset();
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "test_measurement_pipeline.hpp"
+
+#include <vector>
+#include <stdexcept>
+
+//! Observable whose copies throw for negative values
+class TestMeasurementPipeline::CountingObservable
+{
+public:
+  int value;
+  explicit CountingObservable(int initial_value) : value(initial_value) {}
+  CountingObservable(const CountingObservable& other) : value(other.value)
+  {
+    if (value < 0) throw std::runtime_error("Negative observable");
+  }
+  CountingObservable& operator=(const CountingObservable& other)
+  {
+    if (other.value < 0) throw std::runtime_error("Negative observable");
+    value = other.value;
+    return *this;
+  }
+};
+//! Observator returning the snapshot as observable
+struct TestMeasurementPipeline::ObserveSnapshot
+{
+  static CountingObservable observe(int& snapshot) { return CountingObservable(snapshot); }
+};
+//! Accumulator storing the values of the observables
+struct TestMeasurementPipeline::CollectingAccumulator
+{
+  std::vector<int> values;
+  void operator()(const CountingObservable& observable) { values.push_back(observable.value); }
+};
+
+CppUnit::Test* TestMeasurementPipeline::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestMeasurementPipeline");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMeasurementPipeline>("TestMeasurementPipeline: test_order", &TestMeasurementPipeline::test_order) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMeasurementPipeline>("TestMeasurementPipeline: test_throwing_observable", &TestMeasurementPipeline::test_throwing_observable) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMeasurementPipeline>("TestMeasurementPipeline: test_drain", &TestMeasurementPipeline::test_drain) );
+
+  return suite_of_tests;
+}
+
+void TestMeasurementPipeline::setUp() {}
+void TestMeasurementPipeline::tearDown() {}
+
+void TestMeasurementPipeline::test_order()
+{
+  // The observables are accumulated in the order of the snapshots, independent of the number of threads
+  CollectingAccumulator accumulator;
+  Details::Metropolis::MeasurementPipeline<int, CountingObservable, ObserveSnapshot, CollectingAccumulator> pipeline(0, 4, 3, accumulator);
+  for (int i = 0; i < 1000; ++i)
+  {
+    pipeline.acquire() = i;
+    pipeline.submit();
+  }
+  pipeline.finish();
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1000), accumulator.values.size());
+  for (int i = 0; i < 1000; ++i)
+    CPPUNIT_ASSERT_EQUAL(i, accumulator.values[i]);
+}
+
+void TestMeasurementPipeline::test_throwing_observable()
+{
+  // An observable that throws while it is stored in the buffer is rethrown by the simulation thread
+  CollectingAccumulator accumulator;
+  Details::Metropolis::MeasurementPipeline<int, CountingObservable, ObserveSnapshot, CollectingAccumulator> pipeline(0, 2, 2, accumulator);
+  pipeline.acquire() = 1;
+  pipeline.submit();
+  pipeline.acquire() = -1;
+  pipeline.submit();
+  CPPUNIT_ASSERT_THROW(pipeline.finish(), std::runtime_error);
+  CPPUNIT_ASSERT(accumulator.values.size() <= 1);
+}
+
+void TestMeasurementPipeline::test_drain()
+{
+  // After draining all submitted snapshots are accumulated and the pipeline accepts further snapshots
+  CollectingAccumulator accumulator;
+  Details::Metropolis::MeasurementPipeline<int, CountingObservable, ObserveSnapshot, CollectingAccumulator> pipeline(0, 4, 8, accumulator);
+  for (int i = 0; i < 100; ++i)
+  {
+    pipeline.acquire() = i;
+    pipeline.submit();
+    if (i % 10 == 9)
+    {
+      pipeline.drain();
+      CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(i + 1), accumulator.values.size());
+    }
+  }
+  pipeline.finish();
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(100), accumulator.values.size());
+
+  // A failed observation is rethrown by drain()
+  CollectingAccumulator accumulator_failing;
+  Details::Metropolis::MeasurementPipeline<int, CountingObservable, ObserveSnapshot, CollectingAccumulator> pipeline_failing(0, 2, 2, accumulator_failing);
+  pipeline_failing.acquire() = -1;
+  pipeline_failing.submit();
+  CPPUNIT_ASSERT_THROW(pipeline_failing.drain(), std::runtime_error);
+}
@@ -0,0 +1,32 @@
+#ifndef TEST_DETAILS_METROPOLIS_MEASUREMENT_PIPELINE_HPP
+#define TEST_DETAILS_METROPOLIS_MEASUREMENT_PIPELINE_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/details/metropolis/measurement_pipeline.hpp>
+
+using namespace Mocasinns;
+
+class TestMeasurementPipeline : CppUnit::TestFixture
+{
+private:
+  class CountingObservable;
+  struct ObserveSnapshot;
+  struct CollectingAccumulator;
+
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_order();
+  void test_throwing_observable();
+  void test_drain();
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "test_multi_spin.hpp"
+
+#include <vector>
+#include <cmath>
+
+CppUnit::Test* TestMultiSpin::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestMultiSpin");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMultiSpin>("TestMultiSpin: test_threshold_mask_limits", &TestMultiSpin::test_threshold_mask_limits) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMultiSpin>("TestMultiSpin: test_threshold_mask_probability", &TestMultiSpin::test_threshold_mask_probability) );
+
+  return suite_of_tests;
+}
+
+void TestMultiSpin::setUp()
+{
+  test_rng = new Random::Boost_MT19937;
+  test_rng->set_seed(42);
+}
+
+void TestMultiSpin::tearDown()
+{
+  delete test_rng;
+}
+
+void TestMultiSpin::test_threshold_mask_limits()
+{
+  const Details::Metropolis::MultiSpinWord candidates = 0xF0F0F0F00F0F0F0FULL;
+
+  // Probabilities 0 and 1 select none or all candidates
+  CPPUNIT_ASSERT_EQUAL(static_cast<Details::Metropolis::MultiSpinWord>(0), Details::Metropolis::threshold_mask(0.0, candidates, test_rng));
+  CPPUNIT_ASSERT_EQUAL(candidates, Details::Metropolis::threshold_mask(1.0, candidates, test_rng));
+  CPPUNIT_ASSERT_EQUAL(candidates, Details::Metropolis::threshold_mask(2.5, candidates, test_rng));
+
+  // Bits that are not candidates are never selected
+  for (unsigned int i = 0; i < 100; ++i)
+    CPPUNIT_ASSERT_EQUAL(static_cast<Details::Metropolis::MultiSpinWord>(0), Details::Metropolis::threshold_mask(0.5, candidates, test_rng) & ~candidates);
+}
+
+void TestMultiSpin::test_threshold_mask_probability()
+{
+  // Count how often every bit is set for some probabilities
+  const double probabilities[3] = { 0.0183, 0.1353, 0.7 };
+  const unsigned int samples = 20000;
+  for (unsigned int p = 0; p < 3; ++p)
+  {
+    std::vector<unsigned int> counts(64, 0);
+    for (unsigned int i = 0; i < samples; ++i)
+    {
+      Details::Metropolis::MultiSpinWord mask = Details::Metropolis::threshold_mask(probabilities[p], ~static_cast<Details::Metropolis::MultiSpinWord>(0), test_rng);
+      for (unsigned int bit = 0; bit < 64; ++bit)
+	counts[bit] += (mask >> bit) & 1;
+    }
+
+    // Every bit must be set with the given probability (within five standard deviations)
+    const double tolerance = 5.0 * sqrt(probabilities[p] * (1.0 - probabilities[p]) / samples);
+    for (unsigned int bit = 0; bit < 64; ++bit)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(probabilities[p], static_cast<double>(counts[bit]) / samples, tolerance);
+  }
+}
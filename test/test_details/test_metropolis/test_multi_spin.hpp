@@ -0,0 +1,30 @@
+#ifndef TEST_DETAILS_METROPOLIS_MULTI_SPIN_HPP
+#define TEST_DETAILS_METROPOLIS_MULTI_SPIN_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/details/metropolis/multi_spin.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+using namespace Mocasinns;
+
+class TestMultiSpin : CppUnit::TestFixture
+{
+private:
+  Random::Boost_MT19937* test_rng;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_threshold_mask_limits();
+  void test_threshold_mask_probability();
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "test_precision_monitor.hpp"
+
+#include <cmath>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+
+CppUnit::Test* TestPrecisionMonitor::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestPrecisionMonitor");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestPrecisionMonitor>("TestPrecisionMonitor: test_autocorrelation_time", &TestPrecisionMonitor::test_autocorrelation_time) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestPrecisionMonitor>("TestPrecisionMonitor: test_standard_error", &TestPrecisionMonitor::test_standard_error) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestPrecisionMonitor>("TestPrecisionMonitor: test_designated_observable", &TestPrecisionMonitor::test_designated_observable) );
+
+  return suite_of_tests;
+}
+
+void TestPrecisionMonitor::setUp()
+{
+  // AR(1) process x_{i+1} = 0.9 x_i + noise with tau_int = (1 + 0.9)/(2 (1 - 0.9)) = 9.5 and unit variance of the noise
+  boost::random::mt19937 rng(42);
+  boost::random::normal_distribution<double> noise;
+  double x = 0.0;
+  for (unsigned int i = 0; i < (1u << 20); ++i)
+  {
+    x = 0.9*x + noise(rng);
+    test_series.push_back(x);
+  }
+}
+
+void TestPrecisionMonitor::tearDown()
+{
+  test_series.clear();
+}
+
+void TestPrecisionMonitor::test_autocorrelation_time()
+{
+  Details::Metropolis::AutocorrelationEstimator estimator;
+  CPPUNIT_ASSERT(!estimator.is_available());
+  CPPUNIT_ASSERT_EQUAL(0.0, estimator.get_autocorrelation_time());
+
+  for (unsigned int i = 0; i < test_series.size(); ++i)
+    estimator.add(test_series[i]);
+  CPPUNIT_ASSERT_EQUAL(test_series.size(), estimator.get_sample_number());
+  CPPUNIT_ASSERT(estimator.is_available());
+  CPPUNIT_ASSERT(estimator.is_converged());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(9.5, estimator.get_autocorrelation_time(), 1.5);
+
+  // A constant time series has the minimal autocorrelation time
+  Details::Metropolis::AutocorrelationEstimator constant_estimator;
+  for (unsigned int i = 0; i < 1000; ++i)
+    constant_estimator.add(3);
+  CPPUNIT_ASSERT_EQUAL(0.5, constant_estimator.get_autocorrelation_time());
+}
+
+void TestPrecisionMonitor::test_standard_error()
+{
+  // The variance of the AR(1) process is 1/(1 - 0.81), the standard error of the mean sqrt(2 tau_int variance / N)
+  const double expected_error = std::sqrt(2.0 * 9.5 / 0.19 / test_series.size());
+
+  Details::Metropolis::PrecisionMonitor monitor;
+  for (unsigned int i = 0; i < 1000; ++i)
+    monitor.add(test_series[i]);
+  // The binning analysis has not converged for 1000 samples, the target is not reached for any error
+  CPPUNIT_ASSERT(!monitor.is_reached(1e6));
+
+  for (unsigned int i = 1000; i < test_series.size(); ++i)
+    monitor.add(test_series[i]);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(expected_error, monitor.get_standard_error(), 0.2*expected_error);
+  CPPUNIT_ASSERT(monitor.is_reached(2.0*expected_error));
+  CPPUNIT_ASSERT(!monitor.is_reached(0.5*expected_error));
+
+  monitor.clear();
+  CPPUNIT_ASSERT(!monitor.is_available());
+  CPPUNIT_ASSERT_EQUAL(0.0, monitor.get_standard_error());
+}
+
+void TestPrecisionMonitor::test_designated_observable()
+{
+  // The first component of a tuple of observables is monitored
+  Details::Metropolis::PrecisionMonitor tuple_monitor;
+  Details::Metropolis::PrecisionMonitor scalar_monitor;
+  for (unsigned int i = 0; i < 10000; ++i)
+  {
+    tuple_monitor.add(Observables::TupleObservable<double, int>(test_series[i], 1));
+    scalar_monitor.add(test_series[i]);
+  }
+  CPPUNIT_ASSERT_EQUAL(scalar_monitor.get_standard_error(), tuple_monitor.get_standard_error());
+
+  // Observables that are not arithmetic are ignored
+  Details::Metropolis::PrecisionMonitor vector_monitor;
+  for (unsigned int i = 0; i < 10000; ++i)
+    vector_monitor.add(std::vector<double>(2, test_series[i]));
+  CPPUNIT_ASSERT(!vector_monitor.is_available());
+  CPPUNIT_ASSERT(!vector_monitor.is_reached(1e6));
+}
@@ -0,0 +1,33 @@
+#ifndef TEST_DETAILS_METROPOLIS_PRECISION_MONITOR_HPP
+#define TEST_DETAILS_METROPOLIS_PRECISION_MONITOR_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+#include <mocasinns/details/metropolis/precision_monitor.hpp>
+
+using namespace Mocasinns;
+
+class TestPrecisionMonitor : CppUnit::TestFixture
+{
+private:
+  //! Autoregressive time series with known autocorrelation time
+  std::vector<double> test_series;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_autocorrelation_time();
+  void test_standard_error();
+  void test_designated_observable();
+};
+
+#endif
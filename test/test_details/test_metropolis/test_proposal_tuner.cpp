@@ -0,0 +1,117 @@
+#include "test_proposal_tuner.hpp"
+
+#include <cstddef>
+
+//! Configuration with a proposal width for two step types, the width of type 1 is restricted to 1.0
+struct TestWidthConfiguration
+{
+  double widths[2];
+
+  TestWidthConfiguration() { widths[0] = 0.1; widths[1] = 0.1; }
+
+  double get_proposal_width(std::size_t step_type) { return widths[step_type]; }
+  void set_proposal_width(std::size_t step_type, double width) { widths[step_type] = (step_type == 1 && width > 1.0) ? 1.0 : width; }
+};
+
+//! Configuration without proposal widths
+struct TestFixedConfiguration { };
+
+//! Record the given number of proposed and accepted steps of a type
+void record_steps(Statistics::AcceptanceStatistics& statistics, std::size_t step_type, unsigned int proposed, unsigned int accepted)
+{
+  for (unsigned int i = 0; i < proposed; ++i)
+    statistics.record(0, step_type, i < accepted);
+}
+
+CppUnit::Test* TestProposalTuner::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestProposalTuner");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestProposalTuner>("TestProposalTuner: test_update", &TestProposalTuner::test_update) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestProposalTuner>("TestProposalTuner: test_restricted_width", &TestProposalTuner::test_restricted_width) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestProposalTuner>("TestProposalTuner: test_apply", &TestProposalTuner::test_apply) );
+
+  return suite_of_tests;
+}
+
+void TestProposalTuner::setUp() { }
+void TestProposalTuner::tearDown() { }
+
+void TestProposalTuner::test_update()
+{
+  Statistics::AcceptanceStatistics statistics;
+  TestWidthConfiguration configuration;
+  Details::Metropolis::ProposalTuner tuner;
+
+  // Steps recorded before the start are not considered
+  record_steps(statistics, 0, 1000, 0);
+  tuner.start(statistics, 100);
+  CPPUNIT_ASSERT(!tuner.is_tuned());
+
+  // Too few proposed steps of both types
+  record_steps(statistics, 0, 50, 40);
+  record_steps(statistics, 1, 50, 10);
+  tuner.update(statistics, configuration, 0.4);
+  CPPUNIT_ASSERT_EQUAL(0.1, configuration.widths[0]);
+  CPPUNIT_ASSERT_EQUAL(0.1, configuration.widths[1]);
+
+  // Type 0 has enough steps with an acceptance rate of 0.6, the width is increased by 0.6/0.4
+  record_steps(statistics, 0, 50, 20);
+  tuner.update(statistics, configuration, 0.4);
+  CPPUNIT_ASSERT(tuner.is_tuned());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.6, tuner.get_acceptance_rate(0), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.15, configuration.widths[0], 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.15, tuner.get_proposal_width(0), 1e-12);
+  CPPUNIT_ASSERT_EQUAL(0.1, configuration.widths[1]);
+  CPPUNIT_ASSERT_EQUAL(0.0, tuner.get_proposal_width(1));
+
+  // Type 1 rejects almost all steps, the width is at most halved
+  record_steps(statistics, 1, 50, 0);
+  tuner.update(statistics, configuration, 0.4);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1, tuner.get_acceptance_rate(1), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.05, configuration.widths[1], 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.15, configuration.widths[0], 1e-12);
+}
+
+void TestProposalTuner::test_restricted_width()
+{
+  Statistics::AcceptanceStatistics statistics;
+  TestWidthConfiguration configuration;
+  Details::Metropolis::ProposalTuner tuner;
+  tuner.start(statistics, 100);
+
+  // All steps are accepted, the width grows at most by a factor 2 per adaption until the configuration restricts it
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    record_steps(statistics, 1, 100, 100);
+    tuner.update(statistics, configuration, 0.4);
+  }
+  CPPUNIT_ASSERT_EQUAL(1.0, configuration.widths[1]);
+  CPPUNIT_ASSERT_EQUAL(1.0, tuner.get_proposal_width(1));
+}
+
+void TestProposalTuner::test_apply()
+{
+  Statistics::AcceptanceStatistics statistics;
+  TestWidthConfiguration configuration;
+  Details::Metropolis::ProposalTuner tuner;
+  tuner.start(statistics, 100);
+  record_steps(statistics, 0, 100, 80);
+  tuner.update(statistics, configuration, 0.4);
+
+  // Only the tuned widths are applied to another configuration
+  TestWidthConfiguration other_configuration;
+  other_configuration.widths[1] = 0.7;
+  tuner.apply(other_configuration);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, other_configuration.widths[0], 1e-12);
+  CPPUNIT_ASSERT_EQUAL(0.7, other_configuration.widths[1]);
+
+  // Configurations without proposal widths are not changed
+  TestFixedConfiguration fixed_configuration;
+  record_steps(statistics, 0, 100, 100);
+  tuner.update(statistics, fixed_configuration, 0.4);
+  tuner.apply(fixed_configuration);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, tuner.get_proposal_width(0), 1e-12);
+
+  tuner.clear();
+  CPPUNIT_ASSERT(!tuner.is_tuned());
+}
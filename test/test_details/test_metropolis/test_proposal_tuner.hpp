@@ -0,0 +1,27 @@
+#ifndef TEST_DETAILS_METROPOLIS_PROPOSAL_TUNER_HPP
+#define TEST_DETAILS_METROPOLIS_PROPOSAL_TUNER_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/details/metropolis/proposal_tuner.hpp>
+
+using namespace Mocasinns;
+
+class TestProposalTuner : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_update();
+  void test_restricted_width();
+  void test_apply();
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "test_rate_tree.hpp"
+
+CppUnit::Test* TestRateTree::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestRateTree");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestRateTree>("TestRateTree: test_total", &TestRateTree::test_total) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestRateTree>("TestRateTree: test_find", &TestRateTree::test_find) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestRateTree>("TestRateTree: test_set_rate", &TestRateTree::test_set_rate) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestRateTree>("TestRateTree: test_reliable_total", &TestRateTree::test_reliable_total) );
+
+  return suite_of_tests;
+}
+
+void TestRateTree::setUp()
+{
+  // Rates 1.0, 0.0, 0.5, 0.25, 0.0
+  test_tree = new Details::RejectionFree::RateTree();
+  test_tree->assign(5);
+  test_tree->set_rate_lazy(0, 1.0);
+  test_tree->set_rate_lazy(2, 0.5);
+  test_tree->set_rate_lazy(3, 0.25);
+  test_tree->rebuild();
+}
+
+void TestRateTree::tearDown()
+{
+  delete test_tree;
+}
+
+void TestRateTree::test_total()
+{
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(5), test_tree->size());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.75, test_tree->total(), 1e-12);
+}
+
+void TestRateTree::test_find()
+{
+  // Entries with vanishing rates must never be selected
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), test_tree->find(0.0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), test_tree->find(0.99));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), test_tree->find(1.0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), test_tree->find(1.49));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), test_tree->find(1.5));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), test_tree->find(1.74));
+  // Values beyond the total rate select the last entry
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(4), test_tree->find(2.0));
+}
+
+void TestRateTree::test_set_rate()
+{
+  test_tree->set_rate(1, 2.0);
+  test_tree->set_rate(0, 0.0);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(2.75, test_tree->total(), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, test_tree->get_rate(1), 1e-12);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_tree->find(0.0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), test_tree->find(2.0));
+
+  // Many updates trigger a rebuild and must keep the partial sums consistent
+  for (unsigned int i = 0; i < 100; ++i)
+    test_tree->set_rate(i % 5, 0.1 * (i % 7));
+  double total = 0.0;
+  for (std::size_t i = 0; i < test_tree->size(); ++i)
+    total += test_tree->get_rate(i);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(total, test_tree->total(), 1e-12);
+}
+
+void TestRateTree::test_reliable_total()
+{
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.75, test_tree->reliable_total(), 1e-12);
+
+  // Setting all rates to zero may leave a rounding error in the incremental total, which must not be taken as a positive rate
+  for (unsigned int i = 0; i < 7; ++i)
+    test_tree->set_rate(i % 5, 0.1 * (i + 1));
+  for (std::size_t i = 0; i < test_tree->size(); ++i)
+    test_tree->set_rate(i, 0.0);
+  CPPUNIT_ASSERT_EQUAL(0.0, test_tree->reliable_total());
+}
@@ -0,0 +1,31 @@
+#ifndef TEST_DETAILS_REJECTION_FREE_RATE_TREE_HPP
+#define TEST_DETAILS_REJECTION_FREE_RATE_TREE_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/details/rejection_free/rate_tree.hpp>
+
+using namespace Mocasinns;
+
+class TestRateTree : CppUnit::TestFixture
+{
+private:
+  Details::RejectionFree::RateTree* test_tree;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_total();
+  void test_find();
+  void test_set_rate();
+  void test_reliable_total();
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "test_step_classes.hpp"
+
+#include <boost/static_assert.hpp>
+
+CppUnit::Test* TestStepClasses::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestStepClasses");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestStepClasses>("TestStepClasses: test_set_class", &TestStepClasses::test_set_class) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestStepClasses>("TestStepClasses: test_use_step_classes", &TestStepClasses::test_use_step_classes) );
+
+  return suite_of_tests;
+}
+
+void TestStepClasses::setUp()
+{
+  // Five steps with energy differences -4, 0, 4, 0, 4
+  test_classes = new Details::RejectionFree::StepClasses<int>();
+  test_classes->assign(5);
+  test_classes->set_class(0, -4);
+  test_classes->set_class(1, 0);
+  test_classes->set_class(2, 4);
+  test_classes->set_class(3, 0);
+  test_classes->set_class(4, 4);
+}
+
+void TestStepClasses::tearDown()
+{
+  delete test_classes;
+}
+
+void TestStepClasses::test_set_class()
+{
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), test_classes->size());
+  CPPUNIT_ASSERT_EQUAL(-4, test_classes->key(0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_classes->class_size(0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), test_classes->class_size(1));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), test_classes->class_size(2));
+
+  // Move the first member of a class, the last member takes its position
+  test_classes->set_class(1, -4);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), test_classes->class_size(0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_classes->class_size(1));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), test_classes->member(1, 0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_classes->member(0, 1));
+
+  // Create a new class and empty an old one
+  test_classes->set_class(3, 8);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(4), test_classes->size());
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), test_classes->class_size(1));
+  CPPUNIT_ASSERT_EQUAL(8, test_classes->key(3));
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), test_classes->member(3, 0));
+
+  // Setting the same class again changes nothing
+  test_classes->set_class(3, 8);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_classes->class_size(3));
+}
+
+// Create different step classes
+class IntegralStep { public: int delta_E() const { return 0; } };
+class FloatingPointStep { public: double delta_E() const { return 0.0; } };
+class IntegralStepWithSelectionProbabilityFactor { public: int delta_E() const { return 0; } double selection_probability_factor() { return 2.0; } };
+
+void TestStepClasses::test_use_step_classes()
+{
+  BOOST_STATIC_ASSERT_MSG(Details::RejectionFree::use_step_classes<IntegralStep>::value == true,
+			  "use_step_classes is false for integral energy differences");
+  BOOST_STATIC_ASSERT_MSG(Details::RejectionFree::use_step_classes<FloatingPointStep>::value == false,
+			  "use_step_classes is true for floating point energy differences");
+  BOOST_STATIC_ASSERT_MSG(Details::RejectionFree::use_step_classes<IntegralStepWithSelectionProbabilityFactor>::value == false,
+			  "use_step_classes is true for steps with selection probability factor");
+}
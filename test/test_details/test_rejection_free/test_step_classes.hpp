@@ -0,0 +1,29 @@
+#ifndef TEST_DETAILS_REJECTION_FREE_STEP_CLASSES_HPP
+#define TEST_DETAILS_REJECTION_FREE_STEP_CLASSES_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/details/rejection_free/step_classes.hpp>
+
+using namespace Mocasinns;
+
+class TestStepClasses : CppUnit::TestFixture
+{
+private:
+  Details::RejectionFree::StepClasses<int>* test_classes;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_set_class();
+  void test_use_step_classes();
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "test_kinetic_monte_carlo.hpp"
+
+#include <cmath>
+
+CppUnit::Test* TestKineticMonteCarlo::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestKineticMonteCarlo");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestKineticMonteCarlo>("TestKineticMonteCarlo: test_do_kinetic_steps", &TestKineticMonteCarlo::test_do_kinetic_steps) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestKineticMonteCarlo>("TestKineticMonteCarlo: test_do_kinetic_time", &TestKineticMonteCarlo::test_do_kinetic_time) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestKineticMonteCarlo>("TestKineticMonteCarlo: test_do_kinetic_monte_carlo_simulation", &TestKineticMonteCarlo::test_do_kinetic_monte_carlo_simulation) );
+
+  return suite_of_tests;
+}
+
+void TestKineticMonteCarlo::setUp()
+{
+  // Sites that are occupied with rate 1 and emptied with rate 3, the stationary occupation is 1/4
+  TwoStateSimulation::Parameters parameters;
+  parameters.relaxation_time = 5.0;
+  parameters.measurement_number = 200;
+  parameters.time_between_measurement = 0.5;
+  test_configuration = new TwoStateConfiguration(1000, 1.0, 3.0);
+  test_simulation = new TwoStateSimulation(parameters, test_configuration);
+
+  TwoStateSimulationIncremental::Parameters parameters_incremental;
+  parameters_incremental.relaxation_time = 5.0;
+  parameters_incremental.measurement_number = 200;
+  parameters_incremental.time_between_measurement = 0.5;
+  test_configuration_incremental = new TwoStateConfigurationIncremental(1000, 1.0, 3.0);
+  test_simulation_incremental = new TwoStateSimulationIncremental(parameters_incremental, test_configuration_incremental);
+}
+
+void TestKineticMonteCarlo::tearDown()
+{
+  delete test_simulation;
+  delete test_configuration;
+  delete test_simulation_incremental;
+  delete test_configuration_incremental;
+}
+
+void TestKineticMonteCarlo::test_do_kinetic_steps()
+{
+  // Sites that are never emptied again: every site is occupied once, then the total rate vanishes
+  TwoStateConfigurationIncremental configuration(100, 2.0, 0.0);
+  TwoStateSimulationIncremental simulation(TwoStateSimulationIncremental::Parameters(), &configuration);
+  CPPUNIT_ASSERT_EQUAL(static_cast<TwoStateSimulationIncremental::step_number_t>(100), simulation.do_kinetic_steps(1000));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, configuration.energy(), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, simulation.get_total_rate(), 1e-12);
+  CPPUNIT_ASSERT(simulation.get_physical_time() > 0.0);
+
+  // Rates that are not representable exactly leave a rounding error in the incrementally updated total rate, no event with vanishing rate may be executed
+  TwoStateConfigurationIncremental configuration_rounding(100, 0.1, 0.0);
+  TwoStateSimulationIncremental simulation_rounding(TwoStateSimulationIncremental::Parameters(), &configuration_rounding);
+  CPPUNIT_ASSERT_EQUAL(static_cast<TwoStateSimulationIncremental::step_number_t>(100), simulation_rounding.do_kinetic_steps(1000));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, configuration_rounding.energy(), 1e-12);
+
+  // The time until all sites are occupied is the maximum of 100 exponential times, its mean is H_100/2 ~ 2.59
+  double physical_time = 0.0;
+  for (unsigned int run = 0; run < 200; ++run)
+  {
+    TwoStateConfiguration configuration_run(100, 2.0, 0.0);
+    TwoStateSimulation simulation_run(TwoStateSimulation::Parameters(), &configuration_run);
+    simulation_run.set_random_seed(run);
+    CPPUNIT_ASSERT_EQUAL(static_cast<TwoStateSimulation::step_number_t>(100), simulation_run.do_kinetic_steps(1000));
+    physical_time += simulation_run.get_physical_time() / 200;
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5937, physical_time, 0.15);
+}
+
+void TestKineticMonteCarlo::test_do_kinetic_time()
+{
+  // The clock ends exactly at the end of the duration
+  test_simulation_incremental->do_kinetic_time(0.1);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1, test_simulation_incremental->get_physical_time(), 1e-12);
+  test_simulation_incremental->do_kinetic_time(0.4);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, test_simulation_incremental->get_physical_time(), 1e-12);
+
+  // Occupation p(t) = 1/4 (1 - exp(-4t)) of sites that are empty at t = 0
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25*(1.0 - exp(-2.0)), test_configuration_incremental->energy(), 0.05);
+
+  // The clock also advances in the absorbing state
+  TwoStateConfiguration configuration_absorbing(10, 0.0, 1.0);
+  TwoStateSimulation simulation_absorbing(TwoStateSimulation::Parameters(), &configuration_absorbing);
+  simulation_absorbing.do_kinetic_time(2.0);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, simulation_absorbing.get_physical_time(), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, configuration_absorbing.energy(), 1e-12);
+}
+
+void TestKineticMonteCarlo::test_do_kinetic_monte_carlo_simulation()
+{
+  // Full recalculation of the rates
+  std::vector<double> occupations = test_simulation->do_kinetic_monte_carlo_simulation<TwoStateSimulation::DefaultObservator>();
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(200), occupations.size());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(105.0, test_simulation->get_physical_time(), 1e-9);
+  double mean_occupation = 0.0;
+  for (std::size_t m = 0; m < occupations.size(); ++m) mean_occupation += occupations[m] / occupations.size();
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25, mean_occupation, 0.01);
+
+  // Incremental update of the rates
+  std::vector<double> occupations_incremental = test_simulation_incremental->do_kinetic_monte_carlo_simulation<TwoStateSimulationIncremental::DefaultObservator>();
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(200), occupations_incremental.size());
+  mean_occupation = 0.0;
+  for (std::size_t m = 0; m < occupations_incremental.size(); ++m) mean_occupation += occupations_incremental[m] / occupations_incremental.size();
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25, mean_occupation, 0.01);
+}
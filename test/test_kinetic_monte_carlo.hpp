@@ -0,0 +1,94 @@
+#ifndef TEST_KINETIC_MONTE_CARLO_HPP
+#define TEST_KINETIC_MONTE_CARLO_HPP
+
+#include <vector>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/kinetic_monte_carlo.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+using namespace Mocasinns;
+
+class TwoStateConfiguration;
+
+// Event switching a single site of independent two state sites
+class TwoStateStep
+{
+public:
+  TwoStateConfiguration* configuration;
+  std::size_t site;
+
+  TwoStateStep() : configuration(0), site(0) {}
+  TwoStateStep(TwoStateConfiguration* config, std::size_t index) : configuration(config), site(index) {}
+
+  double rate();
+  void execute();
+};
+
+// Independent sites that are occupied with rate rate_up and emptied with rate rate_down
+class TwoStateConfiguration
+{
+public:
+  std::vector<int> occupation;
+  double rate_up;
+  double rate_down;
+
+  TwoStateConfiguration() : occupation(), rate_up(0.0), rate_down(0.0) {}
+  TwoStateConfiguration(std::size_t site_number, double up, double down) : occupation(site_number, 0), rate_up(up), rate_down(down) {}
+
+  void all_steps(std::vector<TwoStateStep>& steps)
+  {
+    steps.clear();
+    for (std::size_t i = 0; i < occupation.size(); ++i) steps.push_back(TwoStateStep(this, i));
+  }
+
+  // Fraction of occupied sites
+  double energy() const
+  {
+    double result = 0.0;
+    for (std::size_t i = 0; i < occupation.size(); ++i) result += occupation[i];
+    return result / occupation.size();
+  }
+};
+
+// Same configuration reporting the events affected by an executed event
+class TwoStateConfigurationIncremental : public TwoStateConfiguration
+{
+public:
+  TwoStateConfigurationIncremental(std::size_t site_number, double up, double down) : TwoStateConfiguration(site_number, up, down) {}
+
+  void all_steps(std::vector<TwoStateStep>& steps) { TwoStateConfiguration::all_steps(steps); }
+  void affected_steps(TwoStateStep& executed_step, std::vector<std::size_t>& indices) { indices.push_back(executed_step.site); }
+};
+
+inline double TwoStateStep::rate() { return (configuration->occupation[site] == 0 ? configuration->rate_up : configuration->rate_down); }
+inline void TwoStateStep::execute() { configuration->occupation[site] = 1 - configuration->occupation[site]; }
+
+typedef KineticMonteCarlo<TwoStateConfiguration, TwoStateStep, Random::Boost_MT19937, Hooks::NoHooks> TwoStateSimulation;
+typedef KineticMonteCarlo<TwoStateConfigurationIncremental, TwoStateStep, Random::Boost_MT19937, Hooks::NoHooks> TwoStateSimulationIncremental;
+
+class TestKineticMonteCarlo : CppUnit::TestFixture
+{
+private:
+  TwoStateConfiguration* test_configuration;
+  TwoStateSimulation* test_simulation;
+  TwoStateConfigurationIncremental* test_configuration_incremental;
+  TwoStateSimulationIncremental* test_simulation_incremental;
+
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_do_kinetic_steps();
+  void test_do_kinetic_time();
+  void test_do_kinetic_monte_carlo_simulation();
+};
+
+#endif
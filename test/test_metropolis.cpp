@@ -33,11 +33,75 @@ public:
   }
 };
 
+//! Hook policy counting the measurements
+struct TestMetropolis::CountMeasurementsHooks : public Hooks::NoHooks
+{
+  unsigned int measurement_count;
+  CountMeasurementsHooks() : measurement_count(0) {}
+  template <class SimulationType> void measurement(SimulationType*) { ++measurement_count; }
+};
+
+//! Lattice proposing the steps in blocks
+class TestMetropolis::BatchedConfigurationType : public ConfigurationType
+{
+public:
+  BatchedConfigurationType() : ConfigurationType() {}
+  BatchedConfigurationType(const std::vector<unsigned int>& size) : ConfigurationType(size) {}
+  template <class RandomNumberGenerator> void propose_steps(RandomNumberGenerator* rng, std::vector<StepType>& steps)
+  {
+    for (unsigned int s = 0; s < steps.size(); ++s) steps[s] = propose_step(rng);
+  }
+};
+
+//! Lattice counting the visits of the sites by the sweep
+class TestMetropolis::SweepCountingLattice : public IsingLattice2d
+{
+public:
+  std::vector<unsigned int> visits;
+  SweepCountingLattice(std::size_t length_x, std::size_t length_y) : IsingLattice2d(length_x, length_y), visits(length_x * length_y, 0) {}
+  std::size_t sweep_length() { return spins.size(); }
+  template <class RandomNumberGenerator> IsingLattice2dStep propose_sweep_step(std::size_t position, RandomNumberGenerator* rng)
+  {
+    ++visits[position];
+    return IsingLattice2d::propose_sweep_step(position, rng);
+  }
+};
+
+//! Lattice proposing blocks of steps with the random numbers of single proposed steps
+class TestMetropolis::BatchedIsingLattice2d : public IsingLattice2d
+{
+public:
+  BatchedIsingLattice2d(std::size_t length_x, std::size_t length_y) : IsingLattice2d(length_x, length_y) {}
+  template <class RandomNumberGenerator> void propose_steps(RandomNumberGenerator* rng, std::vector<IsingLattice2dStep>& steps)
+  {
+    for (std::size_t s = 0; s < steps.size(); ++s) steps[s] = propose_step(rng);
+  }
+};
+
+//! Slot counting the calls of a signal handler
+struct CountSignals
+{
+  unsigned int* count;
+  CountSignals(unsigned int* counter) : count(counter) {}
+  template <class SimulationType> void operator()(SimulationType*) { ++(*count); }
+};
+
 CppUnit::Test* TestMetropolis::suite()
 {
   CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestMetropolis");
   suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_do_metropolis_steps", &TestMetropolis::test_do_metropolis_steps) );
   suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_do_metropolis_simulation", &TestMetropolis::test_do_metropolis_simulation) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_hooks", &TestMetropolis::test_hooks) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_track_energy", &TestMetropolis::test_track_energy) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_pipelined_measurements", &TestMetropolis::test_pipelined_measurements) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_time_budget", &TestMetropolis::test_time_budget) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_adaptive_relaxation", &TestMetropolis::test_adaptive_relaxation) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_adaptive_measurement_spacing", &TestMetropolis::test_adaptive_measurement_spacing) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_target_error", &TestMetropolis::test_target_error) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_batched_proposal", &TestMetropolis::test_batched_proposal) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_sequential_sweep", &TestMetropolis::test_sequential_sweep) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_sublattice_steps", &TestMetropolis::test_sublattice_steps) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolis>("TestMetropolis: test_speculative_steps", &TestMetropolis::test_speculative_steps) );
     
   return suite_of_tests;
 }
@@ -105,3 +169,352 @@ void TestMetropolis::test_do_metropolis_simulation()
   // Test the results
   CPPUNIT_ASSERT_DOUBLES_EQUAL(ba::mean(acc), sum/result_vector.size(), 0.15);
 }
+
+void TestMetropolis::test_hooks()
+{
+  SimulationType::Parameters hooks_parameters;
+  hooks_parameters.relaxation_steps = 100;
+  hooks_parameters.measurement_number = 50;
+  hooks_parameters.steps_between_measurement = 10;
+
+  // The default hook policy invokes the signal handler at every measurement
+  unsigned int signal_count = 0;
+  test_simulation->set_parameters(hooks_parameters);
+  test_simulation->signal_handler_measurement.connect(CountSignals(&signal_count));
+  test_simulation->do_metropolis_simulation(0.0);
+  CPPUNIT_ASSERT_EQUAL(50u, signal_count);
+
+  // An own hook policy is invoked instead of the signal handler
+  typedef Metropolis<ConfigurationType, StepType, Random::Boost_MT19937, false, CountMeasurementsHooks> HooksSimulationType;
+  HooksSimulationType::Parameters hooks_simulation_parameters;
+  hooks_simulation_parameters.relaxation_steps = 100;
+  hooks_simulation_parameters.measurement_number = 50;
+  hooks_simulation_parameters.steps_between_measurement = 10;
+  HooksSimulationType hooks_simulation(hooks_simulation_parameters, test_config_space);
+  unsigned int hooks_signal_count = 0;
+  hooks_simulation.signal_handler_measurement.connect(CountSignals(&hooks_signal_count));
+  hooks_simulation.do_metropolis_simulation(0.0);
+  CPPUNIT_ASSERT_EQUAL(50u, hooks_simulation.get_hooks().measurement_count);
+  CPPUNIT_ASSERT_EQUAL(0u, hooks_signal_count);
+}
+
+void TestMetropolis::test_track_energy()
+{
+  SimulationType::Parameters tracking_parameters;
+  tracking_parameters.relaxation_steps = 1000;
+  tracking_parameters.measurement_number = 100;
+  tracking_parameters.steps_between_measurement = 100;
+
+  // Create a second simulation with the same seed that tracks the energy
+  std::vector<unsigned int> size_2d;
+  size_2d.push_back(4); size_2d.push_back(4);
+  ConfigurationType test_config_tracking(size_2d);
+  tracking_parameters.track_energy = true;
+  SimulationType test_simulation_tracking(tracking_parameters, &test_config_tracking);
+  tracking_parameters.track_energy = false;
+  test_simulation->set_parameters(tracking_parameters);
+  test_simulation->set_random_seed(1);
+  test_simulation_tracking.set_random_seed(1);
+
+  // Both simulations must take the same steps and measure the same energies
+  std::vector<double> energies = test_simulation->do_metropolis_simulation(0.3);
+  std::vector<double> energies_tracking = test_simulation_tracking.do_metropolis_simulation(0.3);
+  CPPUNIT_ASSERT(energies == energies_tracking);
+  CPPUNIT_ASSERT_EQUAL(test_config_tracking.energy(), test_simulation_tracking.get_energy());
+
+  // Setting a new configuration invalidates the tracked energy
+  test_simulation_tracking.set_config_space(test_config_space);
+  CPPUNIT_ASSERT_EQUAL(test_config_space->energy(), test_simulation_tracking.get_energy());
+}
+
+void TestMetropolis::test_pipelined_measurements()
+{
+  SimulationType::Parameters pipelined_parameters;
+  pipelined_parameters.relaxation_steps = 1000;
+  pipelined_parameters.measurement_number = 200;
+  pipelined_parameters.steps_between_measurement = 100;
+
+  // Create a second simulation with the same seed that observes the snapshots in three threads with two buffers
+  std::vector<unsigned int> size_2d;
+  size_2d.push_back(4); size_2d.push_back(4);
+  ConfigurationType test_config_pipelined(size_2d);
+  pipelined_parameters.measurement_thread_number = 3;
+  pipelined_parameters.measurement_buffer_number = 2;
+  SimulationType test_simulation_pipelined(pipelined_parameters, &test_config_pipelined);
+  pipelined_parameters.measurement_thread_number = 0;
+  test_simulation->set_parameters(pipelined_parameters);
+  test_simulation->set_random_seed(1);
+  test_simulation_pipelined.set_random_seed(1);
+
+  // The measurements must be accumulated in the same order
+  std::vector<Observables::VectorObservable<double> > measurements = test_simulation->do_metropolis_simulation<ObserveIsingEnergyMagnetization>(0.3);
+  std::vector<Observables::VectorObservable<double> > measurements_pipelined = test_simulation_pipelined.do_metropolis_simulation<ObserveIsingEnergyMagnetization>(0.3);
+  CPPUNIT_ASSERT_EQUAL(measurements.size(), measurements_pipelined.size());
+  for (unsigned int m = 0; m < measurements.size(); ++m)
+  {
+    CPPUNIT_ASSERT_EQUAL(measurements[m][0], measurements_pipelined[m][0]);
+    CPPUNIT_ASSERT_EQUAL(measurements[m][1], measurements_pipelined[m][1]);
+  }
+  CPPUNIT_ASSERT(*test_config_space == test_config_pipelined);
+}
+
+void TestMetropolis::test_time_budget()
+{
+  SimulationType::Parameters budget_parameters;
+  budget_parameters.relaxation_steps = 1000;
+  budget_parameters.measurement_number = 50;
+  budget_parameters.steps_between_measurement = 100;
+  test_simulation->set_parameters(budget_parameters);
+
+  // A sufficient time budget does not stop the simulation
+  test_simulation->set_time_budget(3600.0);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(50), test_simulation->do_metropolis_simulation(0.3).size());
+  CPPUNIT_ASSERT(!test_simulation->get_is_terminating());
+  CPPUNIT_ASSERT(test_simulation->get_time_budget_remaining() > 0.0);
+
+  // An exhausted time budget stops the simulation after the first measurement and writes a checkpoint
+  test_simulation->set_dump_filename("checkpoint_test.dat");
+  test_simulation->set_time_budget(1e-9);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_simulation->do_metropolis_simulation(0.3).size());
+  CPPUNIT_ASSERT(test_simulation->get_is_terminating());
+  CPPUNIT_ASSERT(test_simulation->get_time_budget_exhausted());
+
+  // The resumed simulation takes the remaining measurements
+  std::vector<unsigned int> size_2d;
+  size_2d.push_back(4); size_2d.push_back(4);
+  ConfigurationType test_config_resumed(size_2d);
+  SimulationType test_simulation_resumed(budget_parameters, &test_config_resumed);
+  test_simulation_resumed.load_checkpoint("checkpoint_test.dat");
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(49), test_simulation_resumed.do_metropolis_simulation(0.3).size());
+  CPPUNIT_ASSERT(!test_simulation_resumed.get_is_terminating());
+
+  // A simulation that is not resumed starts again with the first measurement
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(50), test_simulation_resumed.do_metropolis_simulation(0.3).size());
+
+  // A checkpoint that cannot be written throws instead of silently leaving no checkpoint
+  CPPUNIT_ASSERT_THROW(test_simulation_resumed.save_checkpoint("non_existing_directory/checkpoint_test.dat"), Mocasinns::Exceptions::CheckpointException);
+}
+
+void TestMetropolis::test_adaptive_relaxation()
+{
+  SimulationType::Parameters relaxation_parameters;
+  relaxation_parameters.relaxation_steps = 1000;
+  relaxation_parameters.measurement_number = 10;
+  test_simulation->set_parameters(relaxation_parameters);
+
+  // Without adaptive relaxation all relaxation steps are performed
+  test_simulation->do_metropolis_simulation(0.3);
+  CPPUNIT_ASSERT_EQUAL(static_cast<SimulationType::step_number_t>(1000), test_simulation->get_relaxation_steps_performed());
+
+  // The adaptive relaxation stops as soon as the energy is stationary, but not before the minimal number of batches is recorded
+  relaxation_parameters.adaptive_relaxation = true;
+  relaxation_parameters.relaxation_steps = 1000000;
+  relaxation_parameters.relaxation_sample_steps = 16;
+  relaxation_parameters.relaxation_batch_size = 5;
+  test_simulation->set_parameters(relaxation_parameters);
+  test_simulation->do_metropolis_simulation(0.3);
+  CPPUNIT_ASSERT(test_simulation->get_relaxation_steps_performed() >= 16*5*16);
+  CPPUNIT_ASSERT(test_simulation->get_relaxation_steps_performed() < 1000000);
+  CPPUNIT_ASSERT_EQUAL(static_cast<SimulationType::step_number_t>(0), test_simulation->get_relaxation_steps_performed() % 16);
+}
+
+void TestMetropolis::test_adaptive_measurement_spacing()
+{
+  SimulationType::Parameters spacing_parameters;
+  spacing_parameters.measurement_number = 500;
+  spacing_parameters.steps_between_measurement = 100000;
+  spacing_parameters.track_energy = true;
+  spacing_parameters.adaptive_measurement_spacing = true;
+  spacing_parameters.autocorrelation_sample_steps = 16;
+  spacing_parameters.minimal_steps_between_measurement = 32;
+  spacing_parameters.maximal_steps_between_measurement = 4096;
+  test_simulation->set_parameters(spacing_parameters);
+
+  // The far too large initial spacing is reduced to a multiple of the sample steps within the bounds
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(500), test_simulation->do_metropolis_simulation(0.3).size());
+  CPPUNIT_ASSERT(test_simulation->get_autocorrelation_time() > 0.0);
+  CPPUNIT_ASSERT(test_simulation->get_steps_between_measurement() >= 32);
+  CPPUNIT_ASSERT(test_simulation->get_steps_between_measurement() <= 4096);
+  CPPUNIT_ASSERT_EQUAL(static_cast<SimulationType::step_number_t>(0), test_simulation->get_steps_between_measurement() % 16);
+
+  // Without adaptive spacing the parameter is used
+  spacing_parameters.adaptive_measurement_spacing = false;
+  test_simulation->set_parameters(spacing_parameters);
+  CPPUNIT_ASSERT_EQUAL(static_cast<SimulationType::step_number_t>(100000), test_simulation->get_steps_between_measurement());
+}
+
+void TestMetropolis::test_target_error()
+{
+  SimulationType::Parameters precision_parameters;
+  precision_parameters.relaxation_steps = 1000;
+  precision_parameters.measurement_number = 1000000;
+  precision_parameters.steps_between_measurement = 100;
+
+  // The step budget stops the measurements
+  precision_parameters.step_budget = 5000;
+  test_simulation->set_parameters(precision_parameters);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(50), test_simulation->do_metropolis_simulation(0.3).size());
+  CPPUNIT_ASSERT_EQUAL(static_cast<SimulationType::step_number_t>(5000), test_simulation->get_measurement_steps_performed());
+  CPPUNIT_ASSERT(!test_simulation->get_is_terminating());
+
+  // A loose target error is reached long before the maximal number of measurements
+  precision_parameters.step_budget = 0;
+  precision_parameters.target_error = 1.0;
+  test_simulation->set_parameters(precision_parameters);
+  const std::size_t measurements = test_simulation->do_metropolis_simulation(0.3).size();
+  CPPUNIT_ASSERT(measurements < 1000000);
+  CPPUNIT_ASSERT(test_simulation->get_standard_error() > 0.0);
+  CPPUNIT_ASSERT(test_simulation->get_standard_error() <= 1.0);
+}
+
+void TestMetropolis::test_batched_proposal()
+{
+  typedef Metropolis<BatchedConfigurationType, StepType, Random::Boost_MT19937> BatchedSimulationType;
+  std::vector<unsigned int> size_2d;
+  size_2d.push_back(4); size_2d.push_back(4);
+
+  // Blocks of a single step take the same steps as the proposal of single steps
+  BatchedConfigurationType test_config_batched(size_2d);
+  BatchedSimulationType test_simulation_batched(BatchedSimulationType::Parameters(), &test_config_batched);
+  test_simulation_batched.set_step_block_size(1);
+  test_simulation->set_random_seed(1);
+  test_simulation_batched.set_random_seed(1);
+  for (unsigned int i = 0; i < 100; ++i)
+  {
+    test_simulation->do_metropolis_steps(100, 0.3);
+    test_simulation_batched.do_metropolis_steps(100, 0.3);
+    CPPUNIT_ASSERT(*test_config_space == test_config_batched);
+  }
+
+  // Larger blocks sample the same distribution
+  test_simulation_batched.set_step_block_size(64);
+  double energy_sum = 0.0;
+  double energy_sum_batched = 0.0;
+  for (unsigned int i = 0; i < 10000; ++i)
+  {
+    test_simulation->do_metropolis_steps(100, 0.3);
+    test_simulation_batched.do_metropolis_steps(100, 0.3);
+    energy_sum += test_config_space->energy();
+    energy_sum_batched += test_config_batched.energy();
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(energy_sum / 10000, energy_sum_batched / 10000, 0.5);
+}
+
+void TestMetropolis::test_sequential_sweep()
+{
+  typedef Metropolis<SweepCountingLattice, IsingLattice2dStep, Random::Boost_MT19937> SweepSimulationType;
+  SweepCountingLattice test_config_sweep(4, 6);
+  SweepSimulationType::Parameters sweep_parameters;
+  sweep_parameters.sequential_sweep = true;
+  SweepSimulationType test_simulation_sweep(sweep_parameters, &test_config_sweep);
+
+  // One sweep visits every site exactly once
+  test_simulation_sweep.do_metropolis_steps(24, 0.3);
+  for (std::size_t site = 0; site < 24; ++site)
+    CPPUNIT_ASSERT_EQUAL(1u, test_config_sweep.visits[site]);
+
+  // A sweep split into several calls continues at the position where the last call stopped
+  test_simulation_sweep.do_metropolis_steps(10, 0.3);
+  test_simulation_sweep.do_metropolis_steps(14, 0.3);
+  for (std::size_t site = 0; site < 24; ++site)
+    CPPUNIT_ASSERT_EQUAL(2u, test_config_sweep.visits[site]);
+}
+
+void TestMetropolis::test_sublattice_steps()
+{
+  typedef Metropolis<IsingLattice2d, IsingLattice2dStep, Random::Boost_MT19937> LatticeSimulationType;
+  LatticeSimulationType::Parameters serial_parameters;
+  LatticeSimulationType::Parameters sublattice_parameters;
+  sublattice_parameters.sublattice_thread_number = 2;
+  sublattice_parameters.track_energy = true;
+
+  // The energy is calculated again after the sublattice steps
+  IsingLattice2d test_config_sublattice(4, 4);
+  LatticeSimulationType test_simulation_sublattice(sublattice_parameters, &test_config_sublattice);
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    test_simulation_sublattice.do_metropolis_steps(32, 0.3);
+    CPPUNIT_ASSERT_EQUAL(test_config_sublattice.energy(), test_simulation_sublattice.get_energy());
+  }
+
+  // The sublattice decomposition samples the same distribution as the serial steps at high and low temperature
+  IsingLattice2d test_config_serial(4, 4);
+  LatticeSimulationType test_simulation_serial(serial_parameters, &test_config_serial);
+  const double betas[] = {0.2, 0.6};
+  for (unsigned int b = 0; b < 2; ++b)
+  {
+    double energy_sum_serial = 0.0;
+    double energy_sum_sublattice = 0.0;
+    for (unsigned int i = 0; i < 10000; ++i)
+    {
+      test_simulation_serial.do_metropolis_steps(32, betas[b]);
+      test_simulation_sublattice.do_metropolis_steps(32, betas[b]);
+      energy_sum_serial += test_config_serial.energy();
+      energy_sum_sublattice += test_config_sublattice.energy();
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(energy_sum_serial / 10000, energy_sum_sublattice / 10000, 0.5);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ising_lattice_2d_mean_energy(4, 4, betas[b]), energy_sum_sublattice / 10000, 0.5);
+  }
+}
+
+void TestMetropolis::test_speculative_steps()
+{
+  typedef Metropolis<BatchedIsingLattice2d, IsingLattice2dStep, Random::Boost_MT19937> BatchedSimulationType;
+  typedef Metropolis<IsingLattice2d, IsingLattice2dStep, Random::Boost_MT19937> LatticeSimulationType;
+  const unsigned int window_size = 16;
+  const double beta = 0.4;
+  LatticeSimulationType::Parameters speculative_parameters;
+  speculative_parameters.speculative_window_size = window_size;
+  speculative_parameters.track_energy = true;
+  LatticeSimulationType::Parameters sequential_parameters;
+  sequential_parameters.track_energy = true;
+
+  // Evaluation of the windows by one and by several threads
+  speculative_parameters.speculative_thread_number = 1;
+  IsingLattice2d test_config_single(6, 6);
+  LatticeSimulationType test_simulation_single(speculative_parameters, &test_config_single);
+  test_simulation_single.set_random_seed(7);
+  speculative_parameters.speculative_thread_number = 4;
+  IsingLattice2d test_config_speculative(6, 6);
+  LatticeSimulationType test_simulation_speculative(speculative_parameters, &test_config_speculative);
+  test_simulation_speculative.set_random_seed(7);
+
+  // Reference chain of Simulation::do_steps proposing blocks of the window size
+  BatchedSimulationType::Parameters batched_parameters;
+  batched_parameters.track_energy = true;
+  BatchedIsingLattice2d test_config_batched(6, 6);
+  BatchedSimulationType test_simulation_batched(batched_parameters, &test_config_batched);
+  test_simulation_batched.set_random_seed(7);
+  test_simulation_batched.set_step_block_size(window_size);
+
+  for (unsigned int i = 0; i < 200; ++i)
+  {
+    test_simulation_single.do_metropolis_steps(5 * window_size, beta);
+    test_simulation_speculative.do_metropolis_steps(5 * window_size, beta);
+    test_simulation_batched.do_metropolis_steps(5 * window_size, beta);
+
+    CPPUNIT_ASSERT(test_config_batched == test_config_speculative);
+    CPPUNIT_ASSERT(test_config_single == test_config_speculative);
+    CPPUNIT_ASSERT_EQUAL(test_simulation_batched.get_energy(), test_simulation_speculative.get_energy());
+    CPPUNIT_ASSERT_EQUAL(test_simulation_single.get_energy(), test_simulation_speculative.get_energy());
+    CPPUNIT_ASSERT_EQUAL(test_config_speculative.energy(), test_simulation_speculative.get_energy());
+  }
+
+  // With a window size of 1 the chain is the one of single proposed steps
+  speculative_parameters.speculative_window_size = 1;
+  IsingLattice2d test_config_window(6, 6);
+  LatticeSimulationType test_simulation_window(speculative_parameters, &test_config_window);
+  test_simulation_window.set_random_seed(7);
+  IsingLattice2d test_config_sequential(6, 6);
+  LatticeSimulationType test_simulation_sequential(sequential_parameters, &test_config_sequential);
+  test_simulation_sequential.set_random_seed(7);
+
+  for (unsigned int i = 0; i < 200; ++i)
+  {
+    test_simulation_window.do_metropolis_steps(50, beta);
+    test_simulation_sequential.do_metropolis_steps(50, beta);
+
+    CPPUNIT_ASSERT(test_config_sequential == test_config_window);
+    CPPUNIT_ASSERT_EQUAL(test_simulation_sequential.get_energy(), test_simulation_window.get_energy());
+  }
+}
@@ -13,6 +13,8 @@
 #include <mocasinns/metropolis.hpp>
 #include <mocasinns/random/boost_random.hpp>
 
+#include "ising_lattice_2d.hpp"
+
 using namespace Mocasinns;
 
 class TestMetropolis : CppUnit::TestFixture
@@ -28,6 +30,10 @@ private:
 
   class ObserveIsingEnergy;
   class ObserveIsingEnergyMagnetization;
+  struct CountMeasurementsHooks;
+  class BatchedConfigurationType;
+  class SweepCountingLattice;
+  class BatchedIsingLattice2d;
 
 public:
   static CppUnit::Test* suite();
@@ -37,6 +43,17 @@ public:
 
   void test_do_metropolis_steps();
   void test_do_metropolis_simulation();
+  void test_hooks();
+  void test_track_energy();
+  void test_pipelined_measurements();
+  void test_time_budget();
+  void test_adaptive_relaxation();
+  void test_adaptive_measurement_spacing();
+  void test_target_error();
+  void test_batched_proposal();
+  void test_sequential_sweep();
+  void test_sublattice_steps();
+  void test_speculative_steps();
 };
 
 #endif
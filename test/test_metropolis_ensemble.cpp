@@ -0,0 +1,70 @@
+#include "test_metropolis_ensemble.hpp"
+
+#include <sstream>
+
+#include <mocasinns/metropolis.hpp>
+
+CppUnit::Test* TestMetropolisEnsemble::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestMetropolisEnsemble");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolisEnsemble>("TestMetropolisEnsemble: test_do_ensemble_steps", &TestMetropolisEnsemble::test_do_ensemble_steps) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolisEnsemble>("TestMetropolisEnsemble: test_serialize_lanes", &TestMetropolisEnsemble::test_serialize_lanes) );
+
+  return suite_of_tests;
+}
+
+void TestMetropolisEnsemble::setUp() {}
+void TestMetropolisEnsemble::tearDown() {}
+
+void TestMetropolisEnsemble::test_do_ensemble_steps()
+{
+  typedef Metropolis<IsingLattice2d, IsingLattice2dStep, Random::Boost_MT19937> SerialSimulation;
+  const std::size_t chain_number = 8;
+  EnsembleIsingLattice2d test_config_ensemble(4, 4, chain_number);
+  EnsembleSimulation test_simulation_ensemble(EnsembleSimulation::Parameters(), &test_config_ensemble);
+  IsingLattice2d test_config_serial(4, 4);
+  SerialSimulation test_simulation_serial(SerialSimulation::Parameters(), &test_config_serial);
+
+  // Every chain samples the same distribution as the serial Metropolis algorithm at high and low temperature
+  const double betas[] = {0.2, 0.6};
+  for (unsigned int b = 0; b < 2; ++b)
+  {
+    double energy_sum_serial = 0.0;
+    std::vector<double> energy_sums_ensemble(chain_number, 0.0);
+    for (unsigned int i = 0; i < 5000; ++i)
+    {
+      test_simulation_serial.do_metropolis_steps(32, betas[b]);
+      test_simulation_ensemble.do_ensemble_steps(32, betas[b]);
+      energy_sum_serial += test_config_serial.energy();
+      for (std::size_t k = 0; k < chain_number; ++k)
+	energy_sums_ensemble[k] += test_config_ensemble.energy(k);
+    }
+    for (std::size_t k = 0; k < chain_number; ++k)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(energy_sum_serial / 5000, energy_sums_ensemble[k] / 5000, 1.0);
+  }
+
+  // The chains are independent
+  bool chains_differ = false;
+  for (std::size_t k = 1; k < chain_number; ++k)
+    for (std::size_t site = 0; site < test_config_ensemble.site_number(); ++site)
+      chains_differ = chains_differ || (test_config_ensemble.spins[site * chain_number] != test_config_ensemble.spins[site * chain_number + k]);
+  CPPUNIT_ASSERT(chains_differ);
+}
+
+void TestMetropolisEnsemble::test_serialize_lanes()
+{
+  EnsembleIsingLattice2d test_config(4, 4, 8);
+  EnsembleSimulation test_simulation(EnsembleSimulation::Parameters(), &test_config);
+  test_simulation.do_ensemble_steps(100, 0.4);
+
+  // A simulation loaded from the serialization continues the same chains
+  std::stringstream serialization;
+  test_simulation.save_serialize(serialization);
+  EnsembleIsingLattice2d test_config_loaded(test_config);
+  EnsembleSimulation test_simulation_loaded(EnsembleSimulation::Parameters(), &test_config_loaded);
+  test_simulation_loaded.load_serialize(serialization);
+
+  test_simulation.do_ensemble_steps(100, 0.4);
+  test_simulation_loaded.do_ensemble_steps(100, 0.4);
+  CPPUNIT_ASSERT(test_config.spins == test_config_loaded.spins);
+}
@@ -0,0 +1,76 @@
+#ifndef TEST_METROPOLIS_ENSEMBLE_HPP
+#define TEST_METROPOLIS_ENSEMBLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/metropolis_ensemble.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+#include "ising_lattice_2d.hpp"
+
+using namespace Mocasinns;
+
+// Ensemble of periodic two-dimensional Ising lattices, the spin of chain k at site i has the index i*chains + k
+class EnsembleIsingLattice2d
+{
+public:
+  typedef int energy_type;
+
+  IsingLattice2d lattice;
+  std::size_t chains;
+  std::vector<int> spins;
+
+  EnsembleIsingLattice2d(std::size_t length_x, std::size_t length_y, std::size_t chain_count)
+    : lattice(length_x, length_y), chains(chain_count), spins(length_x * length_y * chain_count, 1) {}
+
+  std::size_t chain_number() const { return chains; }
+  std::size_t site_number() const { return lattice.spins.size(); }
+
+  void ensemble_delta_E(const std::vector<uint32_t>& sites, std::vector<int>& delta_E) const
+  {
+    delta_E.resize(chains);
+    for (std::size_t k = 0; k < chains; ++k)
+    {
+      int neighbour_sum = 0;
+      for (std::size_t n = 0; n < 4; ++n) neighbour_sum += spins[lattice.neighbour(sites[k], n) * chains + k];
+      delta_E[k] = 2 * spins[sites[k] * chains + k] * neighbour_sum;
+    }
+  }
+  void ensemble_execute(const std::vector<uint32_t>& sites, const std::vector<char>& accepted)
+  {
+    for (std::size_t k = 0; k < chains; ++k)
+      if (accepted[k]) spins[sites[k] * chains + k] *= -1;
+  }
+
+  int energy(std::size_t chain) const
+  {
+    int result = 0;
+    for (std::size_t site = 0; site < site_number(); ++site)
+      result -= spins[site * chains + chain] * (spins[lattice.neighbour(site, 1) * chains + chain] + spins[lattice.neighbour(site, 3) * chains + chain]);
+    return result;
+  }
+};
+
+typedef MetropolisEnsemble<EnsembleIsingLattice2d, Random::Boost_MT19937> EnsembleSimulation;
+
+class TestMetropolisEnsemble : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_do_ensemble_steps();
+  void test_serialize_lanes();
+};
+
+#endif
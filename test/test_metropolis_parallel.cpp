@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <cmath>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
@@ -22,6 +23,7 @@ CppUnit::Test* TestMetropolisParallel::suite()
 {
   CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestMetropolisParallel");
   suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolisParallel>("TestMetropolisParallel: test_do_parallel_metropolis_simulation", &TestMetropolisParallel::test_do_parallel_metropolis_simulation) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolisParallel>("TestMetropolisParallel: test_standard_error", &TestMetropolisParallel::test_standard_error) );
     
   return suite_of_tests;
 }
@@ -96,3 +98,35 @@ void TestMetropolisParallel::test_do_parallel_metropolis_simulation()
   CPPUNIT_ASSERT_DOUBLES_EQUAL(ba::mean(accumulator_serial), ba::mean(accumulator_parallel), 1e-4);
   CPPUNIT_ASSERT_DOUBLES_EQUAL(ba::moment<2>(accumulator_serial), ba::moment<2>(accumulator_parallel), 1e-4);
 }
+
+void TestMetropolisParallel::test_standard_error()
+{
+  // No estimate is available before a simulation
+  CPPUNIT_ASSERT_EQUAL(0.0, test_simulation->get_standard_error());
+
+  // Perform four serial simulations with the seeds of the runs and take their binning estimates
+  SimulationTypeSerial::Parameters parameters_serial;
+  parameters_serial.relaxation_steps = 10000;
+  parameters_serial.measurement_number = 1000;
+  parameters_serial.steps_between_measurement = 16;
+  std::vector<double> serial_errors;
+  for (unsigned int run = 0; run < 4; ++run)
+  {
+    ConfigurationType serial_config(*test_config_space);
+    SimulationTypeSerial serial_simulation(parameters_serial, &serial_config);
+    serial_simulation.set_random_seed(run);
+    serial_simulation.do_metropolis_simulation<ObserveIsingEnergy>(0.4);
+    CPPUNIT_ASSERT(serial_simulation.get_standard_error() > 0.0);
+    serial_errors.push_back(serial_simulation.get_standard_error());
+  }
+
+  // The interleaved measurements of the runs are not pooled, the errors of the runs are combined as sigma^2 = sum sigma_i^2 / K^2
+  SimulationType::Parameters parameters_parallel = test_parameters;
+  parameters_parallel.steps_between_measurement = 16;
+  parameters_parallel.process_number = 4;
+  test_simulation->set_parameters(parameters_parallel);
+  test_simulation->set_random_seed(0);
+  test_simulation->do_parallel_metropolis_simulation<ObserveIsingEnergy>(0.4);
+  const double combined_error = sqrt(serial_errors[0]*serial_errors[0] + serial_errors[1]*serial_errors[1] + serial_errors[2]*serial_errors[2] + serial_errors[3]*serial_errors[3]) / 4.0;
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(combined_error, test_simulation->get_standard_error(), 1e-12);
+}
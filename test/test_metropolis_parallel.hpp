@@ -37,6 +37,7 @@ public:
   void tearDown();
 
   void test_do_parallel_metropolis_simulation();
+  void test_standard_error();
 };
 
 #endif
@@ -0,0 +1,118 @@
+#include "test_metropolis_rejection_free.hpp"
+
+#include <cmath>
+
+//! Exact mean energy of a periodic Ising chain with the given length at the given inverse temperature
+double ising_chain_mean_energy(std::size_t length, double beta)
+{
+  const double t = tanh(beta);
+  return -static_cast<double>(length) * (t + pow(t, length - 1)) / (1.0 + pow(t, length));
+}
+
+CppUnit::Test* TestMetropolisRejectionFree::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestMetropolisRejectionFree");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolisRejectionFree>("TestMetropolisRejectionFree: test_do_metropolis_steps", &TestMetropolisRejectionFree::test_do_metropolis_steps) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolisRejectionFree>("TestMetropolisRejectionFree: test_incremental_rates", &TestMetropolisRejectionFree::test_incremental_rates) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMetropolisRejectionFree>("TestMetropolisRejectionFree: test_step_classes_frozen", &TestMetropolisRejectionFree::test_step_classes_frozen) );
+
+  return suite_of_tests;
+}
+
+void TestMetropolisRejectionFree::setUp()
+{
+  test_configuration = new IsingChainConfiguration(16);
+  test_simulation = new IsingChainSimulation(IsingChainSimulation::Parameters(), test_configuration);
+}
+
+void TestMetropolisRejectionFree::tearDown()
+{
+  delete test_simulation;
+  delete test_configuration;
+}
+
+void TestMetropolisRejectionFree::test_do_metropolis_steps()
+{
+  // The steps are written into a buffer of the simulation that is reused by all calls
+  test_simulation->do_metropolis_steps(100, 0.5);
+  const std::vector<IsingChainStep>* buffer = test_configuration->all_steps_buffer;
+  CPPUNIT_ASSERT(test_configuration->all_steps_calls > 0);
+  test_simulation->do_metropolis_steps(100, 0.5);
+  CPPUNIT_ASSERT(buffer == test_configuration->all_steps_buffer);
+
+  // The time-averaged energy is the exact mean energy
+  double energy_sum = 0.0;
+  for (unsigned int i = 0; i < 20000; ++i)
+  {
+    test_simulation->do_metropolis_steps(64, 0.5);
+    energy_sum += test_configuration->energy();
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(ising_chain_mean_energy(16, 0.5), energy_sum / 20000, 0.2);
+
+  // The tracked energy is passed as non-constant parameter of the steps
+  IsingChainSimulation::Parameters tracking_parameters;
+  tracking_parameters.track_energy = true;
+  test_simulation->set_parameters(tracking_parameters);
+  energy_sum = 0.0;
+  for (unsigned int i = 0; i < 20000; ++i)
+  {
+    test_simulation->do_metropolis_steps(64, 0.5);
+    energy_sum += test_configuration->energy();
+  }
+  CPPUNIT_ASSERT_EQUAL(test_configuration->energy(), test_simulation->get_energy());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(ising_chain_mean_energy(16, 0.5), energy_sum / 20000, 0.2);
+}
+
+void TestMetropolisRejectionFree::test_incremental_rates()
+{
+  // The steps are enumerated once per call and their rates are kept in the Fenwick tree, updated for the affected steps
+  IsingChainConfigurationIncremental configuration(16);
+  IsingChainSimulationIncremental simulation(IsingChainSimulationIncremental::Parameters(), &configuration);
+  double energy_sum = 0.0;
+  for (unsigned int i = 0; i < 20000; ++i)
+  {
+    simulation.do_metropolis_steps(64, 0.5);
+    energy_sum += configuration.energy();
+  }
+  CPPUNIT_ASSERT_EQUAL(20000u, configuration.all_steps_calls);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(ising_chain_mean_energy(16, 0.5), energy_sum / 20000, 0.2);
+
+  // If no step is executable, the local rates cannot change and the steps end
+  configuration.frozen = true;
+  const std::vector<int> frozen_spins = configuration.spins;
+  simulation.do_metropolis_steps(64, 0.5);
+  CPPUNIT_ASSERT(frozen_spins == configuration.spins);
+
+  // Acceptance probabilities that depend on the rejected steps are recalculated after every rejected step
+  IsingChainConfigurationIncremental configuration_thawing(16);
+  ThawingSimulation simulation_thawing(&configuration_thawing, 3);
+  simulation_thawing.do_thawing_steps(10);
+  CPPUNIT_ASSERT_EQUAL(3u, simulation_thawing.rejected_steps);
+  CPPUNIT_ASSERT(simulation_thawing.executed_steps > 0);
+}
+
+void TestMetropolisRejectionFree::test_step_classes_frozen()
+{
+  // The n-fold way samples the same distribution as the other rejection-free variants
+  IsingChainConfigurationClasses configuration(16);
+  IsingChainSimulationClasses simulation(IsingChainSimulationClasses::Parameters(), &configuration);
+  double energy_sum = 0.0;
+  for (unsigned int i = 0; i < 20000; ++i)
+  {
+    simulation.do_metropolis_steps(64, 0.5);
+    energy_sum += configuration.energy();
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(ising_chain_mean_energy(16, 0.5), energy_sum / 20000, 0.2);
+
+  // If no step is executable, all class rates vanish and the steps end
+  configuration.frozen = true;
+  const std::vector<int> frozen_spins = configuration.spins;
+  simulation.do_metropolis_steps(64, 0.5);
+  CPPUNIT_ASSERT(frozen_spins == configuration.spins);
+
+  // The same holds if the acceptance probabilities of all steps underflow in the ground state
+  IsingChainConfigurationClasses configuration_ground_state(16);
+  IsingChainSimulationClasses simulation_ground_state(IsingChainSimulationClasses::Parameters(), &configuration_ground_state);
+  simulation_ground_state.do_metropolis_steps(64, 1e4);
+  CPPUNIT_ASSERT_EQUAL(-16, configuration_ground_state.energy());
+}
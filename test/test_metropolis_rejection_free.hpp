@@ -0,0 +1,161 @@
+#ifndef TEST_METROPOLIS_REJECTION_FREE_HPP
+#define TEST_METROPOLIS_REJECTION_FREE_HPP
+
+#include <vector>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/metropolis.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+using namespace Mocasinns;
+
+class IsingChainConfiguration;
+
+// Step flipping a single spin of a periodic Ising chain
+class IsingChainStep
+{
+public:
+  IsingChainConfiguration* configuration;
+  std::size_t site;
+
+  IsingChainStep() : configuration(0), site(0) {}
+  IsingChainStep(IsingChainConfiguration* config, std::size_t index) : configuration(config), site(index) {}
+
+  int delta_E();
+  bool is_executable();
+  void execute();
+};
+
+// Periodic Ising chain filling the buffer of all steps in place, remembers the buffer it was handed
+class IsingChainConfiguration
+{
+public:
+  std::vector<int> spins;
+  bool frozen;
+  const std::vector<IsingChainStep>* all_steps_buffer;
+  unsigned int all_steps_calls;
+
+  IsingChainConfiguration() : spins(), frozen(false), all_steps_buffer(0), all_steps_calls(0) {}
+  IsingChainConfiguration(std::size_t length) : spins(length, 1), frozen(false), all_steps_buffer(0), all_steps_calls(0) {}
+
+  void all_steps(std::vector<IsingChainStep>& steps)
+  {
+    all_steps_buffer = &steps;
+    ++all_steps_calls;
+    steps.clear();
+    for (std::size_t i = 0; i < spins.size(); ++i) steps.push_back(IsingChainStep(this, i));
+  }
+
+  void commit(const IsingChainStep& step) { spins[step.site] *= -1; }
+
+  int energy() const
+  {
+    int result = 0;
+    for (std::size_t i = 0; i < spins.size(); ++i) result -= spins[i] * spins[(i + 1) % spins.size()];
+    return result;
+  }
+};
+
+// Same chain reporting the steps affected by an executed step
+class IsingChainConfigurationIncremental : public IsingChainConfiguration
+{
+public:
+  IsingChainConfigurationIncremental() : IsingChainConfiguration() {}
+  IsingChainConfigurationIncremental(std::size_t length) : IsingChainConfiguration(length) {}
+
+  void all_steps(std::vector<IsingChainStep>& steps) { IsingChainConfiguration::all_steps(steps); }
+  void affected_steps(IsingChainStep& executed_step, std::vector<std::size_t>& indices)
+  {
+    indices.push_back((executed_step.site + spins.size() - 1) % spins.size());
+    indices.push_back(executed_step.site);
+    indices.push_back((executed_step.site + 1) % spins.size());
+  }
+};
+
+// Step of the chain grouped in classes of equal energy difference by the n-fold way
+class IsingChainClassStep : public IsingChainStep
+{
+public:
+  IsingChainClassStep() : IsingChainStep() {}
+  IsingChainClassStep(IsingChainConfiguration* config, std::size_t index) : IsingChainStep(config, index) {}
+
+  // The member function detection does not find inherited member functions
+  bool is_executable() { return IsingChainStep::is_executable(); }
+};
+
+// Same chain enumerating the steps of the n-fold way
+class IsingChainConfigurationClasses : public IsingChainConfigurationIncremental
+{
+public:
+  IsingChainConfigurationClasses(std::size_t length) : IsingChainConfigurationIncremental(length) {}
+
+  void all_steps(std::vector<IsingChainClassStep>& steps)
+  {
+    steps.clear();
+    for (std::size_t i = 0; i < spins.size(); ++i) steps.push_back(IsingChainClassStep(this, i));
+  }
+  void affected_steps(IsingChainClassStep& executed_step, std::vector<std::size_t>& indices) { IsingChainConfigurationIncremental::affected_steps(executed_step, indices); }
+};
+
+// Use the Fenwick tree instead of the n-fold way for the steps of the chain
+namespace Mocasinns { namespace Details { namespace RejectionFree {
+      template <> struct use_step_classes<IsingChainStep> : public boost::false_type {};
+} } }
+
+// Rejection-free algorithm whose acceptance probabilities vanish until a number of steps were rejected
+class ThawingSimulation : public Simulation<IsingChainConfigurationIncremental>
+{
+public:
+  unsigned int rejected_steps;
+  unsigned int executed_steps;
+  unsigned int rejections_until_thawed;
+
+  ThawingSimulation(IsingChainConfigurationIncremental* configuration, unsigned int rejections)
+    : Simulation<IsingChainConfigurationIncremental>(configuration), rejected_steps(0), executed_steps(0), rejections_until_thawed(rejections) {}
+
+  double acceptance_probability(IsingChainStep&, double&) { return (rejected_steps >= rejections_until_thawed ? 1.0 : 0.0); }
+  void handle_executed_step(IsingChainStep&, double, double&) { ++executed_steps; }
+  void handle_rejected_step(IsingChainStep&, double, double&) { ++rejected_steps; }
+
+  void do_thawing_steps(step_number_t number)
+  {
+    double parameter = 0.0;
+    this->template do_steps<ThawingSimulation, IsingChainStep, true>(number, parameter);
+  }
+};
+
+inline int IsingChainStep::delta_E()
+{
+  const std::size_t length = configuration->spins.size();
+  return 2 * configuration->spins[site] * (configuration->spins[(site + length - 1) % length] + configuration->spins[(site + 1) % length]);
+}
+inline bool IsingChainStep::is_executable() { return !configuration->frozen; }
+inline void IsingChainStep::execute() { configuration->commit(*this); }
+
+typedef Metropolis<IsingChainConfiguration, IsingChainStep, Random::Boost_MT19937, true> IsingChainSimulation;
+typedef Metropolis<IsingChainConfigurationIncremental, IsingChainStep, Random::Boost_MT19937, true> IsingChainSimulationIncremental;
+typedef Metropolis<IsingChainConfigurationClasses, IsingChainClassStep, Random::Boost_MT19937, true> IsingChainSimulationClasses;
+
+class TestMetropolisRejectionFree : CppUnit::TestFixture
+{
+private:
+  IsingChainConfiguration* test_configuration;
+  IsingChainSimulation* test_simulation;
+
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_do_metropolis_steps();
+  void test_incremental_rates();
+  void test_step_classes_frozen();
+};
+
+#endif
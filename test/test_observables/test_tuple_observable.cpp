@@ -0,0 +1,78 @@
+#include "test_tuple_observable.hpp"
+
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/statistics/mean.hpp>
+
+namespace ba = boost::accumulators;
+
+CppUnit::Test* TestTupleObservable::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestObservables/TestTupleObservable");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTupleObservable>("TestObservables/TestTupleObservable: test_constructor", &TestTupleObservable::test_constructor) );
+
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTupleObservable>("TestObservables/TestTupleObservable: test_operator_add", &TestTupleObservable::test_operator_add) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTupleObservable>("TestObservables/TestTupleObservable: test_operator_multiply", &TestTupleObservable::test_operator_multiply) );
+
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTupleObservable>("TestObservables/TestTupleObservable: test_pow", &TestTupleObservable::test_pow) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTupleObservable>("TestObservables/TestTupleObservable: test_mean", &TestTupleObservable::test_mean) );
+  
+  return suite_of_tests;
+}
+
+void TestTupleObservable::setUp()
+{
+  tuple_observable = TupleObservable<int, double>(2, -1.5);
+}
+
+void TestTupleObservable::tearDown() { }
+
+void TestTupleObservable::test_constructor()
+{
+  CPPUNIT_ASSERT_EQUAL(2, get<0>(tuple_observable));
+  CPPUNIT_ASSERT_EQUAL(-1.5, get<1>(tuple_observable));
+
+  // The default constructor sets all components to zero
+  TupleObservable<int, double> zero;
+  CPPUNIT_ASSERT_EQUAL(0, get<0>(zero));
+  CPPUNIT_ASSERT_EQUAL(0.0, get<1>(zero));
+}
+
+void TestTupleObservable::test_operator_add()
+{
+  TupleObservable<int, double> result = tuple_observable + TupleObservable<int, double>(3, 0.5);
+  CPPUNIT_ASSERT_EQUAL(5, get<0>(result));
+  CPPUNIT_ASSERT_EQUAL(-1.0, get<1>(result));
+  result = result - tuple_observable;
+  CPPUNIT_ASSERT_EQUAL(3, get<0>(result));
+  CPPUNIT_ASSERT_EQUAL(0.5, get<1>(result));
+}
+
+void TestTupleObservable::test_operator_multiply()
+{
+  // Test the component-wise multiplication and the multiplication with a scalar
+  TupleObservable<int, double> result = tuple_observable * TupleObservable<int, double>(4, 2.0);
+  CPPUNIT_ASSERT_EQUAL(8, get<0>(result));
+  CPPUNIT_ASSERT_EQUAL(-3.0, get<1>(result));
+  result = 2.0*tuple_observable;
+  CPPUNIT_ASSERT_EQUAL(4, get<0>(result));
+  CPPUNIT_ASSERT_EQUAL(-3.0, get<1>(result));
+}
+
+void TestTupleObservable::test_pow()
+{
+  TupleObservable<int, double> powed_tuple_observable = pow(tuple_observable, 2);
+  CPPUNIT_ASSERT_EQUAL(4, get<0>(powed_tuple_observable));
+  CPPUNIT_ASSERT_EQUAL(2.25, get<1>(powed_tuple_observable));
+}
+
+void TestTupleObservable::test_mean()
+{
+  // The mean of integral components must be calculated with a floating point count
+  ba::accumulator_set<TupleObservable<int, double>, ba::stats<ba::tag::mean> > accumulator;
+  accumulator(TupleObservable<int, double>(-30, 1.0));
+  accumulator(TupleObservable<int, double>(-60, 2.0));
+  accumulator(TupleObservable<int, double>(-90, 6.0));
+  CPPUNIT_ASSERT_EQUAL(-60, get<0>(ba::mean(accumulator)));
+  CPPUNIT_ASSERT_EQUAL(3.0, get<1>(ba::mean(accumulator)));
+}
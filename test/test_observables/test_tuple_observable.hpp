@@ -0,0 +1,33 @@
+#ifndef TEST_TUPLE_OBSERVABLE_HPP
+#define TEST_TUPLE_OBSERVABLE_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/observables/tuple_observable.hpp>
+
+using namespace Mocasinns::Observables;
+
+class TestTupleObservable : CppUnit::TestFixture
+{
+private:
+  TupleObservable<int, double> tuple_observable;
+
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_constructor();
+
+  void test_operator_add();
+  void test_operator_multiply();
+  void test_pow();
+  void test_mean();
+};
+
+#endif
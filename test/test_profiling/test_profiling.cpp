@@ -0,0 +1,98 @@
+#include "test_profiling.hpp"
+
+#include <sstream>
+#include <string>
+
+CppUnit::Test* TestProfiling::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestProfiling");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestProfiling>("TestProfiling: test_phase_name", &TestProfiling::test_phase_name) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestProfiling>("TestProfiling: test_nested_phases", &TestProfiling::test_nested_phases) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestProfiling>("TestProfiling: test_reset", &TestProfiling::test_reset) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestProfiling>("TestProfiling: test_dump", &TestProfiling::test_dump) );
+
+  return suite_of_tests;
+}
+
+void TestProfiling::setUp()
+{
+  Profiling::reset();
+}
+
+void TestProfiling::tearDown()
+{
+  Profiling::reset();
+}
+
+void TestProfiling::test_phase_name()
+{
+  CPPUNIT_ASSERT_EQUAL(std::string("propose"), std::string(Profiling::phase_name(Profiling::propose)));
+  CPPUNIT_ASSERT_EQUAL(std::string("delta_E"), std::string(Profiling::phase_name(Profiling::delta_E)));
+  CPPUNIT_ASSERT_EQUAL(std::string("signal"), std::string(Profiling::phase_name(Profiling::signal)));
+  CPPUNIT_ASSERT_EQUAL(std::string("none"), std::string(Profiling::phase_name(Profiling::phase_number)));
+}
+
+void TestProfiling::test_nested_phases()
+{
+  Profiling::ThreadProfiler profiler;
+  
+  // Enter the phase propose twice and the phase delta_E three times nested inside
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    Profiling::Phase outer = profiler.enter(Profiling::propose);
+    CPPUNIT_ASSERT_EQUAL(Profiling::phase_number, outer);
+    Profiling::Phase inner = profiler.enter(Profiling::delta_E);
+    CPPUNIT_ASSERT_EQUAL(Profiling::propose, inner);
+    profiler.leave(inner);
+    if (i == 0)
+    {
+      inner = profiler.enter(Profiling::delta_E);
+      profiler.leave(inner);
+    }
+    profiler.leave(outer);
+  }
+
+  const std::vector<Profiling::PhaseCounter>& counters = profiler.get_counters();
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(Profiling::phase_number), counters.size());
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), counters[Profiling::propose].calls);
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(3), counters[Profiling::delta_E].calls);
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), counters[Profiling::execute].calls);
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), counters[Profiling::execute].nanoseconds);
+}
+
+void TestProfiling::test_reset()
+{
+  {
+    Profiling::ScopedPhase scope(Profiling::handle);
+  }
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), Profiling::aggregate()[Profiling::handle].calls);
+
+  Profiling::reset();
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), Profiling::aggregate()[Profiling::handle].calls);
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), Profiling::aggregate()[Profiling::handle].nanoseconds);
+}
+
+void TestProfiling::test_dump()
+{
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    Profiling::ScopedPhase scope(Profiling::observe);
+  }
+
+  std::stringstream dump_stream;
+  Profiling::dump(dump_stream);
+
+  // The header is followed by one line for each phase of every thread and of the aggregate
+  std::string line;
+  std::getline(dump_stream, line);
+  CPPUNIT_ASSERT_EQUAL(std::string("thread\tphase\tcalls\tnanoseconds"), line);
+  unsigned int line_number = 0;
+  bool aggregate_found = false;
+  while (std::getline(dump_stream, line))
+  {
+    ++line_number;
+    if (line.find("all\tobserve\t5\t") == 0) aggregate_found = true;
+  }
+  CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>((Profiling::thread_counters().size() + 1) * Profiling::phase_number), line_number);
+  CPPUNIT_ASSERT(aggregate_found);
+}
@@ -0,0 +1,28 @@
+#ifndef TEST_PROFILING_PROFILING_HPP
+#define TEST_PROFILING_PROFILING_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/profiling/profiling.hpp>
+
+using namespace Mocasinns;
+
+class TestProfiling : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_phase_name();
+  void test_nested_phases();
+  void test_reset();
+  void test_dump();
+};
+
+#endif
@@ -35,6 +35,13 @@ void TestSimulation::tearDown()
 // Create different classes
 class WithIsExecutable { public: bool is_executable() { return false; } };
 class WithSelectionProbabilityFactor { public: double selection_probability_factor() { return 2.0; } };
+class WithProposeSteps 
+{ 
+public: 
+  template <class RandomNumberGenerator> void propose_steps(RandomNumberGenerator*, std::vector<WithIsExecutable>&) { }
+  void update_proposed_steps(std::vector<WithIsExecutable>&, std::size_t first_index, WithIsExecutable&) { updated_index = first_index; }
+  std::size_t updated_index;
+};
 
 void TestSimulation::test_optional_member_functions()
 {
@@ -47,6 +54,10 @@ void TestSimulation::test_optional_member_functions()
 			  "has_function_selection_probability_factor did not detect the (static) member selection_probability_factor()");
   BOOST_STATIC_ASSERT_MSG(Mocasinns::Details::has_function_selection_probability_factor<WithIsExecutable, double>::value == false,
 			  "has_function_selection_probability_factor did detect a non-existant (static) member selection_probability_factor()");
+  BOOST_STATIC_ASSERT_MSG((Mocasinns::Details::has_function_propose_steps<WithProposeSteps, void, boost::mpl::vector<Random::Boost_MT19937*, std::vector<WithIsExecutable>&> >::value == true),
+			  "has_function_propose_steps did not detect the member function propose_steps(RandomNumberGenerator*, std::vector<StepType>&)");
+  BOOST_STATIC_ASSERT_MSG((Mocasinns::Details::has_function_propose_steps<WithIsExecutable, void, boost::mpl::vector<Random::Boost_MT19937*, std::vector<WithIsExecutable>&> >::value == false),
+			  "has_function_propose_steps did detect a non-existant member function propose_steps(RandomNumberGenerator*, std::vector<StepType>&)");
 
   // Test the default function values
   WithIsExecutable with_is_executable;
@@ -55,6 +66,12 @@ void TestSimulation::test_optional_member_functions()
   CPPUNIT_ASSERT(Mocasinns::Details::OptionalMemberFunctions::optional_is_executable<WithSelectionProbabilityFactor>(with_selection_probability_factor));
   CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, Mocasinns::Details::OptionalMemberFunctions::optional_selection_probability_factor<WithIsExecutable>(with_is_executable), 1e-4);
   CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, Mocasinns::Details::OptionalMemberFunctions::optional_selection_probability_factor<WithSelectionProbabilityFactor>(with_selection_probability_factor), 1e-4);
+  WithProposeSteps with_propose_steps;
+  std::vector<WithIsExecutable> proposed_steps(4);
+  with_propose_steps.updated_index = 0;
+  Mocasinns::Details::OptionalMemberFunctions::optional_update_proposed_steps(with_propose_steps, proposed_steps, 2, proposed_steps[1]);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(2), with_propose_steps.updated_index);
+  Mocasinns::Details::OptionalMemberFunctions::optional_update_proposed_steps(with_selection_probability_factor, proposed_steps, 2, proposed_steps[1]);
 }
 
 void TestSimulation::test_serialize()
@@ -0,0 +1,123 @@
+#include "test_acceptance_statistics.hpp"
+
+#include <sstream>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+
+CppUnit::Test* TestAcceptanceStatistics::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestAcceptanceStatistics");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceStatistics>("TestAcceptanceStatistics: test_record", &TestAcceptanceStatistics::test_record) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceStatistics>("TestAcceptanceStatistics: test_energy_bins", &TestAcceptanceStatistics::test_energy_bins) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceStatistics>("TestAcceptanceStatistics: test_step_types", &TestAcceptanceStatistics::test_step_types) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceStatistics>("TestAcceptanceStatistics: test_merge", &TestAcceptanceStatistics::test_merge) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestAcceptanceStatistics>("TestAcceptanceStatistics: test_serialize", &TestAcceptanceStatistics::test_serialize) );
+
+  return suite_of_tests;
+}
+
+void TestAcceptanceStatistics::setUp()
+{
+  // Record the steps (delta_E, type, accepted): (4,0,yes) (4,0,no) (-4,1,yes) (8,1,no) and a not executable step of type 2
+  test_statistics = new Statistics::AcceptanceStatistics;
+  test_statistics->record(4, 0, true);
+  test_statistics->record(4, 0, false);
+  test_statistics->record(-4, 1, true);
+  test_statistics->record(8, 1, false);
+  test_statistics->record_not_executable(2);
+  test_statistics->add_seconds(0.5);
+}
+
+void TestAcceptanceStatistics::tearDown()
+{
+  delete test_statistics;
+}
+
+void TestAcceptanceStatistics::test_record()
+{
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(5), test_statistics->proposed_steps());
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), test_statistics->accepted_steps());
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), test_statistics->not_executable_steps());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.4, test_statistics->acceptance_ratio(), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, test_statistics->steps_per_second(), 1e-12);
+
+  test_statistics->clear();
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), test_statistics->proposed_steps());
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(0), test_statistics->bin_number());
+  CPPUNIT_ASSERT_EQUAL(0.0, test_statistics->acceptance_ratio());
+  CPPUNIT_ASSERT_EQUAL(0.0, test_statistics->steps_per_second());
+}
+
+void TestAcceptanceStatistics::test_energy_bins()
+{
+  // The bins range from -4 to 8
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(13), test_statistics->bin_number());
+  CPPUNIT_ASSERT_EQUAL(-4l, test_statistics->bin_at(0));
+  CPPUNIT_ASSERT_EQUAL(-4.0, test_statistics->bin_energy(0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), test_statistics->proposed_in_bin(8));
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), test_statistics->accepted_in_bin(8));
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), test_statistics->proposed_in_bin(1));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, test_statistics->acceptance_ratio_of_energy(4), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, test_statistics->acceptance_ratio_of_energy(-4), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, test_statistics->acceptance_ratio_of_energy(8), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, test_statistics->acceptance_ratio_of_energy(100), 1e-12);
+
+  // Bins of width 2.5 for continuous energy differences
+  Statistics::AcceptanceStatistics continuous_statistics(2.5);
+  continuous_statistics.record(-0.1, 0, true);
+  continuous_statistics.record(3.0, 0, true);
+  continuous_statistics.record(4.9, 0, false);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), continuous_statistics.bin_number());
+  CPPUNIT_ASSERT_EQUAL(-2.5, continuous_statistics.bin_energy(0));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, continuous_statistics.acceptance_ratio_of_energy(2.5), 1e-12);
+}
+
+void TestAcceptanceStatistics::test_step_types()
+{
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), test_statistics->step_type_number());
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), test_statistics->proposed_of_type(0));
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), test_statistics->accepted_of_type(1));
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), test_statistics->proposed_of_type(2));
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), test_statistics->proposed_of_type(7));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, test_statistics->acceptance_ratio_of_type(1), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, test_statistics->acceptance_ratio_of_type(2), 1e-12);
+}
+
+void TestAcceptanceStatistics::test_merge()
+{
+  Statistics::AcceptanceStatistics other_statistics;
+  other_statistics.record(-8, 3, true);
+  other_statistics.record(4, 0, true);
+  other_statistics.add_seconds(0.5);
+
+  *test_statistics += other_statistics;
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(7), test_statistics->proposed_steps());
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(4), test_statistics->accepted_steps());
+  CPPUNIT_ASSERT_EQUAL(-8l, test_statistics->bin_at(0));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0/3.0, test_statistics->acceptance_ratio_of_energy(4), 1e-12);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, test_statistics->acceptance_ratio_of_energy(-8), 1e-12);
+  CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), test_statistics->accepted_of_type(3));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, test_statistics->get_seconds(), 1e-12);
+}
+
+void TestAcceptanceStatistics::test_serialize()
+{
+  std::stringstream serialization_stream;
+  {
+    boost::archive::text_oarchive output_archive(serialization_stream);
+    output_archive << *test_statistics;
+  }
+  Statistics::AcceptanceStatistics loaded_statistics;
+  {
+    boost::archive::text_iarchive input_archive(serialization_stream);
+    input_archive >> loaded_statistics;
+  }
+
+  CPPUNIT_ASSERT_EQUAL(test_statistics->proposed_steps(), loaded_statistics.proposed_steps());
+  CPPUNIT_ASSERT_EQUAL(test_statistics->not_executable_steps(), loaded_statistics.not_executable_steps());
+  CPPUNIT_ASSERT_EQUAL(test_statistics->bin_number(), loaded_statistics.bin_number());
+  CPPUNIT_ASSERT_EQUAL(test_statistics->bin_at(0), loaded_statistics.bin_at(0));
+  CPPUNIT_ASSERT_EQUAL(test_statistics->accepted_in_bin(8), loaded_statistics.accepted_in_bin(8));
+  CPPUNIT_ASSERT_EQUAL(test_statistics->step_type_number(), loaded_statistics.step_type_number());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(test_statistics->steps_per_second(), loaded_statistics.steps_per_second(), 1e-12);
+}
@@ -0,0 +1,32 @@
+#ifndef TEST_STATISTICS_ACCEPTANCE_STATISTICS_HPP
+#define TEST_STATISTICS_ACCEPTANCE_STATISTICS_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/statistics/acceptance_statistics.hpp>
+
+using namespace Mocasinns;
+
+class TestAcceptanceStatistics : CppUnit::TestFixture
+{
+private:
+  Statistics::AcceptanceStatistics* test_statistics;
+  
+public:
+  static CppUnit::Test* suite();
+  
+  void setUp();
+  void tearDown();
+
+  void test_record();
+  void test_energy_bins();
+  void test_step_types();
+  void test_merge();
+  void test_serialize();
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include "test_swendsen_wang.hpp"
+
+CppUnit::Test* TestSwendsenWang::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestSwendsenWang");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestSwendsenWang>("TestSwendsenWang: test_do_swendsen_wang_steps", &TestSwendsenWang::test_do_swendsen_wang_steps) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestSwendsenWang>("TestSwendsenWang: test_copy", &TestSwendsenWang::test_copy) );
+
+  return suite_of_tests;
+}
+
+void TestSwendsenWang::setUp()
+{
+  test_config_space = new IsingLattice2d(4, 4);
+  test_simulation = new SimulationType(SimulationType::Parameters(), test_config_space);
+}
+
+void TestSwendsenWang::tearDown()
+{
+  delete test_simulation;
+  delete test_config_space;
+}
+
+void TestSwendsenWang::test_do_swendsen_wang_steps()
+{
+  // Compare the mean energy with the exact value at high, critical and low temperature for one and for several threads
+  const double betas[] = {0.2, 0.44, 0.6};
+  const unsigned int thread_numbers[] = {1, 4};
+  for (unsigned int t = 0; t < 2; ++t)
+  {
+    SimulationType::Parameters parameters;
+    parameters.thread_number = thread_numbers[t];
+    test_simulation->set_parameters(parameters);
+    for (unsigned int b = 0; b < 3; ++b)
+    {
+      test_simulation->do_swendsen_wang_steps(100, betas[b]);
+      double energy_sum = 0.0;
+      for (unsigned int i = 0; i < 10000; ++i)
+      {
+	test_simulation->do_swendsen_wang_steps(1, betas[b]);
+	energy_sum += test_config_space->energy();
+      }
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(ising_lattice_2d_mean_energy(4, 4, betas[b]), energy_sum / 10000, 0.5);
+    }
+  }
+}
+
+void TestSwendsenWang::test_copy()
+{
+  SimulationType::Parameters parameters;
+  parameters.thread_number = 2;
+  test_simulation->set_parameters(parameters);
+  test_simulation->do_swendsen_wang_steps(10, 0.44);
+
+  // Copies create the random number generators of their threads themselves
+  SimulationType test_simulation_copy(*test_simulation);
+  CPPUNIT_ASSERT_EQUAL(test_config_space, test_simulation_copy.get_config_space());
+  CPPUNIT_ASSERT_EQUAL(2u, test_simulation_copy.get_simulation_parameters().thread_number);
+  test_simulation_copy.do_swendsen_wang_steps(10, 0.44);
+
+  SimulationType test_simulation_assigned;
+  test_simulation_assigned.do_swendsen_wang_steps(1, 0.44);
+  test_simulation_assigned = test_simulation_copy;
+  CPPUNIT_ASSERT_EQUAL(test_config_space, test_simulation_assigned.get_config_space());
+  test_simulation_assigned.do_swendsen_wang_steps(10, 0.44);
+}
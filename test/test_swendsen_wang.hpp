@@ -0,0 +1,35 @@
+#ifndef TEST_SWENDSEN_WANG_HPP
+#define TEST_SWENDSEN_WANG_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <mocasinns/swendsen_wang.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+#include "ising_lattice_2d.hpp"
+
+using namespace Mocasinns;
+
+class TestSwendsenWang : CppUnit::TestFixture
+{
+  typedef SwendsenWang<IsingLattice2d, Random::Boost_MT19937> SimulationType;
+
+private:
+  IsingLattice2d* test_config_space;
+  SimulationType* test_simulation;
+
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_do_swendsen_wang_steps();
+  void test_copy();
+};
+
+#endif
@@ -5,6 +5,9 @@ CppUnit::Test* TestWangLandau::suite()
   CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestWangLandau");
   suite_of_tests->addTest( new CppUnit::TestCaller<TestWangLandau>("TestWangLandau: test_do_wang_landau_steps", &TestWangLandau::test_do_wang_landau_steps) );
   suite_of_tests->addTest( new CppUnit::TestCaller<TestWangLandau>("TestWangLandau: test_do_wang_landau_simulation", &TestWangLandau::test_do_wang_landau_simulation) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestWangLandau>("TestWangLandau: test_coalesce_rejected_steps", &TestWangLandau::test_coalesce_rejected_steps) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestWangLandau>("TestWangLandau: test_track_energy", &TestWangLandau::test_track_energy) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestWangLandau>("TestWangLandau: test_time_budget", &TestWangLandau::test_time_budget) );
 
   suite_of_tests->addTest( new CppUnit::TestCaller<TestWangLandau>("TestWangLandau: test_serialize", &TestWangLandau::test_serialize) );
     
@@ -86,6 +89,90 @@ void TestWangLandau::test_do_wang_landau_simulation()
   CPPUNIT_ASSERT_DOUBLES_EQUAL(16.0, exp(first_excited->second) / exp(ground_state->second), 0.9);
 }
 
+void TestWangLandau::test_coalesce_rejected_steps()
+{
+  // Create a second simulation with the same seed that coalesces the rejected steps
+  IsingSimulation2d::Parameters parameters_coalesced = parameters_2d;
+  parameters_coalesced.coalesce_rejected_steps = true;
+  std::vector<unsigned int> size_2d;
+  size_2d.push_back(4); size_2d.push_back(4);
+  IsingConfiguration2d test_ising_config_coalesced(size_2d);
+  IsingSimulation2d test_ising_simulation_coalesced(parameters_coalesced, &test_ising_config_coalesced);
+  test_ising_simulation_2d->set_random_seed(1);
+  test_ising_simulation_coalesced.set_random_seed(1);
+
+  // Both simulations must take the same steps and build the same histograms
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    test_ising_simulation_2d->do_wang_landau_steps(1000);
+    test_ising_simulation_coalesced.do_wang_landau_steps(1000);
+  }
+  CPPUNIT_ASSERT(*test_ising_config_2d == test_ising_config_coalesced);
+  CPPUNIT_ASSERT(test_ising_simulation_2d->get_incidence_counter() == test_ising_simulation_coalesced.get_incidence_counter());
+  Histograms::Histocrete<int, double> log_density_of_states = test_ising_simulation_2d->get_log_density_of_states();
+  Histograms::Histocrete<int, double> log_density_of_states_coalesced = test_ising_simulation_coalesced.get_log_density_of_states();
+  CPPUNIT_ASSERT_EQUAL(log_density_of_states.size(), log_density_of_states_coalesced.size());
+  for (Histograms::Histocrete<int, double>::const_iterator bin = log_density_of_states.begin(); bin != log_density_of_states.end(); ++bin)
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(bin->second, log_density_of_states_coalesced[bin->first], 1e-9);
+}
+
+void TestWangLandau::test_track_energy()
+{
+  // Create a second simulation with the same seed that tracks the energy between the calls
+  IsingSimulation2d::Parameters parameters_tracking = parameters_2d;
+  parameters_tracking.track_energy = true;
+  std::vector<unsigned int> size_2d;
+  size_2d.push_back(4); size_2d.push_back(4);
+  IsingConfiguration2d test_ising_config_tracking(size_2d);
+  IsingSimulation2d test_ising_simulation_tracking(parameters_tracking, &test_ising_config_tracking);
+  test_ising_simulation_2d->set_random_seed(1);
+  test_ising_simulation_tracking.set_random_seed(1);
+
+  // Both simulations must take the same steps and build the same histograms
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    test_ising_simulation_2d->do_wang_landau_steps(1000);
+    test_ising_simulation_tracking.do_wang_landau_steps(1000);
+  }
+  CPPUNIT_ASSERT(*test_ising_config_2d == test_ising_config_tracking);
+  CPPUNIT_ASSERT(test_ising_simulation_2d->get_incidence_counter() == test_ising_simulation_tracking.get_incidence_counter());
+
+  // After the same external change of both configurations the tracked energy is calculated again
+  Random::Boost_MT19937 rng;
+  Random::Boost_MT19937 rng_tracking;
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    test_ising_config_2d->propose_step(&rng).execute();
+    test_ising_config_tracking.propose_step(&rng_tracking).execute();
+  }
+  test_ising_simulation_tracking.invalidate_tracked_energy();
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    test_ising_simulation_2d->do_wang_landau_steps(1000);
+    test_ising_simulation_tracking.do_wang_landau_steps(1000);
+  }
+  CPPUNIT_ASSERT(*test_ising_config_2d == test_ising_config_tracking);
+  CPPUNIT_ASSERT(test_ising_simulation_2d->get_incidence_counter() == test_ising_simulation_tracking.get_incidence_counter());
+}
+
+void TestWangLandau::test_time_budget()
+{
+  // Both drivers stop after the first sweep if the time budget is exhausted
+  test_ising_simulation_2d->set_time_budget(1e-9);
+  test_ising_simulation_2d->do_wang_landau_simulation();
+  CPPUNIT_ASSERT(test_ising_simulation_2d->get_time_budget_exhausted());
+  CPPUNIT_ASSERT(test_ising_simulation_2d->get_modification_factor_current() > parameters_2d.modification_factor_final);
+
+  // The 1/t driver needs the energies that were already visited
+  IsingSimulation2d test_ising_simulation_1_t(parameters_2d, test_ising_config_2d);
+  test_ising_simulation_1_t.do_wang_landau_steps(1000);
+  test_ising_simulation_1_t.set_time_budget(1e-9);
+  test_ising_simulation_1_t.do_wang_landau_simulation_1_t(16);
+  CPPUNIT_ASSERT(test_ising_simulation_1_t.get_is_terminating());
+  CPPUNIT_ASSERT(test_ising_simulation_1_t.get_time_budget_exhausted());
+  CPPUNIT_ASSERT(test_ising_simulation_1_t.get_modification_factor_current() > parameters_2d.modification_factor_final);
+}
+
 void TestWangLandau::test_serialize()
 {
   // Test the serialization of parameters
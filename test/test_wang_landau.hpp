@@ -43,6 +43,9 @@ public:
 
   void test_do_wang_landau_steps();
   void test_do_wang_landau_simulation();
+  void test_coalesce_rejected_steps();
+  void test_track_energy();
+  void test_time_budget();
 
   void test_serialize();
 };
@@ -0,0 +1,60 @@
+#include "test_wolff.hpp"
+
+CppUnit::Test* TestWolff::suite()
+{
+  CppUnit::TestSuite *suite_of_tests = new CppUnit::TestSuite("TestWolff");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestWolff>("TestWolff: test_do_wolff_steps", &TestWolff::test_do_wolff_steps) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestWolff>("TestWolff: test_do_wolff_simulation", &TestWolff::test_do_wolff_simulation) );
+
+  return suite_of_tests;
+}
+
+void TestWolff::setUp()
+{
+  test_config_space = new IsingLattice2d(4, 4);
+  test_simulation = new SimulationType(SimulationType::Parameters(), test_config_space);
+}
+
+void TestWolff::tearDown()
+{
+  delete test_simulation;
+  delete test_config_space;
+}
+
+void TestWolff::test_do_wolff_steps()
+{
+  // Compare the mean energy with the exact value at high, critical and low temperature
+  const double betas[] = {0.2, 0.44, 0.6};
+  for (unsigned int b = 0; b < 3; ++b)
+  {
+    test_simulation->do_wolff_steps(100, betas[b]);
+    double energy_sum = 0.0;
+    for (unsigned int i = 0; i < 20000; ++i)
+    {
+      test_simulation->do_wolff_steps(4, betas[b]);
+      energy_sum += test_config_space->energy();
+      CPPUNIT_ASSERT(test_simulation->get_last_cluster_size() >= 1);
+      CPPUNIT_ASSERT(test_simulation->get_last_cluster_size() <= 16);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ising_lattice_2d_mean_energy(4, 4, betas[b]), energy_sum / 20000, 0.5);
+  }
+
+  // At infinite temperature no bond is activated and only the seed site is flipped
+  test_simulation->do_wolff_steps(1, 0.0);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(1), test_simulation->get_last_cluster_size());
+}
+
+void TestWolff::test_do_wolff_simulation()
+{
+  SimulationType::Parameters parameters;
+  parameters.relaxation_steps = 100;
+  parameters.measurement_number = 5000;
+  parameters.steps_between_measurement = 4;
+  test_simulation->set_parameters(parameters);
+
+  std::vector<int> results = test_simulation->do_wolff_simulation(0.44);
+  CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(5000), results.size());
+  double energy_sum = 0.0;
+  for (std::size_t i = 0; i < results.size(); ++i) energy_sum += results[i];
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(ising_lattice_2d_mean_energy(4, 4, 0.44), energy_sum / results.size(), 1.0);
+}